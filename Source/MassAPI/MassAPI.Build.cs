@@ -33,7 +33,8 @@ public class MassAPI : ModuleRules
                 "MassEntity",
                 "MassCommon",
                 "MassSpawner",
-                "DeveloperSettings"
+                "DeveloperSettings",
+                "Magnus"
                 // "BlueprintGraph" was moved below
             }
         );
@@ -7,6 +7,8 @@
 #include "MassAPI.h"
 #include "MassAPIStructs.h"
 
+DEFINE_LOG_CATEGORY(LogMassAPI);
+
 #define LOCTEXT_NAMESPACE "FMassAPIModule"
 
 void FMassAPIModule::StartupModule()
@@ -0,0 +1,335 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#include "MassAPIFlagIndex.h"
+#include "MassAPIStructs.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+
+//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
+
+//================ FEntityIndexBitmap																				========
+
+bool FEntityIndexBitmap::FContainer::Contains(const uint16 Low) const
+{
+	if (IsBitmap())
+	{
+		return (Bits[Low >> 6] & (1ULL << (Low & 63))) != 0;
+	}
+	return Algo::BinarySearch(Values, Low) != INDEX_NONE;
+}
+
+void FEntityIndexBitmap::FContainer::AppendTo(TArray<uint32>& OutIndices) const
+{
+	const uint32 High = static_cast<uint32>(Key) << 16;
+	OutIndices.Reserve(OutIndices.Num() + Cardinality);
+
+	if (IsBitmap())
+	{
+		for (int32 WordIt = 0; WordIt < BitmapNumWords; ++WordIt)
+		{
+			uint64 Word = Bits[WordIt];
+			while (Word)
+			{
+				const uint32 BitIt = static_cast<uint32>(FMath::CountTrailingZeros64(Word));
+				OutIndices.Add(High | (static_cast<uint32>(WordIt) << 6) | BitIt);
+				Word &= Word - 1;
+			}
+		}
+		return;
+	}
+
+	for (const uint16 Low : Values)
+	{
+		OutIndices.Add(High | Low);
+	}
+}
+
+int32 FEntityIndexBitmap::FindContainer(const uint16 Key) const
+{
+	return Algo::BinarySearchBy(Containers, Key, &FContainer::Key);
+}
+
+const FEntityIndexBitmap::FContainer* FEntityIndexBitmap::FindContainerPtr(const uint16 Key) const
+{
+	const int32 ContainerIndex = FindContainer(Key);
+	return ContainerIndex != INDEX_NONE ? &Containers[ContainerIndex] : nullptr;
+}
+
+bool FEntityIndexBitmap::Add(const uint32 Index)
+{
+	const uint16 Key = static_cast<uint16>(Index >> 16);
+	const uint16 Low = static_cast<uint16>(Index & 0xFFFF);
+
+	int32 ContainerIndex = Algo::LowerBoundBy(Containers, Key, &FContainer::Key);
+	if (ContainerIndex == Containers.Num() || Containers[ContainerIndex].Key != Key)
+	{
+		FContainer& NewContainer = Containers.InsertDefaulted_GetRef(ContainerIndex);
+		NewContainer.Key = Key;
+	}
+	FContainer& Container = Containers[ContainerIndex];
+
+	if (Container.IsBitmap())
+	{
+		uint64& Word = Container.Bits[Low >> 6];
+		const uint64 Mask = 1ULL << (Low & 63);
+		if (Word & Mask) return false;
+		Word |= Mask;
+	}
+	else
+	{
+		const int32 InsertAt = Algo::LowerBound(Container.Values, Low);
+		if (InsertAt < Container.Values.Num() && Container.Values[InsertAt] == Low) return false;
+		Container.Values.Insert(Low, InsertAt);
+
+		// Too many entries for an array, switch to a bitmap | 数组过大，转为位图
+		if (Container.Values.Num() > ArrayMaxCardinality)
+		{
+			Container.Bits.SetNumZeroed(BitmapNumWords);
+			for (const uint16 Value : Container.Values)
+			{
+				Container.Bits[Value >> 6] |= 1ULL << (Value & 63);
+			}
+			Container.Values.Empty();
+		}
+	}
+
+	++Container.Cardinality;
+	++Cardinality;
+	return true;
+}
+
+bool FEntityIndexBitmap::Remove(const uint32 Index)
+{
+	const uint16 Key = static_cast<uint16>(Index >> 16);
+	const uint16 Low = static_cast<uint16>(Index & 0xFFFF);
+
+	const int32 ContainerIndex = FindContainer(Key);
+	if (ContainerIndex == INDEX_NONE) return false;
+	FContainer& Container = Containers[ContainerIndex];
+
+	if (Container.IsBitmap())
+	{
+		uint64& Word = Container.Bits[Low >> 6];
+		const uint64 Mask = 1ULL << (Low & 63);
+		if (!(Word & Mask)) return false;
+		Word &= ~Mask;
+	}
+	else
+	{
+		const int32 Found = Algo::BinarySearch(Container.Values, Low);
+		if (Found == INDEX_NONE) return false;
+		Container.Values.RemoveAt(Found);
+	}
+
+	--Container.Cardinality;
+	--Cardinality;
+
+	if (Container.Cardinality == 0)
+	{
+		Containers.RemoveAt(ContainerIndex);
+	}
+	else if (Container.IsBitmap() && Container.Cardinality < ArrayMaxCardinality / 2)
+	{
+		// Hysteresis: only go back to an array well below the threshold | 远低于阈值时才转回数组
+		TArray<uint32> Remaining;
+		Container.AppendTo(Remaining);
+		Container.Values.Reset(Remaining.Num());
+		for (const uint32 Value : Remaining)
+		{
+			Container.Values.Add(static_cast<uint16>(Value & 0xFFFF));
+		}
+		Container.Bits.Empty();
+	}
+	return true;
+}
+
+bool FEntityIndexBitmap::Contains(const uint32 Index) const
+{
+	const FContainer* Container = FindContainerPtr(static_cast<uint16>(Index >> 16));
+	return Container && Container->Contains(static_cast<uint16>(Index & 0xFFFF));
+}
+
+void FEntityIndexBitmap::Reset()
+{
+	Containers.Reset();
+	Cardinality = 0;
+}
+
+SIZE_T FEntityIndexBitmap::GetAllocatedSize() const
+{
+	SIZE_T Size = Containers.GetAllocatedSize();
+	for (const FContainer& Container : Containers)
+	{
+		Size += Container.Values.GetAllocatedSize() + Container.Bits.GetAllocatedSize();
+	}
+	return Size;
+}
+
+void FEntityIndexBitmap::AppendTo(TArray<uint32>& OutIndices) const
+{
+	OutIndices.Reserve(OutIndices.Num() + Cardinality);
+	for (const FContainer& Container : Containers)
+	{
+		Container.AppendTo(OutIndices);
+	}
+}
+
+void FEntityIndexBitmap::Intersect(const TConstArrayView<const FEntityIndexBitmap*> Bitmaps, TArray<uint32>& OutIndices)
+{
+	if (Bitmaps.Num() == 0) return;
+
+	// Drive the walk from the rarest set | 从最小的集合开始遍历
+	const FEntityIndexBitmap* Smallest = Bitmaps[0];
+	for (const FEntityIndexBitmap* Bitmap : Bitmaps)
+	{
+		if (Bitmap->Num() < Smallest->Num()) Smallest = Bitmap;
+	}
+	if (Smallest->IsEmpty()) return;
+
+	TArray<const FContainer*, TInlineAllocator<8>> Others;
+	TArray<uint32> BucketIndices;
+	for (const FContainer& Container : Smallest->Containers)
+	{
+		// Skip the whole bucket if any other set lacks it | 任一集合缺少该桶则整桶跳过
+		Others.Reset();
+		bool bBucketPresent = true;
+		for (const FEntityIndexBitmap* Bitmap : Bitmaps)
+		{
+			if (Bitmap == Smallest) continue;
+			const FContainer* Other = Bitmap->FindContainerPtr(Container.Key);
+			if (!Other)
+			{
+				bBucketPresent = false;
+				break;
+			}
+			Others.Add(Other);
+		}
+		if (!bBucketPresent) continue;
+
+		BucketIndices.Reset();
+		Container.AppendTo(BucketIndices);
+		for (const uint32 Index : BucketIndices)
+		{
+			const uint16 Low = static_cast<uint16>(Index & 0xFFFF);
+			bool bInAll = true;
+			for (const FContainer* Other : Others)
+			{
+				if (!Other->Contains(Low))
+				{
+					bInAll = false;
+					break;
+				}
+			}
+			if (bInAll) OutIndices.Add(Index);
+		}
+	}
+}
+
+void FEntityIndexBitmap::Union(const TConstArrayView<const FEntityIndexBitmap*> Bitmaps, TArray<uint32>& OutIndices)
+{
+	const int32 FirstNew = OutIndices.Num();
+	for (const FEntityIndexBitmap* Bitmap : Bitmaps)
+	{
+		Bitmap->AppendTo(OutIndices);
+	}
+	if (Bitmaps.Num() <= 1) return;
+
+	// Sort and fold duplicates of the appended range | 排序并去重
+	TArrayView<uint32> Appended(OutIndices.GetData() + FirstNew, OutIndices.Num() - FirstNew);
+	Algo::Sort(Appended);
+	int32 WriteIt = FirstNew;
+	for (int32 ReadIt = FirstNew; ReadIt < OutIndices.Num(); ++ReadIt)
+	{
+		if (WriteIt == FirstNew || OutIndices[WriteIt - 1] != OutIndices[ReadIt])
+		{
+			OutIndices[WriteIt++] = OutIndices[ReadIt];
+		}
+	}
+	OutIndices.SetNum(WriteIt);
+}
+
+//================ FEntityFlagIndex																				========
+
+// Calls Func(Bit) for every set bit of the two 64-bit words | 遍历两个字中的置位
+template<typename FuncType>
+static FORCEINLINE void ForEachFlagBit(const int64 Low, const int64 High, FuncType&& Func)
+{
+	uint64 Word = static_cast<uint64>(Low);
+	while (Word)
+	{
+		Func(static_cast<int32>(FMath::CountTrailingZeros64(Word)));
+		Word &= Word - 1;
+	}
+	Word = static_cast<uint64>(High);
+	while (Word)
+	{
+		Func(64 + static_cast<int32>(FMath::CountTrailingZeros64(Word)));
+		Word &= Word - 1;
+	}
+}
+
+void FEntityFlagIndex::Apply(const uint32 EntityIndex, const int64 SetLow, const int64 SetHigh, const int64 ClearLow, const int64 ClearHigh)
+{
+	ForEachFlagBit(ClearLow & ~SetLow, ClearHigh & ~SetHigh, [this, EntityIndex](const int32 Bit) { Bitmaps[Bit].Remove(EntityIndex); });
+	ForEachFlagBit(SetLow, SetHigh, [this, EntityIndex](const int32 Bit) { Bitmaps[Bit].Add(EntityIndex); });
+}
+
+void FEntityFlagIndex::Reset()
+{
+	for (FEntityIndexBitmap& Bitmap : Bitmaps)
+	{
+		Bitmap.Reset();
+	}
+}
+
+int32 FEntityFlagIndex::EstimateCandidates(const FEntityFlagQueryMask& Mask) const
+{
+	if ((Mask.AllLow | Mask.AllHigh) != 0)
+	{
+		int32 Smallest = MAX_int32;
+		ForEachFlagBit(Mask.AllLow, Mask.AllHigh, [this, &Smallest](const int32 Bit) { Smallest = FMath::Min(Smallest, Bitmaps[Bit].Num()); });
+		return Smallest;
+	}
+	if ((Mask.AnyLow | Mask.AnyHigh) != 0)
+	{
+		int32 Sum = 0;
+		ForEachFlagBit(Mask.AnyLow, Mask.AnyHigh, [this, &Sum](const int32 Bit) { Sum += Bitmaps[Bit].Num(); });
+		return Sum;
+	}
+	return INDEX_NONE;
+}
+
+bool FEntityFlagIndex::CollectCandidates(const FEntityFlagQueryMask& Mask, TArray<uint32>& OutIndices) const
+{
+	TArray<const FEntityIndexBitmap*, TInlineAllocator<8>> Selected;
+	const bool bUseAll = (Mask.AllLow | Mask.AllHigh) != 0;
+	if (bUseAll)
+	{
+		ForEachFlagBit(Mask.AllLow, Mask.AllHigh, [this, &Selected](const int32 Bit) { Selected.Add(&Bitmaps[Bit]); });
+		FEntityIndexBitmap::Intersect(Selected, OutIndices);
+		return true;
+	}
+	if ((Mask.AnyLow | Mask.AnyHigh) != 0)
+	{
+		ForEachFlagBit(Mask.AnyLow, Mask.AnyHigh, [this, &Selected](const int32 Bit) { Selected.Add(&Bitmaps[Bit]); });
+		FEntityIndexBitmap::Union(Selected, OutIndices);
+		return true;
+	}
+	return false;
+}
+
+SIZE_T FEntityFlagIndex::GetAllocatedSize() const
+{
+	SIZE_T Size = 0;
+	for (const FEntityIndexBitmap& Bitmap : Bitmaps)
+	{
+		Size += Bitmap.GetAllocatedSize();
+	}
+	return Size;
+}
+
+//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
@@ -4,18 +4,248 @@
 */
 
 #include "MassAPIFlagSettings.h"
+#include "MassAPIStructs.h"
+#include "MassAPI.h"
+#include <atomic>
 
 //——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
 
+namespace MassAPIFlagTable
+{
+	/** One open-addressed slot; Bit == INDEX_NONE marks an empty slot | 开放寻址槽位 */
+	struct FSlot
+	{
+		FName Name;
+		int32 Bit = INDEX_NONE;
+	};
+
+	/** Everything resolved from the settings, never modified once published | 由设置解析出的全部内容，发布后不再修改 */
+	struct FTable
+	{
+		// Power-of-two sized, at most half full, probed linearly | 容量为 2 的幂，负载不超过一半，线性探测
+		TArray<FSlot> Slots;
+		uint32 SlotMask = 0;
+
+		int32 RegistryVersion = 0;
+
+		// Mirror tag per flag bit 0-127, nullptr when the flag is not tag-backed | 每个旗标位的镜像标签
+		const UScriptStruct* MirrorTags[128] = {};
+		int64 TagBackedLow = 0;
+		int64 TagBackedHigh = 0;
+
+		FORCEINLINE int32 Find(const FName Name) const
+		{
+			if (Slots.Num() == 0 || Name.IsNone()) return INDEX_NONE;
+
+			uint32 SlotIndex = GetTypeHash(Name) & SlotMask;
+			while (Slots[SlotIndex].Bit != INDEX_NONE)
+			{
+				if (Slots[SlotIndex].Name == Name) return Slots[SlotIndex].Bit;
+				SlotIndex = (SlotIndex + 1) & SlotMask;
+			}
+			return INDEX_NONE;
+		}
+
+		void Insert(const FName Name, const int32 Bit)
+		{
+			uint32 SlotIndex = GetTypeHash(Name) & SlotMask;
+			while (Slots[SlotIndex].Bit != INDEX_NONE)
+			{
+				if (Slots[SlotIndex].Name == Name) return; // First registration wins | 先注册者优先
+				SlotIndex = (SlotIndex + 1) & SlotMask;
+			}
+			Slots[SlotIndex].Name = Name;
+			Slots[SlotIndex].Bit = Bit;
+		}
+	};
+
+	// Published table, swapped whole by RebuildFlagTable | 当前发布的表，由 RebuildFlagTable 整体替换
+	static std::atomic<const FTable*> Current { nullptr };
+
+	// Replaced tables stay alive: a worker thread may still be reading one, and rebuilds are rare (config load, edits)
+	// | 被替换的表保留：工作线程可能仍在读取，且重建很少发生
+	static TArray<TUniquePtr<const FTable>> Retired;
+	static FCriticalSection RetiredLock;
+
+	static void Publish(const FTable* Table)
+	{
+		const FTable* Previous = Current.exchange(Table, std::memory_order_acq_rel);
+		if (Previous)
+		{
+			FScopeLock Lock(&RetiredLock);
+			Retired.Emplace(Previous);
+		}
+	}
+
+	static FORCEINLINE const FTable& Get()
+	{
+		const FTable* Table = Current.load(std::memory_order_acquire);
+		if (!Table)
+		{
+			// Only reached before the CDO finished loading | 仅在 CDO 加载完成前进入
+			GetDefault<UMassAPIFlagSettings>()->RebuildFlagTable();
+			Table = Current.load(std::memory_order_acquire);
+		}
+		return *Table;
+	}
+
+	static const UScriptStruct* GetMirrorTagForSlot(const int32 Slot)
+	{
+		switch (Slot)
+		{
+		case 0:		return FEntityFlagMirrorTag0::StaticStruct();
+		case 1:		return FEntityFlagMirrorTag1::StaticStruct();
+		case 2:		return FEntityFlagMirrorTag2::StaticStruct();
+		case 3:		return FEntityFlagMirrorTag3::StaticStruct();
+		case 4:		return FEntityFlagMirrorTag4::StaticStruct();
+		case 5:		return FEntityFlagMirrorTag5::StaticStruct();
+		case 6:		return FEntityFlagMirrorTag6::StaticStruct();
+		case 7:		return FEntityFlagMirrorTag7::StaticStruct();
+		case 8:		return FEntityFlagMirrorTag8::StaticStruct();
+		case 9:		return FEntityFlagMirrorTag9::StaticStruct();
+		case 10:	return FEntityFlagMirrorTag10::StaticStruct();
+		case 11:	return FEntityFlagMirrorTag11::StaticStruct();
+		case 12:	return FEntityFlagMirrorTag12::StaticStruct();
+		case 13:	return FEntityFlagMirrorTag13::StaticStruct();
+		case 14:	return FEntityFlagMirrorTag14::StaticStruct();
+		case 15:	return FEntityFlagMirrorTag15::StaticStruct();
+		default:	return nullptr;
+		}
+	}
+}
+
 EEntityFlags UMassAPIFlagSettings::ResolveFlag(FName FlagName)
 {
-	const UMassAPIFlagSettings* Settings = GetDefault<UMassAPIFlagSettings>();
-	if (!Settings)
+	const int32 Bit = MassAPIFlagTable::Get().Find(FlagName);
+	return (Bit >= 0 && Bit < 128) ? static_cast<EEntityFlags>(Bit) : EEntityFlags::EEntityFlags_MAX;
+}
+
+int32 UMassAPIFlagSettings::ResolveFlagBit(FName FlagName)
+{
+	return MassAPIFlagTable::Get().Find(FlagName);
+}
+
+int32 UMassAPIFlagSettings::GetRegistryVersion()
+{
+	return MassAPIFlagTable::Get().RegistryVersion;
+}
+
+int32 UMassAPIFlagSettings::GetFlagBitCount()
+{
+	// One width for the whole build: the flag block type and the runtime templates both follow MASSAPI_FLAG_BITS | 全局唯一宽度
+	return MASSAPI_FLAG_BITS;
+}
+
+const UScriptStruct* UMassAPIFlagSettings::GetFlagMirrorTag(const int32 Bit)
+{
+	return (Bit >= 0 && Bit < 128) ? MassAPIFlagTable::Get().MirrorTags[Bit] : nullptr;
+}
+
+void UMassAPIFlagSettings::GetTagBackedMask(int64& OutLow, int64& OutHigh)
+{
+	const MassAPIFlagTable::FTable& Table = MassAPIFlagTable::Get();
+	OutLow = Table.TagBackedLow;
+	OutHigh = Table.TagBackedHigh;
+}
+
+void UMassAPIFlagSettings::RebuildFlagTable() const
+{
+	const int32 FlagBitCount = GetFlagBitCount();
+	TUniquePtr<MassAPIFlagTable::FTable> Table = MakeUnique<MassAPIFlagTable::FTable>();
+
+	// Gather valid entries, FlagRegistry first so its names take precedence | 收集有效条目，FlagRegistry 优先
+	TArray<TPair<FName, int32>> Entries;
+	Entries.Reserve(FlagRegistry.Num() + ExtendedFlagRegistry.Num());
+	for (const TPair<FName, EEntityFlags>& Pair : FlagRegistry)
+	{
+		if (!Pair.Key.IsNone() && Pair.Value < EEntityFlags::EEntityFlags_MAX)
+		{
+			Entries.Emplace(Pair.Key, static_cast<int32>(Pair.Value));
+		}
+	}
+	for (const TPair<FName, int32>& Pair : ExtendedFlagRegistry)
+	{
+		if (!Pair.Key.IsNone() && Pair.Value >= 0 && Pair.Value < FlagBitCount && !FlagRegistry.Contains(Pair.Key))
+		{
+			Entries.Emplace(Pair.Key, Pair.Value);
+		}
+	}
+
+	const int32 NumSlots = FMath::RoundUpToPowerOfTwo(FMath::Max(16, Entries.Num() * 2));
+	Table->Slots.SetNum(NumSlots);
+	Table->SlotMask = static_cast<uint32>(NumSlots - 1);
+
+	// The version hashes the name strings, not FName indices, so it is identical across sessions and
+	// a bit index baked into a Blueprint stays valid until the registry content changes.
+	// | 版本按名称字符串计算（而非 FName 索引），跨会话一致
+	uint32 Version = static_cast<uint32>(FlagBitCount);
+	for (const TPair<FName, int32>& Entry : Entries)
+	{
+		Table->Insert(Entry.Key, Entry.Value);
+
+		// Order-independent combine, TMap iteration order is not stable | 与顺序无关的组合
+		const FString LowerName = Entry.Key.ToString().ToLower();
+		Version += HashCombine(FCrc::StrCrc32(*LowerName), static_cast<uint32>(Entry.Value));
+	}
+
+	// Zero is reserved for "never resolved" | 0 保留为“未解析”
+	Table->RegistryVersion = static_cast<int32>(Version == 0 ? 1 : Version);
+
+	// Tag-backed flags take mirror tags in list order | 标签镜像旗标按列表顺序分配镜像标签
+	int32 NumMirrored = 0;
+	for (const EEntityFlags Flag : TagBackedFlags)
+	{
+		const int32 Bit = static_cast<int32>(Flag);
+		if (Flag >= EEntityFlags::EEntityFlags_MAX || Table->MirrorTags[Bit]) continue;
+		if (NumMirrored == NumFlagMirrorTags)
+		{
+			UE_LOG(LogMassAPI, Warning, TEXT("Only %d flags can be tag-backed, the rest of TagBackedFlags is ignored."), NumFlagMirrorTags);
+			break;
+		}
+		Table->MirrorTags[Bit] = MassAPIFlagTable::GetMirrorTagForSlot(NumMirrored++);
+		(Bit < 64 ? Table->TagBackedLow : Table->TagBackedHigh) |= (1LL << (Bit & 63));
+	}
+
+	MassAPIFlagTable::Publish(Table.Release());
+}
+
+void UMassAPIFlagSettings::PostInitProperties()
+{
+	Super::PostInitProperties();
+	if (HasAnyFlags(RF_ClassDefaultObject))
+	{
+		RebuildFlagTable();
+	}
+}
+
+void UMassAPIFlagSettings::PostReloadConfig(FProperty* PropertyThatWasLoaded)
+{
+	Super::PostReloadConfig(PropertyThatWasLoaded);
+	if (HasAnyFlags(RF_ClassDefaultObject))
+	{
+		RebuildFlagTable();
+	}
+}
+
+#if WITH_EDITOR
+void UMassAPIFlagSettings::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	if (HasAnyFlags(RF_ClassDefaultObject))
+	{
+		RebuildFlagTable();
+	}
+}
+#endif
+
+const UScriptStruct* UMassAPIFlagSettings::GetFlagExtFragmentType()
+{
+	switch (GetFlagBitCount())
 	{
-		return EEntityFlags::EEntityFlags_MAX;
+	case 512:	return FEntityFlagExt512Fragment::StaticStruct();
+	case 256:	return FEntityFlagExt256Fragment::StaticStruct();
+	default:	return nullptr;
 	}
-	const EEntityFlags* Found = Settings->FlagRegistry.Find(FlagName);
-	return Found ? *Found : EEntityFlags::EEntityFlags_MAX;
 }
 
 //——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
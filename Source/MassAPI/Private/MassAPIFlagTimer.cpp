@@ -0,0 +1,122 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#include "MassAPIFlagTimer.h"
+
+//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
+
+//================ FEntityFlagTimingWheel																			========
+
+// Ticks covered by levels 0..Level | 0 至 Level 层覆盖的刻数
+static FORCEINLINE uint64 LevelSpan(const int32 Level)
+{
+	return 1ULL << (FEntityFlagTimingWheel::SlotBits * (Level + 1));
+}
+
+void FEntityFlagTimingWheel::Schedule(const FEntityFlagTimer& Timer)
+{
+	FEntityFlagTimer Scheduled = Timer;
+
+	// The current tick's slot is already drained | 当前刻的槽已清空，最早排到下一刻
+	Scheduled.DueTick = FMath::Max(Scheduled.DueTick, CurrentTick + 1);
+	Place(Scheduled);
+	++NumTimers;
+}
+
+void FEntityFlagTimingWheel::Place(const FEntityFlagTimer& Timer)
+{
+	const uint64 Delta = Timer.DueTick > CurrentTick ? Timer.DueTick - CurrentTick : 0;
+
+	int32 Level = 0;
+	while (Level < NumLevels - 1 && Delta >= LevelSpan(Level))
+	{
+		++Level;
+	}
+
+	// Beyond the top span: park in the farthest top slot, re-placed when it comes round | 超出顶层范围时暂存于最远的顶层槽
+	const uint64 SlotTick = Delta < LevelSpan(NumLevels - 1) ? Timer.DueTick : CurrentTick + LevelSpan(NumLevels - 1) - 1;
+	const int32 Slot = static_cast<int32>((SlotTick >> (SlotBits * Level)) & (NumSlots - 1));
+	Slots[Level][Slot].Add(Timer);
+}
+
+void FEntityFlagTimingWheel::Advance(const uint64 TargetTick, TArray<FEntityFlagTimer>& OutDue)
+{
+	TArray<FEntityFlagTimer> Moved;
+	while (CurrentTick < TargetTick)
+	{
+		// Nothing pending: jump straight to the target | 无计时器时直接跳到目标刻
+		if (NumTimers == 0)
+		{
+			CurrentTick = TargetTick;
+			return;
+		}
+
+		++CurrentTick;
+
+		// Redistribute the higher-level slots whose period starts at this tick, highest first | 从高到低下放到期的高层槽
+		int32 TopLevel = 0;
+		while (TopLevel < NumLevels - 1 && (CurrentTick & (LevelSpan(TopLevel) - 1)) == 0)
+		{
+			++TopLevel;
+		}
+		for (int32 Level = TopLevel; Level >= 1; --Level)
+		{
+			TArray<FEntityFlagTimer>& Slot = Slots[Level][(CurrentTick >> (SlotBits * Level)) & (NumSlots - 1)];
+			if (Slot.Num() == 0) continue;
+
+			Moved = MoveTemp(Slot);
+			for (const FEntityFlagTimer& Timer : Moved)
+			{
+				Place(Timer);
+			}
+			Moved.Reset();
+		}
+
+		TArray<FEntityFlagTimer>& DueSlot = Slots[0][CurrentTick & (NumSlots - 1)];
+		if (DueSlot.Num() == 0) continue;
+
+		Moved = MoveTemp(DueSlot);
+		for (const FEntityFlagTimer& Timer : Moved)
+		{
+			if (Timer.DueTick <= CurrentTick)
+			{
+				OutDue.Add(Timer);
+				--NumTimers;
+			}
+			else
+			{
+				Place(Timer);
+			}
+		}
+		Moved.Reset();
+	}
+}
+
+void FEntityFlagTimingWheel::AdvanceSeconds(const double DeltaSeconds, TArray<FEntityFlagTimer>& OutDue)
+{
+	PendingSeconds += FMath::Max(0.0, DeltaSeconds);
+	const int64 NumTicks = FMath::FloorToInt64(PendingSeconds / TickSeconds);
+	if (NumTicks <= 0) return;
+
+	PendingSeconds -= static_cast<double>(NumTicks) * TickSeconds;
+	Advance(CurrentTick + static_cast<uint64>(NumTicks), OutDue);
+}
+
+void FEntityFlagTimingWheel::Reset()
+{
+	for (int32 Level = 0; Level < NumLevels; ++Level)
+	{
+		for (TArray<FEntityFlagTimer>& Slot : Slots[Level])
+		{
+			Slot.Reset();
+		}
+	}
+	CurrentTick = 0;
+	PendingSeconds = 0.0;
+	NumTimers = 0;
+}
+
+//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
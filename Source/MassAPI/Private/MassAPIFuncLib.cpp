@@ -159,18 +159,14 @@ FEntityHandle UMassAPIFuncLib::BuildEntityFromTemplateData(const UObject* WorldC
 		const FMassEntityHandle ReservedEntity = Manager->ReserveEntity();
 
 		// 2. Capture data for the command
-		// Note: We copy the template descriptors to capture them by value for the lambda
-		Data->Sort(); // Ensure sorted before capturing
-		const FMassArchetypeCompositionDescriptor Composition = Data->GetCompositionDescriptor();
-		const FMassArchetypeCreationParams CreationParams = Data->GetArchetypeCreationParams();
+		// Note: The archetype comes from the template's cache, only values are copied for the lambda
+		const FMassArchetypeHandle ArchetypeHandle = TemplateData.GetArchetype(*Manager);
 		const FMassArchetypeSharedFragmentValues SharedValues = Data->GetSharedFragmentValues();
 		const TArray<FInstancedStruct> InitialFragments(Data->GetInitialFragmentValues());
 
 		// 3. Push deferred creation command with callback
-		MassAPI->Defer().PushCommand<FMassDeferredCreateCommand>([ReservedEntity, Composition, CreationParams, SharedValues, InitialFragments, OnFinished](FMassEntityManager& Manager)
+		MassAPI->Defer().PushCommand<FMassDeferredCreateCommand>([ReservedEntity, ArchetypeHandle, SharedValues, InitialFragments, OnFinished](FMassEntityManager& Manager)
 			{
-				// Get or create archetype
-				const FMassArchetypeHandle ArchetypeHandle = Manager.CreateArchetype(Composition, CreationParams);
 				if (!ArchetypeHandle.IsValid())
 				{
 					Manager.ReleaseReservedEntity(ReservedEntity);
@@ -195,7 +191,7 @@ FEntityHandle UMassAPIFuncLib::BuildEntityFromTemplateData(const UObject* WorldC
 	else
 	{
 		// Immediate build
-		FMassEntityHandle MassHandle = MassAPI->BuildEntity(*Data);
+		FMassEntityHandle MassHandle = MassAPI->BuildEntity(TemplateData);
 		OnFinished.ExecuteIfBound(MassHandle);
 		return FEntityHandle(MassHandle);
 	}
@@ -230,16 +226,13 @@ TArray<FEntityHandle> UMassAPIFuncLib::BuildEntitiesFromTemplateData(const UObje
 		}
 
 		// 2. Capture data
-		Data->Sort();
-		const FMassArchetypeCompositionDescriptor Composition = Data->GetCompositionDescriptor();
-		const FMassArchetypeCreationParams CreationParams = Data->GetArchetypeCreationParams();
+		const FMassArchetypeHandle ArchetypeHandle = TemplateData.GetArchetype(*Manager);
 		const FMassArchetypeSharedFragmentValues SharedValues = Data->GetSharedFragmentValues();
 		const TArray<FInstancedStruct> InitialFragments(Data->GetInitialFragmentValues());
 
 		// 3. Push deferred command with callback loop
-		MassAPI->Defer().PushCommand<FMassDeferredCreateCommand>([ReservedEntities, Composition, CreationParams, SharedValues, InitialFragments, OnFinished](FMassEntityManager& Manager)
+		MassAPI->Defer().PushCommand<FMassDeferredCreateCommand>([ReservedEntities, ArchetypeHandle, SharedValues, InitialFragments, OnFinished](FMassEntityManager& Manager)
 			{
-				const FMassArchetypeHandle ArchetypeHandle = Manager.CreateArchetype(Composition, CreationParams);
 				if (!ArchetypeHandle.IsValid())
 				{
 					for (const FMassEntityHandle& Entity : ReservedEntities)
@@ -271,7 +264,7 @@ TArray<FEntityHandle> UMassAPIFuncLib::BuildEntitiesFromTemplateData(const UObje
 	else
 	{
 		// Immediate batch build
-		TArray<FMassEntityHandle> MassHandles = MassAPI->BuildEntities(Quantity, *Data);
+		TArray<FMassEntityHandle> MassHandles = MassAPI->BuildEntities(Quantity, TemplateData);
 
 		BPHandles.Reserve(MassHandles.Num());
 		for (const FMassEntityHandle& MassHandle : MassHandles)
@@ -317,81 +310,95 @@ TArray<FEntityHandle> UMassAPIFuncLib::BuildEntitiesFromTemplateDataArray(const
 			BPHandles.Add(FEntityHandle(Handle));
 		}
 
-		// Capture per-template data for the deferred command
+		// Bucket by archetype and shared values now; the command then creates each bucket in one call | 现在分批，命令中每批一次创建
+		TArray<FEntityTemplateBatch> Batches;
+		MassAPI->GroupTemplatesForBuild(TemplateDatas, Batches);
+
+		struct FValueGroupCapture
+		{
+			TArray<FMassEntityHandle> Entities;
+			TArray<FInstancedStruct> InitialFragments;
+		};
 		struct FTemplateCapture
 		{
-			FMassArchetypeCompositionDescriptor Composition;
-			FMassArchetypeCreationParams CreationParams;
+			FMassArchetypeHandle ArchetypeHandle;
 			FMassArchetypeSharedFragmentValues SharedValues;
-			TArray<FInstancedStruct> InitialFragments;
+			TArray<FMassEntityHandle> Entities;
+			TArray<FValueGroupCapture> ValueGroups;
 		};
 
 		TArray<FTemplateCapture> Captures;
-		Captures.Reserve(TemplateDatas.Num());
+		Captures.Reserve(Batches.Num());
+		TBitArray<> Built(false, ReservedEntities.Num());
 
-		for (const FEntityTemplateData& TemplateData : TemplateDatas)
+		for (const FEntityTemplateBatch& Batch : Batches)
 		{
-			FMassEntityTemplateData* Data = TemplateData.Get();
-			if (Data)
+			FTemplateCapture& Capture = Captures.AddDefaulted_GetRef();
+			Capture.ArchetypeHandle = Batch.ArchetypeHandle;
+			Capture.SharedValues = Batch.SharedSource->GetSharedFragmentValues();
+			Capture.Entities.Reserve(Batch.Indices.Num());
+			for (const int32 Index : Batch.Indices)
 			{
-				Data->Sort();
-				FTemplateCapture& Capture = Captures.AddDefaulted_GetRef();
-				Capture.Composition = Data->GetCompositionDescriptor();
-				Capture.CreationParams = Data->GetArchetypeCreationParams();
-				Capture.SharedValues = Data->GetSharedFragmentValues();
-				Capture.InitialFragments = Data->GetInitialFragmentValues();
+				Capture.Entities.Add(ReservedEntities[Index]);
+				Built[Index] = true;
 			}
-			else
+
+			for (const FEntityTemplateBatch::FValueGroup& Group : Batch.ValueGroups)
 			{
-				Captures.AddDefaulted();
+				if (Group.Source->GetInitialFragmentValues().Num() == 0) continue;
+
+				FValueGroupCapture& GroupCapture = Capture.ValueGroups.AddDefaulted_GetRef();
+				GroupCapture.InitialFragments = Group.Source->GetInitialFragmentValues();
+				GroupCapture.Entities.Reserve(Group.Positions.Num());
+				for (const int32 Position : Group.Positions)
+				{
+					GroupCapture.Entities.Add(Capture.Entities[Position]);
+				}
 			}
 		}
 
-		MassAPI->Defer().PushCommand<FMassDeferredCreateCommand>([ReservedEntities, Captures, OnFinished](FMassEntityManager& Manager)
+		MassAPI->Defer().PushCommand<FMassDeferredCreateCommand>([ReservedEntities, Captures = MoveTemp(Captures), Built = MoveTemp(Built), OnFinished](FMassEntityManager& Manager)
 			{
-				for (int32 i = 0; i < ReservedEntities.Num(); ++i)
+				TArray<FMassArchetypeEntityCollection> EntityCollections;
+				for (const FTemplateCapture& Capture : Captures)
 				{
-					const FMassEntityHandle& Entity = ReservedEntities[i];
-					const FTemplateCapture& Capture = Captures[i];
+					TSharedRef<FMassEntityManager::FEntityCreationContext> CreationContext =
+						Manager.BatchCreateReservedEntities(Capture.ArchetypeHandle, Capture.SharedValues, Capture.Entities);
 
-					if (Capture.Composition.IsEmpty())
+					for (const FValueGroupCapture& Group : Capture.ValueGroups)
 					{
-						Manager.ReleaseReservedEntity(Entity);
-						continue;
+						EntityCollections.Reset();
+						UE::Mass::Utils::CreateEntityCollections(Manager, Group.Entities, FMassArchetypeEntityCollection::NoDuplicates, EntityCollections);
+						Manager.BatchSetEntityFragmentValues(EntityCollections, Group.InitialFragments);
 					}
+				}
 
-					const FMassArchetypeHandle ArchetypeHandle = Manager.CreateArchetype(Capture.Composition, Capture.CreationParams);
-					if (!ArchetypeHandle.IsValid())
+				// Entities of empty templates are released; callbacks follow the input order | 空模板的实体被释放，回调按输入顺序
+				for (int32 i = 0; i < ReservedEntities.Num(); ++i)
+				{
+					if (!Built[i])
 					{
-						Manager.ReleaseReservedEntity(Entity);
+						Manager.ReleaseReservedEntity(ReservedEntities[i]);
 						continue;
 					}
-
-					Manager.BuildEntity(Entity, ArchetypeHandle, Capture.SharedValues);
-
-					if (Capture.InitialFragments.Num() > 0)
-					{
-						Manager.SetEntityFragmentValues(Entity, Capture.InitialFragments);
-					}
-
-					OnFinished.ExecuteIfBound(Entity);
+					OnFinished.ExecuteIfBound(ReservedEntities[i]);
 				}
 			});
 	}
 	else
 	{
-		for (const FEntityTemplateData& TemplateData : TemplateDatas)
+		// Batched per archetype and shared values, handles returned in input order | 按原型与共享值分批创建，句柄保持输入顺序
+		const TArray<FMassEntityHandle> MassHandles = MassAPI->BuildEntitiesFromTemplates(TemplateDatas);
+		for (const FMassEntityHandle& MassHandle : MassHandles)
 		{
-			FMassEntityTemplateData* Data = TemplateData.Get();
-			if (Data)
-			{
-				FMassEntityHandle MassHandle = MassAPI->BuildEntity(*Data);
-				BPHandles.Add(FEntityHandle(MassHandle));
-				OnFinished.ExecuteIfBound(MassHandle);
-			}
-			else
+			BPHandles.Add(FEntityHandle(MassHandle));
+		}
+
+		if (OnFinished.IsBound())
+		{
+			for (const FMassEntityHandle& MassHandle : MassHandles)
 			{
-				BPHandles.Add(FEntityHandle());
+				if (MassHandle.IsSet()) OnFinished.Execute(MassHandle);
 			}
 		}
 	}
@@ -399,6 +406,64 @@ TArray<FEntityHandle> UMassAPIFuncLib::BuildEntitiesFromTemplateDataArray(const
 	return BPHandles;
 }
 
+TArray<FEntityHandle> UMassAPIFuncLib::BuildEntitiesFromTemplateDataWithValues(const UObject* WorldContextObject, UPARAM(ref) const FEntityTemplateData& TemplateData, const TArray<int32>& Values)
+{
+	checkNoEntry();
+	return TArray<FEntityHandle>();
+}
+
+TArray<FEntityHandle> UMassAPIFuncLib::Generic_BuildEntitiesFromTemplateDataWithValues(const UObject* WorldContextObject, const FEntityTemplateData& TemplateData, const FEntityBuildColumn& Column)
+{
+	TArray<FEntityHandle> BPHandles;
+	if (Column.Num <= 0) return BPHandles;
+
+	UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject);
+	if (!MassAPI) return BPHandles;
+
+	const TArray<FMassEntityHandle> MassHandles = MassAPI->BuildEntitiesWithColumns(Column.Num, TemplateData, MakeArrayView(&Column, 1));
+
+	BPHandles.Reserve(MassHandles.Num());
+	for (const FMassEntityHandle& MassHandle : MassHandles)
+	{
+		BPHandles.Add(FEntityHandle(MassHandle));
+	}
+	return BPHandles;
+}
+
+DEFINE_FUNCTION(UMassAPIFuncLib::execBuildEntitiesFromTemplateDataWithValues)
+{
+	P_GET_OBJECT(UObject, WorldContextObject);
+	P_GET_STRUCT_REF(FEntityTemplateData, TemplateData);
+
+	// Wildcard array: read the property to learn the element struct and stride | 通配数组：由属性得到元素结构与步长
+	Stack.MostRecentProperty = nullptr;
+	Stack.StepCompiledIn<FArrayProperty>(nullptr);
+	const void* ValuesAddr = Stack.MostRecentPropertyAddress;
+	const FArrayProperty* ValuesProperty = CastField<FArrayProperty>(Stack.MostRecentProperty);
+	P_FINISH;
+
+	if (!ValuesProperty)
+	{
+		Stack.bArrayContextFailed = true;
+		return;
+	}
+
+	P_NATIVE_BEGIN
+		TArray<FEntityHandle> Result;
+		if (const FStructProperty* InnerProperty = CastField<FStructProperty>(ValuesProperty->Inner))
+		{
+			FScriptArrayHelper ValuesHelper(ValuesProperty, ValuesAddr);
+			const FEntityBuildColumn Column(InnerProperty->Struct, ValuesHelper.GetRawPtr(0), ValuesProperty->Inner->ElementSize, ValuesHelper.Num());
+			Result = Generic_BuildEntitiesFromTemplateDataWithValues(WorldContextObject, TemplateData, Column);
+		}
+		else
+		{
+			UE_LOG(LogMassBlueprintAPI, Warning, TEXT("BuildEntitiesFromTemplateDataWithValues: Values must be an array of fragment structs."));
+		}
+		*(TArray<FEntityHandle>*)RESULT_PARAM = MoveTemp(Result);
+	P_NATIVE_END
+}
+
 //================ Entity Querying & BP Processors																========
 
 bool UMassAPIFuncLib::MatchEntityQuery(const UObject* WorldContextObject, const FEntityHandle& EntityHandle, UPARAM(ref) const FEntityQuery& Query)
@@ -410,7 +475,9 @@ bool UMassAPIFuncLib::MatchEntityQuery(const UObject* WorldContextObject, const
 	return false;
 }
 
-void UMassAPIFuncLib::MatchEntitiesQuery(const UObject* WorldContextObject, const TArray<FEntityHandle>& EntityHandles, UPARAM(ref) const FEntityQuery& Query, TArray<FEntityHandle>& MatchingHandles, TArray<FEntityHandle>& UnmatchingHandles)
+// Shared by the FEntityQuery and FCompiledEntityQuery variants | 两种查询类型共用
+template<typename TQuery>
+static void SplitEntitiesByQuery(const UObject* WorldContextObject, const TArray<FEntityHandle>& EntityHandles, const TQuery& Query, TArray<FEntityHandle>& MatchingHandles, TArray<FEntityHandle>& UnmatchingHandles)
 {
 	MatchingHandles.Reset();
 	UnmatchingHandles.Reset();
@@ -422,22 +489,31 @@ void UMassAPIFuncLib::MatchEntitiesQuery(const UObject* WorldContextObject, cons
 		return;
 	}
 
+	// One composition check per archetype instead of per handle | 每个原型只做一次 Composition 检查
+	TBitArray<> Matches;
+	MassAPI->MatchQueryBatch(EntityHandles, Query, Matches);
+
 	MatchingHandles.Reserve(EntityHandles.Num());
 	UnmatchingHandles.Reserve(EntityHandles.Num());
 
-	for (const FEntityHandle& Handle : EntityHandles)
+	for (int32 EntityIt = 0; EntityIt < EntityHandles.Num(); ++EntityIt)
 	{
-		if (MassAPI->MatchQuery(Handle, Query))
+		if (Matches[EntityIt])
 		{
-			MatchingHandles.Add(Handle);
+			MatchingHandles.Add(EntityHandles[EntityIt]);
 		}
 		else
 		{
-			UnmatchingHandles.Add(Handle);
+			UnmatchingHandles.Add(EntityHandles[EntityIt]);
 		}
 	}
 }
 
+void UMassAPIFuncLib::MatchEntitiesQuery(const UObject* WorldContextObject, const TArray<FEntityHandle>& EntityHandles, UPARAM(ref) const FEntityQuery& Query, TArray<FEntityHandle>& MatchingHandles, TArray<FEntityHandle>& UnmatchingHandles)
+{
+	SplitEntitiesByQuery(WorldContextObject, EntityHandles, Query, MatchingHandles, UnmatchingHandles);
+}
+
 int32 UMassAPIFuncLib::GetNumMatchingEntities(const UObject* WorldContextObject, UPARAM(ref) const FEntityQuery& Query)
 {
 	UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject);
@@ -446,123 +522,224 @@ int32 UMassAPIFuncLib::GetNumMatchingEntities(const UObject* WorldContextObject,
 	FMassEntityManager* EntityManager = MassAPI->GetEntityManager();
 	if (!EntityManager) return 0;
 
-	// 1. Create a bound Native Query (Registers with Manager immediately)
-	FMassEntityQuery NativeQuery = Query.GetNativeQuery(EntityManager->AsShared());
+	// Count-only: composition via the cached Native Query, flags popcounted chunk-wise (no handle array)
+	return MassAPI->CountMatchingEntities(Query);
+}
 
-	// 2. Flags Logic (Low 0-63)
-	const int64 AllFlagsQueryLow = Query.GetAllFlagsBitmask();
-	const int64 AnyFlagsQueryLow = Query.GetAnyFlagsBitmask();
-	const int64 NoneFlagsQueryLow = Query.GetNoneFlagsBitmask();
+bool UMassAPIFuncLib::AnyMatchingEntities(const UObject* WorldContextObject, UPARAM(ref) const FEntityQuery& Query)
+{
+	UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject);
+	if (!MassAPI || !MassAPI->GetEntityManager()) return false;
 
-	// 2b. Flags Logic (High 64-127)
-	const int64 AllFlagsQueryHigh = Query.GetAllFlagsBitmaskHigh();
-	const int64 AnyFlagsQueryHigh = Query.GetAnyFlagsBitmaskHigh();
-	const int64 NoneFlagsQueryHigh = Query.GetNoneFlagsBitmaskHigh();
+	return MassAPI->AnyMatchingEntities(Query);
+}
 
-	// 3. Fast Path
-	if (AllFlagsQueryLow == 0 && AnyFlagsQueryLow == 0 && NoneFlagsQueryLow == 0 &&
-		AllFlagsQueryHigh == 0 && AnyFlagsQueryHigh == 0 && NoneFlagsQueryHigh == 0)
+TArray<int32> UMassAPIFuncLib::GetFlagHistogram(const UObject* WorldContextObject, UPARAM(ref) const FEntityQuery& Query)
+{
+	TArray<int32> Counts;
+	UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject);
+	if (!MassAPI || !MassAPI->GetEntityManager())
 	{
-		return NativeQuery.GetNumMatchingEntities();
+		Counts.SetNumZeroed(128);
+		return Counts;
 	}
 
-	// 4. Slow Path
-	int32 Count = 0;
-	TArray<FMassEntityHandle> Matches = NativeQuery.GetMatchingEntityHandles();
+	MassAPI->GetFlagHistogram(Query, Counts);
+	return Counts;
+}
+
+TArray<FEntityHandle> UMassAPIFuncLib::GetMatchingEntities(const UObject* WorldContextObject, UPARAM(ref) const FEntityQuery& Query)
+{
+	TArray<FEntityHandle> BPHandles;
+
+	UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject);
+	if (!MassAPI) return BPHandles;
 
+	FMassEntityManager* EntityManager = MassAPI->GetEntityManager();
+	if (!EntityManager) return BPHandles;
+
+	// 1. Execute (composition via the cached Native Query, flags chunk-wise)
+	TArray<FMassEntityHandle> Matches;
+	MassAPI->GetMatchingEntities(Query, Matches);
+
+	// 2. Convert
+	BPHandles.Reserve(Matches.Num());
 	for (const FMassEntityHandle& Handle : Matches)
 	{
-		const FEntityFlagFragment* FlagFragment = EntityManager->GetFragmentDataPtr<FEntityFlagFragment>(Handle);
-		const int64 EntityFlagsLow = FlagFragment ? FlagFragment->Flags : 0;
-		const int64 EntityFlagsHigh = FlagFragment ? FlagFragment->FlagsHigh : 0;
+		BPHandles.Add(FEntityHandle(Handle));
+	}
 
-		// All flags: must have ALL in both low and high
-		const bool bAllLow = (AllFlagsQueryLow == 0) || ((EntityFlagsLow & AllFlagsQueryLow) == AllFlagsQueryLow);
-		const bool bAllHigh = (AllFlagsQueryHigh == 0) || ((EntityFlagsHigh & AllFlagsQueryHigh) == AllFlagsQueryHigh);
+	return BPHandles;
+}
+
+TArray<FEntityHandle> UMassAPIFuncLib::GetMatchingEntitiesParallel(const UObject* WorldContextObject, UPARAM(ref) const FEntityQuery& Query, int32 SerialThreshold)
+{
+	TArray<FEntityHandle> BPHandles;
 
-		// Any flags: need at least one match across both
-		const bool bAnyPass = (AnyFlagsQueryLow == 0 && AnyFlagsQueryHigh == 0)
-							|| ((EntityFlagsLow & AnyFlagsQueryLow) != 0)
-							|| ((EntityFlagsHigh & AnyFlagsQueryHigh) != 0);
+	UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject);
+	if (!MassAPI || !MassAPI->GetEntityManager()) return BPHandles;
 
-		// None flags: must NOT have any in either
-		const bool bNoneLow = (NoneFlagsQueryLow == 0) || ((EntityFlagsLow & NoneFlagsQueryLow) == 0);
-		const bool bNoneHigh = (NoneFlagsQueryHigh == 0) || ((EntityFlagsHigh & NoneFlagsQueryHigh) == 0);
+	TArray<FMassEntityHandle> Matches;
+	MassAPI->GetMatchingEntitiesParallel(Query, Matches, SerialThreshold < 0 ? UMassAPISubsystem::ParallelQuerySerialThreshold : SerialThreshold);
 
-		if (bAllLow && bAllHigh && bAnyPass && bNoneLow && bNoneHigh)
-		{
-			Count++;
-		}
+	BPHandles.Reserve(Matches.Num());
+	for (const FMassEntityHandle& Handle : Matches)
+	{
+		BPHandles.Add(FEntityHandle(Handle));
 	}
 
-	return Count;
+	return BPHandles;
 }
 
-TArray<FEntityHandle> UMassAPIFuncLib::GetMatchingEntities(const UObject* WorldContextObject, UPARAM(ref) const FEntityQuery& Query)
+TArray<FEntityHandle> UMassAPIFuncLib::GetTopKMatchingEntities(const UObject* WorldContextObject, UPARAM(ref) const FEntityQuery& Query, const FStructRecursiveMemberReference& SortMember, int32 K, bool bDescending, TArray<double>& OutValues)
 {
 	TArray<FEntityHandle> BPHandles;
+	OutValues.Reset();
 
 	UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject);
-	if (!MassAPI) return BPHandles;
+	if (!MassAPI || !MassAPI->GetEntityManager()) return BPHandles;
 
-	FMassEntityManager* EntityManager = MassAPI->GetEntityManager();
-	if (!EntityManager) return BPHandles;
+	TArray<FMassEntityHandle> Matches;
+	MassAPI->GetTopKMatchingEntities(Query, SortMember, K, bDescending, Matches, &OutValues);
 
-	// 1. Create Bound Query
-	FMassEntityQuery NativeQuery = Query.GetNativeQuery(EntityManager->AsShared());
+	BPHandles.Reserve(Matches.Num());
+	for (const FMassEntityHandle& Handle : Matches)
+	{
+		BPHandles.Add(FEntityHandle(Handle));
+	}
 
-	// 2. Execute
-	TArray<FMassEntityHandle> Matches = NativeQuery.GetMatchingEntityHandles();
+	return BPHandles;
+}
 
-	// 3. Flags Logic (Low 0-63)
-	const int64 AllFlagsQueryLow = Query.GetAllFlagsBitmask();
-	const int64 AnyFlagsQueryLow = Query.GetAnyFlagsBitmask();
-	const int64 NoneFlagsQueryLow = Query.GetNoneFlagsBitmask();
+TArray<FEntityHandle> UMassAPIFuncLib::GetMatchingEntitiesSorted(const UObject* WorldContextObject, UPARAM(ref) const FEntityQuery& Query, const FStructRecursiveMemberReference& SortMember, bool bDescending, TArray<double>& OutValues)
+{
+	TArray<FEntityHandle> BPHandles;
+	OutValues.Reset();
 
-	// 3b. Flags Logic (High 64-127)
-	const int64 AllFlagsQueryHigh = Query.GetAllFlagsBitmaskHigh();
-	const int64 AnyFlagsQueryHigh = Query.GetAnyFlagsBitmaskHigh();
-	const int64 NoneFlagsQueryHigh = Query.GetNoneFlagsBitmaskHigh();
+	UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject);
+	if (!MassAPI || !MassAPI->GetEntityManager()) return BPHandles;
 
-	// 4. Fast Path
-	if (AllFlagsQueryLow == 0 && AnyFlagsQueryLow == 0 && NoneFlagsQueryLow == 0 &&
-		AllFlagsQueryHigh == 0 && AnyFlagsQueryHigh == 0 && NoneFlagsQueryHigh == 0)
+	TArray<FMassEntityHandle> Matches;
+	MassAPI->GetMatchingEntitiesSorted(Query, SortMember, bDescending, Matches, &OutValues);
+
+	BPHandles.Reserve(Matches.Num());
+	for (const FMassEntityHandle& Handle : Matches)
 	{
-		BPHandles.Reserve(Matches.Num());
-		for (const FMassEntityHandle& H : Matches)
-		{
-			BPHandles.Add(FEntityHandle(H));
-		}
-		return BPHandles;
+		BPHandles.Add(FEntityHandle(Handle));
 	}
 
-	// 5. Filter Path
+	return BPHandles;
+}
+
+FCompiledEntityQuery UMassAPIFuncLib::CompileEntityQuery(UPARAM(ref) const FEntityQuery& Query)
+{
+	return Query.Compile();
+}
+
+bool UMassAPIFuncLib::MatchEntityCompiledQuery(const UObject* WorldContextObject, const FEntityHandle& EntityHandle, UPARAM(ref) const FCompiledEntityQuery& Query)
+{
+	if (UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject))
+	{
+		return MassAPI->MatchQuery(EntityHandle, Query);
+	}
+	return false;
+}
+
+void UMassAPIFuncLib::MatchEntitiesCompiledQuery(const UObject* WorldContextObject, const TArray<FEntityHandle>& EntityHandles, UPARAM(ref) const FCompiledEntityQuery& Query, TArray<FEntityHandle>& MatchingHandles, TArray<FEntityHandle>& UnmatchingHandles)
+{
+	SplitEntitiesByQuery(WorldContextObject, EntityHandles, Query, MatchingHandles, UnmatchingHandles);
+}
+
+int32 UMassAPIFuncLib::GetNumMatchingEntitiesCompiled(const UObject* WorldContextObject, UPARAM(ref) const FCompiledEntityQuery& Query)
+{
+	UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject);
+	if (!MassAPI || !MassAPI->GetEntityManager()) return 0;
+
+	return MassAPI->CountMatchingEntities(Query);
+}
+
+bool UMassAPIFuncLib::AnyMatchingEntitiesCompiled(const UObject* WorldContextObject, UPARAM(ref) const FCompiledEntityQuery& Query)
+{
+	UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject);
+	if (!MassAPI || !MassAPI->GetEntityManager()) return false;
+
+	return MassAPI->AnyMatchingEntities(Query);
+}
+
+TArray<FEntityHandle> UMassAPIFuncLib::GetMatchingEntitiesCompiled(const UObject* WorldContextObject, UPARAM(ref) const FCompiledEntityQuery& Query)
+{
+	TArray<FEntityHandle> BPHandles;
+
+	UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject);
+	if (!MassAPI || !MassAPI->GetEntityManager()) return BPHandles;
+
+	TArray<FMassEntityHandle> Matches;
+	MassAPI->GetMatchingEntities(Query, Matches);
+
 	BPHandles.Reserve(Matches.Num());
 	for (const FMassEntityHandle& Handle : Matches)
 	{
-		const FEntityFlagFragment* FlagFragment = EntityManager->GetFragmentDataPtr<FEntityFlagFragment>(Handle);
-		const int64 EntityFlagsLow = FlagFragment ? FlagFragment->Flags : 0;
-		const int64 EntityFlagsHigh = FlagFragment ? FlagFragment->FlagsHigh : 0;
+		BPHandles.Add(FEntityHandle(Handle));
+	}
 
-		// All flags: must have ALL in both low and high
-		const bool bAllLow = (AllFlagsQueryLow == 0) || ((EntityFlagsLow & AllFlagsQueryLow) == AllFlagsQueryLow);
-		const bool bAllHigh = (AllFlagsQueryHigh == 0) || ((EntityFlagsHigh & AllFlagsQueryHigh) == AllFlagsQueryHigh);
+	return BPHandles;
+}
 
-		// Any flags: need at least one match across both
-		const bool bAnyPass = (AnyFlagsQueryLow == 0 && AnyFlagsQueryHigh == 0)
-							|| ((EntityFlagsLow & AnyFlagsQueryLow) != 0)
-							|| ((EntityFlagsHigh & AnyFlagsQueryHigh) != 0);
+int32 UMassAPIFuncLib::RegisterLiveQuery(const UObject* WorldContextObject, UPARAM(ref) const FEntityQuery& Query)
+{
+	UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject);
+	if (!MassAPI || !MassAPI->GetEntityManager()) return INDEX_NONE;
 
-		// None flags: must NOT have any in either
-		const bool bNoneLow = (NoneFlagsQueryLow == 0) || ((EntityFlagsLow & NoneFlagsQueryLow) == 0);
-		const bool bNoneHigh = (NoneFlagsQueryHigh == 0) || ((EntityFlagsHigh & NoneFlagsQueryHigh) == 0);
+	return MassAPI->RegisterLiveQuery(Query);
+}
 
-		if (bAllLow && bAllHigh && bAnyPass && bNoneLow && bNoneHigh)
-		{
-			BPHandles.Add(FEntityHandle(Handle));
-		}
+void UMassAPIFuncLib::UnregisterLiveQuery(const UObject* WorldContextObject, int32 LiveQueryId)
+{
+	if (UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject))
+	{
+		MassAPI->UnregisterLiveQuery(LiveQueryId);
 	}
+}
+
+bool UMassAPIFuncLib::GetLiveQueryDeltas(const UObject* WorldContextObject, int32 LiveQueryId, TArray<FEntityHandle>& Added, TArray<FEntityHandle>& Removed)
+{
+	Added.Reset();
+	Removed.Reset();
+
+	UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject);
+	if (!MassAPI) return false;
 
+	const FEntityLiveQuery* LiveQuery = MassAPI->GetLiveQuery(LiveQueryId);
+	if (!LiveQuery) return false;
+
+	Added.Reserve(LiveQuery->Added.Num());
+	for (const FMassEntityHandle& Handle : LiveQuery->Added)
+	{
+		Added.Add(FEntityHandle(Handle));
+	}
+	Removed.Reserve(LiveQuery->Removed.Num());
+	for (const FMassEntityHandle& Handle : LiveQuery->Removed)
+	{
+		Removed.Add(FEntityHandle(Handle));
+	}
+	return true;
+}
+
+TArray<FEntityHandle> UMassAPIFuncLib::GetLiveQueryEntities(const UObject* WorldContextObject, int32 LiveQueryId)
+{
+	TArray<FEntityHandle> BPHandles;
+
+	UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject);
+	if (!MassAPI) return BPHandles;
+
+	const FEntityLiveQuery* LiveQuery = MassAPI->GetLiveQuery(LiveQueryId);
+	if (!LiveQuery) return BPHandles;
+
+	BPHandles.Reserve(LiveQuery->Matching.Num());
+	for (const FMassEntityHandle& Handle : LiveQuery->Matching)
+	{
+		BPHandles.Add(FEntityHandle(Handle));
+	}
 	return BPHandles;
 }
 
@@ -850,6 +1027,25 @@ void UMassAPIFuncLib::SetFragment_Entity_Unified(const UObject* WorldContextObje
 	checkNoEntry();
 }
 
+// Helper: the entity's flag words, zero without FEntityFlagFragment | 实体的旗标字，无旗标片段时为 0
+static FEntityFlagFragment ReadEntityFlags(const FMassEntityManager& Manager, const FMassEntityHandle Entity)
+{
+	const FEntityFlagFragment* FlagFragment = Manager.GetFragmentDataPtr<FEntityFlagFragment>(Entity);
+	return FlagFragment ? FEntityFlagFragment(*FlagFragment) : FEntityFlagFragment();
+}
+
+// Helper: reports a whole FEntityFlagFragment overwrite as the bits it flipped, so summaries, index and observers see it | 整体覆盖旗标片段时按翻转位通知
+static void NotifyFlagFragmentOverwrite(const UMassAPISubsystem* MassAPI, const FMassEntityManager& Manager, const FMassEntityHandle Entity, const FEntityFlagFragment& Before)
+{
+	const FEntityFlagFragment After = ReadEntityFlags(Manager, Entity);
+	const int64 RoseLow = After.Flags & ~Before.Flags, RoseHigh = After.FlagsHigh & ~Before.FlagsHigh;
+	const int64 FellLow = Before.Flags & ~After.Flags, FellHigh = Before.FlagsHigh & ~After.FlagsHigh;
+	if (MassAPI && (RoseLow | RoseHigh | FellLow | FellHigh) != 0)
+	{
+		MassAPI->NotifyFlagWrite(Manager, Entity, RoseLow, RoseHigh, FellLow, FellHigh);
+	}
+}
+
 // [CHANGED] Signature now uses Value for OnFinished
 void UMassAPIFuncLib::Generic_SetFragment_Entity_Unified(const UObject* WorldContextObject, const FEntityHandle& EntityHandle, UScriptStruct* FragmentType, const void* InFragmentPtr, bool bDeferred, bool& bSuccess, FOnMassDeferredFinished OnFinished)
 {
@@ -868,14 +1064,19 @@ void UMassAPIFuncLib::Generic_SetFragment_Entity_Unified(const UObject* WorldCon
 		FInstancedStruct FragmentInstance;
 		FragmentInstance.InitializeAs(FragmentType, static_cast<const uint8*>(InFragmentPtr));
 
+		// Overwriting the flag fragment is a flag write like any other | 覆盖旗标片段同样属于旗标写入
+		const bool bFlagFragment = FragmentType == FEntityFlagFragment::StaticStruct();
+
 		if (bDeferred)
 		{
 			// Capture by Value (The delegate itself is a small struct wrapping a shared pointer)
-			MassAPI->Defer().PushCommand<FMassDeferredSetCommand>([EntityHandle, FragmentInstance, OnFinished](FMassEntityManager& Manager)
+			MassAPI->Defer().PushCommand<FMassDeferredSetCommand>([WeakMassAPI = TWeakObjectPtr<UMassAPISubsystem>(MassAPI), EntityHandle, FragmentInstance, bFlagFragment, OnFinished](FMassEntityManager& Manager)
 				{
 					if (Manager.IsEntityValid(EntityHandle))
 					{
+						const FEntityFlagFragment Before = bFlagFragment ? ReadEntityFlags(Manager, EntityHandle) : FEntityFlagFragment();
 						Manager.AddFragmentInstanceListToEntity(EntityHandle, MakeArrayView(&FragmentInstance, 1));
+						if (bFlagFragment) NotifyFlagFragmentOverwrite(WeakMassAPI.Get(), Manager, EntityHandle, Before);
 
 						// Execute safe
 						OnFinished.ExecuteIfBound(EntityHandle);
@@ -885,6 +1086,7 @@ void UMassAPIFuncLib::Generic_SetFragment_Entity_Unified(const UObject* WorldCon
 		}
 		else
 		{
+			const FEntityFlagFragment Before = bFlagFragment ? ReadEntityFlags(EntityManager, EntityHandle) : FEntityFlagFragment();
 			if (MassAPI->HasFragment(EntityHandle, FragmentType))
 			{
 				EntityManager.SetEntityFragmentValues(EntityHandle, MakeArrayView(&FragmentInstance, 1));
@@ -893,6 +1095,7 @@ void UMassAPIFuncLib::Generic_SetFragment_Entity_Unified(const UObject* WorldCon
 			{
 				MassAPI->AddFragment(EntityHandle, FragmentInstance);
 			}
+			if (bFlagFragment) NotifyFlagFragmentOverwrite(MassAPI, EntityManager, EntityHandle, Before);
 			bSuccess = true;
 			OnFinished.ExecuteIfBound(EntityHandle);
 		}
@@ -968,155 +1171,204 @@ DEFINE_FUNCTION(UMassAPIFuncLib::execSetFragment_Entity_Unified)
 
 //———————— Set.Fragment.Template (Unified) —————————————————————————————————————
 
-void UMassAPIFuncLib::SetFragment_Template_Unified(const UObject* WorldContextObject, UPARAM(ref) FEntityTemplateData& TemplateData, UScriptStruct* FragmentType, const FGenericStruct& InFragment)
+// Helper: writable initial value of FragmentType in template data the caller owns | 调用方独占的模板中某片段初始值的可写内存
+static uint8* FindTemplateFragmentMemory(FMassEntityTemplateData& Data, const UScriptStruct* FragmentType)
 {
-	checkNoEntry();
+	for (const FInstancedStruct& Value : Data.GetInitialFragmentValues())
+	{
+		if (Value.GetScriptStruct() == FragmentType)
+		{
+			// The engine only hands out a const view; the values themselves belong to Data | 引擎只提供常量视图，值本身属于 Data
+			return const_cast<FInstancedStruct&>(Value).GetMutableMemory();
+		}
+	}
+	return nullptr;
 }
 
-void UMassAPIFuncLib::Generic_SetFragment_Template_Unified(const UObject* WorldContextObject, UPARAM(ref) FEntityTemplateData& TemplateData, UScriptStruct* FragmentType, const void* InFragmentPtr)
+// Helper: copy of Source with the given shared/const shared values swapped in | 替换共享片段值后重建模板
+static TSharedPtr<FMassEntityTemplateData> RebuildTemplateWithSharedValues(const FMassEntityTemplateData& Source, TConstArrayView<FSharedStruct> SharedValues, TConstArrayView<FConstSharedStruct> ConstSharedValues)
 {
-	if (!FragmentType)
+	TSharedPtr<FMassEntityTemplateData> NewData = MakeShared<FMassEntityTemplateData>();
+	NewData->SetTemplateName(Source.GetTemplateName());
+
+	Source.GetTags().ExportTypes([&](const UScriptStruct* TagType) {
+		TEMPLATE_ADD_TAG((*NewData), TagType);
+		return true;
+		});
+	Source.GetCompositionDescriptor().GET_FRAGMENTS.ExportTypes([&](const UScriptStruct* Type) {
+		TEMPLATE_ADD_FRAGMENT((*NewData), Type);
+		return true;
+		});
+	for (const FInstancedStruct& Fragment : Source.GetInitialFragmentValues()) { NewData->AddFragment(FConstStructView(Fragment)); }
+
+	const FMassArchetypeSharedFragmentValues& OldValues = Source.GetSharedFragmentValues();
+	for (const FSharedStruct& S : OldValues.GetSharedFragments())
 	{
-		UE_LOG(LogMassBlueprintAPI, Warning, TEXT("SetFragment_Template: FragmentType is null."));
-		return;
+		const FSharedStruct* Replacement = SharedValues.FindByPredicate([&S](const FSharedStruct& R) { return R.GetScriptStruct() == S.GetScriptStruct(); });
+		NewData->AddSharedFragment(Replacement ? *Replacement : S);
 	}
-	if (!InFragmentPtr)
+	for (const FConstSharedStruct& C : OldValues.GetConstSharedFragments())
 	{
-		UE_LOG(LogMassBlueprintAPI, Warning, TEXT("SetFragment_Template: InFragmentPtr is null."));
-		return;
+		const FConstSharedStruct* Replacement = ConstSharedValues.FindByPredicate([&C](const FConstSharedStruct& R) { return R.GetScriptStruct() == C.GetScriptStruct(); });
+		NewData->AddConstSharedFragment(Replacement ? *Replacement : C);
 	}
+	return NewData;
+}
 
-	const FMassEntityTemplateData* OldData = TemplateData.Get();
-	// Templates are copy-on-write. We create a new one to modify.
-	TSharedPtr<FMassEntityTemplateData> NewData = MakeShared<FMassEntityTemplateData>();
-
-	// Helper to copy Tags and Chunk Fragments Definitions (structure only, no payload usually)
-	auto CopyCommonData = [&](const FMassEntityTemplateData* Source)
-		{
-			if (!Source) return;
-			NewData->SetTemplateName(Source->GetTemplateName());
-
-			Source->GetTags().ExportTypes([&](const UScriptStruct* TagType) {
-				TEMPLATE_ADD_TAG((*NewData), TagType);
-				return true;
-				});
-
-			Source->GetCompositionDescriptor().GET_CHUNK_FRAGMENTS.ExportTypes([&](const UScriptStruct* Type) {
-				// Chunk fragments in templates are generally just types, not values
-				return true;
-				});
-		};
+/**
+ * Helper: writes every value into the template, a later value of a type winning. Fragment values are overwritten in
+ * place or appended, on data copied at most once when another handle shares it. Only replacing shared or const shared
+ * values the template already has needs a rebuild, done once for the whole batch.
+ * | 批量写入模板：片段原地覆盖或追加，被共享时最多复制一次；只有替换已有的共享片段值才重建，整批只重建一次
+ */
+static void ApplyTemplateFragmentValues(const UObject* WorldContextObject, FEntityTemplateData& TemplateData, TConstArrayView<FConstStructView> Values)
+{
+	UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject);
+	FMassEntityManager* Manager = MassAPI ? MassAPI->GetEntityManager() : nullptr;
 
-	if (OldData)
+	// 1. Sort the values by kind, resolving shared instances up front | 按类型分拣，提前解析共享实例
+	TArray<FConstStructView, TInlineAllocator<8>> FragmentValues;
+	TArray<FSharedStruct> SharedValues;
+	TArray<FConstSharedStruct> ConstSharedValues;
+	for (const FConstStructView& Value : Values)
 	{
-		CopyCommonData(OldData);
-		const FMassArchetypeSharedFragmentValues& SharedValues = OldData->GetSharedFragmentValues();
+		const UScriptStruct* Type = Value.GetScriptStruct();
+		if (!Type || !Value.GetMemory()) continue;
 
-		if (FragmentType->IsChildOf(FMassFragment::StaticStruct()))
+		if (Type->IsChildOf(FMassFragment::StaticStruct()))
 		{
-			// 1. Copy Fragment Types
-			OldData->GetCompositionDescriptor().GET_FRAGMENTS.ExportTypes([&](const UScriptStruct* Type) {
-				TEMPLATE_ADD_FRAGMENT((*NewData), Type);
-				return true;
-				});
-
-			// 2. Copy Existing Instance Values (Skip the one being set)
-			for (const FInstancedStruct& Fragment : OldData->GetInitialFragmentValues())
-			{
-				if (Fragment.GetScriptStruct() != FragmentType)
-				{
-					NewData->AddFragment(FConstStructView(Fragment));
-				}
-			}
-
-			// 3. Copy Shared/Const Shared
-			for (const FSharedStruct& S : SharedValues.GetSharedFragments()) { NewData->AddSharedFragment(S); }
-			for (const FConstSharedStruct& C : SharedValues.GetConstSharedFragments()) { NewData->AddConstSharedFragment(C); }
-
-			// 4. Add/Overwrite the Target Fragment Value
-			NewData->AddFragment(FConstStructView(FragmentType, static_cast<const uint8*>(InFragmentPtr)));
+			FragmentValues.Add(Value);
 		}
-		else if (FragmentType->IsChildOf(FMassSharedFragment::StaticStruct()))
+		else if (Type->IsChildOf(FMassSharedFragment::StaticStruct()))
 		{
-			// Copy regular fragments
-			OldData->GetCompositionDescriptor().GET_FRAGMENTS.ExportTypes([&](const UScriptStruct* Type) { TEMPLATE_ADD_FRAGMENT((*NewData), Type); return true; });
-			for (const FInstancedStruct& Fragment : OldData->GetInitialFragmentValues()) { NewData->AddFragment(FConstStructView(Fragment)); }
-
-			// Copy Shared (Skip target)
-			for (const FSharedStruct& S : SharedValues.GetSharedFragments())
-			{
-				if (S.GetScriptStruct() != FragmentType) NewData->AddSharedFragment(S);
-			}
-
-			// Copy Const Shared
-			for (const FConstSharedStruct& C : SharedValues.GetConstSharedFragments()) { NewData->AddConstSharedFragment(C); }
-
-			// Add New Shared
-			if (UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject))
-			{
-				const FSharedStruct& NewStruct = MassAPI->GetEntityManager()->GetOrCreateSharedFragment(*FragmentType, static_cast<const uint8*>(InFragmentPtr));
-				NewData->AddSharedFragment(NewStruct);
-			}
+			if (!Manager) continue;
+			SharedValues.RemoveAll([Type](const FSharedStruct& S) { return S.GetScriptStruct() == Type; });
+			SharedValues.Add(Manager->GetOrCreateSharedFragment(*Type, Value.GetMemory()));
 		}
-		else if (FragmentType->IsChildOf(FMassConstSharedFragment::StaticStruct()))
+		else if (Type->IsChildOf(FMassConstSharedFragment::StaticStruct()))
 		{
-			// Copy regular fragments
-			OldData->GetCompositionDescriptor().GET_FRAGMENTS.ExportTypes([&](const UScriptStruct* Type) { TEMPLATE_ADD_FRAGMENT((*NewData), Type); return true; });
-			for (const FInstancedStruct& Fragment : OldData->GetInitialFragmentValues()) { NewData->AddFragment(FConstStructView(Fragment)); }
-
-			// Copy Shared
-			for (const FSharedStruct& S : SharedValues.GetSharedFragments()) { NewData->AddSharedFragment(S); }
-
-			// Copy Const Shared (Skip target)
-			for (const FConstSharedStruct& C : SharedValues.GetConstSharedFragments())
-			{
-				if (C.GetScriptStruct() != FragmentType) NewData->AddConstSharedFragment(C);
-			}
-
-			// Add New Const Shared
-			if (UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject))
-			{
-				const FConstSharedStruct& NewStruct = MassAPI->GetEntityManager()->GetOrCreateConstSharedFragment(*FragmentType, static_cast<const uint8*>(InFragmentPtr));
-				NewData->AddConstSharedFragment(NewStruct);
-			}
+			if (!Manager) continue;
+			ConstSharedValues.RemoveAll([Type](const FConstSharedStruct& C) { return C.GetScriptStruct() == Type; });
+			ConstSharedValues.Add(Manager->GetOrCreateConstSharedFragment(*Type, Value.GetMemory()));
 		}
 		else
 		{
-			UE_LOG(LogMassBlueprintAPI, Warning, TEXT("SetFragment_Template: Unsupported fragment type '%s'. Chunk fragments cannot be set by value in templates."), *FragmentType->GetName());
-			return; // Abort update
+			UE_LOG(LogMassBlueprintAPI, Warning, TEXT("SetFragment_Template: Unsupported fragment type '%s'. Chunk fragments cannot be set by value in templates."), *Type->GetName());
 		}
 	}
-	else
+	if (FragmentValues.Num() == 0 && SharedValues.Num() == 0 && ConstSharedValues.Num() == 0) return;
+
+	if (!TemplateData.IsValid())
+	{
+		TemplateData = FEntityTemplateData(MakeShared<FMassEntityTemplateData>());
+	}
+
+	// 2. Present shared values cannot be replaced in place: one rebuild covers them all | 已有的共享值无法原地替换，整批重建一次
+	const FMassArchetypeCompositionDescriptor& OldComposition = TemplateData.Get()->GetCompositionDescriptor();
+	const bool bReplacesShared =
+		SharedValues.ContainsByPredicate([&OldComposition](const FSharedStruct& S) { return CONTAINS_SHARED(OldComposition, S.GetScriptStruct()); }) ||
+		ConstSharedValues.ContainsByPredicate([&OldComposition](const FConstSharedStruct& C) { return CONTAINS_CONST_SHARED(OldComposition, C.GetScriptStruct()); });
+	if (bReplacesShared)
+	{
+		TemplateData = FEntityTemplateData(RebuildTemplateWithSharedValues(*TemplateData.Get(), SharedValues, ConstSharedValues));
+	}
+
+	// 3. Everything else lands in place | 其余修改原地完成
+	FMassEntityTemplateData& Data = *TemplateData.GetMutable();
+	bool bLayoutChanged = false;
+	for (const FConstStructView& Value : FragmentValues)
 	{
-		// Handle creating a fresh template if OldData was null
-		if (FragmentType->IsChildOf(FMassFragment::StaticStruct()))
+		if (uint8* Memory = FindTemplateFragmentMemory(Data, Value.GetScriptStruct()))
 		{
-			NewData->AddFragment(FConstStructView(FragmentType, static_cast<const uint8*>(InFragmentPtr)));
+			Value.GetScriptStruct()->CopyScriptStruct(Memory, Value.GetMemory());
 		}
-		else if (FragmentType->IsChildOf(FMassSharedFragment::StaticStruct()))
+		else
 		{
-			if (UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject))
-			{
-				const FSharedStruct& NewStruct = MassAPI->GetEntityManager()->GetOrCreateSharedFragment(*FragmentType, static_cast<const uint8*>(InFragmentPtr));
-				NewData->AddSharedFragment(NewStruct);
-			}
+			Data.AddFragment(Value);
+			bLayoutChanged = true;
 		}
-		else if (FragmentType->IsChildOf(FMassConstSharedFragment::StaticStruct()))
+	}
+	for (const FSharedStruct& S : SharedValues)
+	{
+		if (!CONTAINS_SHARED(Data.GetCompositionDescriptor(), S.GetScriptStruct()))
 		{
-			if (UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject))
-			{
-				const FConstSharedStruct& NewStruct = MassAPI->GetEntityManager()->GetOrCreateConstSharedFragment(*FragmentType, static_cast<const uint8*>(InFragmentPtr));
-				NewData->AddConstSharedFragment(NewStruct);
-			}
+			Data.AddSharedFragment(S);
+			bLayoutChanged = true;
 		}
-		else
+	}
+	for (const FConstSharedStruct& C : ConstSharedValues)
+	{
+		if (!CONTAINS_CONST_SHARED(Data.GetCompositionDescriptor(), C.GetScriptStruct()))
 		{
-			UE_LOG(LogMassBlueprintAPI, Warning, TEXT("SetFragment_Template: Unsupported fragment type '%s' for new template."), *FragmentType->GetName());
-			return;
+			Data.AddConstSharedFragment(C);
+			bLayoutChanged = true;
 		}
 	}
 
-	TemplateData = FEntityTemplateData(NewData);
+	// Overwritten values keep the cached archetype; appended ones change the layout | 仅覆盖值时原型缓存仍有效
+	if (bLayoutChanged)
+	{
+		TemplateData.InvalidateArchetype();
+	}
+}
+
+// Helper: the template's flag fragment, editable in place (copied first if shared, added if missing) | 模板的旗标片段，可原地修改
+static FEntityFlagFragment* GetMutableTemplateFlags(FEntityTemplateData& TemplateData)
+{
+	if (!TemplateData.IsValid())
+	{
+		TemplateData = FEntityTemplateData(MakeShared<FMassEntityTemplateData>());
+	}
+
+	FMassEntityTemplateData& Data = *TemplateData.GetMutable();
+	if (uint8* Memory = FindTemplateFragmentMemory(Data, FEntityFlagFragment::StaticStruct()))
+	{
+		return reinterpret_cast<FEntityFlagFragment*>(Memory);
+	}
+
+	Data.AddFragment(FConstStructView::Make(FEntityFlagFragment()));
+	TemplateData.InvalidateArchetype();
+	return reinterpret_cast<FEntityFlagFragment*>(FindTemplateFragmentMemory(Data, FEntityFlagFragment::StaticStruct()));
+}
+
+// Helper: adds or removes a template tag, copying shared data first so other handles keep their tags | 增删模板标签，共享时先复制
+static void SetTemplateTag(FEntityTemplateData& TemplateData, const UScriptStruct* TagType, const bool bPresent)
+{
+	const FMassEntityTemplateData* Data = TemplateData.Get();
+	if (!Data || (CONTAINS_TAG(Data->GetCompositionDescriptor(), TagType)) == bPresent) return;
+
+	FMassEntityTemplateData& MutableData = *TemplateData.GetMutable();
+	if (bPresent)
+	{
+		TEMPLATE_ADD_TAG(MutableData, TagType);
+	}
+	else
+	{
+		TEMPLATE_REMOVE_TAG(MutableData, TagType);
+	}
+	TemplateData.InvalidateArchetype();
+}
+
+void UMassAPIFuncLib::SetFragment_Template_Unified(const UObject* WorldContextObject, UPARAM(ref) FEntityTemplateData& TemplateData, UScriptStruct* FragmentType, const FGenericStruct& InFragment)
+{
+	checkNoEntry();
+}
+
+void UMassAPIFuncLib::Generic_SetFragment_Template_Unified(const UObject* WorldContextObject, UPARAM(ref) FEntityTemplateData& TemplateData, UScriptStruct* FragmentType, const void* InFragmentPtr)
+{
+	if (!FragmentType)
+	{
+		UE_LOG(LogMassBlueprintAPI, Warning, TEXT("SetFragment_Template: FragmentType is null."));
+		return;
+	}
+	if (!InFragmentPtr)
+	{
+		UE_LOG(LogMassBlueprintAPI, Warning, TEXT("SetFragment_Template: InFragmentPtr is null."));
+		return;
+	}
+
+	const FConstStructView Value(FragmentType, static_cast<const uint8*>(InFragmentPtr));
+	ApplyTemplateFragmentValues(WorldContextObject, TemplateData, MakeArrayView(&Value, 1));
 }
 
 DEFINE_FUNCTION(UMassAPIFuncLib::execSetFragment_Template_Unified)
@@ -1134,6 +1386,19 @@ DEFINE_FUNCTION(UMassAPIFuncLib::execSetFragment_Template_Unified)
 	P_NATIVE_END
 }
 
+//———————— Set.Fragments.Template																					————
+
+void UMassAPIFuncLib::SetFragments_Template(const UObject* WorldContextObject, UPARAM(ref) FEntityTemplateData& TemplateData, const TArray<FInstancedStruct>& Fragments)
+{
+	TArray<FConstStructView, TInlineAllocator<8>> Values;
+	Values.Reserve(Fragments.Num());
+	for (const FInstancedStruct& Fragment : Fragments)
+	{
+		if (Fragment.IsValid()) Values.Add(FConstStructView(Fragment));
+	}
+	ApplyTemplateFragmentValues(WorldContextObject, TemplateData, Values);
+}
+
 //———————— Get.Fragment.Entity (Unified) ———————————————————————————————————————
 
 void UMassAPIFuncLib::GetFragment_Entity_Unified(const UObject* WorldContextObject, const FEntityHandle& EntityHandle, UScriptStruct* FragmentType, FGenericStruct& OutFragment, bool& bSuccess)
@@ -1655,12 +1920,9 @@ void UMassAPIFuncLib::AddTag_Entity(const UObject* WorldContextObject, const FEn
 
 void UMassAPIFuncLib::AddTag_Template(UPARAM(ref) FEntityTemplateData& TemplateData, UScriptStruct* TagType)
 {
-	if (FMassEntityTemplateData* Data = TemplateData.Get())
+	if (TagType && TagType->IsChildOf(FMassTag::StaticStruct()))
 	{
-		if (TagType && TagType->IsChildOf(FMassTag::StaticStruct()))
-		{
-			TEMPLATE_ADD_TAG((*Data), TagType);
-		}
+		SetTemplateTag(TemplateData, TagType, true);
 	}
 }
 
@@ -1695,12 +1957,9 @@ void UMassAPIFuncLib::RemoveTag_Entity(const UObject* WorldContextObject, const
 
 void UMassAPIFuncLib::RemoveTag_Template(UPARAM(ref) FEntityTemplateData& TemplateData, UScriptStruct* TagType)
 {
-	if (FMassEntityTemplateData* Data = TemplateData.Get())
+	if (TagType && TagType->IsChildOf(FMassTag::StaticStruct()))
 	{
-		if (TagType && TagType->IsChildOf(FMassTag::StaticStruct()))
-		{
-			TEMPLATE_REMOVE_TAG((*Data), TagType);
-		}
+		SetTemplateTag(TemplateData, TagType, false);
 	}
 }
 
@@ -1741,13 +2000,14 @@ bool UMassAPIFuncLib::SetFlag_Entity(const UObject* WorldContextObject, const FE
 
 	if (bDeferred)
 	{
-		MassAPI->Defer().PushCommand<FMassDeferredSetCommand>([EntityHandle, FlagToSet, OnFinished](FMassEntityManager& Manager)
+		MassAPI->Defer().PushCommand<FMassDeferredSetCommand>([WeakMassAPI = TWeakObjectPtr<UMassAPISubsystem>(MassAPI), EntityHandle, FlagToSet, OnFinished](FMassEntityManager& Manager)
 		{
 			if (Manager.IsEntityValid(EntityHandle))
 			{
 				if (FEntityFlagFragment* FlagFragment = Manager.GetFragmentDataPtr<FEntityFlagFragment>(EntityHandle))
 				{
-					FlagFragment->SetFlag(FlagToSet);
+					const bool bChanged = FlagFragment->SetFlagIfClear(FlagToSet);
+					if (const UMassAPISubsystem* DeferredMassAPI = WeakMassAPI.Get(); DeferredMassAPI && bChanged) DeferredMassAPI->NotifyFlagWrite(Manager, EntityHandle, FlagToSet, true);
 					OnFinished.ExecuteIfBound(EntityHandle);
 				}
 			}
@@ -1771,30 +2031,17 @@ void UMassAPIFuncLib::SetFlag_Template(const UObject* WorldContextObject, UPARAM
 		return;
 	}
 
-	// 1. Get current flags state (both low and high)
-	FEntityFlagFragment TempFlagFragment;
-	if (const FMassEntityTemplateData* Data = TemplateData.Get())
+	// 1. Edit the template's flag fragment in place (copy-on-write when shared) | 原地修改模板旗标片段（被共享时写时复制）
+	if (FEntityFlagFragment* FlagFragment = GetMutableTemplateFlags(TemplateData))
 	{
-		TConstArrayView<FInstancedStruct> InitialValues = Data->GetInitialFragmentValues();
-		for (const FInstancedStruct& Value : InitialValues)
-		{
-			if (Value.GetScriptStruct() == FEntityFlagFragment::StaticStruct())
-			{
-				if (const FEntityFlagFragment* ExistingFragment = reinterpret_cast<const FEntityFlagFragment*>(Value.GetMemory()))
-				{
-					TempFlagFragment.Flags = ExistingFragment->Flags;
-					TempFlagFragment.FlagsHigh = ExistingFragment->FlagsHigh;
-					break;
-				}
-			}
-		}
+		FlagFragment->SetFlag(FlagToSet);
 	}
 
-	// 2. Use the fragment's own logic to set the flag (handles both low and high)
-	TempFlagFragment.SetFlag(FlagToSet);
-
-	// 3. Write the modified fragment back to the template
-	Generic_SetFragment_Template_Unified(WorldContextObject, TemplateData, FEntityFlagFragment::StaticStruct(), &TempFlagFragment);
+	// 2. Keep the mirror tag of a tag-backed flag in step | 同步标签镜像旗标的镜像标签
+	if (const UScriptStruct* MirrorTag = UMassAPIFlagSettings::GetFlagMirrorTag(static_cast<int32>(FlagToSet)))
+	{
+		SetTemplateTag(TemplateData, MirrorTag, true);
+	}
 }
 
 //———————— Get.Flags																								————
@@ -1840,13 +2087,14 @@ bool UMassAPIFuncLib::ClearFlag_Entity(const UObject* WorldContextObject, const
 
 	if (bDeferred)
 	{
-		MassAPI->Defer().PushCommand<FMassDeferredSetCommand>([EntityHandle, FlagToClear, OnFinished](FMassEntityManager& Manager)
+		MassAPI->Defer().PushCommand<FMassDeferredSetCommand>([WeakMassAPI = TWeakObjectPtr<UMassAPISubsystem>(MassAPI), EntityHandle, FlagToClear, OnFinished](FMassEntityManager& Manager)
 		{
 			if (Manager.IsEntityValid(EntityHandle))
 			{
 				if (FEntityFlagFragment* FlagFragment = Manager.GetFragmentDataPtr<FEntityFlagFragment>(EntityHandle))
 				{
-					FlagFragment->ClearFlag(FlagToClear);
+					const bool bChanged = FlagFragment->ClearFlagIfSet(FlagToClear);
+					if (const UMassAPISubsystem* DeferredMassAPI = WeakMassAPI.Get(); DeferredMassAPI && bChanged) DeferredMassAPI->NotifyFlagWrite(Manager, EntityHandle, FlagToClear, false);
 					OnFinished.ExecuteIfBound(EntityHandle);
 				}
 			}
@@ -1870,30 +2118,17 @@ void UMassAPIFuncLib::ClearFlag_Template(const UObject* WorldContextObject, UPAR
 		return;
 	}
 
-	// 1. Get current flags state (both low and high)
-	FEntityFlagFragment TempFlagFragment;
-	if (const FMassEntityTemplateData* Data = TemplateData.Get())
+	// 1. Edit the template's flag fragment in place (copy-on-write when shared) | 原地修改模板旗标片段（被共享时写时复制）
+	if (FEntityFlagFragment* FlagFragment = GetMutableTemplateFlags(TemplateData))
 	{
-		TConstArrayView<FInstancedStruct> InitialValues = Data->GetInitialFragmentValues();
-		for (const FInstancedStruct& Value : InitialValues)
-		{
-			if (Value.GetScriptStruct() == FEntityFlagFragment::StaticStruct())
-			{
-				if (const FEntityFlagFragment* ExistingFragment = reinterpret_cast<const FEntityFlagFragment*>(Value.GetMemory()))
-				{
-					TempFlagFragment.Flags = ExistingFragment->Flags;
-					TempFlagFragment.FlagsHigh = ExistingFragment->FlagsHigh;
-					break;
-				}
-			}
-		}
+		FlagFragment->ClearFlag(FlagToClear);
 	}
 
-	// 2. Use the fragment's own logic to clear the flag (handles both low and high)
-	TempFlagFragment.ClearFlag(FlagToClear);
-
-	// 3. Write the modified fragment back to the template
-	Generic_SetFragment_Template_Unified(WorldContextObject, TemplateData, FEntityFlagFragment::StaticStruct(), &TempFlagFragment);
+	// 2. Keep the mirror tag of a tag-backed flag in step | 同步标签镜像旗标的镜像标签
+	if (const UScriptStruct* MirrorTag = UMassAPIFlagSettings::GetFlagMirrorTag(static_cast<int32>(FlagToClear)))
+	{
+		SetTemplateTag(TemplateData, MirrorTag, false);
+	}
 }
 
 //———————— Has.Flag																									————
@@ -1941,22 +2176,53 @@ bool UMassAPIFuncLib::HasFlag_Template(UPARAM(ref) const FEntityTemplateData& Te
 // Flag Operations (FName-Based) | FName 旗标操作
 //——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
 
-// Helper: resolve FName → EEntityFlags via settings registry | 通过设置注册表解析 FName → EEntityFlags
+// Helper: resolve FName → EEntityFlags via the settings flag table | 通过设置的旗标查找表解析 FName → EEntityFlags
 static bool LookupFlagByName(FName FlagName, EEntityFlags& OutFlag)
 {
-	const UMassAPIFlagSettings* Settings = GetDefault<UMassAPIFlagSettings>();
-	if (!Settings) return false;
-	const EEntityFlags* Found = Settings->FlagRegistry.Find(FlagName);
-	if (!Found) return false;
-	OutFlag = *Found;
-	return true;
+	OutFlag = UMassAPIFlagSettings::ResolveFlag(FlagName);
+	return OutFlag != EEntityFlags::EEntityFlags_MAX;
+}
+
+// Helper: names from the extended registry may map to bits 128+ | 扩展注册表中的名称可映射到 128 以上的位
+static bool WriteFlagBitByName(const UObject* WorldContextObject, const FEntityHandle& EntityHandle, const int32 Bit, const bool bValue, const bool bDeferred, FOnMassDeferredFinished OnFinished)
+{
+	if (Bit < 128)
+	{
+		return bValue
+			? UMassAPIFuncLib::SetFlag_Entity(WorldContextObject, EntityHandle, static_cast<EEntityFlags>(Bit), bDeferred, OnFinished)
+			: UMassAPIFuncLib::ClearFlag_Entity(WorldContextObject, EntityHandle, static_cast<EEntityFlags>(Bit), bDeferred, OnFinished);
+	}
+
+	UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject);
+	if (!MassAPI || !MassAPI->IsValid(EntityHandle)) return false;
+
+	if (bDeferred)
+	{
+		MassAPI->Defer().PushCommand<FMassDeferredSetCommand>([WeakMassAPI = TWeakObjectPtr<UMassAPISubsystem>(MassAPI), EntityHandle, Bit, bValue, OnFinished](FMassEntityManager& Manager)
+		{
+			bool bChanged = false;
+			if (Manager.IsEntityValid(EntityHandle) && UMassAPISubsystem::WriteExtFlagBit(Manager, EntityHandle, Bit, bValue, bChanged))
+			{
+				if (const UMassAPISubsystem* DeferredMassAPI = WeakMassAPI.Get(); DeferredMassAPI && bChanged) DeferredMassAPI->NotifyExtFlagWrite(Manager, EntityHandle);
+				OnFinished.ExecuteIfBound(EntityHandle);
+			}
+		});
+		return true;
+	}
+
+	const bool bResult = bValue ? MassAPI->SetEntityFlagBit(EntityHandle, Bit) : MassAPI->ClearEntityFlagBit(EntityHandle, Bit);
+	OnFinished.ExecuteIfBound(EntityHandle);
+	return bResult;
 }
 
 bool UMassAPIFuncLib::HasFlag_EntityByName(const UObject* WorldContextObject, const FEntityHandle& EntityHandle, FName FlagName)
 {
 	EEntityFlags Flag;
-	if (!LookupFlagByName(FlagName, Flag)) return false;
-	return HasFlag_Entity(WorldContextObject, EntityHandle, Flag);
+	if (LookupFlagByName(FlagName, Flag)) return HasFlag_Entity(WorldContextObject, EntityHandle, Flag);
+
+	const int32 Bit = UMassAPIFlagSettings::ResolveFlagBit(FlagName);
+	UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject);
+	return (Bit != INDEX_NONE) && MassAPI && MassAPI->HasEntityFlagBit(EntityHandle, Bit);
 }
 
 bool UMassAPIFuncLib::HasFlag_TemplateByName(UPARAM(ref) const FEntityTemplateData& TemplateData, FName FlagName)
@@ -1969,8 +2235,10 @@ bool UMassAPIFuncLib::HasFlag_TemplateByName(UPARAM(ref) const FEntityTemplateDa
 bool UMassAPIFuncLib::SetFlag_EntityByName(const UObject* WorldContextObject, const FEntityHandle& EntityHandle, FName FlagName, bool bDeferred, FOnMassDeferredFinished OnFinished)
 {
 	EEntityFlags Flag;
-	if (!LookupFlagByName(FlagName, Flag)) return false;
-	return SetFlag_Entity(WorldContextObject, EntityHandle, Flag, bDeferred, OnFinished);
+	if (LookupFlagByName(FlagName, Flag)) return SetFlag_Entity(WorldContextObject, EntityHandle, Flag, bDeferred, OnFinished);
+
+	const int32 Bit = UMassAPIFlagSettings::ResolveFlagBit(FlagName);
+	return (Bit != INDEX_NONE) && WriteFlagBitByName(WorldContextObject, EntityHandle, Bit, true, bDeferred, OnFinished);
 }
 
 void UMassAPIFuncLib::SetFlag_TemplateByName(const UObject* WorldContextObject, UPARAM(ref) FEntityTemplateData& TemplateData, FName FlagName)
@@ -1983,8 +2251,10 @@ void UMassAPIFuncLib::SetFlag_TemplateByName(const UObject* WorldContextObject,
 bool UMassAPIFuncLib::ClearFlag_EntityByName(const UObject* WorldContextObject, const FEntityHandle& EntityHandle, FName FlagName, bool bDeferred, FOnMassDeferredFinished OnFinished)
 {
 	EEntityFlags Flag;
-	if (!LookupFlagByName(FlagName, Flag)) return false;
-	return ClearFlag_Entity(WorldContextObject, EntityHandle, Flag, bDeferred, OnFinished);
+	if (LookupFlagByName(FlagName, Flag)) return ClearFlag_Entity(WorldContextObject, EntityHandle, Flag, bDeferred, OnFinished);
+
+	const int32 Bit = UMassAPIFlagSettings::ResolveFlagBit(FlagName);
+	return (Bit != INDEX_NONE) && WriteFlagBitByName(WorldContextObject, EntityHandle, Bit, false, bDeferred, OnFinished);
 }
 
 void UMassAPIFuncLib::ClearFlag_TemplateByName(const UObject* WorldContextObject, UPARAM(ref) FEntityTemplateData& TemplateData, FName FlagName)
@@ -1994,6 +2264,240 @@ void UMassAPIFuncLib::ClearFlag_TemplateByName(const UObject* WorldContextObject
 	ClearFlag_Template(WorldContextObject, TemplateData, Flag);
 }
 
+//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
+// Flag Operations (Pre-resolved Id) | 预解析旗标 ID 操作
+//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
+
+FEntityFlagId UMassAPIFuncLib::MakeFlagId(FName FlagName)
+{
+	return FEntityFlagId(FlagName);
+}
+
+bool UMassAPIFuncLib::IsFlagIdValid(const FEntityFlagId& FlagId)
+{
+	return FlagId.IsValid();
+}
+
+bool UMassAPIFuncLib::HasFlag_EntityById(const UObject* WorldContextObject, const FEntityHandle& EntityHandle, const FEntityFlagId& FlagId)
+{
+	const int32 Bit = FlagId.GetBit();
+	if (Bit == INDEX_NONE) return false;
+	if (Bit < 128) return HasFlag_Entity(WorldContextObject, EntityHandle, static_cast<EEntityFlags>(Bit));
+
+	UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject);
+	return MassAPI && MassAPI->HasEntityFlagBit(EntityHandle, Bit);
+}
+
+bool UMassAPIFuncLib::HasFlag_TemplateById(UPARAM(ref) const FEntityTemplateData& TemplateData, const FEntityFlagId& FlagId)
+{
+	const EEntityFlags Flag = FlagId.GetFlag();
+	return (Flag != EEntityFlags::EEntityFlags_MAX) && HasFlag_Template(TemplateData, Flag);
+}
+
+bool UMassAPIFuncLib::SetFlag_EntityById(const UObject* WorldContextObject, const FEntityHandle& EntityHandle, const FEntityFlagId& FlagId, bool bDeferred, FOnMassDeferredFinished OnFinished)
+{
+	const int32 Bit = FlagId.GetBit();
+	return (Bit != INDEX_NONE) && WriteFlagBitByName(WorldContextObject, EntityHandle, Bit, true, bDeferred, OnFinished);
+}
+
+void UMassAPIFuncLib::SetFlag_TemplateById(const UObject* WorldContextObject, UPARAM(ref) FEntityTemplateData& TemplateData, const FEntityFlagId& FlagId)
+{
+	const EEntityFlags Flag = FlagId.GetFlag();
+	if (Flag == EEntityFlags::EEntityFlags_MAX) return;
+	SetFlag_Template(WorldContextObject, TemplateData, Flag);
+}
+
+bool UMassAPIFuncLib::ClearFlag_EntityById(const UObject* WorldContextObject, const FEntityHandle& EntityHandle, const FEntityFlagId& FlagId, bool bDeferred, FOnMassDeferredFinished OnFinished)
+{
+	const int32 Bit = FlagId.GetBit();
+	return (Bit != INDEX_NONE) && WriteFlagBitByName(WorldContextObject, EntityHandle, Bit, false, bDeferred, OnFinished);
+}
+
+void UMassAPIFuncLib::ClearFlag_TemplateById(const UObject* WorldContextObject, UPARAM(ref) FEntityTemplateData& TemplateData, const FEntityFlagId& FlagId)
+{
+	const EEntityFlags Flag = FlagId.GetFlag();
+	if (Flag == EEntityFlags::EEntityFlags_MAX) return;
+	ClearFlag_Template(WorldContextObject, TemplateData, Flag);
+}
+
+//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
+// Flag Operations (Batch) | 批量旗标操作
+//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
+
+// Helper: EEntityFlags array → low/high masks | 旗标数组转换为低/高位掩码
+static void MakeFlagMask(const TArray<EEntityFlags>& Flags, int64& OutLow, int64& OutHigh)
+{
+	OutLow = 0;
+	OutHigh = 0;
+	for (const EEntityFlags Flag : Flags)
+	{
+		if (Flag >= EEntityFlags::EEntityFlags_MAX) continue;
+		const int64 Bit = (1LL << FEntityFlagFragment::GetLocalBitIndex(Flag));
+		(FEntityFlagFragment::IsHighFlag(Flag) ? OutHigh : OutLow) |= Bit;
+	}
+}
+
+int32 UMassAPIFuncLib::ApplyFlagMask(const UObject* WorldContextObject, const TArray<FEntityHandle>& EntityHandles, const TArray<EEntityFlags>& FlagsToSet, const TArray<EEntityFlags>& FlagsToClear, bool bDeferred)
+{
+	UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject);
+	if (!MassAPI || !MassAPI->GetEntityManager()) return 0;
+
+	int64 SetLow, SetHigh, ClearLow, ClearHigh;
+	MakeFlagMask(FlagsToSet, SetLow, SetHigh);
+	MakeFlagMask(FlagsToClear, ClearLow, ClearHigh);
+
+	TArray<FMassEntityHandle> Entities;
+	Entities.Reserve(EntityHandles.Num());
+	for (const FEntityHandle& Handle : EntityHandles)
+	{
+		Entities.Add(Handle);
+	}
+
+	if (bDeferred)
+	{
+		MassAPI->ApplyFlagMaskDefer(MassAPI->Defer(), MoveTemp(Entities), SetLow, SetHigh, ClearLow, ClearHigh);
+		return 0;
+	}
+	return MassAPI->ApplyFlagMask(Entities, SetLow, SetHigh, ClearLow, ClearHigh);
+}
+
+int32 UMassAPIFuncLib::SetFlagsBatch(const UObject* WorldContextObject, const TArray<FEntityHandle>& EntityHandles, const TArray<EEntityFlags>& Flags, bool bDeferred)
+{
+	return ApplyFlagMask(WorldContextObject, EntityHandles, Flags, TArray<EEntityFlags>(), bDeferred);
+}
+
+int32 UMassAPIFuncLib::ClearFlagsBatch(const UObject* WorldContextObject, const TArray<FEntityHandle>& EntityHandles, const TArray<EEntityFlags>& Flags, bool bDeferred)
+{
+	return ApplyFlagMask(WorldContextObject, EntityHandles, TArray<EEntityFlags>(), Flags, bDeferred);
+}
+
+int32 UMassAPIFuncLib::ApplyFlagMaskToQuery(const UObject* WorldContextObject, UPARAM(ref) const FEntityQuery& Query, const TArray<EEntityFlags>& FlagsToSet, const TArray<EEntityFlags>& FlagsToClear, bool bDeferred)
+{
+	UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject);
+	if (!MassAPI || !MassAPI->GetEntityManager()) return 0;
+
+	int64 SetLow, SetHigh, ClearLow, ClearHigh;
+	MakeFlagMask(FlagsToSet, SetLow, SetHigh);
+	MakeFlagMask(FlagsToClear, ClearLow, ClearHigh);
+
+	if (bDeferred)
+	{
+		MassAPI->ApplyFlagMaskDefer(MassAPI->Defer(), Query, SetLow, SetHigh, ClearLow, ClearHigh);
+		return 0;
+	}
+	return MassAPI->ApplyFlagMask(Query, SetLow, SetHigh, ClearLow, ClearHigh);
+}
+
+//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
+// Flag Index | 旗标索引
+//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
+
+TArray<FEntityHandle> UMassAPIFuncLib::GetEntitiesWithFlag(const UObject* WorldContextObject, EEntityFlags Flag)
+{
+	TArray<FEntityHandle> BPHandles;
+
+	UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject);
+	if (!MassAPI || !MassAPI->GetEntityManager()) return BPHandles;
+
+	TArray<FMassEntityHandle> Matches;
+	MassAPI->GetEntitiesWithFlag(Flag, Matches);
+
+	BPHandles.Reserve(Matches.Num());
+	for (const FMassEntityHandle& Handle : Matches)
+	{
+		BPHandles.Add(FEntityHandle(Handle));
+	}
+
+	return BPHandles;
+}
+
+void UMassAPIFuncLib::SetFlagIndexEnabled(const UObject* WorldContextObject, bool bEnabled)
+{
+	if (UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject))
+	{
+		MassAPI->SetFlagIndexEnabled(bEnabled);
+	}
+}
+
+//================ Flag Change Tracking																	========
+
+int64 UMassAPIFuncLib::GetFlagChangeEpoch(const UObject* WorldContextObject)
+{
+	const UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject);
+	return MassAPI ? static_cast<int64>(MassAPI->GetFlagChangeEpoch()) : 0;
+}
+
+//================ Timed Flags																					========
+
+bool UMassAPIFuncLib::SetFlagForDuration(const UObject* WorldContextObject, const FEntityHandle& EntityHandle, EEntityFlags Flag, float Duration)
+{
+	UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject);
+	if (!MassAPI || !MassAPI->IsValid(EntityHandle)) return false;
+
+	return MassAPI->SetFlagForDuration(EntityHandle, Flag, Duration);
+}
+
+void UMassAPIFuncLib::ScheduleFlagChange(const UObject* WorldContextObject, const FEntityHandle& EntityHandle, EEntityFlags Flag, bool bValue, float Delay)
+{
+	UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject);
+	if (!MassAPI || !MassAPI->IsValid(EntityHandle)) return;
+
+	MassAPI->ScheduleFlagChange(EntityHandle, Flag, bValue, Delay);
+}
+
+//================ Flag Observers																					========
+
+int32 UMassAPIFuncLib::RegisterFlagObserver(const UObject* WorldContextObject, const TArray<EEntityFlags>& Flags, FOnMassFlagsChanged OnChanged)
+{
+	UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject);
+	if (!MassAPI || !MassAPI->GetEntityManager()) return INDEX_NONE;
+
+	// Converted to Blueprint handles once per batch | 每批只转换一次句柄
+	return MassAPI->RegisterFlagObserver(Flags, FOnEntityFlagsChanged::CreateLambda([OnChanged](const TConstArrayView<FMassEntityHandle> SetEntities, const TConstArrayView<FMassEntityHandle> ClearedEntities)
+		{
+			auto ToBPHandles = [](const TConstArrayView<FMassEntityHandle> Entities)
+				{
+					TArray<FEntityHandle> BPHandles;
+					BPHandles.Reserve(Entities.Num());
+					for (const FMassEntityHandle& Entity : Entities)
+					{
+						BPHandles.Add(FEntityHandle(Entity));
+					}
+					return BPHandles;
+				};
+			OnChanged.ExecuteIfBound(ToBPHandles(SetEntities), ToBPHandles(ClearedEntities));
+		}));
+}
+
+void UMassAPIFuncLib::UnregisterFlagObserver(const UObject* WorldContextObject, int32 ObserverId)
+{
+	if (UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject))
+	{
+		MassAPI->UnregisterFlagObserver(ObserverId);
+	}
+}
+
+//———————— Get.FlagMigrationStats																					————
+
+FEntityFlagMigrationStats UMassAPIFuncLib::GetFlagMigrationStats(const UObject* WorldContextObject, EEntityFlags Flag)
+{
+	if (const UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject))
+	{
+		return MassAPI->GetFlagMigrationStats(Flag);
+	}
+	return FEntityFlagMigrationStats();
+}
+
+//———————— Reset.FlagMigrationStats																				————
+
+void UMassAPIFuncLib::ResetFlagMigrationStats(const UObject* WorldContextObject)
+{
+	if (const UMassAPISubsystem* MassAPI = UMassAPISubsystem::GetPtr(WorldContextObject))
+	{
+		MassAPI->ResetFlagMigrationStats();
+	}
+}
+
 //——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
 // Deprecated Functions
 //——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
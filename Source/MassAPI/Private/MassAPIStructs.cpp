@@ -85,5 +85,155 @@ void FEntityTemplate::GetTemplateData(FMassEntityTemplateData& OutTemplateData,
 
 		// Add the fragment to the composition and store its initial value (the calculated bitmasks)
 		OutTemplateData.AddFragment(FConstStructView::Make(FlagFragment));
+
+		// Wider flag widths carry bits 128+ in an extension fragment | 更宽的旗标宽度附加扩展片段
+		if (const UScriptStruct* ExtFragmentType = UMassAPIFlagSettings::GetFlagExtFragmentType())
+		{
+			OutTemplateData.AddFragment(*ExtFragmentType);
+		}
+
+		// Per-chunk OR/AND summary so flag queries can skip whole chunks | 每个 Chunk 的旗标摘要，供查询整块跳过
+		if (GetDefault<UMassAPIFlagSettings>()->bEnableFlagChunkSummary)
+		{
+			OutTemplateData.AddChunkFragment<FEntityFlagChunkFragment>();
+		}
+
+		// Last flag change epoch and bits, for changed-since queries | 最近一次旗标变化，供变更查询
+		if (GetDefault<UMassAPIFlagSettings>()->bEnableFlagChangeTracking)
+		{
+			OutTemplateData.AddFragment<FEntityFlagChangeFragment>();
+		}
+
+		// Initial tag-backed flags start with their mirror tag | 初始的标签镜像旗标直接带上镜像标签
+		for (const EEntityFlags Flag : Flags)
+		{
+			if (const UScriptStruct* MirrorTag = UMassAPIFlagSettings::GetFlagMirrorTag(static_cast<int32>(Flag)))
+			{
+				TEMPLATE_ADD_TAG(OutTemplateData, MirrorTag);
+			}
+		}
 	}
-}
\ No newline at end of file
+}
+
+FMassEntityTemplateData* FEntityTemplateData::GetMutable()
+{
+	if (!DataPtr.IsValid()) return nullptr;
+	if (DataPtr.IsUnique()) return DataPtr.Get();
+
+	// Same composition, so the copy starts from the shared cache's archetype | 组合相同，副本沿用原型缓存
+	DataPtr = MakeShared<FMassEntityTemplateData>(*DataPtr);
+	ArchetypeCache = ArchetypeCache.IsValid() ? MakeShared<FEntityTemplateArchetypeCache>(*ArchetypeCache) : MakeShared<FEntityTemplateArchetypeCache>();
+	return DataPtr.Get();
+}
+
+FMassArchetypeHandle FEntityTemplateData::GetArchetype(FMassEntityManager& Manager) const
+{
+	FMassEntityTemplateData* Data = DataPtr.Get();
+	if (!Data || !ArchetypeCache.IsValid()) return FMassArchetypeHandle();
+
+	FEntityTemplateArchetypeCache& Cache = *ArchetypeCache;
+	if (Cache.Archetype.IsValid() && Cache.Manager.HasSameObject(&Manager))
+	{
+		return Cache.Archetype;
+	}
+
+	if (!Cache.bSorted)
+	{
+		Data->Sort();
+		Cache.bSorted = true;
+	}
+	Cache.Archetype = Manager.CreateArchetype(Data->GetCompositionDescriptor(), Data->GetArchetypeCreationParams());
+	Cache.Manager = Manager.AsShared();
+	return Cache.Archetype;
+}
+
+bool FCompiledFragmentMember::Resolve(const FStructRecursiveMemberReference& Reference, FCompiledFragmentMember& OutMember)
+{
+	OutMember = FCompiledFragmentMember();
+
+	const UScriptStruct* FragmentType = Reference.StructType.Get();
+	if (!FragmentType || !FragmentType->IsChildOf(FMassFragment::StaticStruct()) || Reference.MemberPaths.Num() == 0)
+	{
+		UE_LOG(LogMassAPI, Warning, TEXT("Fragment member reference needs an FMassFragment type and a member path (%s)."), *Reference.GetFullDescription());
+		return false;
+	}
+
+	// Walk the path once, summing member offsets | 逐级解析路径并累加偏移
+	const FString& MemberPath = Reference.MemberPaths[0];
+	TArray<FString> PathParts;
+	MemberPath.ParseIntoArray(PathParts, TEXT("."), true);
+
+	const UStruct* CurrentStruct = FragmentType;
+	const FProperty* Property = nullptr;
+	int32 Offset = 0;
+	for (int32 PartIt = 0; PartIt < PathParts.Num(); ++PartIt)
+	{
+		Property = StructMemberHelper::FindPropertyInStruct(CurrentStruct, FName(*PathParts[PartIt]));
+		if (!Property || Property->ArrayDim != 1)
+		{
+			Property = nullptr;
+			break;
+		}
+		Offset += Property->GetOffset_ForInternal();
+
+		if (PartIt < PathParts.Num() - 1)
+		{
+			const FStructProperty* StructProperty = CastField<FStructProperty>(Property);
+			if (!StructProperty || !StructProperty->Struct)
+			{
+				Property = nullptr;
+				break;
+			}
+			CurrentStruct = StructProperty->Struct;
+		}
+	}
+
+	if (!Property)
+	{
+		UE_LOG(LogMassAPI, Warning, TEXT("Fragment member '%s' not found in %s."), *MemberPath, *FragmentType->GetName());
+		return false;
+	}
+
+	// Enums compare on their underlying integer | 枚举按底层整数比较
+	if (const FEnumProperty* EnumProperty = CastField<FEnumProperty>(Property))
+	{
+		Property = EnumProperty->GetUnderlyingProperty();
+	}
+
+	EEntityPredicateValueType ValueType = EEntityPredicateValueType::Invalid;
+	if (const FBoolProperty* BoolProperty = CastField<FBoolProperty>(Property))
+	{
+		// Bitfield bools cannot be read through a plain offset | 位域 bool 无法按偏移读取
+		if (BoolProperty->IsNativeBool()) ValueType = EEntityPredicateValueType::Bool;
+	}
+	else if (Property->IsA<FInt8Property>())	{ ValueType = EEntityPredicateValueType::Int8; }
+	else if (Property->IsA<FByteProperty>())	{ ValueType = EEntityPredicateValueType::UInt8; }
+	else if (Property->IsA<FInt16Property>())	{ ValueType = EEntityPredicateValueType::Int16; }
+	else if (Property->IsA<FUInt16Property>())	{ ValueType = EEntityPredicateValueType::UInt16; }
+	else if (Property->IsA<FIntProperty>())		{ ValueType = EEntityPredicateValueType::Int32; }
+	else if (Property->IsA<FUInt32Property>())	{ ValueType = EEntityPredicateValueType::UInt32; }
+	else if (Property->IsA<FInt64Property>())	{ ValueType = EEntityPredicateValueType::Int64; }
+	else if (Property->IsA<FUInt64Property>())	{ ValueType = EEntityPredicateValueType::UInt64; }
+	else if (Property->IsA<FFloatProperty>())	{ ValueType = EEntityPredicateValueType::Float; }
+	else if (Property->IsA<FDoubleProperty>())	{ ValueType = EEntityPredicateValueType::Double; }
+
+	if (ValueType == EEntityPredicateValueType::Invalid)
+	{
+		UE_LOG(LogMassAPI, Warning, TEXT("Fragment member '%s' of %s is not a bool, integer, float, double or enum."), *MemberPath, *FragmentType->GetName());
+		return false;
+	}
+
+	OutMember.FragmentType = FragmentType;
+	OutMember.Offset = Offset;
+	OutMember.Stride = FragmentType->GetStructureSize();
+	OutMember.ValueType = ValueType;
+	return true;
+}
+
+bool FEntityFragmentPredicate::Compile(FCompiledFragmentPredicate& OutPredicate) const
+{
+	OutPredicate = FCompiledFragmentPredicate();
+	OutPredicate.Op = Op;
+	OutPredicate.Value = Value;
+	return FCompiledFragmentMember::Resolve(Member, OutPredicate.Member);
+}
@@ -11,25 +11,46 @@
 #include "MassAPIFuncLib.h"
 #include "MassEntityQuery.h"
 #include "MassEntitySubsystem.h"
-
-// Define a log category for MassAPI, or use LogTemp if you prefer.
-DEFINE_LOG_CATEGORY_STATIC(LogMassAPI, Log, All);
+#include "Async/ParallelFor.h"
+#include "StructUtils/StructUtils.h"
 
 void UMassAPISubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
 	Super::Initialize(Collection);
 	Collection.InitializeDependency<UMassEntitySubsystem>();
 	GetEntityManager();
-	UE_LOG(LogTemp, Log, TEXT("MassAPISubsystem Initialized."));
+	SetFlagIndexEnabled(GetDefault<UMassAPIFlagSettings>()->bEnableFlagIndex);
+	bFlagChangeTrackingEnabled = GetDefault<UMassAPIFlagSettings>()->bEnableFlagChangeTracking;
+	FlagChangeEpoch = 1;
+	UMassAPIFlagSettings::GetTagBackedMask(TagBackedFlagsLow, TagBackedFlagsHigh);
+	const bool bCollectAll = GetDefault<UMassAPIFlagSettings>()->bCollectFlagMigrationStats;
+	MigrationStatFlagsLow = bCollectAll ? ~0LL : TagBackedFlagsLow;
+	MigrationStatFlagsHigh = bCollectAll ? ~0LL : TagBackedFlagsHigh;
+	UE_LOG(LogMassAPI, Log, TEXT("MassAPISubsystem Initialized."));
 }
 
 void UMassAPISubsystem::Deinitialize()
 {
+	QueryCache.Reset();
+	LiveQueries.Reset();
+	FlagArchetypeWrites.Reset();
+	FlagIndex.Reset();
+	FlagIndexedChunks.Reset();
+	bFlagIndexEnabled = false;
+	bFlagChangeTrackingEnabled = false;
+	FlagTimers.Reset();
+	FlagTimerGenerations.Reset();
+	FlagObservers.Reset();
+	ObservedFlagsLow = ObservedFlagsHigh = 0;
+	PendingFlagMirrors.Reset();
+	BuildSignatureArchetypes.Reset();
+	TagBackedFlagsLow = TagBackedFlagsHigh = 0;
+	MigrationStatFlagsLow = MigrationStatFlagsHigh = 0;
 	EntityManager = nullptr;
 	MassEntitySubsystem = nullptr;
 	CurrentWorld = nullptr;
 	Super::Deinitialize();
-	UE_LOG(LogTemp, Log, TEXT("MassAPISubsystem Deinitialized."));
+	UE_LOG(LogMassAPI, Log, TEXT("MassAPISubsystem Deinitialized."));
 }
 
 TStatId UMassAPISubsystem::GetStatId() const
@@ -106,339 +127,2462 @@ void UMassAPISubsystem::Tick(float DeltaTime)
 	{
 		EntityManager->FlushCommands();
 	}
-}
 
-TArray<FMassEntityHandle> UMassAPISubsystem::BuildEntities(int32 Quantity, FMassEntityTemplateData& TemplateData) const
-{
-	TArray<FMassEntityHandle> SpawnedEntities;
-	FMassEntityManager* Manager = GetEntityManager();
-	checkf(Manager, TEXT("EntityManager is not available"));
+	// Timed flag changes due this frame, applied before live queries and epochs observe the frame | 应用本帧到期的定时旗标
+	FlushFlagTimers(DeltaTime);
 
-	// Validate input
-	if (Quantity <= 0)
+	// Mirror tags of tag-backed flags written this frame, migrated in one batched command | 本帧镜像旗标的标签迁移，合并为一条命令
+	if ((TagBackedFlagsLow | TagBackedFlagsHigh) != 0)
 	{
-		return SpawnedEntities;
+		FlushFlagMirrors();
 	}
 
-	TemplateData.Sort();
-
-	// Create an archetype from the MODIFIED template data composition
-	FMassArchetypeHandle ArchetypeHandle = Manager->CreateArchetype
-	(
-		TemplateData.GetCompositionDescriptor(),
-		TemplateData.GetArchetypeCreationParams()
-	);
-
-	// Check if archetype creation was successful
-	if (!ArchetypeHandle.IsValid())
+	// One batched callback per flag observer for everything that flipped since last tick | 每个观察者批量回调一次
+	if (FlagObservers.Num() > 0)
 	{
-		return SpawnedEntities;
+		DispatchFlagObservers();
 	}
 
-	// Get shared fragment values from the template
-	const FMassArchetypeSharedFragmentValues& SharedFragmentValues = TemplateData.GetSharedFragmentValues();
-
-	// Batch create entities with the archetype and shared fragments
-	TSharedRef<FMassEntityManager::FEntityCreationContext> CreationContext =
-		Manager->BatchCreateEntities(ArchetypeHandle, SharedFragmentValues, Quantity, SpawnedEntities);
-
-	// Set initial fragment values if provided
-	TConstArrayView<FInstancedStruct> InitialFragmentValues = TemplateData.GetInitialFragmentValues();
-
-	if (InitialFragmentValues.Num() > 0)
+	// Live queries read this epoch's flag writes, so refresh them before it closes | 在纪元结束前刷新实时查询
+	if (EntityManager && LiveQueries.Num() > 0)
 	{
-		// Create entity collection for the spawned entities
-		TArray<FMassArchetypeEntityCollection> EntityCollections;
-
-		UE::Mass::Utils::CreateEntityCollections
-		(
-			*Manager,
-			SpawnedEntities,
-			FMassArchetypeEntityCollection::NoDuplicates,
-			EntityCollections
-		);
-
-		// Apply initial fragment values to all spawned entities
-		Manager->BatchSetEntityFragmentValues(EntityCollections, InitialFragmentValues);
+		for (TPair<int32, FEntityLiveQuery>& Pair : LiveQueries)
+		{
+			RefreshLiveQuery(Pair.Value);
+		}
 	}
 
-	return SpawnedEntities;
-}
-
-FMassEntityHandle UMassAPISubsystem::BuildEntity(FMassEntityTemplateData& TemplateData) const
-{
-	auto Handles = BuildEntities(1, TemplateData);
+	// Changes from here on belong to the next frame | 此后的旗标变化属于下一帧
+	++FlagChangeEpoch;
 
-	if (!Handles.IsEmpty())
+	// Start a new flag write epoch: chunk summaries of written archetypes rebuild on next query | 开启新写入纪元
+	FWriteScopeLock WriteLock(FlagArchetypeWritesLock);
+	for (TPair<FMassArchetypeHandle, FEntityFlagArchetypeWrites>& Pair : FlagArchetypeWrites)
 	{
-		return Handles[0];
+		FEntityFlagArchetypeWrites& Writes = Pair.Value;
+		if (Writes.HasWrites())
+		{
+			Writes.SetLow = Writes.SetHigh = Writes.ClearLow = Writes.ClearHigh = 0;
+			++Writes.Epoch;
+		}
+		Writes.bExtWrites = false;
 	}
-	else
+
+	// Evict cached queries nobody asked for recently | 清除长时间未使用的缓存查询
+	if (QueryCache.Num() > 0)
 	{
-		return FMassEntityHandle();
+		const uint64 CurrentFrame = GFrameCounter;
+		for (auto It = QueryCache.CreateIterator(); It; ++It)
+		{
+			It.Value().RemoveAll([CurrentFrame](const FEntityQueryCacheEntry& Entry)
+				{
+					return CurrentFrame - Entry.LastUsedFrame > QueryCacheEvictionFrames;
+				});
+			if (It.Value().Num() == 0)
+			{
+				It.RemoveCurrent();
+			}
+		}
 	}
 }
 
-FMassEntityHandle UMassAPISubsystem::BuildEntityDefer(FMassExecutionContext& Context, FMassEntityTemplateData& TemplateData) const
+//----------------------------------------------------------------------//
+// Query Cache | 查询缓存
+//----------------------------------------------------------------------//
+
+FMassEntityQuery& UMassAPISubsystem::GetCachedNativeQuery(const FEntityQuery& Query) const
 {
-	FMassEntityManager* Manager = GetEntityManager();
-	checkf(Manager, TEXT("EntityManager is not available"));
+	TArray<const UScriptStruct*> AllStructs, AnyStructs, NoneStructs;
+	Query.GatherRequirementStructs(AllStructs, AnyStructs, NoneStructs);
 
-	// 1. Reserve entity handle
-	const FMassEntityHandle ReservedEntity = Manager->ReserveEntity();
-	const FMassArchetypeCompositionDescriptor Composition = TemplateData.GetCompositionDescriptor();
-	const FMassArchetypeCreationParams CreationParams = TemplateData.GetArchetypeCreationParams();
-	const FMassArchetypeSharedFragmentValues SharedValues = TemplateData.GetSharedFragmentValues();
-	const TArray<FInstancedStruct> InitialFragments(TemplateData.GetInitialFragmentValues());
+	EMassFragmentPresence FlagPresence = EMassFragmentPresence::None;
+	const bool bReadsFlags = Query.GetFlagFragmentPresence(FlagPresence);
 
-	// 3. Push deferred creation command
-	Context.Defer().PushCommand<FMassDeferredCreateCommand>([ReservedEntity, Composition, CreationParams, SharedValues, InitialFragments](FMassEntityManager& Manager)
-		{
-			// Get or create archetype (using the modified Composition)
-			const FMassArchetypeHandle ArchetypeHandle = Manager.CreateArchetype(Composition, CreationParams);
-			if (!ArchetypeHandle.IsValid())
-			{
-				// If archetype creation fails, release the reserved entity to prevent leaks
-				Manager.ReleaseReservedEntity(ReservedEntity);
-				return;
-			}
+	return FindOrAddCachedQuery(Query.GetNativeQueryKey(), AllStructs, AnyStructs, NoneStructs, bReadsFlags, FlagPresence,
+		[&Query](FMassEntityQuery& NativeQuery) { Query.ConfigureQuery(NativeQuery); });
+}
 
-			// Build entity with archetype and shared fragments
-			Manager.BuildEntity(ReservedEntity, ArchetypeHandle, SharedValues);
+FMassEntityQuery& UMassAPISubsystem::GetCachedNativeQuery(const FCompiledEntityQuery& Query) const
+{
+	EMassFragmentPresence FlagPresence = EMassFragmentPresence::None;
+	const bool bReadsFlags = Query.GetFlagFragmentPresence(FlagPresence);
 
-			// Set initial fragment values
-			if (InitialFragments.Num() > 0)
-			{
-				Manager.SetEntityFragmentValues(ReservedEntity, InitialFragments);
-			}
-		});
+	return FindOrAddCachedQuery(Query.GetNativeQueryKey(), Query.GetAllStructs(), Query.GetAnyStructs(), Query.GetNoneStructs(), bReadsFlags, FlagPresence,
+		[&Query](FMassEntityQuery& NativeQuery) { Query.ConfigureQuery(NativeQuery); });
+}
 
-	return ReservedEntity;
+static bool SameStructs(const TArray<const UScriptStruct*>& Cached, const TConstArrayView<const UScriptStruct*> Structs)
+{
+	return Cached.Num() == Structs.Num() && CompareItems(Cached.GetData(), Structs.GetData(), Structs.Num());
 }
 
-FMassEntityHandle UMassAPISubsystem::BuildEntityDefer(FMassCommandBuffer& CommandBuffer, FMassEntityTemplateData& TemplateData) const
+TSharedRef<const FCompiledEntityQuery> UMassAPISubsystem::GetCachedCompiledQuery(const FEntityQuery& Query, const TConstArrayView<const UScriptStruct*> ReadFragments) const
 {
-	FMassEntityManager* Manager = GetEntityManager();
-	checkf(Manager, TEXT("EntityManager is not available"));
+	const int32 RegistryVersion = UMassAPIFlagSettings::GetRegistryVersion();
 
-	// 1. Reserve entity handle
-	const FMassEntityHandle ReservedEntity = Manager->ReserveEntity();
+	TArray<const UScriptStruct*> AllStructs, AnyStructs, NoneStructs;
+	Query.GatherRequirementStructs(AllStructs, AnyStructs, NoneStructs);
+	EMassFragmentPresence FlagPresence = EMassFragmentPresence::None;
+	const bool bReadsFlags = Query.GetFlagFragmentPresence(FlagPresence);
 
-	TemplateData.Sort();
-	const FMassArchetypeCompositionDescriptor Composition = TemplateData.GetCompositionDescriptor();
-	const FMassArchetypeCreationParams CreationParams = TemplateData.GetArchetypeCreationParams();
-	const FMassArchetypeSharedFragmentValues SharedValues = TemplateData.GetSharedFragmentValues();
-	const TArray<FInstancedStruct> InitialFragments(TemplateData.GetInitialFragmentValues());
+	FEntityQueryCacheEntry& Entry = FindOrAddCacheEntry(Query.GetNativeQueryKey(), AllStructs, AnyStructs, NoneStructs, bReadsFlags, FlagPresence);
+	Entry.LastUsedFrame = GFrameCounter;
 
-	// 3. Push deferred creation command
-	CommandBuffer.PushCommand<FMassDeferredCreateCommand>([ReservedEntity, Composition, CreationParams, SharedValues, InitialFragments](FMassEntityManager& Manager)
+	// Same key does not mean same query: masks, WHERE values and epochs are compared field by field | 同键不代表同一查询，逐字段比较
+	for (int32 SlotIt = Entry.CompiledQueries.Num() - 1; SlotIt >= 0; --SlotIt)
+	{
+		const FEntityCompiledQuerySlot& Slot = Entry.CompiledQueries[SlotIt];
+		if (Slot.RegistryVersion == RegistryVersion
+			&& SameStructs(Slot.ReadFragments, ReadFragments)
+			&& FEntityQuery::StaticStruct()->CompareScriptStruct(&Slot.Source, &Query, PPF_None))
 		{
-			// Get or create archetype (using the modified Composition)
-			const FMassArchetypeHandle ArchetypeHandle = Manager.CreateArchetype(Composition, CreationParams);
-			if (!ArchetypeHandle.IsValid())
-			{
-				// If archetype creation fails, release the reserved entity to prevent leaks
-				Manager.ReleaseReservedEntity(ReservedEntity);
-				return;
-			}
+			return Slot.Compiled.ToSharedRef();
+		}
+	}
 
-			// Build entity with archetype and shared fragments
-			Manager.BuildEntity(ReservedEntity, ArchetypeHandle, SharedValues);
+	if (Entry.CompiledQueries.Num() >= MaxCompiledQueriesPerKey)
+	{
+		Entry.CompiledQueries.RemoveAt(0);
+	}
 
-			// Set initial fragment values
-			if (InitialFragments.Num() > 0)
-			{
-				Manager.SetEntityFragmentValues(ReservedEntity, InitialFragments);
-			}
-		});
+	FEntityCompiledQuerySlot& Slot = Entry.CompiledQueries.AddDefaulted_GetRef();
+	Slot.Source = Query;
+	Slot.ReadFragments = ReadFragments;
+	Slot.RegistryVersion = RegistryVersion;
+	Slot.Compiled = MakeShared<const FCompiledEntityQuery>(Query.Compile(ReadFragments));
+	return Slot.Compiled.ToSharedRef();
+}
 
-	return ReservedEntity;
+FEntityQueryCacheEntry& UMassAPISubsystem::FindOrAddCacheEntry(const uint32 Key, const TConstArrayView<const UScriptStruct*> AllStructs,
+	const TConstArrayView<const UScriptStruct*> AnyStructs, const TConstArrayView<const UScriptStruct*> NoneStructs,
+	const bool bReadsFlags, const EMassFragmentPresence FlagPresence) const
+{
+	// A key shared by different requirement sets keeps one entry per set, so colliding queries never evict each other | 同键不同需求各占一个条目，冲突的查询互不覆盖
+	TArray<FEntityQueryCacheEntry, TInlineAllocator<1>>& Entries = QueryCache.FindOrAdd(Key);
+	for (FEntityQueryCacheEntry& Entry : Entries)
+	{
+		if (Entry.bReadsFlags == bReadsFlags
+			&& Entry.FlagPresence == FlagPresence
+			&& SameStructs(Entry.AllStructs, AllStructs)
+			&& SameStructs(Entry.AnyStructs, AnyStructs)
+			&& SameStructs(Entry.NoneStructs, NoneStructs))
+		{
+			return Entry;
+		}
+	}
+
+	FEntityQueryCacheEntry& Entry = Entries.AddDefaulted_GetRef();
+	Entry.AllStructs = AllStructs;
+	Entry.AnyStructs = AnyStructs;
+	Entry.NoneStructs = NoneStructs;
+	Entry.bReadsFlags = bReadsFlags;
+	Entry.FlagPresence = FlagPresence;
+	return Entry;
 }
 
-void UMassAPISubsystem::BuildEntitiesDefer(FMassExecutionContext& Context, int32 Quantity, FMassEntityTemplateData& TemplateData, TArray<FMassEntityHandle>& OutEntities) const
+FMassEntityQuery& UMassAPISubsystem::FindOrAddCachedQuery(const uint32 Key, const TConstArrayView<const UScriptStruct*> AllStructs,
+	const TConstArrayView<const UScriptStruct*> AnyStructs, const TConstArrayView<const UScriptStruct*> NoneStructs,
+	const bool bReadsFlags, const EMassFragmentPresence FlagPresence, const TFunctionRef<void(FMassEntityQuery&)> Configure) const
 {
 	FMassEntityManager* Manager = GetEntityManager();
 	checkf(Manager, TEXT("EntityManager is not available"));
 
-	// 1. Batch reserve entities
-	TArray<FMassEntityHandle> ReservedEntities;
-	ReservedEntities.AddUninitialized(Quantity);
-	Manager->BatchReserveEntities(MakeArrayView(ReservedEntities));
-
-	// Add reserved handles to the output array
-	OutEntities.Append(ReservedEntities);
-
-	const FMassArchetypeCompositionDescriptor Composition = TemplateData.GetCompositionDescriptor();
-	const FMassArchetypeCreationParams CreationParams = TemplateData.GetArchetypeCreationParams();
-	const FMassArchetypeSharedFragmentValues SharedValues = TemplateData.GetSharedFragmentValues();
-	const TArray<FInstancedStruct> InitialFragments(TemplateData.GetInitialFragmentValues());
+	FEntityQueryCacheEntry& Entry = FindOrAddCacheEntry(Key, AllStructs, AnyStructs, NoneStructs, bReadsFlags, FlagPresence);
 
-	// 3. Push deferred creation command
-	Context.Defer().PushCommand<FMassDeferredCreateCommand>([ReservedEntities, Composition, CreationParams, SharedValues, InitialFragments](FMassEntityManager& Manager)
+	// Built on first use and kept for as long as the entry lives | 首次使用时构建，随条目保留
+	if (!Entry.NativeQuery.IsValid())
+	{
+		Entry.NativeQuery = MakeShared<FMassEntityQuery>(Manager->AsShared());
+		Configure(*Entry.NativeQuery);
+		if (bReadsFlags)
 		{
-			// Get or create archetype (using the modified Composition)
-			const FMassArchetypeHandle ArchetypeHandle = Manager.CreateArchetype(Composition, CreationParams);
-			if (!ArchetypeHandle.IsValid())
-			{
-				// If archetype creation fails, release all reserved entities
-				for (const FMassEntityHandle& Entity : ReservedEntities)
-				{
-					Manager.ReleaseReservedEntity(Entity);
-				}
-				return;
-			}
-
-			// Batch build reserved entities
-			Manager.BatchCreateReservedEntities(ArchetypeHandle, SharedValues, ReservedEntities);
+			Entry.NativeQuery->AddRequirement<FEntityFlagFragment>(EMassFragmentAccess::ReadOnly, FlagPresence);
+			Entry.NativeQuery->AddChunkRequirement<FEntityFlagChunkFragment>(EMassFragmentAccess::ReadWrite, EMassFragmentPresence::Optional);
+		}
+	}
 
-			// Batch set initial fragment values
-			if (InitialFragments.Num() > 0)
-			{
-				TArray<FMassArchetypeEntityCollection> EntityCollections;
-				UE::Mass::Utils::CreateEntityCollections(Manager, ReservedEntities, FMassArchetypeEntityCollection::NoDuplicates, EntityCollections);
-				Manager.BatchSetEntityFragmentValues(EntityCollections, InitialFragments);
-			}
-		});
+	Entry.LastUsedFrame = GFrameCounter;
+	return *Entry.NativeQuery;
 }
 
-void UMassAPISubsystem::BuildEntitiesDefer(FMassCommandBuffer& CommandBuffer, int32 Quantity, FMassEntityTemplateData& TemplateData, TArray<FMassEntityHandle>& OutEntities) const
+// Chunk-level verdict derived from FEntityFlagChunkFragment | 基于 Chunk 摘要的判定
+enum class EFlagChunkVerdict : uint8
 {
-	FMassEntityManager* Manager = GetEntityManager();
-	checkf(Manager, TEXT("EntityManager is not available"));
-
-	// 1. Batch reserve entities
-	TArray<FMassEntityHandle> ReservedEntities;
-	ReservedEntities.AddUninitialized(Quantity);
-	Manager->BatchReserveEntities(MakeArrayView(ReservedEntities));
+	Scan,		// Summary inconclusive or stale, test every lane | 摘要不确定或过期，逐个测试
+	Reject,		// No entity in the chunk can pass | 整块跳过
+	Accept		// Every entity in the chunk passes | 整块通过
+};
+
+/**
+ * Resolves the chunk's flag summary against the query mask.
+ * Returns the summary when it is stale so the caller can rebuild it during its lane scan, nullptr otherwise.
+ * | 用摘要判定整个 Chunk；摘要过期时返回其指针，由调用方在逐个扫描时重建
+ */
+static FEntityFlagChunkFragment* EvaluateFlagChunkSummary(FMassExecutionContext& Context, const FEntityFlagQueryMask& Mask,
+	const TMap<FMassArchetypeHandle, FEntityFlagArchetypeWrites>& WritesMap, const uint32 Generation, EFlagChunkVerdict& OutVerdict, uint32& OutEpoch)
+{
+	OutVerdict = EFlagChunkVerdict::Scan;
+	OutEpoch = 1;
 
-	// Add reserved handles to the output array
-	OutEntities.Append(ReservedEntities);
+	FEntityFlagChunkFragment* Summary = Context.GetMutableChunkFragmentPtr<FEntityFlagChunkFragment>();
+	if (!Summary) return nullptr;
 
-	const FMassArchetypeCompositionDescriptor Composition = TemplateData.GetCompositionDescriptor();
-	const FMassArchetypeCreationParams CreationParams = TemplateData.GetArchetypeCreationParams();
-	const FMassArchetypeSharedFragmentValues SharedValues = TemplateData.GetSharedFragmentValues();
-	const TArray<FInstancedStruct> InitialFragments(TemplateData.GetInitialFragmentValues());
+	const FEntityFlagArchetypeWrites* Writes = WritesMap.Find(Context.GetEntityCollection().GetArchetype());
+	OutEpoch = Writes ? Writes->Epoch : 1;
 
-	// 3. Push deferred creation command
-	CommandBuffer.PushCommand<FMassDeferredCreateCommand>([ReservedEntities, Composition, CreationParams, SharedValues, InitialFragments](FMassEntityManager& Manager)
-		{
-			// Get or create archetype (using the modified Composition)
-			const FMassArchetypeHandle ArchetypeHandle = Manager.CreateArchetype(Composition, CreationParams);
-			if (!ArchetypeHandle.IsValid())
-			{
-				// If archetype creation fails, release all reserved entities
-				for (const FMassEntityHandle& Entity : ReservedEntities)
-				{
-					Manager.ReleaseReservedEntity(Entity);
-				}
-				return;
-			}
+	if (!Summary->IsBuiltFor(Context.GetChunkSerialModificationNumber(), OutEpoch, Generation))
+	{
+		return Summary;
+	}
 
-			// Batch build reserved entities
-			Manager.BatchCreateReservedEntities(ArchetypeHandle, SharedValues, ReservedEntities);
+	// Widen the bounds by what was written since the summary was built | 用本纪元写入放宽上下界
+	const int64 OrLow = Summary->OrLow | (Writes ? Writes->SetLow : 0);
+	const int64 OrHigh = Summary->OrHigh | (Writes ? Writes->SetHigh : 0);
+	const int64 AndLow = Summary->AndLow & ~(Writes ? Writes->ClearLow : 0);
+	const int64 AndHigh = Summary->AndHigh & ~(Writes ? Writes->ClearHigh : 0);
 
-			// Batch set initial fragment values
-			if (InitialFragments.Num() > 0)
-			{
-				TArray<FMassArchetypeEntityCollection> EntityCollections;
-				UE::Mass::Utils::CreateEntityCollections(Manager, ReservedEntities, FMassArchetypeEntityCollection::NoDuplicates, EntityCollections);
-				Manager.BatchSetEntityFragmentValues(EntityCollections, InitialFragments);
-			}
-		});
+	if (!Mask.CanAnyPass(OrLow, OrHigh, AndLow, AndHigh))
+	{
+		OutVerdict = EFlagChunkVerdict::Reject;
+	}
+	else if (Mask.MustAllPass(OrLow, OrHigh, AndLow, AndHigh))
+	{
+		OutVerdict = EFlagChunkVerdict::Accept;
+	}
+	return nullptr;
 }
 
-//----------------------------------------------------------------------//
-// (新) Flag Fragment Operations
-//----------------------------------------------------------------------//
+// Helper: the chunk's flag column, empty if its archetype has none (also when the query lists the fragment as None,
+// which leaves it unbound) so such chunks read as flags == 0 | Chunk 的旗标列；原型没有该片段（含 None 排除）时为空，按旗标为 0 处理
+static TConstArrayView<FEntityFlagFragment> GetFlagColumn(const FMassExecutionContext& Context)
+{
+	if (!Context.DoesArchetypeHaveFragment<FEntityFlagFragment>()) return TConstArrayView<FEntityFlagFragment>();
+	return Context.GetFragmentView<FEntityFlagFragment>();
+}
 
-int64 UMassAPISubsystem::GetEntityFlags(FMassEntityHandle EntityHandle) const
+// OR/AND of every lane seen during a scan, used to rebuild a stale chunk summary | 扫描时累积的 OR/AND，用于重建摘要
+struct FFlagLaneSummary
 {
-	FMassEntityManager* Manager = GetEntityManager();
-	if (!Manager || !Manager->IsEntityValid(EntityHandle))
-	{
-		return 0;
-	}
+	int64 OrLow = 0;
+	int64 OrHigh = 0;
+	int64 AndLow = ~0LL;
+	int64 AndHigh = ~0LL;
+};
+
+// A summary rebuilt during a scan, stored once the scan has released its read lock | 扫描中重建、释放读锁后再写入的摘要
+struct FPendingFlagChunkSummary
+{
+	FEntityFlagChunkFragment* Summary = nullptr;
+	int32 ChunkSerial = 0;
+	uint32 Epoch = 0;
+	FFlagLaneSummary Lanes;
+};
+
+/**
+ * Stores rebuilt summaries under the write lock. Queries evaluate summaries under the read lock, so chunk memory is
+ * never written while another query reads it. Generation is the one read when the scan started, so a summary scanned
+ * before an invalidation stays stale. | 在写锁下写入重建的摘要；查询持读锁读取，Chunk 内存不会被并发读写
+ */
+static void StoreFlagChunkSummaries(FRWLock& Lock, const uint32 Generation, const TConstArrayView<FPendingFlagChunkSummary> Pending)
+{
+	if (Pending.Num() == 0) return;
 
-	if (const FEntityFlagFragment* FlagFragment = Manager->GetFragmentDataPtr<FEntityFlagFragment>(EntityHandle))
+	FWriteScopeLock WriteLock(Lock);
+	for (const FPendingFlagChunkSummary& Entry : Pending)
 	{
-		return FlagFragment->Flags;
+		FEntityFlagChunkFragment& Summary = *Entry.Summary;
+		Summary.OrLow = Entry.Lanes.OrLow;
+		Summary.OrHigh = Entry.Lanes.OrHigh;
+		Summary.AndLow = Entry.Lanes.AndLow;
+		Summary.AndHigh = Entry.Lanes.AndHigh;
+		Summary.ChunkSerial = Entry.ChunkSerial;
+		Summary.WriteEpoch = Entry.Epoch;
+		Summary.Generation = Generation;
 	}
-
-	// Log a warning if the fragment is missing
-	UE_LOG(LogMassAPI, Warning, TEXT("GetEntityFlags: Entity does not have FEntityFlagFragment. Add the fragment to the entity template or manually."));
-	return 0;
 }
 
-int64 UMassAPISubsystem::GetEntityFlagsHigh(FMassEntityHandle EntityHandle) const
+/**
+ * Evaluates the flag column 64 lanes per word into pass bits and returns the number of passing lanes.
+ * | 每 64 个实体压成一个通过位字，返回通过数量
+ */
+static int32 EvaluateFlagLanes(const TConstArrayView<FEntityFlagFragment> FlagList, const FEntityFlagQueryMask& Mask, TArrayView<uint64> OutPassWords, FFlagLaneSummary& OutLanes)
 {
-	FMassEntityManager* Manager = GetEntityManager();
-	if (!Manager || !Manager->IsEntityValid(EntityHandle))
+	const int32 NumEntities = FlagList.Num();
+	int32 NumPassed = 0;
+	for (int32 WordIt = 0; WordIt < OutPassWords.Num(); ++WordIt)
 	{
-		return 0;
+		const int32 Base = WordIt * 64;
+		const int32 NumLanes = FMath::Min(64, NumEntities - Base);
+		uint64 Word = 0;
+		for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+		{
+			const FEntityFlagFragment& Flags = FlagList[Base + Lane];
+			Word |= static_cast<uint64>(Mask.Matches(Flags.Flags, Flags.FlagsHigh)) << Lane;
+			OutLanes.OrLow |= Flags.Flags; OutLanes.OrHigh |= Flags.FlagsHigh;
+			OutLanes.AndLow &= Flags.Flags; OutLanes.AndHigh &= Flags.FlagsHigh;
+		}
+		OutPassWords[WordIt] = Word;
+		NumPassed += FMath::CountBits(Word);
 	}
+	return NumPassed;
+}
 
-	if (const FEntityFlagFragment* FlagFragment = Manager->GetFragmentDataPtr<FEntityFlagFragment>(EntityHandle))
+// Appends the entities whose pass bit is set, in chunk order | 按 Chunk 顺序追加通过位为 1 的实体
+static void AppendPassingEntities(const TConstArrayView<FMassEntityHandle> Entities, const TConstArrayView<uint64> PassWords, TArray<FMassEntityHandle>& OutEntities)
+{
+	for (int32 WordIt = 0; WordIt < PassWords.Num(); ++WordIt)
 	{
-		return FlagFragment->FlagsHigh;
+		for (uint64 Word = PassWords[WordIt]; Word != 0; Word &= Word - 1)
+		{
+			OutEntities.Add(Entities[WordIt * 64 + static_cast<int32>(FMath::CountTrailingZeros64(Word))]);
+		}
 	}
-
-	// Log a warning if the fragment is missing
-	UE_LOG(LogMassAPI, Warning, TEXT("GetEntityFlagsHigh: Entity does not have FEntityFlagFragment. Add the fragment to the entity template or manually."));
-	return 0;
 }
 
-bool UMassAPISubsystem::HasEntityFlag(FMassEntityHandle EntityHandle, EEntityFlags FlagToTest) const
+// Sets one pass bit per entity of the chunk | 为 Chunk 内每个实体置通过位
+static void FillPassWords(TArray<uint64, TInlineAllocator<64>>& PassWords, const int32 NumEntities)
 {
-	// Validation handled inside fragment method, but we check validity here first
-	if (FlagToTest >= EEntityFlags::EEntityFlags_MAX)
+	PassWords.SetNumUninitialized(FMath::DivideAndRoundUp(NumEntities, 64));
+	for (int32 WordIt = 0; WordIt < PassWords.Num(); ++WordIt)
 	{
-		return false;
+		const int32 NumLanes = FMath::Min(64, NumEntities - WordIt * 64);
+		PassWords[WordIt] = NumLanes == 64 ? ~0ULL : ((1ULL << NumLanes) - 1);
 	}
+}
 
-	FMassEntityManager* Manager = GetEntityManager();
+/**
+ * ANDs every WHERE clause into PassWords, column by column, and returns the number of surviving lanes.
+ * Columns[i] is the fragment column read by Predicates[i] (nullptr if the predicate failed to compile).
+ * | 逐列把成员谓词按位与进通过位，返回剩余通过数量
+ */
+static int32 ApplyFragmentPredicates(const TConstArrayView<FCompiledFragmentPredicate> Predicates, const TConstArrayView<const uint8*> Columns,
+	const int32 NumEntities, TArrayView<uint64> PassWords)
+{
+	for (int32 PredicateIt = 0; PredicateIt < Predicates.Num(); ++PredicateIt)
+	{
+		if (Columns[PredicateIt])
+		{
+			Predicates[PredicateIt].EvaluateColumn(Columns[PredicateIt], NumEntities, PassWords);
+		}
+		else
+		{
+			for (uint64& Word : PassWords) { Word = 0; }
+		}
+	}
+
+	int32 NumPassed = 0;
+	for (const uint64 Word : PassWords)
+	{
+		NumPassed += FMath::CountBits(Word);
+	}
+	return NumPassed;
+}
+
+// Raw column pointer of each predicate's fragment in the current chunk | 当前 Chunk 中各谓词片段列的首地址
+static void GatherPredicateColumns(FMassExecutionContext& Context, const TConstArrayView<FCompiledFragmentPredicate> Predicates, TArray<const uint8*, TInlineAllocator<4>>& OutColumns)
+{
+	OutColumns.Reset();
+	for (const FCompiledFragmentPredicate& Predicate : Predicates)
+	{
+		OutColumns.Add(Predicate.Member.IsValid() ? reinterpret_cast<const uint8*>(Context.GetFragmentView(Predicate.Member.FragmentType).GetData()) : nullptr);
+	}
+}
+
+// Per-entity WHERE test, for handle-based matching | 单个实体的成员谓词测试
+static bool MatchFragmentPredicates(const FMassEntityManager& Manager, const FMassEntityHandle Entity, const TConstArrayView<FCompiledFragmentPredicate> Predicates)
+{
+	for (const FCompiledFragmentPredicate& Predicate : Predicates)
+	{
+		if (!Predicate.Member.IsValid()) return false;
+
+		const FStructView Fragment = Manager.GetFragmentDataStruct(Entity, Predicate.Member.FragmentType);
+		if (!Fragment.GetMemory() || !Predicate.Matches(Fragment.GetMemory())) return false;
+	}
+	return true;
+}
+
+void UMassAPISubsystem::VisitFlagFilteredChunks(const FEntityQuery& Query, FFlagChunkVisitor Visitor) const
+{
+	if (Query.HasPredicates())
+	{
+		VisitFlagFilteredChunks(*GetCachedCompiledQuery(Query), Visitor);
+		return;
+	}
+	VisitFlagFilteredChunks(GetCachedNativeQuery(Query), Query.GetFlagQueryMask(), {}, Visitor);
+}
+
+void UMassAPISubsystem::VisitFlagFilteredChunks(const FCompiledEntityQuery& Query, FFlagChunkVisitor Visitor) const
+{
+	VisitFlagFilteredChunks(GetCachedNativeQuery(Query), Query.GetFlagQueryMask(), Query.GetPredicates(), Visitor);
+}
+
+void UMassAPISubsystem::VisitFlagFilteredChunks(FMassEntityQuery& NativeQuery, const FEntityFlagQueryMask& Mask,
+	const TConstArrayView<FCompiledFragmentPredicate> Predicates, FFlagChunkVisitor Visitor) const
+{
+	FMassEntityManager* Manager = GetEntityManager();
+	checkf(Manager, TEXT("EntityManager is not available"));
+
+	const bool bNoFlags = Mask.IsEmpty();
+	const bool bEmptyFlagsPass = Mask.Matches(0, 0);
+	const bool bHasPredicates = Predicates.Num() > 0;
+	bool bStopped = false;
+
+	TArray<uint64, TInlineAllocator<64>> PassWords;
+	TArray<const uint8*, TInlineAllocator<4>> Columns;
+	TArray<FPendingFlagChunkSummary> RebuiltSummaries;
+	uint32 Generation = 0;
+
+	{
+		FReadScopeLock ReadLock(FlagArchetypeWritesLock);
+		Generation = FlagSummaryGeneration;
+		FMassExecutionContext ExecContext(*Manager, 0.f, /*bFlushDeferredCommands*/false);
+		NativeQuery.ForEachEntityChunk(ExecContext, [&](FMassExecutionContext& Context)
+			{
+				if (bStopped) return;
+
+				const int32 NumEntities = Context.GetNumEntities();
+				const TConstArrayView<FEntityFlagFragment> FlagList = bNoFlags ? TConstArrayView<FEntityFlagFragment>() : GetFlagColumn(Context);
+
+				// Whole chunk passed the flag stage: hand it over, or narrow it by the WHERE clauses | 整块通过旗标阶段
+				auto VisitWholeChunk = [&]()
+					{
+						if (!bHasPredicates)
+						{
+							bStopped = !Visitor(Context, TConstArrayView<uint64>(), NumEntities);
+							return;
+						}
+						FillPassWords(PassWords, NumEntities);
+						GatherPredicateColumns(Context, Predicates, Columns);
+						const int32 NumPassed = ApplyFragmentPredicates(Predicates, Columns, NumEntities, PassWords);
+						if (NumPassed > 0)
+						{
+							bStopped = !Visitor(Context, PassWords, NumPassed);
+						}
+					};
+
+				// No flag constraint, or archetype without the flag column (every lane has flags == 0) | 无旗标约束或无旗标列
+				if (FlagList.Num() == 0)
+				{
+					if (bNoFlags || bEmptyFlagsPass)
+					{
+						VisitWholeChunk();
+					}
+					return;
+				}
+
+				// Chunk summary: skip or accept the whole chunk without touching lanes | 用摘要整块跳过或接受
+				EFlagChunkVerdict Verdict;
+				uint32 Epoch;
+				FEntityFlagChunkFragment* StaleSummary = EvaluateFlagChunkSummary(Context, Mask, FlagArchetypeWrites, Generation, Verdict, Epoch);
+				if (Verdict == EFlagChunkVerdict::Reject)
+				{
+					return;
+				}
+				if (Verdict == EFlagChunkVerdict::Accept)
+				{
+					VisitWholeChunk();
+					return;
+				}
+
+				// Evaluate 64 lanes per word into pass bits, popcount as we go | 每 64 个实体压成一个通过位字并计数
+				PassWords.SetNumZeroed(FMath::DivideAndRoundUp(NumEntities, 64));
+				FFlagLaneSummary Lanes;
+				int32 NumPassed = EvaluateFlagLanes(FlagList, Mask, PassWords, Lanes);
+
+				if (StaleSummary)
+				{
+					RebuiltSummaries.Add({ StaleSummary, Context.GetChunkSerialModificationNumber(), Epoch, Lanes });
+				}
+
+				if (bHasPredicates && NumPassed > 0)
+				{
+					GatherPredicateColumns(Context, Predicates, Columns);
+					NumPassed = ApplyFragmentPredicates(Predicates, Columns, NumEntities, PassWords);
+				}
+
+				if (NumPassed > 0)
+				{
+					bStopped = !Visitor(Context, PassWords, NumPassed);
+				}
+			});
+	}
+
+	// Rebuilt summaries are written under the write lock, after the read lock is gone | 释放读锁后在写锁下写入重建的摘要
+	StoreFlagChunkSummaries(FlagArchetypeWritesLock, Generation, RebuiltSummaries);
+}
+
+void UMassAPISubsystem::GetMatchingEntities(const FEntityQuery& Query, TArray<FMassEntityHandle>& OutEntities) const
+{
+	// The index path needs the compiled composition for per-candidate checks | 索引路径需要编译后的 Composition 逐个确认
+	if (Query.HasPredicates() || (bFlagIndexEnabled && Query.GetFlagQueryMask().RequiresFlagFragment()))
+	{
+		GetMatchingEntities(*GetCachedCompiledQuery(Query), OutEntities);
+		return;
+	}
+	GetMatchingEntities(GetCachedNativeQuery(Query), Query.GetFlagQueryMask(), {}, OutEntities);
+}
+
+void UMassAPISubsystem::GetMatchingEntities(const FCompiledEntityQuery& Query, TArray<FMassEntityHandle>& OutEntities) const
+{
+	if (bFlagIndexEnabled && GetMatchingEntitiesFromFlagIndex(Query, OutEntities))
+	{
+		return;
+	}
+	GetMatchingEntities(GetCachedNativeQuery(Query), Query.GetFlagQueryMask(), Query.GetPredicates(), OutEntities);
+}
+
+void UMassAPISubsystem::GetMatchingEntities(FMassEntityQuery& NativeQuery, const FEntityFlagQueryMask& Mask,
+	const TConstArrayView<FCompiledFragmentPredicate> Predicates, TArray<FMassEntityHandle>& OutEntities) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("MassAPI_GetMatchingEntities");
+
+	// Fast Path: composition only, let Mass hand back the handles | 仅 Composition，直接交给 Mass
+	if (Mask.IsEmpty() && Predicates.Num() == 0)
+	{
+		OutEntities.Append(NativeQuery.GetMatchingEntityHandles());
+		return;
+	}
+
+	// Chunk Path: emit only the passing lanes | 按 Chunk 只输出通过的实体
+	VisitFlagFilteredChunks(NativeQuery, Mask, Predicates, [&OutEntities](FMassExecutionContext& Context, TConstArrayView<uint64> PassWords, int32 NumPassed)
+		{
+			const TConstArrayView<FMassEntityHandle> Entities = Context.GetEntities();
+			if (PassWords.Num() == 0)
+			{
+				OutEntities.Append(Entities.GetData(), Entities.Num());
+				return true;
+			}
+
+			OutEntities.Reserve(OutEntities.Num() + NumPassed);
+			AppendPassingEntities(Entities, PassWords, OutEntities);
+			return true;
+		});
+}
+
+void UMassAPISubsystem::GetMatchingEntitiesParallel(const FEntityQuery& Query, TArray<FMassEntityHandle>& OutEntities, const int32 SerialThreshold) const
+{
+	if (Query.HasPredicates())
+	{
+		GetMatchingEntitiesParallel(*GetCachedCompiledQuery(Query), OutEntities, SerialThreshold);
+		return;
+	}
+	GetMatchingEntitiesParallel(GetCachedNativeQuery(Query), Query.GetFlagQueryMask(), {}, OutEntities, SerialThreshold);
+}
+
+void UMassAPISubsystem::GetMatchingEntitiesParallel(const FCompiledEntityQuery& Query, TArray<FMassEntityHandle>& OutEntities, const int32 SerialThreshold) const
+{
+	GetMatchingEntitiesParallel(GetCachedNativeQuery(Query), Query.GetFlagQueryMask(), Query.GetPredicates(), OutEntities, SerialThreshold);
+}
+
+void UMassAPISubsystem::GetMatchingEntitiesParallel(FMassEntityQuery& NativeQuery, const FEntityFlagQueryMask& Mask,
+	const TConstArrayView<FCompiledFragmentPredicate> Predicates, TArray<FMassEntityHandle>& OutEntities, const int32 SerialThreshold) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("MassAPI_GetMatchingEntitiesParallel");
+
+	if (Mask.IsEmpty() && Predicates.Num() == 0)
+	{
+		OutEntities.Append(NativeQuery.GetMatchingEntityHandles());
+		return;
+	}
+
+	FMassEntityManager* Manager = GetEntityManager();
+	checkf(Manager, TEXT("EntityManager is not available"));
+
+	// One matching chunk, captured in archetype → chunk order | 按原型、Chunk 顺序记录的匹配 Chunk
+	struct FChunkTask
+	{
+		TConstArrayView<FMassEntityHandle> Entities;
+		TConstArrayView<FEntityFlagFragment> FlagList;
+		TArray<const uint8*, TInlineAllocator<4>> PredicateColumns;
+		FEntityFlagChunkFragment* StaleSummary = nullptr;
+		FFlagLaneSummary Lanes;
+		int32 ChunkSerial = 0;
+		uint32 Epoch = 0;
+		bool bAcceptAll = false;
+	};
+
+	// 1. Serial pass: resolve summaries and record the chunk views (no structural change can happen until we return)
+	TArray<FChunkTask> Tasks;
+	int32 NumCandidates = 0;
+	const bool bNoFlags = Mask.IsEmpty();
+	const bool bEmptyFlagsPass = Mask.Matches(0, 0);
+
+	uint32 Generation = 0;
+	{
+		FReadScopeLock ReadLock(FlagArchetypeWritesLock);
+		Generation = FlagSummaryGeneration;
+		FMassExecutionContext ExecContext(*Manager, 0.f, /*bFlushDeferredCommands*/false);
+		NativeQuery.ForEachEntityChunk(ExecContext, [&](FMassExecutionContext& Context)
+			{
+				const TConstArrayView<FEntityFlagFragment> FlagList = bNoFlags ? TConstArrayView<FEntityFlagFragment>() : GetFlagColumn(Context);
+				if (FlagList.Num() == 0 && !bEmptyFlagsPass) return;
+
+				EFlagChunkVerdict Verdict = EFlagChunkVerdict::Accept;
+				uint32 Epoch = 1;
+				FEntityFlagChunkFragment* StaleSummary = nullptr;
+				if (FlagList.Num() > 0)
+				{
+					StaleSummary = EvaluateFlagChunkSummary(Context, Mask, FlagArchetypeWrites, Generation, Verdict, Epoch);
+					if (Verdict == EFlagChunkVerdict::Reject) return;
+				}
+
+				FChunkTask& Task = Tasks.AddDefaulted_GetRef();
+				Task.Entities = Context.GetEntities();
+				Task.FlagList = FlagList;
+				GatherPredicateColumns(Context, Predicates, Task.PredicateColumns);
+				Task.StaleSummary = StaleSummary;
+				Task.ChunkSerial = Context.GetChunkSerialModificationNumber();
+				Task.Epoch = Epoch;
+				Task.bAcceptAll = (Verdict == EFlagChunkVerdict::Accept);
+				NumCandidates += Task.Entities.Num();
+			});
+	}
+
+	// 2. Per-chunk evaluation into its own buffer | 每个 Chunk 求值到各自的缓冲区
+	auto EvaluateTask = [&Mask, Predicates](FChunkTask& Task, TArray<FMassEntityHandle>& Out)
+		{
+			const int32 NumEntities = Task.Entities.Num();
+			if (Task.bAcceptAll && Predicates.Num() == 0)
+			{
+				Out.Append(Task.Entities.GetData(), NumEntities);
+				return;
+			}
+
+			TArray<uint64, TInlineAllocator<64>> PassWords;
+			int32 NumPassed = NumEntities;
+			if (Task.bAcceptAll)
+			{
+				FillPassWords(PassWords, NumEntities);
+			}
+			else
+			{
+				PassWords.AddZeroed(FMath::DivideAndRoundUp(NumEntities, 64));
+				NumPassed = EvaluateFlagLanes(Task.FlagList, Mask, PassWords, Task.Lanes);
+			}
+			if (Predicates.Num() > 0 && NumPassed > 0)
+			{
+				NumPassed = ApplyFragmentPredicates(Predicates, Task.PredicateColumns, NumEntities, PassWords);
+			}
+			Out.Reserve(Out.Num() + NumPassed);
+			AppendPassingEntities(Task.Entities, PassWords, Out);
+		};
+
+	// Summaries rebuilt by the workers are stored serially, under the write lock | 工作线程重建的摘要串行地在写锁下写入
+	auto StoreRebuiltSummaries = [&]()
+		{
+			TArray<FPendingFlagChunkSummary> RebuiltSummaries;
+			for (const FChunkTask& Task : Tasks)
+			{
+				if (Task.StaleSummary && !Task.bAcceptAll)
+				{
+					RebuiltSummaries.Add({ Task.StaleSummary, Task.ChunkSerial, Task.Epoch, Task.Lanes });
+				}
+			}
+			StoreFlagChunkSummaries(FlagArchetypeWritesLock, Generation, RebuiltSummaries);
+		};
+
+	// Small result sets are not worth waking the workers | 候选较少时保持串行
+	if (NumCandidates < SerialThreshold || Tasks.Num() < 2)
+	{
+		OutEntities.Reserve(OutEntities.Num() + NumCandidates);
+		for (FChunkTask& Task : Tasks)
+		{
+			EvaluateTask(Task, OutEntities);
+		}
+		StoreRebuiltSummaries();
+		return;
+	}
+
+	// 3. Contiguous chunk ranges per batch, concatenated in batch order → deterministic output | 按批次顺序拼接，结果确定
+	const int32 NumBatches = FMath::Min(Tasks.Num(), FMath::Max(1, FTaskGraphInterface::Get().GetNumWorkerThreads() + 1));
+	const int32 TasksPerBatch = FMath::DivideAndRoundUp(Tasks.Num(), NumBatches);
+	TArray<TArray<FMassEntityHandle>> BatchResults;
+	BatchResults.SetNum(NumBatches);
+
+	ParallelFor(NumBatches, [&](const int32 BatchIndex)
+		{
+			const int32 First = BatchIndex * TasksPerBatch;
+			const int32 Last = FMath::Min(First + TasksPerBatch, Tasks.Num());
+			for (int32 TaskIt = First; TaskIt < Last; ++TaskIt)
+			{
+				EvaluateTask(Tasks[TaskIt], BatchResults[BatchIndex]);
+			}
+		});
+
+	int32 NumResults = 0;
+	for (const TArray<FMassEntityHandle>& Batch : BatchResults)
+	{
+		NumResults += Batch.Num();
+	}
+	OutEntities.Reserve(OutEntities.Num() + NumResults);
+	for (const TArray<FMassEntityHandle>& Batch : BatchResults)
+	{
+		OutEntities.Append(Batch);
+	}
+	StoreRebuiltSummaries();
+}
+
+int32 UMassAPISubsystem::CountMatchingEntities(const FEntityQuery& Query) const
+{
+	if (Query.HasPredicates())
+	{
+		return CountMatchingEntities(*GetCachedCompiledQuery(Query));
+	}
+	return CountMatchingEntities(GetCachedNativeQuery(Query), Query.GetFlagQueryMask(), {});
+}
+
+int32 UMassAPISubsystem::CountMatchingEntities(const FCompiledEntityQuery& Query) const
+{
+	return CountMatchingEntities(GetCachedNativeQuery(Query), Query.GetFlagQueryMask(), Query.GetPredicates());
+}
+
+int32 UMassAPISubsystem::CountMatchingEntities(FMassEntityQuery& NativeQuery, const FEntityFlagQueryMask& Mask, const TConstArrayView<FCompiledFragmentPredicate> Predicates) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("MassAPI_CountMatchingEntities");
+
+	if (Mask.IsEmpty() && Predicates.Num() == 0)
+	{
+		return NativeQuery.GetNumMatchingEntities();
+	}
+
+	int32 Count = 0;
+	VisitFlagFilteredChunks(NativeQuery, Mask, Predicates, [&Count](FMassExecutionContext&, TConstArrayView<uint64>, int32 NumPassed)
+		{
+			Count += NumPassed;
+			return true;
+		});
+	return Count;
+}
+
+bool UMassAPISubsystem::AnyMatchingEntities(const FEntityQuery& Query) const
+{
+	if (Query.HasPredicates())
+	{
+		return AnyMatchingEntities(*GetCachedCompiledQuery(Query));
+	}
+	return AnyMatchingEntities(GetCachedNativeQuery(Query), Query.GetFlagQueryMask(), {});
+}
+
+bool UMassAPISubsystem::AnyMatchingEntities(const FCompiledEntityQuery& Query) const
+{
+	return AnyMatchingEntities(GetCachedNativeQuery(Query), Query.GetFlagQueryMask(), Query.GetPredicates());
+}
+
+bool UMassAPISubsystem::AnyMatchingEntities(FMassEntityQuery& NativeQuery, const FEntityFlagQueryMask& Mask, const TConstArrayView<FCompiledFragmentPredicate> Predicates) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("MassAPI_AnyMatchingEntities");
+
+	bool bFound = false;
+	VisitFlagFilteredChunks(NativeQuery, Mask, Predicates, [&bFound](FMassExecutionContext&, TConstArrayView<uint64>, int32 NumPassed)
+		{
+			bFound = NumPassed > 0;
+			return !bFound;
+		});
+	return bFound;
+}
+
+// Bit-sliced counters for one flag word: Slices[j] holds bit j of all 64 per-flag counters, so adding a lane is a
+// ripple carry over a few words. Flushed into Totals before any counter can overflow. | 位切片计数器：每层保存 64 个计数器的一位，溢出前刷新到总数
+struct FFlagBitSliceCounter
+{
+	static constexpr int32 NumSlices = 8;
+	static constexpr int32 MaxPending = (1 << NumSlices) - 1;
+
+	uint64 Slices[NumSlices] = {};
+	int32 NumPending = 0;
+
+	FORCEINLINE void Add(uint64 Word, int32* Totals)
+	{
+		for (int32 Slice = 0; Word != 0 && Slice < NumSlices; ++Slice)
+		{
+			const uint64 Carry = Slices[Slice] & Word;
+			Slices[Slice] ^= Word;
+			Word = Carry;
+		}
+		if (++NumPending == MaxPending) Flush(Totals);
+	}
+
+	void Flush(int32* Totals)
+	{
+		for (int32 Slice = 0; Slice < NumSlices; ++Slice)
+		{
+			uint64 Word = Slices[Slice];
+			while (Word)
+			{
+				Totals[FMath::CountTrailingZeros64(Word)] += (1 << Slice);
+				Word &= Word - 1;
+			}
+			Slices[Slice] = 0;
+		}
+		NumPending = 0;
+	}
+};
+
+void UMassAPISubsystem::GetFlagHistogram(const FEntityQuery& Query, TArray<int32>& OutCounts) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("MassAPI_GetFlagHistogram");
+
+	OutCounts.Reset();
+	OutCounts.SetNumZeroed(128);
+
+	FFlagBitSliceCounter LowCounter, HighCounter;
+	int32* LowTotals = OutCounts.GetData();
+	int32* HighTotals = OutCounts.GetData() + 64;
+
+	// The flag column joins the requirements, entities without it contribute nothing | 旗标列加入需求，无旗标的实体不计数
+	VisitFlagFilteredChunks(*GetCachedCompiledQuery(Query, { FEntityFlagFragment::StaticStruct() }),
+		[&](FMassExecutionContext& Context, TConstArrayView<uint64> PassWords, int32 NumPassed)
+		{
+			const TConstArrayView<FEntityFlagFragment> FlagList = GetFlagColumn(Context);
+			if (FlagList.Num() == 0) return true;
+
+			auto AddLane = [&](const int32 EntityIt)
+				{
+					const FEntityFlagFragment& Flags = FlagList[EntityIt];
+					if (Flags.Flags) LowCounter.Add(static_cast<uint64>(Flags.Flags), LowTotals);
+					if (Flags.FlagsHigh) HighCounter.Add(static_cast<uint64>(Flags.FlagsHigh), HighTotals);
+				};
+
+			if (PassWords.Num() == 0)
+			{
+				for (int32 EntityIt = 0; EntityIt < FlagList.Num(); ++EntityIt) { AddLane(EntityIt); }
+				return true;
+			}
+			for (int32 WordIt = 0; WordIt < PassWords.Num(); ++WordIt)
+			{
+				uint64 Word = PassWords[WordIt];
+				while (Word)
+				{
+					AddLane(WordIt * 64 + static_cast<int32>(FMath::CountTrailingZeros64(Word)));
+					Word &= Word - 1;
+				}
+			}
+			return true;
+		});
+
+	LowCounter.Flush(LowTotals);
+	HighCounter.Flush(HighTotals);
+}
+
+// Sort key of one entity; ties fall back to the entity index | 排序键，同值按实体索引
+struct FEntitySortKey
+{
+	double Value;
+	FMassEntityHandle Entity;
+};
+
+static FORCEINLINE bool SortKeyBefore(const FEntitySortKey& A, const FEntitySortKey& B, const bool bDescending)
+{
+	if (A.Value != B.Value)
+	{
+		return bDescending ? A.Value > B.Value : A.Value < B.Value;
+	}
+	return A.Entity.Index < B.Entity.Index;
+}
+
+// Reads the sort member of every passing lane of the chunk | 读取 Chunk 中所有通过实体的排序成员
+template<typename TEmit>
+static void ForEachSortKey(FMassExecutionContext& Context, const FCompiledFragmentMember& Member, const TConstArrayView<uint64> PassWords, TEmit&& Emit)
+{
+	const uint8* Column = reinterpret_cast<const uint8*>(Context.GetFragmentView(Member.FragmentType).GetData());
+	if (!Column) return;
+
+	const TConstArrayView<FMassEntityHandle> Entities = Context.GetEntities();
+	if (PassWords.Num() == 0)
+	{
+		for (int32 EntityIt = 0; EntityIt < Entities.Num(); ++EntityIt)
+		{
+			Emit(FEntitySortKey{ Member.ReadAt(Column, EntityIt), Entities[EntityIt] });
+		}
+		return;
+	}
+
+	for (int32 WordIt = 0; WordIt < PassWords.Num(); ++WordIt)
+	{
+		uint64 Word = PassWords[WordIt];
+		while (Word)
+		{
+			const int32 EntityIt = WordIt * 64 + static_cast<int32>(FMath::CountTrailingZeros64(Word));
+			Word &= Word - 1;
+			Emit(FEntitySortKey{ Member.ReadAt(Column, EntityIt), Entities[EntityIt] });
+		}
+	}
+}
+
+static void WriteSortedKeys(const TConstArrayView<FEntitySortKey> Keys, TArray<FMassEntityHandle>& OutEntities, TArray<double>* OutValues)
+{
+	OutEntities.Reserve(OutEntities.Num() + Keys.Num());
+	if (OutValues) OutValues->Reserve(OutValues->Num() + Keys.Num());
+	for (const FEntitySortKey& Key : Keys)
+	{
+		OutEntities.Add(Key.Entity);
+		if (OutValues) OutValues->Add(Key.Value);
+	}
+}
+
+void UMassAPISubsystem::GetTopKMatchingEntities(const FEntityQuery& Query, const FStructRecursiveMemberReference& SortMember, const int32 K, const bool bDescending,
+	TArray<FMassEntityHandle>& OutEntities, TArray<double>* OutValues) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("MassAPI_GetTopKMatchingEntities");
+
+	OutEntities.Reset();
+	if (OutValues) OutValues->Reset();
+
+	FCompiledFragmentMember Member;
+	if (K <= 0 || !FCompiledFragmentMember::Resolve(SortMember, Member)) return;
+
+	// Heap top is the worst of the K kept so far | 堆顶为当前保留的最差元素
+	const auto WorseFirst = [bDescending](const FEntitySortKey& A, const FEntitySortKey& B) { return SortKeyBefore(B, A, bDescending); };
+	TArray<FEntitySortKey> Heap;
+	Heap.Reserve(K);
+
+	VisitFlagFilteredChunks(*GetCachedCompiledQuery(Query, { Member.FragmentType }), [&](FMassExecutionContext& Context, TConstArrayView<uint64> PassWords, int32)
+		{
+			ForEachSortKey(Context, Member, PassWords, [&](const FEntitySortKey& Key)
+				{
+					if (Heap.Num() < K)
+					{
+						Heap.HeapPush(Key, WorseFirst);
+					}
+					else if (SortKeyBefore(Key, Heap.HeapTop(), bDescending))
+					{
+						Heap.HeapPopDiscard(WorseFirst);
+						Heap.HeapPush(Key, WorseFirst);
+					}
+				});
+			return true;
+		});
+
+	Heap.Sort([bDescending](const FEntitySortKey& A, const FEntitySortKey& B) { return SortKeyBefore(A, B, bDescending); });
+	WriteSortedKeys(Heap, OutEntities, OutValues);
+}
+
+void UMassAPISubsystem::GetMatchingEntitiesSorted(const FEntityQuery& Query, const FStructRecursiveMemberReference& SortMember, const bool bDescending,
+	TArray<FMassEntityHandle>& OutEntities, TArray<double>* OutValues) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("MassAPI_GetMatchingEntitiesSorted");
+
+	OutEntities.Reset();
+	if (OutValues) OutValues->Reset();
+
+	FCompiledFragmentMember Member;
+	if (!FCompiledFragmentMember::Resolve(SortMember, Member)) return;
+
+	TArray<FEntitySortKey> Keys;
+	VisitFlagFilteredChunks(*GetCachedCompiledQuery(Query, { Member.FragmentType }), [&](FMassExecutionContext& Context, TConstArrayView<uint64> PassWords, int32 NumPassed)
+		{
+			Keys.Reserve(Keys.Num() + NumPassed);
+			ForEachSortKey(Context, Member, PassWords, [&Keys](const FEntitySortKey& Key) { Keys.Add(Key); });
+			return true;
+		});
+
+	Keys.Sort([bDescending](const FEntitySortKey& A, const FEntitySortKey& B) { return SortKeyBefore(A, B, bDescending); });
+	WriteSortedKeys(Keys, OutEntities, OutValues);
+}
+
+// Shared by the FEntityQuery and FCompiledEntityQuery overloads | 两种查询类型共用
+template<typename TQuery>
+static void MatchQueryBatchImpl(const FMassEntityManager* Manager, const TConstArrayView<FEntityHandle> EntityHandles, const TQuery& Query,
+	const TConstArrayView<FCompiledFragmentPredicate> Predicates, TBitArray<>& OutMatches)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("MassAPI_MatchQueryBatch");
+
+	checkf(Manager, TEXT("EntityManager is not available"));
+
+	OutMatches.Init(false, EntityHandles.Num());
+
+	const FEntityFlagQueryMask Mask = Query.GetFlagQueryMask();
+	const bool bEmptyFlagsPass = Mask.Matches(0, 0);
+
+	// What an archetype's entities still need once its composition is known | 原型确定后实体还需要的检查
+	enum class EArchetypeVerdict : uint8 { Reject, Accept, CheckFlags };
+
+	// Inputs usually span a handful of archetypes, and neighbours often share one | 输入通常只涉及少数原型
+	TMap<FMassArchetypeHandle, EArchetypeVerdict> Verdicts;
+	FMassArchetypeHandle LastArchetype;
+	EArchetypeVerdict LastVerdict = EArchetypeVerdict::Reject;
+
+	for (int32 EntityIt = 0; EntityIt < EntityHandles.Num(); ++EntityIt)
+	{
+		const FMassEntityHandle Entity = EntityHandles[EntityIt];
+		if (UNLIKELY(!Manager->IsEntityActive(Entity))) continue;
+
+		const FMassArchetypeHandle Archetype = Manager->GetArchetypeForEntity(Entity);
+		if (UNLIKELY(!Archetype.IsValid())) continue;
+
+		if (Archetype != LastArchetype)
+		{
+			if (const EArchetypeVerdict* Found = Verdicts.Find(Archetype))
+			{
+				LastVerdict = *Found;
+			}
+			else
+			{
+				const FMassArchetypeCompositionDescriptor& Composition = Manager->GetArchetypeComposition(Archetype);
+				if (!UMassAPISubsystem::MatchQuery(Composition, Query))
+				{
+					LastVerdict = EArchetypeVerdict::Reject;
+				}
+				else if (Mask.IsEmpty())
+				{
+					LastVerdict = EArchetypeVerdict::Accept;
+				}
+				else if (!CONTAINS_T_FRAGMENT(Composition, FEntityFlagFragment))
+				{
+					// No flag column: every entity reads as all-zero flags | 无旗标列，按全 0 处理
+					LastVerdict = bEmptyFlagsPass ? EArchetypeVerdict::Accept : EArchetypeVerdict::Reject;
+				}
+				else
+				{
+					LastVerdict = EArchetypeVerdict::CheckFlags;
+				}
+				Verdicts.Add(Archetype, LastVerdict);
+			}
+			LastArchetype = Archetype;
+		}
+
+		bool bPass = (LastVerdict == EArchetypeVerdict::Accept);
+		if (LastVerdict == EArchetypeVerdict::CheckFlags)
+		{
+			const FEntityFlagFragment* FlagFragment = Manager->GetFragmentDataPtr<FEntityFlagFragment>(Entity);
+			bPass = FlagFragment ? Mask.Matches(*FlagFragment) : bEmptyFlagsPass;
+		}
+		if (bPass && Predicates.Num() > 0)
+		{
+			bPass = MatchFragmentPredicates(*Manager, Entity, Predicates);
+		}
+		OutMatches[EntityIt] = bPass;
+	}
+}
+
+void UMassAPISubsystem::MatchQueryBatch(const TConstArrayView<FEntityHandle> EntityHandles, const FEntityQuery& Query, TBitArray<>& OutMatches) const
+{
+	if (Query.HasPredicates())
+	{
+		MatchQueryBatch(EntityHandles, *GetCachedCompiledQuery(Query), OutMatches);
+		return;
+	}
+	MatchQueryBatchImpl(GetEntityManager(), EntityHandles, Query, {}, OutMatches);
+}
+
+void UMassAPISubsystem::MatchQueryBatch(const TConstArrayView<FEntityHandle> EntityHandles, const FCompiledEntityQuery& Query, TBitArray<>& OutMatches) const
+{
+	MatchQueryBatchImpl(GetEntityManager(), EntityHandles, Query, Query.GetPredicates(), OutMatches);
+}
+
+bool UMassAPISubsystem::MatchQueryPredicates(const FEntityHandle EntityHandle, const FCompiledEntityQuery& Query) const
+{
+	FMassEntityManager* Manager = GetEntityManager();
+	checkf(Manager, TEXT("EntityManager is not available"));
+
+	return MatchFragmentPredicates(*Manager, EntityHandle, Query.GetPredicates());
+}
+
+//----------------------------------------------------------------------//
+// Live Query | 实时查询
+//----------------------------------------------------------------------//
+
+int32 UMassAPISubsystem::RegisterLiveQuery(const FEntityQuery& Query)
+{
+	return RegisterLiveQuery(Query.Compile());
+}
+
+int32 UMassAPISubsystem::RegisterLiveQuery(const FCompiledEntityQuery& Query)
+{
+	const int32 LiveQueryId = NextLiveQueryId++;
+	FEntityLiveQuery& LiveQuery = LiveQueries.Add(LiveQueryId);
+	LiveQuery.Query = Query;
+	RefreshLiveQuery(LiveQuery);
+	return LiveQueryId;
+}
+
+void UMassAPISubsystem::UnregisterLiveQuery(const int32 LiveQueryId)
+{
+	LiveQueries.Remove(LiveQueryId);
+}
+
+void UMassAPISubsystem::RefreshLiveQuery(FEntityLiveQuery& LiveQuery) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("MassAPI_RefreshLiveQuery");
+
+	FMassEntityManager* Manager = GetEntityManager();
+	checkf(Manager, TEXT("EntityManager is not available"));
+
+	const uint64 Refresh = ++LiveQuery.RefreshCount;
+	LiveQuery.Added.Reset();
+	LiveQuery.Removed.Reset();
+
+	const FEntityFlagQueryMask& Mask = LiveQuery.Query.GetFlagQueryMask();
+	const TConstArrayView<FCompiledFragmentPredicate> Predicates = LiveQuery.Query.GetPredicates();
+	const bool bNoFlags = Mask.IsEmpty();
+	const bool bEmptyFlagsPass = Mask.Matches(0, 0);
+
+	// Bits whose writes can change this query's result: the flag mask plus what change filters watch | 写入后可能改变结果的旗标位
+	int64 WatchedLow = Mask.AllLow | Mask.AnyLow | Mask.NoneLow;
+	int64 WatchedHigh = Mask.AllHigh | Mask.AnyHigh | Mask.NoneHigh;
+	bool bWatchesExt = false;
+	for (const FCompiledFragmentPredicate& Predicate : Predicates)
+	{
+		if (!Predicate.bFlagChangeFilter) continue;
+		if ((Predicate.ChangedMaskLow | Predicate.ChangedMaskHigh) == 0)
+		{
+			WatchedLow = WatchedHigh = ~static_cast<int64>(0);
+			bWatchesExt = true;
+		}
+		else
+		{
+			WatchedLow |= Predicate.ChangedMaskLow;
+			WatchedHigh |= Predicate.ChangedMaskHigh;
+		}
+	}
+
+	// Flag writes leave the chunk serial alone, so the archetypes MassAPI recorded writes for this epoch are rescanned
+	// | 旗标写入不改变 Chunk 序号，因此重扫本纪元内被 MassAPI 写入过相关位的原型
+	bool bInvalidated = false;
+	TSet<FMassArchetypeHandle, DefaultKeyFuncs<FMassArchetypeHandle>, TInlineSetAllocator<16>> WrittenArchetypes;
+	{
+		FReadScopeLock ReadLock(FlagArchetypeWritesLock);
+		bInvalidated = LiveQuery.Generation != LiveQueryGeneration;
+		LiveQuery.Generation = LiveQueryGeneration;
+
+		if (!bInvalidated && ((WatchedLow | WatchedHigh) != 0 || bWatchesExt))
+		{
+			for (const TPair<FMassArchetypeHandle, FEntityFlagArchetypeWrites>& Pair : FlagArchetypeWrites)
+			{
+				const FEntityFlagArchetypeWrites& Writes = Pair.Value;
+				if ((((Writes.SetLow | Writes.ClearLow) & WatchedLow) | ((Writes.SetHigh | Writes.ClearHigh) & WatchedHigh)) != 0 || (bWatchesExt && Writes.bExtWrites))
+				{
+					WrittenArchetypes.Add(Pair.Key);
+				}
+			}
+		}
+	}
+
+	TArray<uint64, TInlineAllocator<64>> PassWords;
+	TArray<const uint8*, TInlineAllocator<4>> Columns;
+
+	// Entities leaving / entering a rescanned chunk; resolved against the set afterwards | 离开与进入的候选，最后统一结算
+	TArray<FMassEntityHandle> Left;
+	TArray<FMassEntityHandle> Entered;
+
+	{
+		FMassExecutionContext ExecContext(*Manager, 0.f, /*bFlushDeferredCommands*/false);
+		GetCachedNativeQuery(LiveQuery.Query).ForEachEntityChunk(ExecContext, [&](FMassExecutionContext& Context)
+			{
+				const TConstArrayView<FMassEntityHandle> Entities = Context.GetEntities();
+				const FMassArchetypeHandle Archetype = Context.GetEntityCollection().GetArchetype();
+				const int32 ChunkSerial = Context.GetChunkSerialModificationNumber();
+
+				FEntityLiveQueryChunk& Chunk = LiveQuery.Chunks.FindOrAdd(Entities.GetData());
+				Chunk.LastSeenRefresh = Refresh;
+
+				// Same archetype, no structural change, no recorded write → last result still holds | 未变化的 Chunk 直接沿用
+				if (!bInvalidated && Chunk.Archetype == Archetype && Chunk.ChunkSerial == ChunkSerial && !WrittenArchetypes.Contains(Archetype))
+				{
+					return;
+				}
+
+				const TConstArrayView<FEntityFlagFragment> FlagList = bNoFlags ? TConstArrayView<FEntityFlagFragment>() : GetFlagColumn(Context);
+
+				Left.Append(Chunk.Matching);
+				Chunk.Matching.Reset();
+
+				if (FlagList.Num() == 0)
+				{
+					if (bNoFlags || bEmptyFlagsPass)
+					{
+						FillPassWords(PassWords, Entities.Num());
+					}
+					else
+					{
+						PassWords.SetNumZeroed(FMath::DivideAndRoundUp(Entities.Num(), 64));
+					}
+				}
+				else
+				{
+					PassWords.SetNumZeroed(FMath::DivideAndRoundUp(Entities.Num(), 64));
+					FFlagLaneSummary Lanes;
+					EvaluateFlagLanes(FlagList, Mask, PassWords, Lanes);
+				}
+
+				if (Predicates.Num() > 0)
+				{
+					GatherPredicateColumns(Context, Predicates, Columns);
+					ApplyFragmentPredicates(Predicates, Columns, Entities.Num(), PassWords);
+				}
+				AppendPassingEntities(Entities, PassWords, Chunk.Matching);
+
+				Entered.Append(Chunk.Matching);
+				Chunk.Archetype = Archetype;
+				Chunk.ChunkSerial = ChunkSerial;
+			});
+	}
+
+	// Chunks not visited this time are gone (released or emptied) | 本次未访问的 Chunk 已释放
+	for (auto It = LiveQuery.Chunks.CreateIterator(); It; ++It)
+	{
+		if (It.Value().LastSeenRefresh != Refresh)
+		{
+			Left.Append(It.Value().Matching);
+			It.RemoveCurrent();
+		}
+	}
+
+	// Entities that only moved between chunks produce no delta | 仅在 Chunk 间移动的实体不产生增量
+	TSet<FMassEntityHandle> EnteredSet;
+	EnteredSet.Append(Entered);
+	for (const FMassEntityHandle& Entity : Left)
+	{
+		if (!EnteredSet.Contains(Entity) && LiveQuery.Matching.Remove(Entity) > 0)
+		{
+			LiveQuery.Removed.Add(Entity);
+		}
+	}
+	for (const FMassEntityHandle& Entity : Entered)
+	{
+		bool bAlreadyMatching = false;
+		LiveQuery.Matching.Add(Entity, &bAlreadyMatching);
+		if (!bAlreadyMatching)
+		{
+			LiveQuery.Added.Add(Entity);
+		}
+	}
+}
+
+void UMassAPISubsystem::NotifyFlagWrite(const FMassEntityManager& Manager, FMassEntityHandle EntityHandle, int64 SetLow, int64 SetHigh, int64 ClearLow, int64 ClearHigh) const
+{
+	NotifyFlagArchetypeWrite(Manager.GetArchetypeForEntity(EntityHandle), SetLow, SetHigh, ClearLow, ClearHigh);
+
+	if (bFlagChangeTrackingEnabled)
+	{
+		if (FEntityFlagChangeFragment* Change = Manager.GetFragmentDataPtr<FEntityFlagChangeFragment>(EntityHandle))
+		{
+			Change->Record(FlagChangeEpoch, SetLow | ClearLow, SetHigh | ClearHigh);
+		}
+	}
+
+	const bool bObserved = (((SetLow | ClearLow) & ObservedFlagsLow) | ((SetHigh | ClearHigh) & ObservedFlagsHigh)) != 0;
+	const bool bMigrated = (((SetLow | ClearLow) & MigrationStatFlagsLow) | ((SetHigh | ClearHigh) & MigrationStatFlagsHigh)) != 0;
+	if (bObserved || bMigrated)
+	{
+		FEntityFlagTransition Transition;
+		Transition.Entity = EntityHandle;
+		Transition.RoseLow = SetLow;
+		Transition.RoseHigh = SetHigh;
+		Transition.FellLow = ClearLow;
+		Transition.FellHigh = ClearHigh;
+		if (bObserved) RecordFlagTransitions(MakeArrayView(&Transition, 1));
+		if (bMigrated) RecordFlagMigrations(MakeArrayView(&Transition, 1));
+	}
+
+	if (bFlagIndexEnabled)
+	{
+		FWriteScopeLock WriteLock(FlagIndexLock);
+		FlagIndex.Apply(static_cast<uint32>(EntityHandle.Index), SetLow, SetHigh, ClearLow, ClearHigh);
+	}
+}
+
+void UMassAPISubsystem::NotifyFlagArchetypeWrite(const FMassArchetypeHandle ArchetypeHandle, const int64 SetLow, const int64 SetHigh, const int64 ClearLow, const int64 ClearHigh) const
+{
+	if (!ArchetypeHandle.IsValid()) return;
+
+	FWriteScopeLock WriteLock(FlagArchetypeWritesLock);
+	FEntityFlagArchetypeWrites& Writes = FlagArchetypeWrites.FindOrAdd(ArchetypeHandle);
+	Writes.SetLow |= SetLow;
+	Writes.SetHigh |= SetHigh;
+	Writes.ClearLow |= ClearLow;
+	Writes.ClearHigh |= ClearHigh;
+}
+
+void UMassAPISubsystem::InvalidateFlagChunkSummaries() const
+{
+	FWriteScopeLock WriteLock(FlagArchetypeWritesLock);
+	++FlagSummaryGeneration;
+}
+
+void UMassAPISubsystem::InvalidateLiveQueries() const
+{
+	FWriteScopeLock WriteLock(FlagArchetypeWritesLock);
+	++LiveQueryGeneration;
+}
+
+//--------------- Flag Index | 旗标索引 ---------------
+
+void UMassAPISubsystem::SetFlagIndexEnabled(const bool bEnabled)
+{
+	if (bEnabled == bFlagIndexEnabled) return;
+
+	bFlagIndexEnabled = bEnabled;
+	if (bEnabled)
+	{
+		RebuildFlagIndex();
+	}
+	else
+	{
+		FWriteScopeLock WriteLock(FlagIndexLock);
+		FlagIndex.Reset();
+		FlagIndexedChunks.Reset();
+	}
+}
+
+void UMassAPISubsystem::RebuildFlagIndex() const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("MassAPI_RebuildFlagIndex");
+
+	FWriteScopeLock WriteLock(FlagIndexLock);
+	FlagIndex.Reset();
+	FlagIndexedChunks.Reset();
+
+	FMassEntityManager* Manager = GetEntityManager();
+	if (!Manager || !bFlagIndexEnabled) return;
+
+	FMassEntityQuery ScanQuery(Manager->AsShared());
+	ScanQuery.AddRequirement<FEntityFlagFragment>(EMassFragmentAccess::ReadOnly);
+
+	FMassExecutionContext ExecContext(*Manager, 0.f, /*bFlushDeferredCommands*/false);
+	ScanQuery.ForEachEntityChunk(ExecContext, [this](FMassExecutionContext& Context)
+		{
+			const TConstArrayView<FEntityFlagFragment> FlagList = Context.GetFragmentView<FEntityFlagFragment>();
+			const TConstArrayView<FMassEntityHandle> Entities = Context.GetEntities();
+			for (int32 EntityIt = 0; EntityIt < Entities.Num(); ++EntityIt)
+			{
+				FlagIndex.Apply(static_cast<uint32>(Entities[EntityIt].Index), FlagList[EntityIt].Flags, FlagList[EntityIt].FlagsHigh, 0, 0);
+			}
+			FlagIndexedChunks.Add(Entities.GetData(), { Context.GetEntityCollection().GetArchetype(), Context.GetChunkSerialModificationNumber() });
+		});
+}
+
+void UMassAPISubsystem::SeedFlagIndexChunks(FMassEntityQuery& NativeQuery) const
+{
+	FMassEntityManager* Manager = GetEntityManager();
+	if (!Manager) return;
+
+	struct FPendingChunk
+	{
+		const FMassEntityHandle* Key = nullptr;
+		FEntityFlagIndexChunk Chunk;
+		int32 FirstEntry = 0;
+	};
+	TArray<FPendingChunk> PendingChunks;
+	TArray<TPair<uint32, FEntityFlagFragment>> PendingEntries;
+
+	// Structural changes (including entities created outside MassAPI) move the chunk serial | 结构变化（含 MassAPI 之外创建的实体）会改变 Chunk 序号
+	{
+		FReadScopeLock ReadLock(FlagIndexLock);
+		FMassExecutionContext ExecContext(*Manager, 0.f, /*bFlushDeferredCommands*/false);
+		NativeQuery.ForEachEntityChunk(ExecContext, [&](FMassExecutionContext& Context)
+			{
+				const TConstArrayView<FMassEntityHandle> Entities = Context.GetEntities();
+				const FEntityFlagIndexChunk Chunk{ Context.GetEntityCollection().GetArchetype(), Context.GetChunkSerialModificationNumber() };
+				const FEntityFlagIndexChunk* Indexed = FlagIndexedChunks.Find(Entities.GetData());
+				if (Indexed && Indexed->Archetype == Chunk.Archetype && Indexed->ChunkSerial == Chunk.ChunkSerial) return;
+
+				PendingChunks.Add({ Entities.GetData(), Chunk, PendingEntries.Num() });
+				const TConstArrayView<FEntityFlagFragment> FlagList = GetFlagColumn(Context);
+				for (int32 EntityIt = 0; EntityIt < Entities.Num(); ++EntityIt)
+				{
+					PendingEntries.Emplace(static_cast<uint32>(Entities[EntityIt].Index), FlagList.Num() > 0 ? FlagList[EntityIt] : FEntityFlagFragment());
+				}
+			});
+	}
+	if (PendingChunks.Num() == 0) return;
+
+	FWriteScopeLock WriteLock(FlagIndexLock);
+	for (const TPair<uint32, FEntityFlagFragment>& Entry : PendingEntries)
+	{
+		// A reused entity index may still carry bits of its previous owner | 复用的实体索引可能残留旧实体的位
+		FlagIndex.Apply(Entry.Key, Entry.Value.Flags, Entry.Value.FlagsHigh, ~Entry.Value.Flags, ~Entry.Value.FlagsHigh);
+	}
+	for (const FPendingChunk& Pending : PendingChunks)
+	{
+		FlagIndexedChunks.Add(Pending.Key, Pending.Chunk);
+	}
+}
+
+void UMassAPISubsystem::IndexBuiltEntities(const FMassEntityManager& Manager, const TConstArrayView<FMassEntityHandle> Entities) const
+{
+	if (!bFlagIndexEnabled || Entities.Num() == 0) return;
+
+	FWriteScopeLock WriteLock(FlagIndexLock);
+	for (const FMassEntityHandle& Entity : Entities)
+	{
+		if (const FEntityFlagFragment* FlagFragment = Manager.GetFragmentDataPtr<FEntityFlagFragment>(Entity))
+		{
+			// A reused entity index may still carry bits of its previous owner | 复用的实体索引可能残留旧实体的位
+			FlagIndex.Apply(static_cast<uint32>(Entity.Index), FlagFragment->Flags, FlagFragment->FlagsHigh, ~FlagFragment->Flags, ~FlagFragment->FlagsHigh);
+		}
+	}
+}
+
+int32 UMassAPISubsystem::GetFlagIndexCount(const EEntityFlags Flag) const
+{
+	if (!bFlagIndexEnabled || Flag >= EEntityFlags::EEntityFlags_MAX) return 0;
+
+	FReadScopeLock ReadLock(FlagIndexLock);
+	return FlagIndex.GetBitmap(static_cast<int32>(Flag)).Num();
+}
+
+void UMassAPISubsystem::GetEntitiesWithFlag(const EEntityFlags Flag, TArray<FMassEntityHandle>& OutEntities) const
+{
+	if (Flag >= EEntityFlags::EEntityFlags_MAX) return;
+
+	FMassEntityManager* Manager = GetEntityManager();
+	checkf(Manager, TEXT("EntityManager is not available"));
+
+	// No index: scan the flag column | 未开启索引：扫描旗标列
+	if (!bFlagIndexEnabled)
+	{
+		FMassEntityQuery ScanQuery(Manager->AsShared());
+		ScanQuery.AddRequirement<FEntityFlagFragment>(EMassFragmentAccess::ReadOnly);
+
+		FMassExecutionContext ExecContext(*Manager, 0.f, /*bFlushDeferredCommands*/false);
+		ScanQuery.ForEachEntityChunk(ExecContext, [Flag, &OutEntities](FMassExecutionContext& Context)
+			{
+				const TConstArrayView<FEntityFlagFragment> FlagList = Context.GetFragmentView<FEntityFlagFragment>();
+				const TConstArrayView<FMassEntityHandle> Entities = Context.GetEntities();
+				for (int32 EntityIt = 0; EntityIt < Entities.Num(); ++EntityIt)
+				{
+					if (FlagList[EntityIt].HasFlag(Flag)) OutEntities.Add(Entities[EntityIt]);
+				}
+			});
+		return;
+	}
+
+	{
+		FMassEntityQuery SeedQuery(Manager->AsShared());
+		SeedQuery.AddRequirement<FEntityFlagFragment>(EMassFragmentAccess::ReadOnly);
+		SeedFlagIndexChunks(SeedQuery);
+	}
+
+	TArray<uint32> Candidates;
+	{
+		FReadScopeLock ReadLock(FlagIndexLock);
+		FlagIndex.GetBitmap(static_cast<int32>(Flag)).AppendTo(Candidates);
+	}
+
+	TArray<uint32> StaleIndices;
+	OutEntities.Reserve(OutEntities.Num() + Candidates.Num());
+	for (const uint32 EntityIndex : Candidates)
+	{
+		const FMassEntityHandle Entity = Manager->CreateEntityIndexHandle(static_cast<int32>(EntityIndex));
+		const FEntityFlagFragment* FlagFragment = Entity.IsSet() && Manager->IsEntityActive(Entity)
+			? Manager->GetFragmentDataPtr<FEntityFlagFragment>(Entity) : nullptr;
+
+		if (FlagFragment && FlagFragment->HasFlag(Flag))
+		{
+			OutEntities.Add(Entity);
+		}
+		else
+		{
+			StaleIndices.Add(EntityIndex);
+		}
+	}
+
+	if (StaleIndices.Num() > 0)
+	{
+		const int64 Bit = (1LL << FEntityFlagFragment::GetLocalBitIndex(Flag));
+		const int64 ClearLow = FEntityFlagFragment::IsHighFlag(Flag) ? 0 : Bit;
+		const int64 ClearHigh = FEntityFlagFragment::IsHighFlag(Flag) ? Bit : 0;
+
+		FWriteScopeLock WriteLock(FlagIndexLock);
+		for (const uint32 EntityIndex : StaleIndices)
+		{
+			FlagIndex.Apply(EntityIndex, 0, 0, ClearLow, ClearHigh);
+		}
+	}
+}
+
+bool UMassAPISubsystem::GetMatchingEntitiesFromFlagIndex(const FCompiledEntityQuery& Query, TArray<FMassEntityHandle>& OutEntities) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("MassAPI_GetMatchingEntitiesFromFlagIndex");
+
+	FMassEntityManager* Manager = GetEntityManager();
+	checkf(Manager, TEXT("EntityManager is not available"));
+
+	const FEntityFlagQueryMask& Mask = Query.GetFlagQueryMask();
+	if (!Mask.RequiresFlagFragment()) return false;
+
+	// Chunks the index has not read yet are read first, so entities it never saw are not missed | 先读取索引未见过的 Chunk，避免漏掉未索引的实体
+	SeedFlagIndexChunks(GetCachedNativeQuery(Query));
+
+	TArray<uint32> Candidates;
+	{
+		FReadScopeLock ReadLock(FlagIndexLock);
+
+		// Only worth it when the candidates are few compared to a column scan | 候选远少于扫描量时才使用索引
+		const int32 Estimate = FlagIndex.EstimateCandidates(Mask);
+		if (Estimate == INDEX_NONE) return false;
+		if (Estimate > 0 && static_cast<int64>(Estimate) * FlagIndexScanRatio > GetCachedNativeQuery(Query).GetNumMatchingEntities()) return false;
+
+		FlagIndex.CollectCandidates(Mask, Candidates);
+	}
+
+	// Confirm composition, flags and WHERE clauses on the survivors; drop stale index bits on the way
+	// | 对幸存实体确认 Composition、旗标与谓词，同时清理过期的索引位
+	const int64 IndexedLow = Mask.AllLow | Mask.AnyLow;
+	const int64 IndexedHigh = Mask.AllHigh | Mask.AnyHigh;
+	TArray<TPair<uint32, FEntityFlagFragment>> StaleEntries;
+
+	OutEntities.Reserve(OutEntities.Num() + Candidates.Num());
+	for (const uint32 EntityIndex : Candidates)
+	{
+		const FMassEntityHandle Entity = Manager->CreateEntityIndexHandle(static_cast<int32>(EntityIndex));
+		const FEntityFlagFragment* FlagFragment = Entity.IsSet() && Manager->IsEntityActive(Entity)
+			? Manager->GetFragmentDataPtr<FEntityFlagFragment>(Entity) : nullptr;
+
+		if (!FlagFragment)
+		{
+			FEntityFlagFragment Cleared;
+			Cleared.Flags = IndexedLow;
+			Cleared.FlagsHigh = IndexedHigh;
+			StaleEntries.Emplace(EntityIndex, Cleared);
+			continue;
+		}
+
+		const int64 MissingLow = IndexedLow & ~FlagFragment->Flags;
+		const int64 MissingHigh = IndexedHigh & ~FlagFragment->FlagsHigh;
+		if (UNLIKELY((Mask.AllLow & MissingLow) | (Mask.AllHigh & MissingHigh)))
+		{
+			FEntityFlagFragment Cleared;
+			Cleared.Flags = MissingLow;
+			Cleared.FlagsHigh = MissingHigh;
+			StaleEntries.Emplace(EntityIndex, Cleared);
+		}
+
+		if (MatchQuery(FEntityHandle(Entity), Query))
+		{
+			OutEntities.Add(Entity);
+		}
+	}
+
+	if (StaleEntries.Num() > 0)
+	{
+		FWriteScopeLock WriteLock(FlagIndexLock);
+		for (const TPair<uint32, FEntityFlagFragment>& Stale : StaleEntries)
+		{
+			FlagIndex.Apply(Stale.Key, 0, 0, Stale.Value.Flags, Stale.Value.FlagsHigh);
+		}
+	}
+	return true;
+}
+
+TArray<FMassEntityHandle> UMassAPISubsystem::BuildEntities(int32 Quantity, FMassEntityTemplateData& TemplateData) const
+{
+	FMassEntityManager* Manager = GetEntityManager();
+	checkf(Manager, TEXT("EntityManager is not available"));
+
+	// Validate input
+	if (Quantity <= 0)
+	{
+		return TArray<FMassEntityHandle>();
+	}
+
+	TemplateData.Sort();
+
+	// Create an archetype from the MODIFIED template data composition
+	const FMassArchetypeHandle ArchetypeHandle = Manager->CreateArchetype
+	(
+		TemplateData.GetCompositionDescriptor(),
+		TemplateData.GetArchetypeCreationParams()
+	);
+	return BuildEntities(Quantity, ArchetypeHandle, TemplateData);
+}
+
+TArray<FMassEntityHandle> UMassAPISubsystem::BuildEntities(int32 Quantity, FEntityTemplateData TemplateData) const
+{
+	FMassEntityManager* Manager = GetEntityManager();
+	checkf(Manager, TEXT("EntityManager is not available"));
+
+	const FMassEntityTemplateData* Data = TemplateData.Get();
+	if (Quantity <= 0 || !Data)
+	{
+		return TArray<FMassEntityHandle>();
+	}
+
+	// Sorted and resolved once per template, then reused | 每个模板只排序与解析一次
+	return BuildEntities(Quantity, TemplateData.GetArchetype(*Manager), *Data);
+}
+
+TArray<FMassEntityHandle> UMassAPISubsystem::BuildEntities(int32 Quantity, const FMassArchetypeHandle& ArchetypeHandle, const FMassEntityTemplateData& TemplateData) const
+{
+	TArray<FMassEntityHandle> SpawnedEntities;
+	FMassEntityManager* Manager = GetEntityManager();
+	checkf(Manager, TEXT("EntityManager is not available"));
+
+	// Check if archetype creation was successful
+	if (Quantity <= 0 || !ArchetypeHandle.IsValid())
+	{
+		return SpawnedEntities;
+	}
+
+	// Get shared fragment values from the template
+	const FMassArchetypeSharedFragmentValues& SharedFragmentValues = TemplateData.GetSharedFragmentValues();
+
+	// Batch create entities with the archetype and shared fragments
+	TSharedRef<FMassEntityManager::FEntityCreationContext> CreationContext =
+		Manager->BatchCreateEntities(ArchetypeHandle, SharedFragmentValues, Quantity, SpawnedEntities);
+
+	// Set initial fragment values if provided
+	TConstArrayView<FInstancedStruct> InitialFragmentValues = TemplateData.GetInitialFragmentValues();
+
+	if (InitialFragmentValues.Num() > 0)
+	{
+		// Create entity collection for the spawned entities
+		TArray<FMassArchetypeEntityCollection> EntityCollections;
+
+		UE::Mass::Utils::CreateEntityCollections
+		(
+			*Manager,
+			SpawnedEntities,
+			FMassArchetypeEntityCollection::NoDuplicates,
+			EntityCollections
+		);
+
+		// Apply initial fragment values to all spawned entities
+		Manager->BatchSetEntityFragmentValues(EntityCollections, InitialFragmentValues);
+	}
+
+	IndexBuiltEntities(*Manager, SpawnedEntities);
+	return SpawnedEntities;
+}
+
+TArray<FMassEntityHandle> UMassAPISubsystem::BuildEntitiesWithColumns(int32 Quantity, FEntityTemplateData TemplateData, TConstArrayView<FEntityBuildColumn> Columns) const
+{
+	TArray<FMassEntityHandle> SpawnedEntities;
+	FMassEntityManager* Manager = GetEntityManager();
+	checkf(Manager, TEXT("EntityManager is not available"));
+
+	const FMassEntityTemplateData* Data = TemplateData.Get();
+	if (Quantity <= 0 || !Data)
+	{
+		return SpawnedEntities;
+	}
+
+	// Columns are validated up front so a bad one builds nothing | 预先校验各列，任一列无效则不创建
+	const FMassArchetypeCompositionDescriptor& Composition = Data->GetCompositionDescriptor();
+	for (int32 ColumnIndex = 0; ColumnIndex < Columns.Num(); ++ColumnIndex)
+	{
+		const FEntityBuildColumn& Column = Columns[ColumnIndex];
+		if (!Column.FragmentType || !Column.FragmentType->IsChildOf(FMassFragment::StaticStruct()) || !Column.Data || Column.Stride < Column.FragmentType->GetStructureSize())
+		{
+			UE_LOG(LogMassAPI, Warning, TEXT("BuildEntitiesWithColumns: Column '%s' is not a fragment value array."), Column.FragmentType ? *Column.FragmentType->GetName() : TEXT("Null"));
+			return SpawnedEntities;
+		}
+		for (int32 OtherIndex = 0; OtherIndex < ColumnIndex; ++OtherIndex)
+		{
+			// Two columns for one fragment would leave the result up to copy order | 同一片段两列时结果取决于拷贝顺序
+			if (Columns[OtherIndex].FragmentType == Column.FragmentType)
+			{
+				UE_LOG(LogMassAPI, Warning, TEXT("BuildEntitiesWithColumns: Fragment '%s' is given by more than one column."), *Column.FragmentType->GetName());
+				return SpawnedEntities;
+			}
+		}
+		if (!CONTAINS_FRAGMENT(Composition, Column.FragmentType))
+		{
+			UE_LOG(LogMassAPI, Warning, TEXT("BuildEntitiesWithColumns: Template has no '%s' fragment to take the column."), *Column.FragmentType->GetName());
+			return SpawnedEntities;
+		}
+		if (Column.Num < Quantity)
+		{
+			UE_LOG(LogMassAPI, Warning, TEXT("BuildEntitiesWithColumns: Column '%s' holds %d values for %d entities."), *Column.FragmentType->GetName(), Column.Num, Quantity);
+			return SpawnedEntities;
+		}
+	}
+
+	const FMassArchetypeHandle ArchetypeHandle = TemplateData.GetArchetype(*Manager);
+	if (!ArchetypeHandle.IsValid())
+	{
+		return SpawnedEntities;
+	}
+
+	TSharedRef<FMassEntityManager::FEntityCreationContext> CreationContext =
+		Manager->BatchCreateEntities(ArchetypeHandle, Data->GetSharedFragmentValues(), Quantity, SpawnedEntities);
+
+	// Template values first, then the columns over them | 先写模板初始值，再用列覆盖
+	TArray<FMassArchetypeEntityCollection> EntityCollections;
+	UE::Mass::Utils::CreateEntityCollections(*Manager, SpawnedEntities, FMassArchetypeEntityCollection::NoDuplicates, EntityCollections);
+	TConstArrayView<FInstancedStruct> InitialFragmentValues = Data->GetInitialFragmentValues();
+	if (InitialFragmentValues.Num() > 0)
+	{
+		Manager->BatchSetEntityFragmentValues(EntityCollections, InitialFragmentValues);
+	}
+
+	// Source row of each entity; a chunk normally holds a run of consecutive rows | 每个实体对应的源行，一个 Chunk 通常是连续的一段
+	TMap<int32, int32> RowByEntityIndex;
+	RowByEntityIndex.Reserve(SpawnedEntities.Num());
+	for (int32 Row = 0; Row < SpawnedEntities.Num(); ++Row)
+	{
+		RowByEntityIndex.Add(SpawnedEntities[Row].Index, Row);
+	}
+
+	FMassEntityQuery ColumnQuery(Manager->AsShared());
+	for (const FEntityBuildColumn& Column : Columns)
+	{
+		ColumnQuery.AddRequirement(Column.FragmentType, EMassFragmentAccess::ReadWrite);
+	}
+
+	// Columns are written chunk by chunk, a whole run in one copy when the source is packed | 按 Chunk 写入各列，源数据紧密排列时整段一次复制
+	FMassExecutionContext ExecContext(*Manager, 0.f, /*bFlushDeferredCommands*/false);
+	ColumnQuery.ForEachEntityChunkInCollections(EntityCollections, ExecContext, [&](FMassExecutionContext& Context)
+		{
+			const TConstArrayView<FMassEntityHandle> Entities = Context.GetEntities();
+			if (Entities.Num() == 0) return;
+
+			const int32 FirstRow = RowByEntityIndex.FindChecked(Entities[0].Index);
+			bool bConsecutive = FirstRow + Entities.Num() <= SpawnedEntities.Num();
+			for (int32 EntityIt = 1; bConsecutive && EntityIt < Entities.Num(); ++EntityIt)
+			{
+				bConsecutive = SpawnedEntities[FirstRow + EntityIt] == Entities[EntityIt];
+			}
+
+			for (const FEntityBuildColumn& Column : Columns)
+			{
+				uint8* Dest = reinterpret_cast<uint8*>(Context.GetMutableFragmentView(Column.FragmentType).GetData());
+				const int32 Size = Column.FragmentType->GetStructureSize();
+				if (bConsecutive && Column.Stride == Size)
+				{
+					Column.FragmentType->CopyScriptStruct(Dest, Column.GetElement(FirstRow), Entities.Num());
+					continue;
+				}
+				for (int32 EntityIt = 0; EntityIt < Entities.Num(); ++EntityIt)
+				{
+					const int32 Row = bConsecutive ? FirstRow + EntityIt : RowByEntityIndex.FindChecked(Entities[EntityIt].Index);
+					Column.FragmentType->CopyScriptStruct(Dest + static_cast<int64>(EntityIt) * Size, Column.GetElement(Row));
+				}
+			}
+		});
+
+	IndexBuiltEntities(*Manager, SpawnedEntities);
+	return SpawnedEntities;
+}
+
+// Helper: same struct type and equal contents, whether or not the manager interned both into one instance | 类型相同且内容相等，无论是否为同一共享实例
+static bool IsSameSharedValue(const UScriptStruct* TypeA, const uint8* MemoryA, const UScriptStruct* TypeB, const uint8* MemoryB)
+{
+	if (TypeA != TypeB) return false;
+	if (MemoryA == MemoryB) return true;
+	return TypeA && MemoryA && MemoryB && TypeA->CompareScriptStruct(MemoryA, MemoryB, PPF_None);
+}
+
+// Helper: shared and const shared values compared by type and value, in any order | 按类型与值比较共享片段值，与顺序无关
+static bool HasSameSharedValues(const FMassArchetypeSharedFragmentValues& A, const FMassArchetypeSharedFragmentValues& B)
+{
+	if (&A == &B) return true;
+
+	const TConstArrayView<FSharedStruct> SharedA = A.GetSharedFragments();
+	const TConstArrayView<FSharedStruct> SharedB = B.GetSharedFragments();
+	const TConstArrayView<FConstSharedStruct> ConstA = A.GetConstSharedFragments();
+	const TConstArrayView<FConstSharedStruct> ConstB = B.GetConstSharedFragments();
+	if (SharedA.Num() != SharedB.Num() || ConstA.Num() != ConstB.Num()) return false;
+
+	for (const FSharedStruct& ValueA : SharedA)
+	{
+		const FSharedStruct* ValueB = SharedB.FindByPredicate([&ValueA](const FSharedStruct& Value) { return Value.GetScriptStruct() == ValueA.GetScriptStruct(); });
+		if (!ValueB || !IsSameSharedValue(ValueA.GetScriptStruct(), ValueA.GetMemory(), ValueB->GetScriptStruct(), ValueB->GetMemory())) return false;
+	}
+	for (const FConstSharedStruct& ValueA : ConstA)
+	{
+		const FConstSharedStruct* ValueB = ConstB.FindByPredicate([&ValueA](const FConstSharedStruct& Value) { return Value.GetScriptStruct() == ValueA.GetScriptStruct(); });
+		if (!ValueB || !IsSameSharedValue(ValueA.GetScriptStruct(), ValueA.GetMemory(), ValueB->GetScriptStruct(), ValueB->GetMemory())) return false;
+	}
+	return true;
+}
+
+// Helper: order-independent hash of shared value types and contents, so only likely-equal sets are compared | 与顺序无关的共享值哈希，只比较可能相等的集合
+static uint32 HashSharedValues(const FMassArchetypeSharedFragmentValues& Values)
+{
+	uint32 Hash = 0;
+	for (const FSharedStruct& Value : Values.GetSharedFragments())
+	{
+		Hash ^= HashCombine(GetTypeHash(Value.GetScriptStruct()), UE::StructUtils::GetStructCrc32(FConstStructView(Value.GetScriptStruct(), Value.GetMemory())));
+	}
+	for (const FConstSharedStruct& Value : Values.GetConstSharedFragments())
+	{
+		Hash ^= HashCombine(GetTypeHash(Value.GetScriptStruct()), UE::StructUtils::GetStructCrc32(FConstStructView(Value.GetScriptStruct(), Value.GetMemory())));
+	}
+	return Hash;
+}
+
+void UMassAPISubsystem::GroupTemplatesForBuild(TConstArrayView<FEntityTemplateData> Templates, TArray<FEntityTemplateBatch>& OutBatches) const
+{
+	OutBatches.Reset();
+	FMassEntityManager* Manager = GetEntityManager();
+	checkf(Manager, TEXT("EntityManager is not available"));
+
+	// Batches per (archetype, shared value hash), and where each template data already went (batch, value group)
+	// | 按（原型, 共享值哈希）分桶的批次，以及模板数据已归入的位置
+	TMap<TTuple<FMassArchetypeHandle, uint32>, TArray<int32, TInlineAllocator<2>>> BatchesByArchetype;
+	TMap<const FMassEntityTemplateData*, FIntPoint> Placements;
+
+	for (int32 Index = 0; Index < Templates.Num(); ++Index)
+	{
+		const FMassEntityTemplateData* Data = Templates[Index].Get();
+		if (!Data) continue;
+
+		// Repeats of the same template data skip the archetype and shared value checks | 重复的模板数据直接归入已有分组
+		if (const FIntPoint* Placement = Placements.Find(Data))
+		{
+			FEntityTemplateBatch& Batch = OutBatches[Placement->X];
+			Batch.ValueGroups[Placement->Y].Positions.Add(Batch.Indices.Add(Index));
+			continue;
+		}
+
+		const FMassArchetypeHandle ArchetypeHandle = Templates[Index].GetArchetype(*Manager);
+		if (!ArchetypeHandle.IsValid()) continue;
+
+		TArray<int32, TInlineAllocator<2>>& Candidates = BatchesByArchetype.FindOrAdd(MakeTuple(ArchetypeHandle, HashSharedValues(Data->GetSharedFragmentValues())));
+		int32 BatchIndex = INDEX_NONE;
+		for (const int32 Candidate : Candidates)
+		{
+			if (HasSameSharedValues(OutBatches[Candidate].SharedSource->GetSharedFragmentValues(), Data->GetSharedFragmentValues()))
+			{
+				BatchIndex = Candidate;
+				break;
+			}
+		}
+		if (BatchIndex == INDEX_NONE)
+		{
+			BatchIndex = OutBatches.AddDefaulted();
+			OutBatches[BatchIndex].ArchetypeHandle = ArchetypeHandle;
+			OutBatches[BatchIndex].SharedSource = Data;
+			Candidates.Add(BatchIndex);
+		}
+
+		FEntityTemplateBatch& Batch = OutBatches[BatchIndex];
+		const int32 GroupIndex = Batch.ValueGroups.AddDefaulted();
+		Batch.ValueGroups[GroupIndex].Source = Data;
+		Batch.ValueGroups[GroupIndex].Positions.Add(Batch.Indices.Add(Index));
+		Placements.Add(Data, FIntPoint(BatchIndex, GroupIndex));
+	}
+}
+
+TArray<FMassEntityHandle> UMassAPISubsystem::BuildEntitiesFromTemplates(TConstArrayView<FEntityTemplateData> Templates) const
+{
+	TArray<FMassEntityHandle> Entities;
+	Entities.SetNum(Templates.Num());
+
+	FMassEntityManager* Manager = GetEntityManager();
+	checkf(Manager, TEXT("EntityManager is not available"));
+
+	TArray<FEntityTemplateBatch> Batches;
+	GroupTemplatesForBuild(Templates, Batches);
+
+	TArray<FMassEntityHandle> BuiltEntities;
+	BuiltEntities.Reserve(Templates.Num());
+	TArray<FMassEntityHandle> BatchEntities;
+	TArray<FMassEntityHandle> GroupEntities;
+	TArray<FMassArchetypeEntityCollection> EntityCollections;
+	for (const FEntityTemplateBatch& Batch : Batches)
+	{
+		BatchEntities.Reset();
+		{
+			TSharedRef<FMassEntityManager::FEntityCreationContext> CreationContext =
+				Manager->BatchCreateEntities(Batch.ArchetypeHandle, Batch.SharedSource->GetSharedFragmentValues(), Batch.Indices.Num(), BatchEntities);
+
+			for (const FEntityTemplateBatch::FValueGroup& Group : Batch.ValueGroups)
+			{
+				const TConstArrayView<FInstancedStruct> InitialFragmentValues = Group.Source->GetInitialFragmentValues();
+				if (InitialFragmentValues.Num() == 0) continue;
+
+				// A group covering the whole batch uses the batch's handles as they are | 覆盖整批的分组直接使用整批句柄
+				TConstArrayView<FMassEntityHandle> Targets = BatchEntities;
+				if (Group.Positions.Num() != BatchEntities.Num())
+				{
+					GroupEntities.Reset();
+					for (const int32 Position : Group.Positions)
+					{
+						GroupEntities.Add(BatchEntities[Position]);
+					}
+					Targets = GroupEntities;
+				}
+
+				EntityCollections.Reset();
+				UE::Mass::Utils::CreateEntityCollections(*Manager, Targets, FMassArchetypeEntityCollection::NoDuplicates, EntityCollections);
+				Manager->BatchSetEntityFragmentValues(EntityCollections, InitialFragmentValues);
+			}
+		}
+
+		for (int32 Position = 0; Position < BatchEntities.Num(); ++Position)
+		{
+			Entities[Batch.Indices[Position]] = BatchEntities[Position];
+		}
+		BuiltEntities.Append(BatchEntities);
+	}
+
+	IndexBuiltEntities(*Manager, BuiltEntities);
+	return Entities;
+}
+
+FMassArchetypeHandle UMassAPISubsystem::GetBuildSignatureArchetype(const FMassArchetypeCompositionDescriptor& Composition) const
+{
+	if (const FMassArchetypeHandle* Found = BuildSignatureArchetypes.Find(&Composition))
+	{
+		return *Found;
+	}
+
+	FMassEntityManager* Manager = GetEntityManager();
+	checkf(Manager, TEXT("EntityManager is not available"));
+
+	const FMassArchetypeHandle ArchetypeHandle = Manager->CreateArchetype(Composition);
+	if (ArchetypeHandle.IsValid())
+	{
+		BuildSignatureArchetypes.Add(&Composition, ArchetypeHandle);
+	}
+	return ArchetypeHandle;
+}
+
+FMassEntityHandle UMassAPISubsystem::BuildEntity(FMassEntityTemplateData& TemplateData) const
+{
+	auto Handles = BuildEntities(1, TemplateData);
+
+	if (!Handles.IsEmpty())
+	{
+		return Handles[0];
+	}
+	else
+	{
+		return FMassEntityHandle();
+	}
+}
+
+FMassEntityHandle UMassAPISubsystem::BuildEntity(FEntityTemplateData TemplateData) const
+{
+	const TArray<FMassEntityHandle> Handles = BuildEntities(1, MoveTemp(TemplateData));
+	return Handles.IsEmpty() ? FMassEntityHandle() : Handles[0];
+}
+
+FMassEntityHandle UMassAPISubsystem::BuildEntityDefer(FMassExecutionContext& Context, FMassEntityTemplateData& TemplateData) const
+{
+	FMassEntityManager* Manager = GetEntityManager();
+	checkf(Manager, TEXT("EntityManager is not available"));
+
+	// 1. Reserve entity handle
+	const FMassEntityHandle ReservedEntity = Manager->ReserveEntity();
+	const FMassArchetypeCompositionDescriptor Composition = TemplateData.GetCompositionDescriptor();
+	const FMassArchetypeCreationParams CreationParams = TemplateData.GetArchetypeCreationParams();
+	const FMassArchetypeSharedFragmentValues SharedValues = TemplateData.GetSharedFragmentValues();
+	const TArray<FInstancedStruct> InitialFragments(TemplateData.GetInitialFragmentValues());
+
+	// 3. Push deferred creation command
+	Context.Defer().PushCommand<FMassDeferredCreateCommand>([WeakThis = TWeakObjectPtr<const UMassAPISubsystem>(this), ReservedEntity, Composition, CreationParams, SharedValues, InitialFragments](FMassEntityManager& Manager)
+		{
+			// Get or create archetype (using the modified Composition)
+			const FMassArchetypeHandle ArchetypeHandle = Manager.CreateArchetype(Composition, CreationParams);
+			if (!ArchetypeHandle.IsValid())
+			{
+				// If archetype creation fails, release the reserved entity to prevent leaks
+				Manager.ReleaseReservedEntity(ReservedEntity);
+				return;
+			}
+
+			// Build entity with archetype and shared fragments
+			Manager.BuildEntity(ReservedEntity, ArchetypeHandle, SharedValues);
+
+			// Set initial fragment values
+			if (InitialFragments.Num() > 0)
+			{
+				Manager.SetEntityFragmentValues(ReservedEntity, InitialFragments);
+			}
+
+			if (const UMassAPISubsystem* This = WeakThis.Get()) This->IndexBuiltEntities(Manager, MakeArrayView(&ReservedEntity, 1));
+		});
+
+	return ReservedEntity;
+}
+
+FMassEntityHandle UMassAPISubsystem::BuildEntityDefer(FMassCommandBuffer& CommandBuffer, FMassEntityTemplateData& TemplateData) const
+{
+	FMassEntityManager* Manager = GetEntityManager();
+	checkf(Manager, TEXT("EntityManager is not available"));
+
+	// 1. Reserve entity handle
+	const FMassEntityHandle ReservedEntity = Manager->ReserveEntity();
+
+	TemplateData.Sort();
+	const FMassArchetypeCompositionDescriptor Composition = TemplateData.GetCompositionDescriptor();
+	const FMassArchetypeCreationParams CreationParams = TemplateData.GetArchetypeCreationParams();
+	const FMassArchetypeSharedFragmentValues SharedValues = TemplateData.GetSharedFragmentValues();
+	const TArray<FInstancedStruct> InitialFragments(TemplateData.GetInitialFragmentValues());
+
+	// 3. Push deferred creation command
+	CommandBuffer.PushCommand<FMassDeferredCreateCommand>([WeakThis = TWeakObjectPtr<const UMassAPISubsystem>(this), ReservedEntity, Composition, CreationParams, SharedValues, InitialFragments](FMassEntityManager& Manager)
+		{
+			// Get or create archetype (using the modified Composition)
+			const FMassArchetypeHandle ArchetypeHandle = Manager.CreateArchetype(Composition, CreationParams);
+			if (!ArchetypeHandle.IsValid())
+			{
+				// If archetype creation fails, release the reserved entity to prevent leaks
+				Manager.ReleaseReservedEntity(ReservedEntity);
+				return;
+			}
+
+			// Build entity with archetype and shared fragments
+			Manager.BuildEntity(ReservedEntity, ArchetypeHandle, SharedValues);
+
+			// Set initial fragment values
+			if (InitialFragments.Num() > 0)
+			{
+				Manager.SetEntityFragmentValues(ReservedEntity, InitialFragments);
+			}
+
+			if (const UMassAPISubsystem* This = WeakThis.Get()) This->IndexBuiltEntities(Manager, MakeArrayView(&ReservedEntity, 1));
+		});
+
+	return ReservedEntity;
+}
+
+void UMassAPISubsystem::BuildEntitiesDefer(FMassExecutionContext& Context, int32 Quantity, FMassEntityTemplateData& TemplateData, TArray<FMassEntityHandle>& OutEntities) const
+{
+	FMassEntityManager* Manager = GetEntityManager();
+	checkf(Manager, TEXT("EntityManager is not available"));
+
+	// 1. Batch reserve entities
+	TArray<FMassEntityHandle> ReservedEntities;
+	ReservedEntities.AddUninitialized(Quantity);
+	Manager->BatchReserveEntities(MakeArrayView(ReservedEntities));
+
+	// Add reserved handles to the output array
+	OutEntities.Append(ReservedEntities);
+
+	const FMassArchetypeCompositionDescriptor Composition = TemplateData.GetCompositionDescriptor();
+	const FMassArchetypeCreationParams CreationParams = TemplateData.GetArchetypeCreationParams();
+	const FMassArchetypeSharedFragmentValues SharedValues = TemplateData.GetSharedFragmentValues();
+	const TArray<FInstancedStruct> InitialFragments(TemplateData.GetInitialFragmentValues());
+
+	// 3. Push deferred creation command
+	Context.Defer().PushCommand<FMassDeferredCreateCommand>([WeakThis = TWeakObjectPtr<const UMassAPISubsystem>(this), ReservedEntities, Composition, CreationParams, SharedValues, InitialFragments](FMassEntityManager& Manager)
+		{
+			// Get or create archetype (using the modified Composition)
+			const FMassArchetypeHandle ArchetypeHandle = Manager.CreateArchetype(Composition, CreationParams);
+			if (!ArchetypeHandle.IsValid())
+			{
+				// If archetype creation fails, release all reserved entities
+				for (const FMassEntityHandle& Entity : ReservedEntities)
+				{
+					Manager.ReleaseReservedEntity(Entity);
+				}
+				return;
+			}
+
+			// Batch build reserved entities
+			Manager.BatchCreateReservedEntities(ArchetypeHandle, SharedValues, ReservedEntities);
+
+			// Batch set initial fragment values
+			if (InitialFragments.Num() > 0)
+			{
+				TArray<FMassArchetypeEntityCollection> EntityCollections;
+				UE::Mass::Utils::CreateEntityCollections(Manager, ReservedEntities, FMassArchetypeEntityCollection::NoDuplicates, EntityCollections);
+				Manager.BatchSetEntityFragmentValues(EntityCollections, InitialFragments);
+			}
+
+			if (const UMassAPISubsystem* This = WeakThis.Get()) This->IndexBuiltEntities(Manager, ReservedEntities);
+		});
+}
+
+void UMassAPISubsystem::BuildEntitiesDefer(FMassCommandBuffer& CommandBuffer, int32 Quantity, FMassEntityTemplateData& TemplateData, TArray<FMassEntityHandle>& OutEntities) const
+{
+	FMassEntityManager* Manager = GetEntityManager();
+	checkf(Manager, TEXT("EntityManager is not available"));
+
+	// 1. Batch reserve entities
+	TArray<FMassEntityHandle> ReservedEntities;
+	ReservedEntities.AddUninitialized(Quantity);
+	Manager->BatchReserveEntities(MakeArrayView(ReservedEntities));
+
+	// Add reserved handles to the output array
+	OutEntities.Append(ReservedEntities);
+
+	const FMassArchetypeCompositionDescriptor Composition = TemplateData.GetCompositionDescriptor();
+	const FMassArchetypeCreationParams CreationParams = TemplateData.GetArchetypeCreationParams();
+	const FMassArchetypeSharedFragmentValues SharedValues = TemplateData.GetSharedFragmentValues();
+	const TArray<FInstancedStruct> InitialFragments(TemplateData.GetInitialFragmentValues());
+
+	// 3. Push deferred creation command
+	CommandBuffer.PushCommand<FMassDeferredCreateCommand>([WeakThis = TWeakObjectPtr<const UMassAPISubsystem>(this), ReservedEntities, Composition, CreationParams, SharedValues, InitialFragments](FMassEntityManager& Manager)
+		{
+			// Get or create archetype (using the modified Composition)
+			const FMassArchetypeHandle ArchetypeHandle = Manager.CreateArchetype(Composition, CreationParams);
+			if (!ArchetypeHandle.IsValid())
+			{
+				// If archetype creation fails, release all reserved entities
+				for (const FMassEntityHandle& Entity : ReservedEntities)
+				{
+					Manager.ReleaseReservedEntity(Entity);
+				}
+				return;
+			}
+
+			// Batch build reserved entities
+			Manager.BatchCreateReservedEntities(ArchetypeHandle, SharedValues, ReservedEntities);
+
+			// Batch set initial fragment values
+			if (InitialFragments.Num() > 0)
+			{
+				TArray<FMassArchetypeEntityCollection> EntityCollections;
+				UE::Mass::Utils::CreateEntityCollections(Manager, ReservedEntities, FMassArchetypeEntityCollection::NoDuplicates, EntityCollections);
+				Manager.BatchSetEntityFragmentValues(EntityCollections, InitialFragments);
+			}
+
+			if (const UMassAPISubsystem* This = WeakThis.Get()) This->IndexBuiltEntities(Manager, ReservedEntities);
+		});
+}
+
+FMassEntityHandle UMassAPISubsystem::BuildEntityDefer(FMassCommandBuffer& CommandBuffer, FEntityTemplateData TemplateData) const
+{
+	TArray<FMassEntityHandle> ReservedEntities;
+	BuildEntitiesDefer(CommandBuffer, 1, MoveTemp(TemplateData), ReservedEntities);
+	return ReservedEntities.IsEmpty() ? FMassEntityHandle() : ReservedEntities[0];
+}
+
+void UMassAPISubsystem::BuildEntitiesDefer(FMassCommandBuffer& CommandBuffer, int32 Quantity, FEntityTemplateData TemplateData, TArray<FMassEntityHandle>& OutEntities) const
+{
+	FMassEntityManager* Manager = GetEntityManager();
+	checkf(Manager, TEXT("EntityManager is not available"));
+
+	const FMassEntityTemplateData* Data = TemplateData.Get();
+	if (Quantity <= 0 || !Data) return;
+
+	// The command captures the cached archetype instead of the composition | 命令捕获缓存的原型而非 Composition
+	const FMassArchetypeHandle ArchetypeHandle = TemplateData.GetArchetype(*Manager);
+	if (!ArchetypeHandle.IsValid()) return;
+
+	TArray<FMassEntityHandle> ReservedEntities;
+	ReservedEntities.AddUninitialized(Quantity);
+	Manager->BatchReserveEntities(MakeArrayView(ReservedEntities));
+	OutEntities.Append(ReservedEntities);
+
+	const FMassArchetypeSharedFragmentValues SharedValues = Data->GetSharedFragmentValues();
+	const TArray<FInstancedStruct> InitialFragments(Data->GetInitialFragmentValues());
+
+	CommandBuffer.PushCommand<FMassDeferredCreateCommand>([WeakThis = TWeakObjectPtr<const UMassAPISubsystem>(this), ReservedEntities, ArchetypeHandle, SharedValues, InitialFragments](FMassEntityManager& Manager)
+		{
+			Manager.BatchCreateReservedEntities(ArchetypeHandle, SharedValues, ReservedEntities);
+
+			if (InitialFragments.Num() > 0)
+			{
+				TArray<FMassArchetypeEntityCollection> EntityCollections;
+				UE::Mass::Utils::CreateEntityCollections(Manager, ReservedEntities, FMassArchetypeEntityCollection::NoDuplicates, EntityCollections);
+				Manager.BatchSetEntityFragmentValues(EntityCollections, InitialFragments);
+			}
+
+			if (const UMassAPISubsystem* This = WeakThis.Get()) This->IndexBuiltEntities(Manager, ReservedEntities);
+		});
+}
+
+//----------------------------------------------------------------------//
+// (新) Flag Fragment Operations
+//----------------------------------------------------------------------//
+
+int64 UMassAPISubsystem::GetEntityFlags(FMassEntityHandle EntityHandle) const
+{
+	FMassEntityManager* Manager = GetEntityManager();
+	if (!Manager || !Manager->IsEntityValid(EntityHandle))
+	{
+		return 0;
+	}
+
+	if (const FEntityFlagFragment* FlagFragment = Manager->GetFragmentDataPtr<FEntityFlagFragment>(EntityHandle))
+	{
+		return FlagFragment->Flags;
+	}
+
+	// Log a warning if the fragment is missing
+	UE_LOG(LogMassAPI, Warning, TEXT("GetEntityFlags: Entity does not have FEntityFlagFragment. Add the fragment to the entity template or manually."));
+	return 0;
+}
+
+int64 UMassAPISubsystem::GetEntityFlagsHigh(FMassEntityHandle EntityHandle) const
+{
+	FMassEntityManager* Manager = GetEntityManager();
+	if (!Manager || !Manager->IsEntityValid(EntityHandle))
+	{
+		return 0;
+	}
+
+	if (const FEntityFlagFragment* FlagFragment = Manager->GetFragmentDataPtr<FEntityFlagFragment>(EntityHandle))
+	{
+		return FlagFragment->FlagsHigh;
+	}
+
+	// Log a warning if the fragment is missing
+	UE_LOG(LogMassAPI, Warning, TEXT("GetEntityFlagsHigh: Entity does not have FEntityFlagFragment. Add the fragment to the entity template or manually."));
+	return 0;
+}
+
+bool UMassAPISubsystem::HasEntityFlag(FMassEntityHandle EntityHandle, EEntityFlags FlagToTest) const
+{
+	// Validation handled inside fragment method, but we check validity here first
+	if (FlagToTest >= EEntityFlags::EEntityFlags_MAX)
+	{
+		return false;
+	}
+
+	FMassEntityManager* Manager = GetEntityManager();
+	if (!Manager || !Manager->IsEntityValid(EntityHandle))
+	{
+		return false;
+	}
+
+	if (const FEntityFlagFragment* FlagFragment = Manager->GetFragmentDataPtr<FEntityFlagFragment>(EntityHandle))
+	{
+		return FlagFragment->HasFlag(FlagToTest);
+	}
+
+	// No fragment = flag not set
+	return false;
+}
+
+bool UMassAPISubsystem::SetEntityFlag(FMassEntityHandle EntityHandle, EEntityFlags FlagToSet) const
+{
+	if (FlagToSet >= EEntityFlags::EEntityFlags_MAX)
+	{
+		return false;
+	}
+
+	FMassEntityManager* Manager = GetEntityManager();
+	if (!Manager || !Manager->IsEntityValid(EntityHandle))
+	{
+		return false;
+	}
+
+	// Get mutable pointer
+	if (FEntityFlagFragment* FlagFragment = Manager->GetFragmentDataPtr<FEntityFlagFragment>(EntityHandle))
+	{
+		// Unchanged flags are not reported, so change tracking only sees real transitions | 未变化时不通知
+		const bool bChanged = FlagFragment->SetFlagIfClear(FlagToSet);
+		if (bChanged) NotifyFlagWrite(*Manager, EntityHandle, FlagToSet, true);
+		return true;
+	}
+
+	UE_LOG(LogMassAPI, Warning, TEXT("SetEntityFlag: Entity does not have FEntityFlagFragment. Flag not set."));
+	return false;
+}
+
+bool UMassAPISubsystem::ClearEntityFlag(FMassEntityHandle EntityHandle, EEntityFlags FlagToClear) const
+{
+	if (FlagToClear >= EEntityFlags::EEntityFlags_MAX)
+	{
+		return false;
+	}
+
+	FMassEntityManager* Manager = GetEntityManager();
 	if (!Manager || !Manager->IsEntityValid(EntityHandle))
 	{
 		return false;
 	}
 
-	if (const FEntityFlagFragment* FlagFragment = Manager->GetFragmentDataPtr<FEntityFlagFragment>(EntityHandle))
+	// Get mutable pointer
+	if (FEntityFlagFragment* FlagFragment = Manager->GetFragmentDataPtr<FEntityFlagFragment>(EntityHandle))
 	{
-		return FlagFragment->HasFlag(FlagToTest);
+		const bool bChanged = FlagFragment->ClearFlagIfSet(FlagToClear);
+		if (bChanged) NotifyFlagWrite(*Manager, EntityHandle, FlagToClear, false);
+		return true;
 	}
 
-	// No fragment = flag not set
+	UE_LOG(LogMassAPI, Warning, TEXT("ClearEntityFlag: Entity does not have FEntityFlagFragment. Flag not cleared."));
 	return false;
 }
 
-bool UMassAPISubsystem::SetEntityFlag(FMassEntityHandle EntityHandle, EEntityFlags FlagToSet) const
+//--------------- Flag Operations (Batch) | 批量旗标操作 ---------------
+
+int32 UMassAPISubsystem::ApplyFlagMask(const TConstArrayView<FMassEntityHandle> Entities, const int64 SetLow, const int64 SetHigh, const int64 ClearLow, const int64 ClearHigh) const
 {
-	if (FlagToSet >= EEntityFlags::EEntityFlags_MAX)
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("MassAPI_ApplyFlagMask");
+
+	FMassEntityManager* Manager = GetEntityManager();
+	checkf(Manager, TEXT("EntityManager is not available"));
+
+	if (Entities.Num() == 0 || (SetLow | SetHigh | ClearLow | ClearHigh) == 0) return 0;
+
+	TArray<FMassEntityHandle> ValidEntities;
+	ValidEntities.Reserve(Entities.Num());
+	for (const FMassEntityHandle& Entity : Entities)
+	{
+		if (Manager->IsEntityValid(Entity)) ValidEntities.Add(Entity);
+	}
+
+	// Group by archetype, keeping only archetypes that carry the flag column | 按原型分组，仅保留带旗标列的原型
+	TArray<FMassArchetypeEntityCollection> EntityCollections;
+	UE::Mass::Utils::CreateEntityCollections(*Manager, ValidEntities, FMassArchetypeEntityCollection::FoldDuplicates, EntityCollections);
+	EntityCollections.RemoveAllSwap([Manager](const FMassArchetypeEntityCollection& Collection)
+		{
+			return !CONTAINS_T_FRAGMENT(Manager->GetArchetypeComposition(Collection.GetArchetype()), FEntityFlagFragment);
+		});
+	if (EntityCollections.Num() == 0) return 0;
+
+	FMassEntityQuery WriteQuery(Manager->AsShared());
+	WriteQuery.AddRequirement<FEntityFlagFragment>(EMassFragmentAccess::ReadWrite);
+	if (bFlagChangeTrackingEnabled)
+	{
+		WriteQuery.AddRequirement<FEntityFlagChangeFragment>(EMassFragmentAccess::ReadWrite, EMassFragmentPresence::Optional);
+	}
+
+	// Observers and migration stats only care when the written bits overlap what they watch | 写入位与观察或统计掩码相交时才收集变化
+	const bool bObserved = (((SetLow | ClearLow) & ObservedFlagsLow) | ((SetHigh | ClearHigh) & ObservedFlagsHigh)) != 0;
+	const bool bMigrated = (((SetLow | ClearLow) & MigrationStatFlagsLow) | ((SetHigh | ClearHigh) & MigrationStatFlagsHigh)) != 0;
+	TArray<FEntityFlagTransition> Transitions;
+
+	int32 NumWritten = 0;
+	FMassExecutionContext ExecContext(*Manager, 0.f, /*bFlushDeferredCommands*/false);
+	WriteQuery.ForEachEntityChunkInCollections(EntityCollections, ExecContext, [&](FMassExecutionContext& Context)
+		{
+			const TArrayView<FEntityFlagFragment> FlagList = Context.GetMutableFragmentView<FEntityFlagFragment>();
+			const TArrayView<FEntityFlagChangeFragment> ChangeList = bFlagChangeTrackingEnabled ? Context.GetMutableFragmentView<FEntityFlagChangeFragment>() : TArrayView<FEntityFlagChangeFragment>();
+			const TConstArrayView<FMassEntityHandle> ChunkEntities = Context.GetEntities();
+			for (int32 EntityIt = 0; EntityIt < FlagList.Num(); ++EntityIt)
+			{
+				FEntityFlagFragment& FlagFragment = FlagList[EntityIt];
+				const FEntityFlagFragment BeforeClear = FlagFragment.FetchClearFlags(ClearLow, ClearHigh);
+				const FEntityFlagFragment BeforeSet = FlagFragment.FetchSetFlags(SetLow, SetHigh);
+
+				// Only the bits this write flipped count, read from the words the atomics replaced: a bit both cleared and
+				// set again nets out | 仅按原子操作返回的旧值计算本次写入翻转的位；先清后置的位相互抵消
+				const int64 FellLow = BeforeClear.Flags & ClearLow & ~SetLow;
+				const int64 FellHigh = BeforeClear.FlagsHigh & ClearHigh & ~SetHigh;
+				const int64 RoseLow = SetLow & ~BeforeSet.Flags & ~(BeforeClear.Flags & ClearLow);
+				const int64 RoseHigh = SetHigh & ~BeforeSet.FlagsHigh & ~(BeforeClear.FlagsHigh & ClearHigh);
+				if (ChangeList.Num() > 0)
+				{
+					ChangeList[EntityIt].Record(FlagChangeEpoch, RoseLow | FellLow, RoseHigh | FellHigh);
+				}
+				if ((bObserved || bMigrated) && (RoseLow | RoseHigh | FellLow | FellHigh) != 0)
+				{
+					FEntityFlagTransition& Transition = Transitions.AddDefaulted_GetRef();
+					Transition.Entity = ChunkEntities[EntityIt];
+					Transition.RoseLow = RoseLow;
+					Transition.RoseHigh = RoseHigh;
+					Transition.FellLow = FellLow;
+					Transition.FellHigh = FellHigh;
+				}
+			}
+			NumWritten += FlagList.Num();
+
+			if (bFlagIndexEnabled)
+			{
+				FWriteScopeLock WriteLock(FlagIndexLock);
+				for (const FMassEntityHandle& Entity : Context.GetEntities())
+				{
+					FlagIndex.Apply(static_cast<uint32>(Entity.Index), SetLow, SetHigh, ClearLow, ClearHigh);
+				}
+			}
+		});
+
+	for (const FMassArchetypeEntityCollection& Collection : EntityCollections)
+	{
+		NotifyFlagArchetypeWrite(Collection.GetArchetype(), SetLow, SetHigh, ClearLow, ClearHigh);
+	}
+	if (Transitions.Num() > 0)
+	{
+		if (bObserved) RecordFlagTransitions(Transitions);
+		if (bMigrated) RecordFlagMigrations(Transitions);
+	}
+	return NumWritten;
+}
+
+int32 UMassAPISubsystem::ApplyFlagMask(const FEntityQuery& Query, const int64 SetLow, const int64 SetHigh, const int64 ClearLow, const int64 ClearHigh) const
+{
+	if ((SetLow | SetHigh | ClearLow | ClearHigh) == 0) return 0;
+
+	// Matching runs chunk-wise on the read-only cached query, the write pass regroups the result by chunk | 先按 Chunk 匹配，再按 Chunk 写入
+	TArray<FMassEntityHandle> Matches;
+	GetMatchingEntities(Query, Matches);
+	return ApplyFlagMask(Matches, SetLow, SetHigh, ClearLow, ClearHigh);
+}
+
+// Word of the configured extension fragment holding Bit (>= 128), or nullptr | 扩展片段中存放 Bit 的字
+static int64* FindExtFlagWord(const FMassEntityManager& Manager, const FMassEntityHandle EntityHandle, const int32 Bit)
+{
+	if (Bit < 128 || Bit >= UMassAPIFlagSettings::GetFlagBitCount()) return nullptr;
+
+	if (FEntityFlagExt512Fragment* Ext512 = Manager.GetFragmentDataPtr<FEntityFlagExt512Fragment>(EntityHandle))
+	{
+		return MassAPIFlags::FindExtWord(*Ext512, Bit);
+	}
+	if (FEntityFlagExt256Fragment* Ext256 = Manager.GetFragmentDataPtr<FEntityFlagExt256Fragment>(EntityHandle))
+	{
+		return MassAPIFlags::FindExtWord(*Ext256, Bit);
+	}
+	return nullptr;
+}
+
+bool UMassAPISubsystem::WriteExtFlagBit(FMassEntityManager& Manager, const FMassEntityHandle EntityHandle, const int32 Bit, const bool bValue, bool& bOutChanged)
+{
+	bOutChanged = false;
+	int64* Word = FindExtFlagWord(Manager, EntityHandle, Bit);
+	if (!Word)
 	{
 		return false;
 	}
 
+	// The previous word comes back from the atomic itself, so concurrent writers agree on who flipped the bit | 由原子操作返回旧值判断是否翻转
+	const int64 Mask = (1LL << ((Bit - 128) & 63));
+	const int64 Previous = bValue ? FPlatformAtomics::InterlockedOr(Word, Mask) : FPlatformAtomics::InterlockedAnd(Word, ~Mask);
+	bOutChanged = ((Previous & Mask) != 0) != bValue;
+	return true;
+}
+
+void UMassAPISubsystem::NotifyExtFlagWrite(const FMassEntityManager& Manager, const FMassEntityHandle EntityHandle) const
+{
+	if (bFlagChangeTrackingEnabled)
+	{
+		if (FEntityFlagChangeFragment* Change = Manager.GetFragmentDataPtr<FEntityFlagChangeFragment>(EntityHandle))
+		{
+			Change->RecordEpoch(FlagChangeEpoch);
+
+			// Live "any flag" change filters rescan this archetype | 实时"任意旗标"变更过滤器将重扫此原型
+			const FMassArchetypeHandle ArchetypeHandle = Manager.GetArchetypeForEntity(EntityHandle);
+			FWriteScopeLock WriteLock(FlagArchetypeWritesLock);
+			FlagArchetypeWrites.FindOrAdd(ArchetypeHandle).bExtWrites = true;
+		}
+	}
+}
+
+bool UMassAPISubsystem::HasEntityFlagBit(FMassEntityHandle EntityHandle, int32 Bit) const
+{
+	if (Bit >= 0 && Bit < 128)
+	{
+		return HasEntityFlag(EntityHandle, static_cast<EEntityFlags>(Bit));
+	}
+
 	FMassEntityManager* Manager = GetEntityManager();
 	if (!Manager || !Manager->IsEntityValid(EntityHandle))
 	{
 		return false;
 	}
 
-	// Get mutable pointer
-	if (FEntityFlagFragment* FlagFragment = Manager->GetFragmentDataPtr<FEntityFlagFragment>(EntityHandle))
+	const int64* Word = FindExtFlagWord(*Manager, EntityHandle, Bit);
+	return Word && (FPlatformAtomics::AtomicRead_Relaxed(Word) & (1LL << ((Bit - 128) & 63))) != 0;
+}
+
+bool UMassAPISubsystem::SetEntityFlagBit(FMassEntityHandle EntityHandle, int32 Bit) const
+{
+	if (Bit >= 0 && Bit < 128)
+	{
+		return SetEntityFlag(EntityHandle, static_cast<EEntityFlags>(Bit));
+	}
+
+	FMassEntityManager* Manager = GetEntityManager();
+	if (!Manager || !Manager->IsEntityValid(EntityHandle))
+	{
+		return false;
+	}
+
+	bool bChanged = false;
+	if (WriteExtFlagBit(*Manager, EntityHandle, Bit, true, bChanged))
 	{
-		FlagFragment->SetFlag(FlagToSet);
+		if (bChanged) NotifyExtFlagWrite(*Manager, EntityHandle);
 		return true;
 	}
 
-	UE_LOG(LogMassAPI, Warning, TEXT("SetEntityFlag: Entity does not have FEntityFlagFragment. Flag not set."));
+	UE_LOG(LogMassAPI, Warning, TEXT("SetEntityFlagBit: Bit %d is outside the flag width or the entity has no flag extension fragment. Flag not set."), Bit);
 	return false;
 }
 
-bool UMassAPISubsystem::ClearEntityFlag(FMassEntityHandle EntityHandle, EEntityFlags FlagToClear) const
+bool UMassAPISubsystem::ClearEntityFlagBit(FMassEntityHandle EntityHandle, int32 Bit) const
 {
-	if (FlagToClear >= EEntityFlags::EEntityFlags_MAX)
+	if (Bit >= 0 && Bit < 128)
 	{
-		return false;
+		return ClearEntityFlag(EntityHandle, static_cast<EEntityFlags>(Bit));
 	}
 
 	FMassEntityManager* Manager = GetEntityManager();
@@ -447,17 +2591,376 @@ bool UMassAPISubsystem::ClearEntityFlag(FMassEntityHandle EntityHandle, EEntityF
 		return false;
 	}
 
-	// Get mutable pointer
-	if (FEntityFlagFragment* FlagFragment = Manager->GetFragmentDataPtr<FEntityFlagFragment>(EntityHandle))
+	bool bChanged = false;
+	if (WriteExtFlagBit(*Manager, EntityHandle, Bit, false, bChanged))
 	{
-		FlagFragment->ClearFlag(FlagToClear);
+		if (bChanged) NotifyExtFlagWrite(*Manager, EntityHandle);
 		return true;
 	}
 
-	UE_LOG(LogMassAPI, Warning, TEXT("ClearEntityFlag: Entity does not have FEntityFlagFragment. Flag not cleared."));
+	UE_LOG(LogMassAPI, Warning, TEXT("ClearEntityFlagBit: Bit %d is outside the flag width or the entity has no flag extension fragment. Flag not cleared."), Bit);
 	return false;
 }
 
+//--------------- Timed Flags | 定时旗标 ---------------
+
+// Pending timers are keyed by entity index and flag; the serial is checked when the change is applied | 以实体索引与旗标为键
+static FORCEINLINE uint64 MakeFlagTimerKey(const FMassEntityHandle EntityHandle, const uint8 Bit)
+{
+	return (static_cast<uint64>(static_cast<uint32>(EntityHandle.Index)) << 8) | Bit;
+}
+
+void UMassAPISubsystem::ScheduleFlagChange(const FMassEntityHandle EntityHandle, const EEntityFlags Flag, const bool bValue, const float Delay) const
+{
+	if (Flag >= EEntityFlags::EEntityFlags_MAX || !EntityHandle.IsSet())
+	{
+		return;
+	}
+
+	FEntityFlagTimer Timer;
+	Timer.Entity = EntityHandle;
+	Timer.Bit = static_cast<uint8>(Flag);
+	Timer.bValue = bValue;
+
+	FScopeLock Lock(&FlagTimersLock);
+	Timer.Generation = NextFlagTimerGeneration++;
+	Timer.DueTick = FlagTimers.GetDueTick(Delay);
+	FlagTimerGenerations.Add(MakeFlagTimerKey(EntityHandle, Timer.Bit), Timer.Generation);
+	FlagTimers.Schedule(Timer);
+}
+
+bool UMassAPISubsystem::SetFlagForDuration(const FMassEntityHandle EntityHandle, const EEntityFlags Flag, const float Duration) const
+{
+	if (!SetEntityFlag(EntityHandle, Flag))
+	{
+		return false;
+	}
+	ScheduleFlagChange(EntityHandle, Flag, false, Duration);
+	return true;
+}
+
+void UMassAPISubsystem::CancelScheduledFlagChange(const FMassEntityHandle EntityHandle, const EEntityFlags Flag) const
+{
+	if (Flag >= EEntityFlags::EEntityFlags_MAX) return;
+
+	// The timer stays in the wheel and is ignored when it comes due | 计时器留在时间轮中，到期时被忽略
+	FScopeLock Lock(&FlagTimersLock);
+	FlagTimerGenerations.Remove(MakeFlagTimerKey(EntityHandle, static_cast<uint8>(Flag)));
+}
+
+int32 UMassAPISubsystem::GetNumScheduledFlagChanges() const
+{
+	FScopeLock Lock(&FlagTimersLock);
+	return FlagTimerGenerations.Num();
+}
+
+void UMassAPISubsystem::FlushFlagTimers(const float DeltaTime)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("MassAPI_FlushFlagTimers");
+
+	TArray<FEntityFlagTimer> Due;
+	{
+		FScopeLock Lock(&FlagTimersLock);
+		FlagTimers.AdvanceSeconds(DeltaTime, Due);
+
+		// Superseded or cancelled timers are dropped here | 丢弃被覆盖或已取消的计时器
+		Due.RemoveAll([this](const FEntityFlagTimer& Timer)
+			{
+				const uint64 Key = MakeFlagTimerKey(Timer.Entity, Timer.Bit);
+				const uint32* LiveGeneration = FlagTimerGenerations.Find(Key);
+				if (!LiveGeneration || *LiveGeneration != Timer.Generation) return true;
+				FlagTimerGenerations.Remove(Key);
+				return false;
+			});
+	}
+	if (Due.Num() == 0 || !GetEntityManager()) return;
+
+	// One batched flag pass per (flag, value); stale handles are filtered by ApplyFlagMask | 每个 (旗标, 值) 一次批量写入，过期句柄由 ApplyFlagMask 过滤
+	TMap<int32, TArray<FMassEntityHandle>> Batches;
+	for (const FEntityFlagTimer& Timer : Due)
+	{
+		Batches.FindOrAdd(Timer.Bit * 2 + (Timer.bValue ? 1 : 0)).Add(Timer.Entity);
+	}
+	for (const TPair<int32, TArray<FMassEntityHandle>>& Batch : Batches)
+	{
+		const int32 Bit = Batch.Key / 2;
+		const bool bValue = (Batch.Key & 1) != 0;
+		const int64 Low = Bit < 64 ? (1LL << Bit) : 0;
+		const int64 High = Bit < 64 ? 0 : (1LL << (Bit - 64));
+		ApplyFlagMask(Batch.Value, bValue ? Low : 0, bValue ? High : 0, bValue ? 0 : Low, bValue ? 0 : High);
+	}
+}
+
+//--------------- Flag Observers | 旗标观察者 ---------------
+
+int32 UMassAPISubsystem::RegisterFlagObserver(const int64 MaskLow, const int64 MaskHigh, FOnEntityFlagsChanged Callback)
+{
+	if ((MaskLow | MaskHigh) == 0 || !Callback.IsBound())
+	{
+		UE_LOG(LogMassAPI, Warning, TEXT("RegisterFlagObserver: Needs a non-empty flag mask and a bound callback."));
+		return INDEX_NONE;
+	}
+
+	const int32 ObserverId = NextFlagObserverId++;
+	{
+		FScopeLock Lock(&FlagObserversLock);
+		FEntityFlagObserver& Observer = FlagObservers.Add(ObserverId);
+		Observer.MaskLow = MaskLow;
+		Observer.MaskHigh = MaskHigh;
+		Observer.Callback = MoveTemp(Callback);
+	}
+	UpdateObservedFlags();
+	return ObserverId;
+}
+
+int32 UMassAPISubsystem::RegisterFlagObserver(const TConstArrayView<EEntityFlags> Flags, FOnEntityFlagsChanged Callback)
+{
+	int64 MaskLow = 0, MaskHigh = 0;
+	for (const EEntityFlags Flag : Flags)
+	{
+		if (Flag >= EEntityFlags::EEntityFlags_MAX) continue;
+		const int64 Bit = (1LL << FEntityFlagFragment::GetLocalBitIndex(Flag));
+		(FEntityFlagFragment::IsHighFlag(Flag) ? MaskHigh : MaskLow) |= Bit;
+	}
+	return RegisterFlagObserver(MaskLow, MaskHigh, MoveTemp(Callback));
+}
+
+void UMassAPISubsystem::UnregisterFlagObserver(const int32 ObserverId)
+{
+	{
+		FScopeLock Lock(&FlagObserversLock);
+		FlagObservers.Remove(ObserverId);
+	}
+	UpdateObservedFlags();
+}
+
+void UMassAPISubsystem::UpdateObservedFlags()
+{
+	FScopeLock Lock(&FlagObserversLock);
+	ObservedFlagsLow = 0;
+	ObservedFlagsHigh = 0;
+	for (const TPair<int32, FEntityFlagObserver>& Pair : FlagObservers)
+	{
+		ObservedFlagsLow |= Pair.Value.MaskLow;
+		ObservedFlagsHigh |= Pair.Value.MaskHigh;
+	}
+}
+
+void UMassAPISubsystem::RecordFlagTransitions(const TConstArrayView<FEntityFlagTransition> Transitions) const
+{
+	FScopeLock Lock(&FlagObserversLock);
+	for (TPair<int32, FEntityFlagObserver>& Pair : FlagObservers)
+	{
+		FEntityFlagObserver& Observer = Pair.Value;
+		for (const FEntityFlagTransition& Transition : Transitions)
+		{
+			if ((Transition.RoseLow & Observer.MaskLow) | (Transition.RoseHigh & Observer.MaskHigh))
+			{
+				Observer.PendingSet.Add(Transition.Entity);
+			}
+			if ((Transition.FellLow & Observer.MaskLow) | (Transition.FellHigh & Observer.MaskHigh))
+			{
+				Observer.PendingCleared.Add(Transition.Entity);
+			}
+		}
+	}
+}
+
+void UMassAPISubsystem::DispatchFlagObservers()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("MassAPI_DispatchFlagObservers");
+
+	// Take the batches out first: callbacks may write flags or (un)register observers | 先取出批次，回调中可写旗标或增删观察者
+	struct FFlagObserverBatch
+	{
+		FOnEntityFlagsChanged Callback;
+		TArray<FMassEntityHandle> SetEntities;
+		TArray<FMassEntityHandle> ClearedEntities;
+	};
+	TArray<FFlagObserverBatch> Batches;
+	{
+		FScopeLock Lock(&FlagObserversLock);
+		for (TPair<int32, FEntityFlagObserver>& Pair : FlagObservers)
+		{
+			FEntityFlagObserver& Observer = Pair.Value;
+			if (Observer.PendingSet.Num() == 0 && Observer.PendingCleared.Num() == 0) continue;
+
+			FFlagObserverBatch& Batch = Batches.AddDefaulted_GetRef();
+			Batch.Callback = Observer.Callback;
+			Batch.SetEntities = MoveTemp(Observer.PendingSet);
+			Batch.ClearedEntities = MoveTemp(Observer.PendingCleared);
+		}
+	}
+
+	for (const FFlagObserverBatch& Batch : Batches)
+	{
+		Batch.Callback.ExecuteIfBound(Batch.SetEntities, Batch.ClearedEntities);
+	}
+}
+
+//--------------- Tag-Backed Flags | 标签镜像旗标 ---------------
+
+FEntityFlagMigrationStats UMassAPISubsystem::GetFlagMigrationStats(const EEntityFlags Flag) const
+{
+	if (Flag >= EEntityFlags::EEntityFlags_MAX) return FEntityFlagMigrationStats();
+
+	FScopeLock Lock(&FlagMirrorsLock);
+	return FlagMigrationStats[static_cast<int32>(Flag)];
+}
+
+void UMassAPISubsystem::ResetFlagMigrationStats() const
+{
+	FScopeLock Lock(&FlagMirrorsLock);
+	for (FEntityFlagMigrationStats& Stats : FlagMigrationStats)
+	{
+		Stats = FEntityFlagMigrationStats();
+	}
+}
+
+int32 UMassAPISubsystem::GetNumPendingFlagMirrors() const
+{
+	FScopeLock Lock(&FlagMirrorsLock);
+	return PendingFlagMirrors.Num();
+}
+
+void UMassAPISubsystem::RecordFlagMigrations(const TConstArrayView<FEntityFlagTransition> Transitions) const
+{
+	FScopeLock Lock(&FlagMirrorsLock);
+	for (const FEntityFlagTransition& Transition : Transitions)
+	{
+		const int64 FlippedLow = (Transition.RoseLow | Transition.FellLow) & MigrationStatFlagsLow;
+		const int64 FlippedHigh = (Transition.RoseHigh | Transition.FellHigh) & MigrationStatFlagsHigh;
+		for (int32 Bit = 0; Bit < 128; ++Bit)
+		{
+			if (((Bit < 64 ? FlippedLow : FlippedHigh) >> (Bit & 63)) & 1)
+			{
+				++FlagMigrationStats[Bit].Transitions;
+			}
+		}
+
+		if ((FlippedLow & TagBackedFlagsLow) | (FlippedHigh & TagBackedFlagsHigh))
+		{
+			PendingFlagMirrors.Add(Transition.Entity);
+		}
+	}
+}
+
+void UMassAPISubsystem::FlushFlagMirrors()
+{
+	TArray<FMassEntityHandle> Entities;
+	{
+		FScopeLock Lock(&FlagMirrorsLock);
+		if (PendingFlagMirrors.Num() == 0) return;
+		Entities = PendingFlagMirrors.Array();
+		PendingFlagMirrors.Reset();
+	}
+	if (!GetEntityManager()) return;
+
+	// Flags are read again when the command runs, so later writes this frame are honoured | 命令执行时重新读取旗标，本帧之后的写入同样生效
+	Defer().PushCommand<FMassDeferredChangeCompositionCommand>([WeakMassAPI = TWeakObjectPtr<const UMassAPISubsystem>(this), Entities = MoveTemp(Entities)](FMassEntityManager& Manager)
+		{
+			if (const UMassAPISubsystem* MassAPI = WeakMassAPI.Get())
+			{
+				MassAPI->ApplyFlagMirrors(Manager, Entities);
+			}
+		});
+}
+
+void UMassAPISubsystem::ApplyFlagMirrors(FMassEntityManager& Manager, const TConstArrayView<FMassEntityHandle> Entities) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("MassAPI_ApplyFlagMirrors");
+
+	// Local mirror slots: flag bit and single-tag bit set, at most NumFlagMirrorTags | 本地镜像槽：旗标位与单标签位集
+	TArray<int32, TInlineAllocator<NumFlagMirrorTags>> SlotBits;
+	TArray<FMassTagBitSet, TInlineAllocator<NumFlagMirrorTags>> SlotTags;
+	for (int32 Bit = 0; Bit < 128; ++Bit)
+	{
+		if (!(((Bit < 64 ? TagBackedFlagsLow : TagBackedFlagsHigh) >> (Bit & 63)) & 1)) continue;
+		if (const UScriptStruct* MirrorTag = UMassAPIFlagSettings::GetFlagMirrorTag(Bit))
+		{
+			SlotBits.Add(Bit);
+			BIT_SET_ADD(SlotTags.AddDefaulted_GetRef(), MirrorTag);
+		}
+	}
+	if (SlotBits.Num() == 0) return;
+
+	// Mirror slots present per archetype | 各原型当前带有的镜像槽
+	TMap<FMassArchetypeHandle, uint32> ArchetypeSlots;
+	auto GetArchetypeSlots = [&](const FMassArchetypeHandle& Archetype)
+		{
+			if (const uint32* Found = ArchetypeSlots.Find(Archetype)) return *Found;
+			const FMassTagBitSet& Tags = Manager.GetArchetypeComposition(Archetype).GET_TAGS;
+			uint32 Present = 0;
+			for (int32 Slot = 0; Slot < SlotTags.Num(); ++Slot)
+			{
+				if (Tags.HasAll(SlotTags[Slot])) Present |= (1u << Slot);
+			}
+			return ArchetypeSlots.Add(Archetype, Present);
+		};
+
+	// Group the entities whose mirrors are out of date by the slots they should carry | 按目标镜像槽分组过期实体
+	TMap<uint32, TArray<FMassEntityHandle>> Groups;
+	for (const FMassEntityHandle& Entity : Entities)
+	{
+		if (!Manager.IsEntityValid(Entity)) continue;
+		const FEntityFlagFragment* FlagFragment = Manager.GetFragmentDataPtr<FEntityFlagFragment>(Entity);
+		if (!FlagFragment) continue;
+
+		uint32 Wanted = 0;
+		for (int32 Slot = 0; Slot < SlotBits.Num(); ++Slot)
+		{
+			if (FlagFragment->HasFlag(static_cast<EEntityFlags>(SlotBits[Slot]))) Wanted |= (1u << Slot);
+		}
+		if (Wanted != GetArchetypeSlots(Manager.GetArchetypeForEntity(Entity)))
+		{
+			Groups.FindOrAdd(Wanted).Add(Entity);
+		}
+	}
+
+	TArray<FMassArchetypeEntityCollection> EntityCollections;
+	for (const TPair<uint32, TArray<FMassEntityHandle>>& Group : Groups)
+	{
+		FMassTagBitSet TagsToAdd;
+		FMassTagBitSet TagsToRemove;
+		for (int32 Slot = 0; Slot < SlotTags.Num(); ++Slot)
+		{
+			if ((Group.Key >> Slot) & 1)
+			{
+				TagsToAdd = TagsToAdd + SlotTags[Slot];
+			}
+			else
+			{
+				TagsToRemove = TagsToRemove + SlotTags[Slot];
+			}
+		}
+
+		// Count per flag before the move, while the source archetypes are still known | 迁移前按旗标统计
+		EntityCollections.Reset();
+		UE::Mass::Utils::CreateEntityCollections(Manager, Group.Value, FMassArchetypeEntityCollection::FoldDuplicates, EntityCollections);
+		{
+			FScopeLock Lock(&FlagMirrorsLock);
+			for (const FMassEntityHandle& Entity : Group.Value)
+			{
+				const uint32 Changed = Group.Key ^ GetArchetypeSlots(Manager.GetArchetypeForEntity(Entity));
+				for (int32 Slot = 0; Slot < SlotBits.Num(); ++Slot)
+				{
+					if ((Changed >> Slot) & 1) ++FlagMigrationStats[SlotBits[Slot]].Migrations;
+				}
+			}
+			for (const FMassArchetypeEntityCollection& Collection : EntityCollections)
+			{
+				const uint32 Changed = Group.Key ^ GetArchetypeSlots(Collection.GetArchetype());
+				for (int32 Slot = 0; Slot < SlotBits.Num(); ++Slot)
+				{
+					if ((Changed >> Slot) & 1) ++FlagMigrationStats[SlotBits[Slot]].Batches;
+				}
+			}
+		}
+
+		Manager.BatchChangeTagsForEntities(EntityCollections, TagsToAdd, TagsToRemove);
+	}
+}
+
 //--------------- Entity ForEach Iteration (cursor-based) | 实体遍历迭代（游标模式）---------------
 // State stored on subsystem via EntityForEachStates / NextForEachId
 // Native functions live on UMassAPIFuncLib (BeginEntityForEach, AdvanceEntityForEach, etc.)
@@ -0,0 +1,93 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Async/ParallelFor.h"
+#include "MassAPIStructs.h"
+
+BEGIN_DEFINE_SPEC(FMassAPIAtomicFlagSpec, "MassAPI.AtomicFlag", EAutomationTestFlags::ProductFilter | EAutomationTestFlags_ApplicationContextMask)
+	FEntityFlagFragment Fragment;
+
+	static EEntityFlags Flag(const int32 Bit) { return static_cast<EEntityFlags>(Bit); }
+END_DEFINE_SPEC(FMassAPIAtomicFlagSpec)
+
+void FMassAPIAtomicFlagSpec::Define()
+{
+	BeforeEach([this]()
+		{
+			Fragment = FEntityFlagFragment();
+		});
+
+	It("loses no bit when every flag is set from its own task", [this]()
+		{
+			ParallelFor(128, [this](const int32 Bit) { Fragment.SetFlag(Flag(Bit)); });
+			TestEqual(TEXT("Low word full"), Fragment.Flags, static_cast<int64>(-1));
+			TestEqual(TEXT("High word full"), Fragment.FlagsHigh, static_cast<int64>(-1));
+
+			ParallelFor(128, [this](const int32 Bit) { if (Bit % 2 == 0) Fragment.ClearFlag(Flag(Bit)); });
+			TestEqual(TEXT("Even bits cleared, odd kept"), Fragment.Flags, static_cast<int64>(0xAAAAAAAAAAAAAAAAull));
+			TestEqual(TEXT("High word too"), Fragment.FlagsHigh, static_cast<int64>(0xAAAAAAAAAAAAAAAAull));
+		});
+
+	It("reports a transition to exactly one of many racing writers", [this]()
+		{
+			std::atomic<int32> Sets { 0 };
+			std::atomic<int32> Clears { 0 };
+			ParallelFor(256, [this, &Sets](int32) { if (Fragment.SetFlagIfClear(Flag(70))) ++Sets; });
+			ParallelFor(256, [this, &Clears](int32) { if (Fragment.ClearFlagIfSet(Flag(70))) ++Clears; });
+			TestEqual(TEXT("One set"), Sets.load(), 1);
+			TestEqual(TEXT("One clear"), Clears.load(), 1);
+			TestFalse(TEXT("Flag ends clear"), Fragment.HasFlag(Flag(70)));
+		});
+
+	It("lets only one claimant take a multi-flag mask", [this]()
+		{
+			const int64 Mask = 0b111 << 4;
+			std::atomic<int32> Winners { 0 };
+			ParallelFor(64, [this, Mask, &Winners](int32)
+				{
+					int64 Previous = 0;
+					if (Fragment.TrySetFlagsIfClear(false, Mask, Previous)) ++Winners;
+				});
+			TestEqual(TEXT("One winner"), Winners.load(), 1);
+			TestEqual(TEXT("Mask set once"), Fragment.Flags, Mask);
+		});
+
+	It("refuses a claim overlapping a set bit and leaves the word alone", [this]()
+		{
+			Fragment.SetFlag(Flag(5));
+			int64 Previous = 0;
+			TestFalse(TEXT("Claim refused"), Fragment.TrySetFlagsIfClear(false, 0b1111 << 4, Previous));
+			TestEqual(TEXT("Previous word reported"), Previous, static_cast<int64>(1) << 5);
+			TestEqual(TEXT("Word untouched"), Fragment.Flags, static_cast<int64>(1) << 5);
+		});
+
+	It("returns the masks as they were before a multi-flag write", [this]()
+		{
+			Fragment.SetFlag(Flag(1));
+			Fragment.SetFlag(Flag(65));
+			const FEntityFlagFragment BeforeSet = Fragment.FetchSetFlags(0b100, 0b1000);
+			TestEqual(TEXT("Low before set"), BeforeSet.Flags, static_cast<int64>(0b10));
+			TestEqual(TEXT("High before set"), BeforeSet.FlagsHigh, static_cast<int64>(0b10));
+
+			const FEntityFlagFragment BeforeClear = Fragment.FetchClearFlags(0b110, 0);
+			TestEqual(TEXT("Low before clear"), BeforeClear.Flags, static_cast<int64>(0b110));
+			TestEqual(TEXT("High read without a write"), BeforeClear.FlagsHigh, static_cast<int64>(0b1010));
+			TestEqual(TEXT("Low after"), Fragment.Flags, static_cast<int64>(0));
+		});
+
+	It("ignores flags past the last bit", [this]()
+		{
+			Fragment.SetFlag(EEntityFlags::EEntityFlags_MAX);
+			TestFalse(TEXT("No transition"), Fragment.SetFlagIfClear(EEntityFlags::EEntityFlags_MAX));
+			TestEqual(TEXT("Low untouched"), Fragment.Flags, static_cast<int64>(0));
+			TestEqual(TEXT("High untouched"), Fragment.FlagsHigh, static_cast<int64>(0));
+		});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,135 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "MassAPITestWorld.h"
+
+BEGIN_DEFINE_SPEC(FMassAPIColumnBuildSpec, "MassAPI.ColumnBuild", EAutomationTestFlags::ProductFilter | EAutomationTestFlags_ApplicationContextMask)
+	FMassAPITestWorld TestWorld;
+	FEntityTemplateData Template;
+
+	// Larger caller rows, of which a column reads one member | 调用方的较大行结构，列只读取其中一个成员
+	struct FRow
+	{
+		int32 Id = 0;
+		FAgentRadiusFragment Radius;
+		double Padding = 0.0;
+	};
+
+	static TArray<FAgentRadiusFragment> MakeRadii(const int32 Num)
+	{
+		TArray<FAgentRadiusFragment> Radii;
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			Radii.Add_GetRef(FAgentRadiusFragment()).Radius = 10.f + Index;
+		}
+		return Radii;
+	}
+
+	int32 NumBuilt() const
+	{
+		FEntityQuery Query;
+		Query.All<FAgentRadiusFragment>();
+		TArray<FMassEntityHandle> Entities;
+		TestWorld.MassAPI->GetMatchingEntities(Query, Entities);
+		return Entities.Num();
+	}
+
+	float RadiusOf(const FMassEntityHandle Entity) const
+	{
+		return TestWorld.Manager->GetFragmentDataChecked<FAgentRadiusFragment>(Entity).Radius;
+	}
+END_DEFINE_SPEC(FMassAPIColumnBuildSpec)
+
+void FMassAPIColumnBuildSpec::Define()
+{
+	BeforeEach([this]()
+		{
+			TestTrue(TEXT("Test world has an entity manager"), TestWorld.Create());
+
+			Template = FEntityTemplateData(MakeShared<FMassEntityTemplateData>());
+			FAgentRadiusFragment DefaultRadius;
+			DefaultRadius.Radius = 1.f;
+			Template.Get()->AddFragment(FConstStructView::Make(DefaultRadius));
+			Template.Get()->AddFragment(FConstStructView::Make(FTransformFragment()));
+		});
+
+	AfterEach([this]()
+		{
+			Template = FEntityTemplateData();
+			TestWorld.Destroy();
+		});
+
+	It("gives entity i element i of every column", [this]()
+		{
+			const TArray<FAgentRadiusFragment> Radii = MakeRadii(300);
+			TArray<FTransformFragment> Transforms;
+			for (int32 Index = 0; Index < Radii.Num(); ++Index)
+			{
+				Transforms.Add(FTransformFragment(FTransform(FVector(Index, 0.0, 0.0))));
+			}
+
+			const TArray<FMassEntityHandle> Built = TestWorld.MassAPI->BuildEntitiesWithColumns(Radii.Num(), Template,
+				{ FEntityBuildColumn::Make(Radii), FEntityBuildColumn::Make(Transforms) });
+			TestEqual(TEXT("Built"), Built.Num(), Radii.Num());
+			TestEqual(TEXT("First radius"), RadiusOf(Built[0]), 10.f);
+			TestEqual(TEXT("Last radius, past the first chunk"), RadiusOf(Built.Last()), 309.f);
+			TestEqual(TEXT("Transform column"), TestWorld.Manager->GetFragmentDataChecked<FTransformFragment>(Built[123]).GetTransform().GetLocation().X, 123.0);
+		});
+
+	It("reads one member of larger rows through the stride", [this]()
+		{
+			TArray<FRow> Rows;
+			Rows.SetNum(4);
+			for (int32 Index = 0; Index < Rows.Num(); ++Index)
+			{
+				Rows[Index].Radius.Radius = 100.f + Index;
+			}
+
+			const FEntityBuildColumn Column(FAgentRadiusFragment::StaticStruct(), &Rows[0].Radius, sizeof(FRow), Rows.Num());
+			const TArray<FMassEntityHandle> Built = TestWorld.MassAPI->BuildEntitiesWithColumns(Rows.Num(), Template, { Column });
+			TestEqual(TEXT("Built"), Built.Num(), 4);
+			TestEqual(TEXT("Third row"), RadiusOf(Built[2]), 102.f);
+		});
+
+	It("uses the first Quantity values of a longer column", [this]()
+		{
+			const TArray<FAgentRadiusFragment> Radii = MakeRadii(8);
+			const TArray<FMassEntityHandle> Built = TestWorld.MassAPI->BuildEntitiesWithColumns(3, Template, { FEntityBuildColumn::Make(Radii) });
+			TestEqual(TEXT("Built"), Built.Num(), 3);
+			TestEqual(TEXT("Last built"), RadiusOf(Built[2]), 12.f);
+		});
+
+	It("builds nothing when a column is shorter than the quantity", [this]()
+		{
+			AddExpectedMessage(TEXT("holds 3 values for 5 entities"), ELogVerbosity::Warning);
+			const TArray<FAgentRadiusFragment> Radii = MakeRadii(3);
+			TestEqual(TEXT("Nothing returned"), TestWorld.MassAPI->BuildEntitiesWithColumns(5, Template, { FEntityBuildColumn::Make(Radii) }).Num(), 0);
+			TestEqual(TEXT("Nothing built"), NumBuilt(), 0);
+		});
+
+	It("builds nothing when a fragment is given by two columns", [this]()
+		{
+			AddExpectedMessage(TEXT("is given by more than one column"), ELogVerbosity::Warning);
+			const TArray<FAgentRadiusFragment> Radii = MakeRadii(4);
+			const TArray<FAgentRadiusFragment> Others = MakeRadii(4);
+			TestEqual(TEXT("Nothing returned"), TestWorld.MassAPI->BuildEntitiesWithColumns(4, Template, { FEntityBuildColumn::Make(Radii), FEntityBuildColumn::Make(Others) }).Num(), 0);
+			TestEqual(TEXT("Nothing built"), NumBuilt(), 0);
+		});
+
+	It("builds nothing when the template lacks a column's fragment", [this]()
+		{
+			AddExpectedMessage(TEXT("Template has no"), ELogVerbosity::Warning);
+			TArray<FEntityFlagFragment> Flags;
+			Flags.SetNum(4);
+			TestEqual(TEXT("Nothing returned"), TestWorld.MassAPI->BuildEntitiesWithColumns(4, Template, { FEntityBuildColumn::Make(Flags) }).Num(), 0);
+			TestEqual(TEXT("Nothing built"), NumBuilt(), 0);
+		});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
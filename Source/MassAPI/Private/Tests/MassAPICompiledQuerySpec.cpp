@@ -0,0 +1,97 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Async/ParallelFor.h"
+#include "MassAPITestWorld.h"
+
+BEGIN_DEFINE_SPEC(FMassAPICompiledQuerySpec, "MassAPI.CompiledQuery", EAutomationTestFlags::ProductFilter | EAutomationTestFlags_ApplicationContextMask)
+	FMassAPITestWorld TestWorld;
+	TArray<FMassEntityHandle> Built;
+	TArray<FMassEntityHandle> Raw;
+END_DEFINE_SPEC(FMassAPICompiledQuerySpec)
+
+void FMassAPICompiledQuerySpec::Define()
+{
+	BeforeEach([this]()
+		{
+			TestTrue(TEXT("Test world has an entity manager"), TestWorld.Create());
+			Built = TestWorld.BuildWithFlags(300, { EEntityFlags::Flag0 });
+			Raw = TestWorld.BuildRaw(300, FMassAPITestWorld::FlagBit(EEntityFlags::Flag1));
+		});
+
+	AfterEach([this]()
+		{
+			Built.Reset();
+			Raw.Reset();
+			TestWorld.Destroy();
+		});
+
+	It("matches the same entities as the source query", [this]()
+		{
+			const FEntityQuery Query = FMassAPITestWorld::FlagQuery({}, { EEntityFlags::Flag0, EEntityFlags::Flag1 }, { EEntityFlags::Flag2 });
+			const FCompiledEntityQuery Compiled = Query.Compile();
+
+			TArray<FMassEntityHandle> FromQuery, FromCompiled;
+			TestWorld.MassAPI->GetMatchingEntities(Query, FromQuery);
+			TestWorld.MassAPI->GetMatchingEntities(Compiled, FromCompiled);
+			TestTrue(TEXT("Same result"), FromCompiled == FromQuery);
+			TestEqual(TEXT("Both groups"), FromCompiled.Num(), Built.Num() + Raw.Num());
+		});
+
+	It("keeps reading live flags after compilation", [this]()
+		{
+			const FCompiledEntityQuery Compiled = FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag2 }).Compile();
+			TestWorld.WriteFlagsDirect(Raw[5], FMassAPITestWorld::FlagBit(EEntityFlags::Flag2), 0);
+			TestWorld.MassAPI->SetEntityFlag(Built[9], EEntityFlags::Flag2);
+
+			TArray<FMassEntityHandle> Result;
+			TestWorld.MassAPI->GetMatchingEntities(Compiled, Result);
+			TestTrue(TEXT("Direct and MassAPI writes"), FMassAPITestWorld::SameEntities(Result, { Raw[5], Built[9] }));
+		});
+
+	It("can be shared across worker threads", [this]()
+		{
+			const FCompiledEntityQuery Compiled = FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag1 }).Compile();
+			TArray<FMassEntityHandle> Entities = Built;
+			Entities.Append(Raw);
+
+			TArray<uint8> Verdicts;
+			Verdicts.SetNumZeroed(Entities.Num());
+			const UMassAPISubsystem* MassAPI = TestWorld.MassAPI;
+			ParallelFor(Entities.Num(), [&](const int32 Index)
+				{
+					Verdicts[Index] = MassAPI->MatchQuery(FEntityHandle(Entities[Index]), Compiled) ? 1 : 0;
+				});
+
+			int32 NumMatched = 0;
+			for (int32 Index = 0; Index < Entities.Num(); ++Index)
+			{
+				NumMatched += Verdicts[Index];
+				if ((Verdicts[Index] != 0) != (Index >= Built.Num()))
+				{
+					AddError(FString::Printf(TEXT("Wrong verdict for entity %d"), Index));
+					break;
+				}
+			}
+			TestEqual(TEXT("Only the raw entities carry Flag1"), NumMatched, Raw.Num());
+		});
+
+	It("is cached next to its native query", [this]()
+		{
+			const FEntityQuery Query = FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag0 });
+			const TSharedRef<const FCompiledEntityQuery> First = TestWorld.MassAPI->GetCachedCompiledQuery(Query);
+			const TSharedRef<const FCompiledEntityQuery> Second = TestWorld.MassAPI->GetCachedCompiledQuery(FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag0 }));
+			TestTrue(TEXT("Equal queries share the compiled form"), &First.Get() == &Second.Get());
+
+			const TSharedRef<const FCompiledEntityQuery> Other = TestWorld.MassAPI->GetCachedCompiledQuery(FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag1 }));
+			TestTrue(TEXT("Different flags compile separately"), &First.Get() != &Other.Get());
+		});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
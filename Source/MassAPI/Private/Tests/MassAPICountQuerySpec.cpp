@@ -0,0 +1,74 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "MassAPITestWorld.h"
+
+BEGIN_DEFINE_SPEC(FMassAPICountQuerySpec, "MassAPI.CountQuery", EAutomationTestFlags::ProductFilter | EAutomationTestFlags_ApplicationContextMask)
+	FMassAPITestWorld TestWorld;
+
+	// Count and Any must agree with the materializing path | 计数与 Any 必须与生成句柄的路径一致
+	void ExpectSameAsMatching(const TCHAR* What, const FEntityQuery& Query)
+	{
+		TArray<FMassEntityHandle> Matching;
+		TestWorld.MassAPI->GetMatchingEntities(Query, Matching);
+		TestEqual(FString::Printf(TEXT("%s: count"), What), TestWorld.MassAPI->CountMatchingEntities(Query), Matching.Num());
+		TestEqual(FString::Printf(TEXT("%s: any"), What), TestWorld.MassAPI->AnyMatchingEntities(Query), Matching.Num() > 0);
+	}
+END_DEFINE_SPEC(FMassAPICountQuerySpec)
+
+void FMassAPICountQuerySpec::Define()
+{
+	BeforeEach([this]()
+		{
+			TestTrue(TEXT("Test world has an entity manager"), TestWorld.Create());
+		});
+
+	AfterEach([this]()
+		{
+			TestWorld.Destroy();
+		});
+
+	It("counts MassAPI-built entities without materializing them", [this]()
+		{
+			TestWorld.BuildWithFlags(150, { EEntityFlags::Flag0 });
+			TestWorld.BuildWithFlags(250, { EEntityFlags::Flag1 });
+
+			TestEqual(TEXT("All Flag0"), TestWorld.MassAPI->CountMatchingEntities(FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag0 })), 150);
+			TestEqual(TEXT("None Flag0"), TestWorld.MassAPI->CountMatchingEntities(FMassAPITestWorld::FlagQuery({}, {}, { EEntityFlags::Flag0 })), 250);
+			TestEqual(TEXT("Any Flag0/Flag1"), TestWorld.MassAPI->CountMatchingEntities(FMassAPITestWorld::FlagQuery({}, { EEntityFlags::Flag0, EEntityFlags::Flag1 })), 400);
+			TestFalse(TEXT("Nobody has Flag2"), TestWorld.MassAPI->AnyMatchingEntities(FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag2 })));
+		});
+
+	It("counts flags written directly into the fragment", [this]()
+		{
+			const TArray<FMassEntityHandle> Entities = TestWorld.BuildRaw(200, 0);
+			for (int32 Index = 0; Index < 70; ++Index)
+			{
+				TestWorld.WriteFlagsDirect(Entities[Index * 2], FMassAPITestWorld::FlagBit(EEntityFlags::Flag2), 0);
+			}
+
+			TestEqual(TEXT("Directly set"), TestWorld.MassAPI->CountMatchingEntities(FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag2 })), 70);
+			TestTrue(TEXT("Any sees a directly set flag"), TestWorld.MassAPI->AnyMatchingEntities(FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag2 })));
+			ExpectSameAsMatching(TEXT("None Flag2"), FMassAPITestWorld::FlagQuery({}, {}, { EEntityFlags::Flag2 }));
+		});
+
+	It("agrees with GetMatchingEntities across mixed archetypes", [this]()
+		{
+			TestWorld.BuildWithFlags(90, { EEntityFlags::Flag0, EEntityFlags::Flag3 });
+			TestWorld.BuildRaw(130, FMassAPITestWorld::FlagBit(EEntityFlags::Flag3));
+			TestWorld.BuildRaw(40, 0, { FTransformFragment::StaticStruct() });
+
+			ExpectSameAsMatching(TEXT("Composition only"), FMassAPITestWorld::FlagQuery({}));
+			ExpectSameAsMatching(TEXT("All Flag3"), FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag3 }));
+			ExpectSameAsMatching(TEXT("All Flag3, None Flag0"), FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag3 }, {}, { EEntityFlags::Flag0 }));
+			ExpectSameAsMatching(TEXT("None Flag3"), FMassAPITestWorld::FlagQuery({}, {}, { EEntityFlags::Flag3 }));
+		});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,94 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "MassAPITestWorld.h"
+
+BEGIN_DEFINE_SPEC(FMassAPIFlagBatchSpec, "MassAPI.FlagBatch", EAutomationTestFlags::ProductFilter | EAutomationTestFlags_ApplicationContextMask)
+	FMassAPITestWorld TestWorld;
+	TArray<FMassEntityHandle> Raw;
+
+	int64 FlagsOf(const FMassEntityHandle Entity) const
+	{
+		return TestWorld.Manager->GetFragmentDataChecked<FEntityFlagFragment>(Entity).Flags;
+	}
+END_DEFINE_SPEC(FMassAPIFlagBatchSpec)
+
+void FMassAPIFlagBatchSpec::Define()
+{
+	const int64 Flag0 = FMassAPITestWorld::FlagBit(EEntityFlags::Flag0);
+	const int64 Flag1 = FMassAPITestWorld::FlagBit(EEntityFlags::Flag1);
+	const int64 Flag5 = FMassAPITestWorld::FlagBit(EEntityFlags::Flag5);
+
+	BeforeEach([this, Flag5]()
+		{
+			TestTrue(TEXT("Test world has an entity manager"), TestWorld.Create());
+			Raw = TestWorld.BuildRaw(300, Flag5);
+		});
+
+	AfterEach([this]()
+		{
+			Raw.Reset();
+			TestWorld.Destroy();
+		});
+
+	It("writes only the masked bits of a handle array", [this, Flag0, Flag1, Flag5]()
+		{
+			TestWorld.WriteFlagsDirect(Raw[0], Flag0 | Flag5, 0);
+
+			const TArray<FMassEntityHandle> Targets = { Raw[0], Raw[1], Raw[2] };
+			TestEqual(TEXT("Three entities written"), TestWorld.MassAPI->ApplyFlagMask(Targets, Flag1, 0, Flag0, 0), 3);
+			TestEqual(TEXT("Directly set Flag0 cleared, Flag1 set, Flag5 kept"), FlagsOf(Raw[0]), Flag1 | Flag5);
+			TestEqual(TEXT("Flag1 set, Flag5 kept"), FlagsOf(Raw[2]), Flag1 | Flag5);
+			TestEqual(TEXT("Untargeted entity untouched"), FlagsOf(Raw[3]), Flag5);
+		});
+
+	It("skips invalid entities and entities without the flag fragment", [this, Flag1]()
+		{
+			const FMassEntityHandle Destroyed = TestWorld.BuildRaw(1, 0)[0];
+			TestWorld.Manager->DestroyEntity(Destroyed);
+			const FMassEntityHandle Unflagged = TestWorld.BuildRaw(1, 0, { FTransformFragment::StaticStruct() })[0];
+
+			const TArray<FMassEntityHandle> Targets = { Raw[7], Destroyed, Unflagged, FMassEntityHandle() };
+			TestEqual(TEXT("Only the flagged entity is written"), TestWorld.MassAPI->SetFlagsBatch(Targets, Flag1, 0), 1);
+			TestTrue(TEXT("Flag1 set"), (FlagsOf(Raw[7]) & Flag1) != 0);
+		});
+
+	It("applies the mask to every entity matching a query", [this, Flag0, Flag1, Flag5]()
+		{
+			for (int32 Index = 0; Index < Raw.Num(); Index += 10)
+			{
+				TestWorld.WriteFlagsDirect(Raw[Index], Flag0 | Flag5, 0);
+			}
+
+			TestEqual(TEXT("Directly flagged entities"), TestWorld.MassAPI->SetFlagsBatch(FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag0 }), Flag1, 0), 30);
+			TestEqual(TEXT("Matched entity"), FlagsOf(Raw[20]), Flag0 | Flag1 | Flag5);
+			TestEqual(TEXT("Unmatched entity"), FlagsOf(Raw[21]), Flag5);
+
+			TestEqual(TEXT("Clear by query"), TestWorld.MassAPI->ClearFlagsBatch(FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag1 }), Flag0 | Flag1, 0), 30);
+			TestEqual(TEXT("Back to Flag5"), FlagsOf(Raw[20]), Flag5);
+		});
+
+	It("writes nothing until the deferred command flushes", [this, Flag1, Flag5]()
+		{
+			TestWorld.MassAPI->SetFlagsBatchDefer(TestWorld.Manager->Defer(), { Raw[4], Raw[5] }, Flag1, 0);
+			TestEqual(TEXT("Not yet"), FlagsOf(Raw[4]), Flag5);
+
+			TestWorld.Manager->FlushCommands();
+			TestEqual(TEXT("First entity"), FlagsOf(Raw[4]), Flag1 | Flag5);
+			TestEqual(TEXT("Second entity"), FlagsOf(Raw[5]), Flag1 | Flag5);
+		});
+
+	It("sets a bit that is both cleared and set", [this, Flag1, Flag5]()
+		{
+			TestWorld.MassAPI->ApplyFlagMask(TArray<FMassEntityHandle>{ Raw[8] }, Flag1, 0, Flag1 | Flag5, 0);
+			TestEqual(TEXT("Clear first, then set"), FlagsOf(Raw[8]), Flag1);
+		});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
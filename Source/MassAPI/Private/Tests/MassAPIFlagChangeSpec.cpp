@@ -0,0 +1,137 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Async/ParallelFor.h"
+#include "MassAPITestWorld.h"
+
+BEGIN_DEFINE_SPEC(FMassAPIFlagChangeSpec, "MassAPI.FlagChange", EAutomationTestFlags::ProductFilter | EAutomationTestFlags_ApplicationContextMask)
+	FMassAPITestWorld TestWorld;
+	TArray<FMassEntityHandle> Built;
+	TArray<FMassEntityHandle> Raw;
+
+	// Entities whose flags changed in Epoch or later, optionally only the given flags | 自 Epoch 起旗标变化的实体
+	TArray<FMassEntityHandle> ChangedSince(const uint32 Epoch, const TArray<EEntityFlags>& Flags = {}) const
+	{
+		TArray<FName> FlagNames;
+		for (const EEntityFlags Flag : Flags) { FlagNames.Add(FMassAPITestWorld::FlagName(Flag)); }
+
+		FEntityQuery Query = FMassAPITestWorld::FlagQuery({});
+		Query.ChangedSince(Epoch, MoveTemp(FlagNames));
+		Query.MarkCacheDirty();
+
+		TArray<FMassEntityHandle> Result;
+		TestWorld.MassAPI->GetMatchingEntities(Query, Result);
+		return Result;
+	}
+END_DEFINE_SPEC(FMassAPIFlagChangeSpec)
+
+void FMassAPIFlagChangeSpec::Define()
+{
+	BeforeEach([this]()
+		{
+			TestTrue(TEXT("Test world has an entity manager"), TestWorld.Create([](UMassAPIFlagSettings& Settings) { Settings.bEnableFlagChangeTracking = true; }));
+
+			Built = TestWorld.BuildWithFlags(100, { EEntityFlags::Flag0 });
+			Raw = TestWorld.BuildRaw(100, FMassAPITestWorld::FlagBit(EEntityFlags::Flag0),
+				{ FEntityFlagFragment::StaticStruct(), FEntityFlagChangeFragment::StaticStruct(), FTransformFragment::StaticStruct() });
+			TestWorld.Tick();
+		});
+
+	AfterEach([this]()
+		{
+			Built.Reset();
+			Raw.Reset();
+			TestWorld.Destroy();
+		});
+
+	It("advances the epoch once per tick", [this]()
+		{
+			const uint32 Epoch = TestWorld.MassAPI->GetFlagChangeEpoch();
+			TestWorld.Tick();
+			TestWorld.Tick();
+			TestEqual(TEXT("Two ticks"), TestWorld.MassAPI->GetFlagChangeEpoch(), Epoch + 2);
+		});
+
+	It("matches entities changed through MassAPI, filtered by flag", [this]()
+		{
+			const uint32 Epoch = TestWorld.MassAPI->GetFlagChangeEpoch();
+			TestWorld.MassAPI->SetEntityFlag(Built[3], EEntityFlags::Flag1);
+			TestWorld.MassAPI->ClearEntityFlag(Raw[4], EEntityFlags::Flag0);
+
+			TestTrue(TEXT("Any flag"), FMassAPITestWorld::SameEntities(ChangedSince(Epoch), { Built[3], Raw[4] }));
+			TestTrue(TEXT("Flag1 only"), FMassAPITestWorld::SameEntities(ChangedSince(Epoch, { EEntityFlags::Flag1 }), { Built[3] }));
+			TestEqual(TEXT("Untouched flag"), ChangedSince(Epoch, { EEntityFlags::Flag2 }).Num(), 0);
+
+			TestWorld.Tick();
+			TestEqual(TEXT("Still changed since the saved epoch"), ChangedSince(Epoch).Num(), 2);
+			TestEqual(TEXT("Nothing changed in the new epoch"), ChangedSince(TestWorld.MassAPI->GetFlagChangeEpoch()).Num(), 0);
+		});
+
+	It("keeps a flag's change when another flag changes in a later epoch", [this]()
+		{
+			// Burning at epoch N, Stunned at N + 1: asking for Burning since N must still find the entity
+			// | N 纪元设置 Burning、N + 1 纪元设置 Stunned 后，查询 N 起的 Burning 仍须命中
+			const uint32 Epoch = TestWorld.MassAPI->GetFlagChangeEpoch();
+			TestWorld.MassAPI->SetEntityFlag(Raw[11], EEntityFlags::Flag1);
+			TestWorld.Tick();
+			TestWorld.MassAPI->SetEntityFlag(Raw[11], EEntityFlags::Flag2);
+
+			TestTrue(TEXT("First flag since its epoch"), FMassAPITestWorld::SameEntities(ChangedSince(Epoch, { EEntityFlags::Flag1 }), { Raw[11] }));
+			TestTrue(TEXT("Second flag since its epoch"), FMassAPITestWorld::SameEntities(ChangedSince(Epoch + 1, { EEntityFlags::Flag2 }), { Raw[11] }));
+			TestTrue(TEXT("Either flag"), FMassAPITestWorld::SameEntities(ChangedSince(Epoch, { EEntityFlags::Flag1, EEntityFlags::Flag2 }), { Raw[11] }));
+		});
+
+	It("loses no bits and keeps the newest epoch under concurrent writers", [this]()
+		{
+			FEntityFlagChangeFragment Change;
+			ParallelFor(128, [&Change](const int32 Bit)
+				{
+					const int64 Word = 1LL << (Bit & 63);
+					Change.Record(static_cast<uint32>(Bit + 1), Bit < 64 ? Word : 0, Bit < 64 ? 0 : Word);
+				});
+			TestEqual(TEXT("Low bits"), Change.ChangedLow, static_cast<int64>(~0ull));
+			TestEqual(TEXT("High bits"), Change.ChangedHigh, static_cast<int64>(~0ull));
+			TestEqual(TEXT("Newest epoch"), Change.ChangeEpoch, 128u);
+		});
+
+	It("does not count writes that leave the flag as it was", [this]()
+		{
+			const uint32 Epoch = TestWorld.MassAPI->GetFlagChangeEpoch();
+			TestWorld.MassAPI->SetEntityFlag(Built[5], EEntityFlags::Flag0);
+			TestWorld.MassAPI->ClearEntityFlag(Raw[5], EEntityFlags::Flag2);
+			TestEqual(TEXT("Setters"), ChangedSince(Epoch).Num(), 0);
+
+			// Flag0 is already set, only Flag1 flips | Flag0 已置位，只有 Flag1 翻转
+			TestWorld.MassAPI->ApplyFlagMask(TArray<FMassEntityHandle>{ Raw[6] }, FMassAPITestWorld::FlagBit(EEntityFlags::Flag0) | FMassAPITestWorld::FlagBit(EEntityFlags::Flag1), 0, 0, 0);
+			TestEqual(TEXT("Batch mask, unchanged bit"), ChangedSince(Epoch, { EEntityFlags::Flag0 }).Num(), 0);
+			TestTrue(TEXT("Batch mask, flipped bit"), FMassAPITestWorld::SameEntities(ChangedSince(Epoch, { EEntityFlags::Flag1 }), { Raw[6] }));
+		});
+
+	It("stamps deferred writes in the epoch they are flushed", [this]()
+		{
+			TestWorld.MassAPI->SetEntityFlagDefer(TestWorld.Manager->Defer(), Raw[9], EEntityFlags::Flag1);
+			const uint32 Epoch = TestWorld.MassAPI->GetFlagChangeEpoch();
+			TestWorld.Tick();
+			TestTrue(TEXT("Flushed by the tick"), FMassAPITestWorld::SameEntities(ChangedSince(Epoch), { Raw[9] }));
+		});
+
+	It("does not see flags written directly into the fragment", [this]()
+		{
+			const uint32 Epoch = TestWorld.MassAPI->GetFlagChangeEpoch();
+			TestWorld.WriteFlagsDirect(Raw[7], FMassAPITestWorld::FlagBit(EEntityFlags::Flag1), 0);
+			TestWorld.WriteFlagsDirect(Built[7], 0, 0);
+			TestEqual(TEXT("Direct writes are not stamped"), ChangedSince(Epoch).Num(), 0);
+
+			// A later MassAPI write on the same entity is | 之后经 MassAPI 的写入会被记录
+			TestWorld.MassAPI->SetEntityFlag(Raw[7], EEntityFlags::Flag2);
+			TestTrue(TEXT("MassAPI write"), FMassAPITestWorld::SameEntities(ChangedSince(Epoch, { EEntityFlags::Flag2 }), { Raw[7] }));
+		});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
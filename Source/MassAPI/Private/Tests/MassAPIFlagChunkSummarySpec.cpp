@@ -0,0 +1,85 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "MassAPITestWorld.h"
+
+BEGIN_DEFINE_SPEC(FMassAPIFlagChunkSummarySpec, "MassAPI.FlagChunkSummary", EAutomationTestFlags::ProductFilter | EAutomationTestFlags_ApplicationContextMask)
+	FMassAPITestWorld TestWorld;
+	TArray<FMassEntityHandle> Entities;
+END_DEFINE_SPEC(FMassAPIFlagChunkSummarySpec)
+
+void FMassAPIFlagChunkSummarySpec::Define()
+{
+	BeforeEach([this]()
+		{
+			TestTrue(TEXT("Test world has an entity manager"), TestWorld.Create([](UMassAPIFlagSettings& Settings) { Settings.bEnableFlagChunkSummary = true; }));
+
+			Entities = TestWorld.BuildWithFlags(200, { EEntityFlags::Flag0 });
+			TestTrue(TEXT("Templates with flags carry the chunk summary"),
+				TestWorld.Manager->GetArchetypeComposition(TestWorld.Manager->GetArchetypeForEntity(Entities[0])).GET_CHUNK_FRAGMENTS.Contains<FEntityFlagChunkFragment>());
+		});
+
+	AfterEach([this]()
+		{
+			Entities.Reset();
+			TestWorld.Destroy();
+		});
+
+	It("sees MassAPI writes in the frame they happen", [this]()
+		{
+			TArray<FMassEntityHandle> Result;
+			TestWorld.MassAPI->GetMatchingEntities(FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag1 }), Result);
+			TestEqual(TEXT("No entity has Flag1 yet"), Result.Num(), 0);
+
+			TestWorld.MassAPI->SetEntityFlag(Entities[17], EEntityFlags::Flag1);
+			Result.Reset();
+			TestWorld.MassAPI->GetMatchingEntities(FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag1 }), Result);
+			TestTrue(TEXT("Set in this frame"), FMassAPITestWorld::SameEntities(Result, { Entities[17] }));
+
+			TestWorld.Tick();
+			TestWorld.MassAPI->ClearEntityFlag(Entities[17], EEntityFlags::Flag1);
+			Result.Reset();
+			TestWorld.MassAPI->GetMatchingEntities(FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag1 }), Result);
+			TestEqual(TEXT("Cleared in a later frame"), Result.Num(), 0);
+		});
+
+	It("sees direct fragment writes after InvalidateFlagChunkSummaries", [this]()
+		{
+			TArray<FMassEntityHandle> Result;
+			TestWorld.MassAPI->GetMatchingEntities(FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag1 }), Result);
+			TestEqual(TEXT("Summaries built without Flag1"), Result.Num(), 0);
+
+			TestWorld.WriteFlagsDirect(Entities[42], FMassAPITestWorld::FlagBit(EEntityFlags::Flag0) | FMassAPITestWorld::FlagBit(EEntityFlags::Flag1), 0);
+			TestWorld.WriteFlagsDirect(Entities[43], 0, 0);
+			TestWorld.MassAPI->InvalidateFlagChunkSummaries();
+
+			Result.Reset();
+			TestWorld.MassAPI->GetMatchingEntities(FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag1 }), Result);
+			TestTrue(TEXT("Directly set flag is found"), FMassAPITestWorld::SameEntities(Result, { Entities[42] }));
+
+			Result.Reset();
+			TestWorld.MassAPI->GetMatchingEntities(FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag0 }), Result);
+			TestEqual(TEXT("A chunk summarized as all-Flag0 is no longer accepted whole"), Result.Num(), Entities.Num() - 1);
+			TestFalse(TEXT("Directly cleared entity is left out"), Result.Contains(Entities[43]));
+		});
+
+	It("rebuilds a summary when the chunk changes structurally", [this]()
+		{
+			TArray<FMassEntityHandle> Result;
+			TestWorld.MassAPI->GetMatchingEntities(FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag0 }), Result);
+			TestEqual(TEXT("Every entity has Flag0"), Result.Num(), Entities.Num());
+
+			const TArray<FMassEntityHandle> Added = TestWorld.BuildWithFlags(1, { EEntityFlags::Flag0, EEntityFlags::Flag2 });
+			Result.Reset();
+			TestWorld.MassAPI->GetMatchingEntities(FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag2 }), Result);
+			TestTrue(TEXT("The new entity is found in its chunk"), FMassAPITestWorld::SameEntities(Result, Added));
+		});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
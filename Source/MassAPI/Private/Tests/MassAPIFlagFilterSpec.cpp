@@ -0,0 +1,84 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "MassAPITestWorld.h"
+
+BEGIN_DEFINE_SPEC(FMassAPIFlagFilterSpec, "MassAPI.FlagFilter", EAutomationTestFlags::ProductFilter | EAutomationTestFlags_ApplicationContextMask)
+	FMassAPITestWorld TestWorld;
+END_DEFINE_SPEC(FMassAPIFlagFilterSpec)
+
+void FMassAPIFlagFilterSpec::Define()
+{
+	BeforeEach([this]()
+		{
+			TestTrue(TEXT("Test world has an entity manager"), TestWorld.Create());
+		});
+
+	AfterEach([this]()
+		{
+			TestWorld.Destroy();
+		});
+
+	It("emits only the entities whose flags pass the masks", [this]()
+		{
+			const TArray<FMassEntityHandle> Flagged = TestWorld.BuildWithFlags(100, { EEntityFlags::Flag0, EEntityFlags::Flag1 });
+			const TArray<FMassEntityHandle> Plain = TestWorld.BuildWithFlags(200, { EEntityFlags::Flag7 });
+
+			TArray<FMassEntityHandle> Result;
+			TestWorld.MassAPI->GetMatchingEntities(FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag0 }), Result);
+			TestTrue(TEXT("All: only the flagged entities"), FMassAPITestWorld::SameEntities(Result, Flagged));
+
+			Result.Reset();
+			TestWorld.MassAPI->GetMatchingEntities(FMassAPITestWorld::FlagQuery({}, { EEntityFlags::Flag1, EEntityFlags::Flag2 }, { EEntityFlags::Flag0 }), Result);
+			TestEqual(TEXT("Any + None: no entity has Flag1 without Flag0"), Result.Num(), 0);
+
+			Result.Reset();
+			TestWorld.MassAPI->GetMatchingEntities(FMassAPITestWorld::FlagQuery({}, {}, { EEntityFlags::Flag0 }), Result);
+			TestTrue(TEXT("None: only the plain entities"), FMassAPITestWorld::SameEntities(Result, Plain));
+		});
+
+	It("reads flags written directly into the fragment", [this]()
+		{
+			const TArray<FMassEntityHandle> Entities = TestWorld.BuildRaw(300, 0);
+			TArray<FMassEntityHandle> Expected;
+			for (int32 Index = 0; Index < Entities.Num(); Index += 37)
+			{
+				TestWorld.WriteFlagsDirect(Entities[Index], FMassAPITestWorld::FlagBit(EEntityFlags::Flag3), 0);
+				Expected.Add(Entities[Index]);
+			}
+
+			TArray<FMassEntityHandle> Result;
+			TestWorld.MassAPI->GetMatchingEntities(FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag3 }), Result);
+			TestTrue(TEXT("Directly written flags are found"), FMassAPITestWorld::SameEntities(Result, Expected));
+
+			Result.Reset();
+			TestWorld.MassAPI->GetMatchingEntities(FMassAPITestWorld::FlagQuery({}, {}, { EEntityFlags::Flag3 }), Result);
+			TestEqual(TEXT("None excludes them"), Result.Num(), Entities.Num() - Expected.Num());
+		});
+
+	It("treats an excluded flag fragment as zero flags", [this]()
+		{
+			const TArray<FMassEntityHandle> Unflagged = TestWorld.BuildRaw(20, 0, { FTransformFragment::StaticStruct() });
+			TestWorld.BuildRaw(20, FMassAPITestWorld::FlagBit(EEntityFlags::Flag0));
+
+			FEntityQuery NoneOnly = FMassAPITestWorld::FlagQuery({}, {}, { EEntityFlags::Flag0 });
+			NoneOnly.None<FEntityFlagFragment>();
+			TArray<FMassEntityHandle> Result;
+			TestWorld.MassAPI->GetMatchingEntities(NoneOnly, Result);
+			TestTrue(TEXT("None flags match every entity without the fragment"), FMassAPITestWorld::SameEntities(Result, Unflagged));
+
+			FEntityQuery AllFlags = FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag0 });
+			AllFlags.None<FEntityFlagFragment>();
+			Result.Reset();
+			TestWorld.MassAPI->GetMatchingEntities(AllFlags, Result);
+			TestEqual(TEXT("All flags match nothing"), Result.Num(), 0);
+		});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,121 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "MassAPITestWorld.h"
+
+BEGIN_DEFINE_SPEC(FMassAPIFlagHistogramSpec, "MassAPI.FlagHistogram", EAutomationTestFlags::ProductFilter | EAutomationTestFlags_ApplicationContextMask)
+	FMassAPITestWorld TestWorld;
+	TArray<FMassEntityHandle> Flagged;
+
+	// Per-bit reference count over the entities that pass Filter | 逐位参考计数
+	TArray<int32> CountBits(TFunctionRef<bool(const FEntityFlagFragment&)> Filter) const
+	{
+		TArray<int32> Counts;
+		Counts.SetNumZeroed(128);
+		for (const FMassEntityHandle& Entity : Flagged)
+		{
+			const FEntityFlagFragment& Flags = TestWorld.Manager->GetFragmentDataChecked<FEntityFlagFragment>(Entity);
+			if (!Filter(Flags)) continue;
+			for (int32 Bit = 0; Bit < 64; ++Bit)
+			{
+				Counts[Bit] += static_cast<int32>((static_cast<uint64>(Flags.Flags) >> Bit) & 1);
+				Counts[Bit + 64] += static_cast<int32>((static_cast<uint64>(Flags.FlagsHigh) >> Bit) & 1);
+			}
+		}
+		return Counts;
+	}
+
+	void ExpectHistogram(const TCHAR* What, const FEntityQuery& Query, const TArray<int32>& Expected)
+	{
+		TArray<int32> Histogram;
+		TestWorld.MassAPI->GetFlagHistogram(Query, Histogram);
+		if (!TestEqual(FString::Printf(TEXT("%s: 128 entries"), What), Histogram.Num(), 128)) return;
+		for (int32 Bit = 0; Bit < 128; ++Bit)
+		{
+			if (Histogram[Bit] != Expected[Bit])
+			{
+				AddError(FString::Printf(TEXT("%s: bit %d counted %d, expected %d"), What, Bit, Histogram[Bit], Expected[Bit]));
+				return;
+			}
+		}
+	}
+END_DEFINE_SPEC(FMassAPIFlagHistogramSpec)
+
+void FMassAPIFlagHistogramSpec::Define()
+{
+	BeforeEach([this]()
+		{
+			TestTrue(TEXT("Test world has an entity manager"), TestWorld.Create());
+
+			Flagged = TestWorld.BuildWithFlags(300, { EEntityFlags::Flag0, EEntityFlags::Flag2 });
+			const TArray<FMassEntityHandle> Raw = TestWorld.BuildRaw(2500, 0);
+			Flagged.Append(Raw);
+
+			// Scrambled low and high words written straight into the fragments | 直接写入打散的高低位
+			uint64 Seed = 0x9E3779B97F4A7C15ull;
+			for (const FMassEntityHandle& Entity : Raw)
+			{
+				Seed ^= Seed << 13; Seed ^= Seed >> 7; Seed ^= Seed << 17;
+				const uint64 Low = Seed;
+				Seed ^= Seed << 13; Seed ^= Seed >> 7; Seed ^= Seed << 17;
+				TestWorld.WriteFlagsDirect(Entity, static_cast<int64>(Low), static_cast<int64>(Seed & (Seed >> 3)));
+			}
+
+			// Entities without the flag fragment contribute nothing | 无旗标片段的实体不计数
+			TestWorld.BuildRaw(100, 0, { FTransformFragment::StaticStruct() });
+		});
+
+	AfterEach([this]()
+		{
+			Flagged.Reset();
+			TestWorld.Destroy();
+		});
+
+	It("counts every flag of every matching entity", [this]()
+		{
+			ExpectHistogram(TEXT("All entities"), FMassAPITestWorld::FlagQuery({}), CountBits([](const FEntityFlagFragment&) { return true; }));
+		});
+
+	It("only counts entities that pass the flag filter", [this]()
+		{
+			ExpectHistogram(TEXT("All Flag0"), FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag0 }),
+				CountBits([](const FEntityFlagFragment& Flags) { return Flags.HasFlag(EEntityFlags::Flag0); }));
+			ExpectHistogram(TEXT("None Flag1"), FMassAPITestWorld::FlagQuery({}, {}, { EEntityFlags::Flag1 }),
+				CountBits([](const FEntityFlagFragment& Flags) { return !Flags.HasFlag(EEntityFlags::Flag1); }));
+		});
+
+	It("agrees with CountMatchingEntities per flag", [this]()
+		{
+			TArray<int32> Histogram;
+			TestWorld.MassAPI->GetFlagHistogram(FMassAPITestWorld::FlagQuery({}), Histogram);
+			for (int32 Bit = 0; Bit < 8; ++Bit)
+			{
+				const EEntityFlags Flag = static_cast<EEntityFlags>(Bit);
+				TestEqual(*FString::Printf(TEXT("Flag%d"), Bit), Histogram[Bit], TestWorld.MassAPI->CountMatchingEntities(FMassAPITestWorld::FlagQuery({ Flag })));
+			}
+		});
+
+	It("reflects later direct writes", [this]()
+		{
+			TArray<int32> Before;
+			TestWorld.MassAPI->GetFlagHistogram(FMassAPITestWorld::FlagQuery({}), Before);
+
+			for (int32 Index = 0; Index < 10; ++Index)
+			{
+				TestWorld.WriteFlagsDirect(Flagged[Index], 0, 0);
+			}
+			ExpectHistogram(TEXT("After clearing"), FMassAPITestWorld::FlagQuery({}), CountBits([](const FEntityFlagFragment&) { return true; }));
+
+			TArray<int32> After;
+			TestWorld.MassAPI->GetFlagHistogram(FMassAPITestWorld::FlagQuery({}), After);
+			TestEqual(TEXT("Ten fewer Flag0"), After[0], Before[0] - 10);
+		});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,112 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "MassAPITestWorld.h"
+
+BEGIN_DEFINE_SPEC(FMassAPIFlagIndexSpec, "MassAPI.FlagIndex", EAutomationTestFlags::ProductFilter | EAutomationTestFlags_ApplicationContextMask)
+	FMassAPITestWorld TestWorld;
+	TArray<FMassEntityHandle> Raw;
+
+	// Index lookups must agree with a plain column scan | 索引结果必须与列扫描一致
+	void ExpectSameAsScan(const TCHAR* What, const EEntityFlags Flag)
+	{
+		TArray<FMassEntityHandle> FromIndex;
+		TestWorld.MassAPI->GetEntitiesWithFlag(Flag, FromIndex);
+
+		TestWorld.MassAPI->SetFlagIndexEnabled(false);
+		TArray<FMassEntityHandle> FromScan;
+		TestWorld.MassAPI->GetEntitiesWithFlag(Flag, FromScan);
+		TestWorld.MassAPI->SetFlagIndexEnabled(true);
+
+		TestTrue(What, FMassAPITestWorld::SameEntities(FromIndex, FromScan));
+	}
+END_DEFINE_SPEC(FMassAPIFlagIndexSpec)
+
+void FMassAPIFlagIndexSpec::Define()
+{
+	BeforeEach([this]()
+		{
+			TestTrue(TEXT("Test world has an entity manager"), TestWorld.Create([](UMassAPIFlagSettings& Settings) { Settings.bEnableFlagIndex = true; }));
+			TestTrue(TEXT("Index enabled from settings"), TestWorld.MassAPI->IsFlagIndexEnabled());
+
+			// Created and flagged after the index was enabled, bypassing MassAPI | 索引开启后绕过 MassAPI 创建并写入旗标
+			Raw = TestWorld.BuildRaw(2000, 0);
+			for (int32 Index = 0; Index < Raw.Num(); Index += 500)
+			{
+				TestWorld.WriteFlagsDirect(Raw[Index], FMassAPITestWorld::FlagBit(EEntityFlags::Flag3), 0);
+			}
+		});
+
+	AfterEach([this]()
+		{
+			Raw.Reset();
+			TestWorld.Destroy();
+		});
+
+	It("finds entities the index never saw being created", [this]()
+		{
+			const TArray<FMassEntityHandle> Expected = { Raw[0], Raw[500], Raw[1000], Raw[1500] };
+
+			TArray<FMassEntityHandle> WithFlag;
+			TestWorld.MassAPI->GetEntitiesWithFlag(EEntityFlags::Flag3, WithFlag);
+			TestTrue(TEXT("GetEntitiesWithFlag"), FMassAPITestWorld::SameEntities(WithFlag, Expected));
+
+			TArray<FMassEntityHandle> Matching;
+			TestWorld.MassAPI->GetMatchingEntities(FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag3 }), Matching);
+			TestTrue(TEXT("GetMatchingEntities"), FMassAPITestWorld::SameEntities(Matching, Expected));
+			TestEqual(TEXT("Index count"), TestWorld.MassAPI->GetFlagIndexCount(EEntityFlags::Flag3), 4);
+		});
+
+	It("reads chunks that changed structurally since they were indexed", [this]()
+		{
+			ExpectSameAsScan(TEXT("Seeded"), EEntityFlags::Flag3);
+
+			const TArray<FMassEntityHandle> Later = TestWorld.BuildRaw(10, FMassAPITestWorld::FlagBit(EEntityFlags::Flag3));
+			TArray<FMassEntityHandle> WithFlag;
+			TestWorld.MassAPI->GetEntitiesWithFlag(EEntityFlags::Flag3, WithFlag);
+			TestEqual(TEXT("Later raw entities are picked up"), WithFlag.Num(), 14);
+			ExpectSameAsScan(TEXT("After more raw entities"), EEntityFlags::Flag3);
+		});
+
+	It("drops directly cleared entities and finds directly set ones after a rebuild", [this]()
+		{
+			TArray<FMassEntityHandle> Seeded;
+			TestWorld.MassAPI->GetEntitiesWithFlag(EEntityFlags::Flag3, Seeded);
+
+			TestWorld.WriteFlagsDirect(Raw[500], 0, 0);
+			TestWorld.WriteFlagsDirect(Raw[7], FMassAPITestWorld::FlagBit(EEntityFlags::Flag3), 0);
+
+			// Candidates are confirmed against the fragment, so a direct clear is never reported | 候选逐个确认，直接清除不会被误报
+			TArray<FMassEntityHandle> WithFlag;
+			TestWorld.MassAPI->GetEntitiesWithFlag(EEntityFlags::Flag3, WithFlag);
+			TestFalse(TEXT("Directly cleared entity"), WithFlag.Contains(Raw[500]));
+			TestEqual(TEXT("Stale entry purged"), TestWorld.MassAPI->GetFlagIndexCount(EEntityFlags::Flag3), 3);
+
+			TestWorld.MassAPI->RebuildFlagIndex();
+			WithFlag.Reset();
+			TestWorld.MassAPI->GetEntitiesWithFlag(EEntityFlags::Flag3, WithFlag);
+			TestTrue(TEXT("Directly set entity after rebuild"), WithFlag.Contains(Raw[7]));
+			ExpectSameAsScan(TEXT("After rebuild"), EEntityFlags::Flag3);
+		});
+
+	It("follows MassAPI writes without a rebuild", [this]()
+		{
+			ExpectSameAsScan(TEXT("Seeded"), EEntityFlags::Flag3);
+
+			TestWorld.MassAPI->SetEntityFlag(Raw[42], EEntityFlags::Flag3);
+			TestWorld.MassAPI->ClearEntityFlag(Raw[0], EEntityFlags::Flag3);
+			const TArray<FMassEntityHandle> Built = TestWorld.BuildWithFlags(3, { EEntityFlags::Flag3 });
+
+			TArray<FMassEntityHandle> Matching;
+			TestWorld.MassAPI->GetMatchingEntities(FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag3 }), Matching);
+			TestTrue(TEXT("Set, cleared and built"), FMassAPITestWorld::SameEntities(Matching, { Raw[42], Raw[500], Raw[1000], Raw[1500], Built[0], Built[1], Built[2] }));
+		});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,126 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "MassAPITestWorld.h"
+
+BEGIN_DEFINE_SPEC(FMassAPIFlagObserverSpec, "MassAPI.FlagObserver", EAutomationTestFlags::ProductFilter | EAutomationTestFlags_ApplicationContextMask)
+	FMassAPITestWorld TestWorld;
+	TArray<FMassEntityHandle> Raw;
+	int32 ObserverId = INDEX_NONE;
+
+	// What the observer received, one entry per callback | 观察者收到的回调，每次一项
+	struct FObserved
+	{
+		TArray<FMassEntityHandle> SetEntities;
+		TArray<FMassEntityHandle> ClearedEntities;
+	};
+	TSharedPtr<TArray<FObserved>> Calls;
+END_DEFINE_SPEC(FMassAPIFlagObserverSpec)
+
+void FMassAPIFlagObserverSpec::Define()
+{
+	BeforeEach([this]()
+		{
+			TestTrue(TEXT("Test world has an entity manager"), TestWorld.Create());
+			Raw = TestWorld.BuildRaw(50, FMassAPITestWorld::FlagBit(EEntityFlags::Flag0));
+
+			Calls = MakeShared<TArray<FObserved>>();
+			ObserverId = TestWorld.MassAPI->RegisterFlagObserver({ EEntityFlags::Flag0, EEntityFlags::Flag1 }, FOnEntityFlagsChanged::CreateLambda(
+				[Calls = Calls](TConstArrayView<FMassEntityHandle> SetEntities, TConstArrayView<FMassEntityHandle> ClearedEntities)
+				{
+					FObserved& Call = Calls->AddDefaulted_GetRef();
+					Call.SetEntities = SetEntities;
+					Call.ClearedEntities = ClearedEntities;
+				}));
+			TestNotEqual(TEXT("Registered"), ObserverId, static_cast<int32>(INDEX_NONE));
+		});
+
+	AfterEach([this]()
+		{
+			if (TestWorld.MassAPI) TestWorld.MassAPI->UnregisterFlagObserver(ObserverId);
+			Calls.Reset();
+			Raw.Reset();
+			TestWorld.Destroy();
+		});
+
+	It("delivers one batched callback per tick", [this]()
+		{
+			TestWorld.MassAPI->SetEntityFlag(Raw[1], EEntityFlags::Flag1);
+			TestWorld.MassAPI->SetFlagsBatch(TArray<FMassEntityHandle>{ Raw[2], Raw[3] }, FMassAPITestWorld::FlagBit(EEntityFlags::Flag1), 0);
+			TestWorld.MassAPI->ClearEntityFlag(Raw[4], EEntityFlags::Flag0);
+			TestEqual(TEXT("Nothing before the tick"), Calls->Num(), 0);
+
+			TestWorld.Tick();
+			if (!TestEqual(TEXT("One callback"), Calls->Num(), 1)) return;
+			TestTrue(TEXT("Set"), FMassAPITestWorld::SameEntities((*Calls)[0].SetEntities, { Raw[1], Raw[2], Raw[3] }));
+			TestTrue(TEXT("Cleared"), FMassAPITestWorld::SameEntities((*Calls)[0].ClearedEntities, { Raw[4] }));
+
+			TestWorld.Tick();
+			TestEqual(TEXT("Quiet tick"), Calls->Num(), 1);
+		});
+
+	It("stays quiet for writes that flip nothing it watches", [this]()
+		{
+			// Already set, already clear, or not observed | 已置位、已清除或未观察的旗标
+			TestWorld.MassAPI->SetEntityFlag(Raw[5], EEntityFlags::Flag0);
+			TestWorld.MassAPI->ClearEntityFlag(Raw[5], EEntityFlags::Flag1);
+			TestWorld.MassAPI->SetEntityFlag(Raw[5], EEntityFlags::Flag2);
+			TestWorld.MassAPI->ApplyFlagMask(TArray<FMassEntityHandle>{ Raw[6] }, FMassAPITestWorld::FlagBit(EEntityFlags::Flag0), 0, FMassAPITestWorld::FlagBit(EEntityFlags::Flag0), 0);
+
+			TestWorld.Tick();
+			TestEqual(TEXT("No callback"), Calls->Num(), 0);
+		});
+
+	It("does not report direct fragment writes unless they are recorded", [this]()
+		{
+			TestWorld.WriteFlagsDirect(Raw[7], FMassAPITestWorld::FlagBit(EEntityFlags::Flag1), 0);
+			TestWorld.Tick();
+			TestEqual(TEXT("Direct write is not observed"), Calls->Num(), 0);
+
+			// A processor writing the fragment reports its own transitions | 直接写片段的处理器自行上报
+			FEntityFlagTransition Transition;
+			Transition.Entity = Raw[8];
+			Transition.RoseLow = FMassAPITestWorld::FlagBit(EEntityFlags::Flag1);
+			TestWorld.WriteFlagsDirect(Raw[8], FMassAPITestWorld::FlagBit(EEntityFlags::Flag0) | Transition.RoseLow, 0);
+			TestWorld.MassAPI->RecordFlagTransitions(MakeArrayView(&Transition, 1));
+
+			TestWorld.Tick();
+			if (!TestEqual(TEXT("Recorded transition"), Calls->Num(), 1)) return;
+			TestTrue(TEXT("Set"), FMassAPITestWorld::SameEntities((*Calls)[0].SetEntities, { Raw[8] }));
+		});
+
+	It("delivers writes made inside a callback on the next tick", [this]()
+		{
+			const int32 ChainedId = TestWorld.MassAPI->RegisterFlagObserver({ EEntityFlags::Flag3 }, FOnEntityFlagsChanged::CreateLambda(
+				[MassAPI = TestWorld.MassAPI](TConstArrayView<FMassEntityHandle> SetEntities, TConstArrayView<FMassEntityHandle>)
+				{
+					for (const FMassEntityHandle& Entity : SetEntities) { MassAPI->SetEntityFlag(Entity, EEntityFlags::Flag1); }
+				}));
+
+			TestWorld.MassAPI->SetEntityFlag(Raw[9], EEntityFlags::Flag3);
+			TestWorld.Tick();
+			TestEqual(TEXT("Not in the same tick"), Calls->Num(), 0);
+			TestWorld.Tick();
+			TestEqual(TEXT("Next tick"), Calls->Num(), 1);
+
+			TestWorld.MassAPI->UnregisterFlagObserver(ChainedId);
+		});
+
+	It("discards pending transitions when unregistered", [this]()
+		{
+			TestWorld.MassAPI->SetEntityFlag(Raw[10], EEntityFlags::Flag1);
+			TestWorld.MassAPI->UnregisterFlagObserver(ObserverId);
+			ObserverId = INDEX_NONE;
+
+			TestWorld.Tick();
+			TestEqual(TEXT("No callback"), Calls->Num(), 0);
+		});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
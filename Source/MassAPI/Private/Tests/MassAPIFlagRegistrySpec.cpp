@@ -0,0 +1,166 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Async/Async.h"
+#include "MassAPITestWorld.h"
+
+BEGIN_DEFINE_SPEC(FMassAPIFlagRegistrySpec, "MassAPI.FlagRegistry", EAutomationTestFlags::ProductFilter | EAutomationTestFlags_ApplicationContextMask)
+	FMassAPITestWorld TestWorld;
+
+	static UMassAPIFlagSettings& Settings() { return *GetMutableDefault<UMassAPIFlagSettings>(); }
+
+	// Applies registry edits to the live settings and rebuilds the table | 修改设置并重建查找表
+	static int32 Rebuild()
+	{
+		Settings().RebuildFlagTable();
+		return UMassAPIFlagSettings::GetRegistryVersion();
+	}
+END_DEFINE_SPEC(FMassAPIFlagRegistrySpec)
+
+void FMassAPIFlagRegistrySpec::Define()
+{
+	BeforeEach([this]()
+		{
+			TestTrue(TEXT("Test world has an entity manager"), TestWorld.Create([](UMassAPIFlagSettings& FlagSettings)
+				{
+					FlagSettings.ExtendedFlagRegistry.Add(TEXT("MassAPITest.Wide"), 100);
+					FlagSettings.ExtendedFlagRegistry.Add(TEXT("MassAPITest.Flag1"), 42);
+					FlagSettings.ExtendedFlagRegistry.Add(TEXT("MassAPITest.TooWide"), 600);
+				}));
+		});
+
+	AfterEach([this]()
+		{
+			TestWorld.Destroy();
+		});
+
+	It("resolves names from both registries, the enum registry first", [this]()
+		{
+			TestEqual(TEXT("Enum registry"), UMassAPIFlagSettings::ResolveFlagBit(FMassAPITestWorld::FlagName(EEntityFlags::Flag3)), 3);
+			TestEqual(TEXT("Extended registry"), UMassAPIFlagSettings::ResolveFlagBit(TEXT("MassAPITest.Wide")), 100);
+			TestEqual(TEXT("Enum registry wins a shared name"), UMassAPIFlagSettings::ResolveFlagBit(FMassAPITestWorld::FlagName(EEntityFlags::Flag1)), 1);
+			TestEqual(TEXT("Bits past every width are dropped"), UMassAPIFlagSettings::ResolveFlagBit(TEXT("MassAPITest.TooWide")), INDEX_NONE);
+			TestEqual(TEXT("Unknown name"), UMassAPIFlagSettings::ResolveFlagBit(TEXT("MassAPITest.Unknown")), INDEX_NONE);
+			TestEqual(TEXT("None name"), UMassAPIFlagSettings::ResolveFlagBit(NAME_None), INDEX_NONE);
+		});
+
+	It("changes the version with the registry and restores it with the registry", [this]()
+		{
+			const int32 Original = UMassAPIFlagSettings::GetRegistryVersion();
+			TestNotEqual(TEXT("Zero means never resolved"), Original, 0);
+			TestEqual(TEXT("Rebuilding the same content"), Rebuild(), Original);
+
+			Settings().FlagRegistry.Add(TEXT("MassAPITest.Added"), EEntityFlags::Flag9);
+			const int32 Added = Rebuild();
+			TestNotEqual(TEXT("New name"), Added, Original);
+
+			Settings().FlagRegistry.Add(TEXT("MassAPITest.Added"), EEntityFlags::Flag10);
+			TestNotEqual(TEXT("Same name, other bit"), Rebuild(), Added);
+
+			Settings().FlagRegistry.Remove(TEXT("MassAPITest.Added"));
+			TestEqual(TEXT("Back to the original registry"), Rebuild(), Original);
+		});
+
+	It("does not depend on registry insertion order", [this]()
+		{
+			const int32 Original = UMassAPIFlagSettings::GetRegistryVersion();
+			TMap<FName, EEntityFlags> Reversed;
+			TArray<FName> Names;
+			Settings().FlagRegistry.GenerateKeyArray(Names);
+			for (int32 Index = Names.Num() - 1; Index >= 0; --Index)
+			{
+				Reversed.Add(Names[Index], Settings().FlagRegistry[Names[Index]]);
+			}
+			Settings().FlagRegistry = MoveTemp(Reversed);
+			TestEqual(TEXT("Same content, reversed order"), Rebuild(), Original);
+		});
+
+	It("detects stale flag ids and re-resolves them", [this]()
+		{
+			const FName Name = FMassAPITestWorld::FlagName(EEntityFlags::Flag2);
+			FEntityFlagId FlagId(Name);
+			TestEqual(TEXT("Resolved"), FlagId.Bit, 2);
+			TestFalse(TEXT("Fresh"), FlagId.IsStale());
+
+			Rebuild();
+			TestFalse(TEXT("Unchanged registry keeps ids fresh"), FlagId.IsStale());
+
+			Settings().FlagRegistry.Add(Name, EEntityFlags::Flag6);
+			Rebuild();
+			TestTrue(TEXT("Stale after the bit moved"), FlagId.IsStale());
+			TestEqual(TEXT("Reads the new bit"), FlagId.GetBit(), 6);
+
+			const TArray<FMassEntityHandle> Entities = TestWorld.BuildRaw(1, 0);
+			TestTrue(TEXT("Stale id still writes"), TestWorld.MassAPI->SetFlag(Entities[0], FlagId));
+			TestTrue(TEXT("The new bit"), TestWorld.MassAPI->HasEntityFlag(Entities[0], EEntityFlags::Flag6));
+			TestFalse(TEXT("Not the old one"), TestWorld.MassAPI->HasEntityFlag(Entities[0], EEntityFlags::Flag2));
+
+			FlagId.Refresh();
+			TestFalse(TEXT("Refreshed"), FlagId.IsStale());
+			TestEqual(TEXT("Baked bit updated"), FlagId.Bit, 6);
+
+			Settings().FlagRegistry.Remove(Name);
+			Rebuild();
+			TestFalse(TEXT("Unregistered name is invalid"), FlagId.IsValid());
+		});
+
+	It("re-resolves query flag lists after a rebuild", [this]()
+		{
+			const FEntityQuery Query = FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag2 });
+			TestEqual(TEXT("Resolved"), Query.GetAllFlagsBitmask(), FMassAPITestWorld::FlagBit(EEntityFlags::Flag2));
+
+			Settings().FlagRegistry.Add(FMassAPITestWorld::FlagName(EEntityFlags::Flag2), EEntityFlags::Flag6);
+			Rebuild();
+			TestEqual(TEXT("Follows the moved bit"), Query.GetAllFlagsBitmask(), FMassAPITestWorld::FlagBit(EEntityFlags::Flag6));
+		});
+
+	It("keeps lookups whole while the table is rebuilt", [this]()
+		{
+			// Two registries that only differ in where one name points | 仅一个名称的位不同的两个注册表
+			const FName Name = TEXT("MassAPITest.Moving");
+			Settings().FlagRegistry.Add(Name, EEntityFlags::Flag3);
+			Rebuild();
+			UMassAPIFlagSettings* Other = NewObject<UMassAPIFlagSettings>(GetTransientPackage());
+			Other->FlagRegistry = Settings().FlagRegistry;
+			Other->ExtendedFlagRegistry = Settings().ExtendedFlagRegistry;
+			Other->FlagRegistry.Add(Name, EEntityFlags::Flag5);
+			const TStrongObjectPtr<UMassAPIFlagSettings> KeepOther(Other);
+
+			std::atomic<bool> bStop { false };
+			std::atomic<int32> NumTorn { 0 };
+			std::atomic<int32> NumReads { 0 };
+			TArray<TFuture<void>> Readers;
+			for (int32 ReaderIt = 0; ReaderIt < 4; ++ReaderIt)
+			{
+				Readers.Add(Async(EAsyncExecution::ThreadPool, [&bStop, &NumTorn, &NumReads, Name]()
+					{
+						while (!bStop.load())
+						{
+							const int32 Bit = UMassAPIFlagSettings::ResolveFlagBit(Name);
+							const int32 Wide = UMassAPIFlagSettings::ResolveFlagBit(TEXT("MassAPITest.Wide"));
+							if ((Bit != 3 && Bit != 5) || Wide != 100) ++NumTorn;
+							++NumReads;
+						}
+					}));
+			}
+
+			// Keep rebuilding until the readers have overlapped a good number of swaps | 持续重建直到读取与足够多的交换重叠
+			for (int32 RebuildIt = 0; RebuildIt < 500 || (NumReads.load() < 1000 && RebuildIt < 20000); ++RebuildIt)
+			{
+				(RebuildIt % 2 ? Other : &Settings())->RebuildFlagTable();
+			}
+			bStop = true;
+			for (TFuture<void>& Reader : Readers) { Reader.Wait(); }
+
+			TestTrue(TEXT("Readers ran"), NumReads.load() > 0);
+			TestEqual(TEXT("Every lookup saw one whole table"), NumTorn.load(), 0);
+		});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
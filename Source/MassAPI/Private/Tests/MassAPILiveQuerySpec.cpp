@@ -0,0 +1,100 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "MassAPITestWorld.h"
+
+BEGIN_DEFINE_SPEC(FMassAPILiveQuerySpec, "MassAPI.LiveQuery", EAutomationTestFlags::ProductFilter | EAutomationTestFlags_ApplicationContextMask)
+	FMassAPITestWorld TestWorld;
+	TArray<FMassEntityHandle> Raw;
+	int32 LiveQueryId = INDEX_NONE;
+
+	const FEntityLiveQuery& GetLive() const { return *TestWorld.MassAPI->GetLiveQuery(LiveQueryId); }
+END_DEFINE_SPEC(FMassAPILiveQuerySpec)
+
+void FMassAPILiveQuerySpec::Define()
+{
+	BeforeEach([this]()
+		{
+			TestTrue(TEXT("Test world has an entity manager"), TestWorld.Create());
+			Raw = TestWorld.BuildRaw(200, 0);
+			TestWorld.WriteFlagsDirect(Raw[3], FMassAPITestWorld::FlagBit(EEntityFlags::Flag0), 0);
+			LiveQueryId = TestWorld.MassAPI->RegisterLiveQuery(FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag0 }));
+		});
+
+	AfterEach([this]()
+		{
+			if (TestWorld.MassAPI) TestWorld.MassAPI->UnregisterLiveQuery(LiveQueryId);
+			Raw.Reset();
+			TestWorld.Destroy();
+		});
+
+	It("reports every current match as added on registration", [this]()
+		{
+			TestNotNull(TEXT("Registered"), TestWorld.MassAPI->GetLiveQuery(LiveQueryId));
+			TestTrue(TEXT("Added"), FMassAPITestWorld::SameEntities(GetLive().Added, { Raw[3] }));
+			TestEqual(TEXT("Matching"), GetLive().Matching.Num(), 1);
+		});
+
+	It("picks up flags written directly into the fragment once invalidated", [this]()
+		{
+			TestWorld.WriteFlagsDirect(Raw[150], FMassAPITestWorld::FlagBit(EEntityFlags::Flag0), 0);
+			TestWorld.Tick();
+			TestEqual(TEXT("Unrecorded write is not rescanned"), GetLive().Added.Num(), 0);
+
+			TestWorld.MassAPI->InvalidateLiveQueries();
+			TestWorld.Tick();
+			TestTrue(TEXT("Directly set entity is added"), FMassAPITestWorld::SameEntities(GetLive().Added, { Raw[150] }));
+			TestEqual(TEXT("Nothing removed"), GetLive().Removed.Num(), 0);
+
+			TestWorld.WriteFlagsDirect(Raw[3], 0, 0);
+			TestWorld.MassAPI->InvalidateLiveQueries();
+			TestWorld.Tick();
+			TestEqual(TEXT("Nothing added"), GetLive().Added.Num(), 0);
+			TestTrue(TEXT("Directly cleared entity is removed"), FMassAPITestWorld::SameEntities(GetLive().Removed, { Raw[3] }));
+			TestTrue(TEXT("Current set"), GetLive().Matching.Contains(Raw[150]) && GetLive().Matching.Num() == 1);
+		});
+
+	It("follows MassAPI writes, builds and destruction", [this]()
+		{
+			TestWorld.MassAPI->SetEntityFlag(Raw[10], EEntityFlags::Flag0);
+			const TArray<FMassEntityHandle> Built = TestWorld.BuildWithFlags(2, { EEntityFlags::Flag0 });
+			TestWorld.Tick();
+			TestTrue(TEXT("Set and built entities are added"), FMassAPITestWorld::SameEntities(GetLive().Added, { Raw[10], Built[0], Built[1] }));
+
+			TestWorld.Manager->DestroyEntity(Built[0]);
+			TestWorld.MassAPI->ClearEntityFlag(Raw[10], EEntityFlags::Flag0);
+			TestWorld.Tick();
+			TestTrue(TEXT("Destroyed and cleared entities are removed"), FMassAPITestWorld::SameEntities(GetLive().Removed, { Built[0], Raw[10] }));
+		});
+
+	It("rescans archetypes only for writes of watched bits", [this]()
+		{
+			// Flag1 is not watched: the direct Flag0 write beside it stays unseen | Flag1 不在掩码中，同原型的直接写入不会被重扫
+			TestWorld.WriteFlagsDirect(Raw[20], FMassAPITestWorld::FlagBit(EEntityFlags::Flag0), 0);
+			TestWorld.MassAPI->SetEntityFlag(Raw[21], EEntityFlags::Flag1);
+			TestWorld.Tick();
+			TestEqual(TEXT("Unwatched write"), GetLive().Added.Num(), 0);
+
+			// A Flag0 write rescans the archetype, which also finds the earlier direct write | Flag0 写入使原型重扫
+			TestWorld.MassAPI->SetEntityFlag(Raw[22], EEntityFlags::Flag0);
+			TestWorld.Tick();
+			TestTrue(TEXT("Watched write"), FMassAPITestWorld::SameEntities(GetLive().Added, { Raw[20], Raw[22] }));
+		});
+
+	It("reports empty deltas when nothing changed", [this]()
+		{
+			TestWorld.Tick();
+			TestWorld.Tick();
+			TestEqual(TEXT("Added"), GetLive().Added.Num(), 0);
+			TestEqual(TEXT("Removed"), GetLive().Removed.Num(), 0);
+			TestEqual(TEXT("Matching"), GetLive().Matching.Num(), 1);
+		});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,85 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "MassAPITestWorld.h"
+
+BEGIN_DEFINE_SPEC(FMassAPIMatchBatchSpec, "MassAPI.MatchBatch", EAutomationTestFlags::ProductFilter | EAutomationTestFlags_ApplicationContextMask)
+	FMassAPITestWorld TestWorld;
+	TArray<FEntityHandle> Handles;
+
+	// Every batched verdict must equal the per-handle MatchQuery | 批量结果必须与逐个 MatchQuery 一致
+	void ExpectSameAsSingle(const TCHAR* What, const FEntityQuery& Query)
+	{
+		TBitArray<> Matches;
+		TestWorld.MassAPI->MatchQueryBatch(Handles, Query, Matches);
+		if (!TestEqual(FString::Printf(TEXT("%s: one verdict per handle"), What), Matches.Num(), Handles.Num())) return;
+
+		for (int32 Index = 0; Index < Handles.Num(); ++Index)
+		{
+			if (Matches[Index] != TestWorld.MassAPI->MatchQuery(Handles[Index], Query))
+			{
+				AddError(FString::Printf(TEXT("%s: verdict %d differs from MatchQuery"), What, Index));
+				return;
+			}
+		}
+	}
+END_DEFINE_SPEC(FMassAPIMatchBatchSpec)
+
+void FMassAPIMatchBatchSpec::Define()
+{
+	BeforeEach([this]()
+		{
+			TestTrue(TEXT("Test world has an entity manager"), TestWorld.Create());
+
+			// Interleave archetypes so the batch has to restore the input order | 交错不同原型，验证保持输入顺序
+			const TArray<FMassEntityHandle> Built = TestWorld.BuildWithFlags(50, { EEntityFlags::Flag0 });
+			const TArray<FMassEntityHandle> Raw = TestWorld.BuildRaw(50, 0);
+			const TArray<FMassEntityHandle> Unflagged = TestWorld.BuildRaw(50, 0, { FTransformFragment::StaticStruct() });
+			for (int32 Index = 0; Index < 50; ++Index)
+			{
+				Handles.Add(Built[Index]);
+				Handles.Add(Raw[Index]);
+				Handles.Add(Unflagged[Index]);
+				if (Index % 7 == 0)
+				{
+					TestWorld.WriteFlagsDirect(Raw[Index], FMassAPITestWorld::FlagBit(EEntityFlags::Flag0), 0);
+				}
+			}
+
+			// Destroyed and never-set handles never match | 已销毁与未设置的句柄不匹配
+			const FMassEntityHandle Destroyed = TestWorld.BuildRaw(1, 0)[0];
+			TestWorld.Manager->DestroyEntity(Destroyed);
+			Handles.Insert(FEntityHandle(Destroyed), 10);
+			Handles.Insert(FEntityHandle(), 20);
+		});
+
+	AfterEach([this]()
+		{
+			Handles.Reset();
+			TestWorld.Destroy();
+		});
+
+	It("keeps the input order and agrees with MatchQuery", [this]()
+		{
+			ExpectSameAsSingle(TEXT("Composition only"), FMassAPITestWorld::FlagQuery({}));
+			ExpectSameAsSingle(TEXT("All Flag0"), FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag0 }));
+			ExpectSameAsSingle(TEXT("None Flag0"), FMassAPITestWorld::FlagQuery({}, {}, { EEntityFlags::Flag0 }));
+		});
+
+	It("reads flags written directly into the fragment", [this]()
+		{
+			TBitArray<> Matches;
+			TestWorld.MassAPI->MatchQueryBatch(Handles, FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag0 }), Matches);
+			TestEqual(TEXT("50 built plus 8 directly flagged"), Matches.CountSetBits(), 58);
+			TestFalse(TEXT("Destroyed handle"), Matches[10]);
+			TestFalse(TEXT("Unset handle"), Matches[20]);
+		});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,77 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "MassAPITestWorld.h"
+
+BEGIN_DEFINE_SPEC(FMassAPIParallelQuerySpec, "MassAPI.ParallelQuery", EAutomationTestFlags::ProductFilter | EAutomationTestFlags_ApplicationContextMask)
+	FMassAPITestWorld TestWorld;
+END_DEFINE_SPEC(FMassAPIParallelQuerySpec)
+
+void FMassAPIParallelQuerySpec::Define()
+{
+	BeforeEach([this]()
+		{
+			TestTrue(TEXT("Test world has an entity manager"), TestWorld.Create());
+
+			// Several archetypes and many chunks, with flags from both MassAPI and direct writes | 多原型多 Chunk，旗标来自 MassAPI 与直接写入
+			TestWorld.BuildWithFlags(3000, { EEntityFlags::Flag0 });
+			TestWorld.BuildWithFlags(2000, { EEntityFlags::Flag1 });
+			const TArray<FMassEntityHandle> Raw = TestWorld.BuildRaw(4000, 0);
+			for (int32 Index = 0; Index < Raw.Num(); Index += 3)
+			{
+				TestWorld.WriteFlagsDirect(Raw[Index], FMassAPITestWorld::FlagBit(EEntityFlags::Flag0), 0);
+			}
+		});
+
+	AfterEach([this]()
+		{
+			TestWorld.Destroy();
+		});
+
+	It("returns the serial result in the same order when forced parallel", [this]()
+		{
+			const FEntityQuery Query = FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag0 });
+
+			TArray<FMassEntityHandle> Serial;
+			TestWorld.MassAPI->GetMatchingEntities(Query, Serial);
+
+			TArray<FMassEntityHandle> Parallel;
+			TestWorld.MassAPI->GetMatchingEntitiesParallel(Query, Parallel, /*SerialThreshold*/0);
+			TestTrue(TEXT("Same entities in archetype then chunk order"), Parallel == Serial);
+			TestEqual(TEXT("MassAPI-built plus directly flagged entities"), Parallel.Num(), 3000 + 1334);
+		});
+
+	It("is deterministic across runs", [this]()
+		{
+			const FEntityQuery Query = FMassAPITestWorld::FlagQuery({}, {}, { EEntityFlags::Flag1 });
+
+			TArray<FMassEntityHandle> First;
+			TestWorld.MassAPI->GetMatchingEntitiesParallel(Query, First, 0);
+			for (int32 Run = 0; Run < 4; ++Run)
+			{
+				TArray<FMassEntityHandle> Again;
+				TestWorld.MassAPI->GetMatchingEntitiesParallel(Query, Again, 0);
+				TestTrue(TEXT("Repeated run"), Again == First);
+			}
+		});
+
+	It("stays serial below the threshold with the same result", [this]()
+		{
+			const FEntityQuery Query = FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag1 });
+
+			TArray<FMassEntityHandle> Serial;
+			TestWorld.MassAPI->GetMatchingEntities(Query, Serial);
+
+			TArray<FMassEntityHandle> BelowThreshold;
+			TestWorld.MassAPI->GetMatchingEntitiesParallel(Query, BelowThreshold, MAX_int32);
+			TestTrue(TEXT("Serial fallback"), BelowThreshold == Serial);
+		});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,109 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "MassAPITestWorld.h"
+
+BEGIN_DEFINE_SPEC(FMassAPIPredicateSpec, "MassAPI.Predicate", EAutomationTestFlags::ProductFilter | EAutomationTestFlags_ApplicationContextMask)
+	FMassAPITestWorld TestWorld;
+	TArray<FMassEntityHandle> Sized;
+	TArray<FMassEntityHandle> Unsized;
+
+	TArray<FMassEntityHandle> Match(const FEntityQuery& Query) const
+	{
+		TArray<FMassEntityHandle> Result;
+		TestWorld.MassAPI->GetMatchingEntities(Query, Result);
+		return Result;
+	}
+
+	static FEntityQuery RadiusWhere(const EEntityPredicateOp Op, const double Value)
+	{
+		FEntityQuery Query;
+		Query.Where<FAgentRadiusFragment>(TEXT("Radius"), Op, Value);
+		return Query;
+	}
+END_DEFINE_SPEC(FMassAPIPredicateSpec)
+
+void FMassAPIPredicateSpec::Define()
+{
+	BeforeEach([this]()
+		{
+			TestTrue(TEXT("Test world has an entity manager"), TestWorld.Create());
+
+			// Radius and X position equal the entity's position in Sized | 半径与 X 坐标等于实体序号
+			Sized = TestWorld.BuildRaw(10, 0, { FEntityFlagFragment::StaticStruct(), FTransformFragment::StaticStruct(), FAgentRadiusFragment::StaticStruct() });
+			for (int32 Index = 0; Index < Sized.Num(); ++Index)
+			{
+				TestWorld.Manager->GetFragmentDataChecked<FAgentRadiusFragment>(Sized[Index]).Radius = Index;
+				TestWorld.Manager->GetFragmentDataChecked<FTransformFragment>(Sized[Index]).GetMutableTransform().SetLocation(FVector(Index, 0.0, 0.0));
+			}
+			Unsized = TestWorld.BuildRaw(5, 0);
+		});
+
+	AfterEach([this]()
+		{
+			Sized.Reset();
+			Unsized.Reset();
+			TestWorld.Destroy();
+		});
+
+	It("applies each comparison operator", [this]()
+		{
+			TestTrue(TEXT("<"), FMassAPITestWorld::SameEntities(Match(RadiusWhere(EEntityPredicateOp::Less, 2.0)), { Sized[0], Sized[1] }));
+			TestTrue(TEXT("<="), FMassAPITestWorld::SameEntities(Match(RadiusWhere(EEntityPredicateOp::LessEqual, 1.0)), { Sized[0], Sized[1] }));
+			TestTrue(TEXT(">"), FMassAPITestWorld::SameEntities(Match(RadiusWhere(EEntityPredicateOp::Greater, 8.0)), { Sized[9] }));
+			TestTrue(TEXT(">="), FMassAPITestWorld::SameEntities(Match(RadiusWhere(EEntityPredicateOp::GreaterEqual, 8.0)), { Sized[8], Sized[9] }));
+			TestTrue(TEXT("=="), FMassAPITestWorld::SameEntities(Match(RadiusWhere(EEntityPredicateOp::Equal, 5.0)), { Sized[5] }));
+			TestEqual(TEXT("!= only sees entities with the fragment"), Match(RadiusWhere(EEntityPredicateOp::NotEqual, 5.0)).Num(), 9);
+		});
+
+	It("requires every clause and agrees with the count path", [this]()
+		{
+			FEntityQuery Query;
+			Query.Where<FAgentRadiusFragment>(TEXT("Radius"), EEntityPredicateOp::GreaterEqual, 3.0)
+				.Where<FAgentRadiusFragment>(TEXT("Radius"), EEntityPredicateOp::Less, 6.0);
+			TestTrue(TEXT("Range"), FMassAPITestWorld::SameEntities(Match(Query), { Sized[3], Sized[4], Sized[5] }));
+			TestEqual(TEXT("Count"), TestWorld.MassAPI->CountMatchingEntities(Query), 3);
+			TestEqual(TEXT("Compiled count"), TestWorld.MassAPI->CountMatchingEntities(Query.Compile()), 3);
+		});
+
+	It("combines clauses with flag conditions", [this]()
+		{
+			TestWorld.MassAPI->SetEntityFlag(Sized[7], EEntityFlags::Flag2);
+			TestWorld.MassAPI->SetEntityFlag(Sized[2], EEntityFlags::Flag2);
+			FEntityQuery Query = FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag2 });
+			Query.Where<FAgentRadiusFragment>(TEXT("Radius"), EEntityPredicateOp::Greater, 4.0);
+			TestTrue(TEXT("Flag and member"), FMassAPITestWorld::SameEntities(Match(Query), { Sized[7] }));
+		});
+
+	It("follows a nested member path", [this]()
+		{
+			FEntityQuery Query;
+			Query.Where<FTransformFragment>(TEXT("Transform.Translation.X"), EEntityPredicateOp::GreaterEqual, 8.0);
+			TestTrue(TEXT("Nested double"), FMassAPITestWorld::SameEntities(Match(Query), { Sized[8], Sized[9] }));
+		});
+
+	It("matches nothing for a member of an unsupported type", [this]()
+		{
+			AddExpectedMessage(TEXT("is not a bool, integer, float, double or enum"), ELogVerbosity::Warning, EAutomationExpectedMessageFlags::Contains, 0);
+			FEntityQuery Query;
+			Query.Where<FTransformFragment>(TEXT("Transform"), EEntityPredicateOp::NotEqual, 0.0);
+			TestEqual(TEXT("Struct member"), Match(Query).Num(), 0);
+			TestEqual(TEXT("Count path too"), TestWorld.MassAPI->CountMatchingEntities(Query), 0);
+		});
+
+	It("matches nothing for a missing member", [this]()
+		{
+			AddExpectedMessage(TEXT("not found in"), ELogVerbosity::Warning, EAutomationExpectedMessageFlags::Contains, 0);
+			FEntityQuery Query;
+			Query.Where<FAgentRadiusFragment>(TEXT("Diameter"), EEntityPredicateOp::NotEqual, 0.0);
+			TestEqual(TEXT("Missing member"), Match(Query).Num(), 0);
+		});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,128 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "MassAPITestWorld.h"
+
+BEGIN_DEFINE_SPEC(FMassAPIQueryCacheSpec, "MassAPI.QueryCache", EAutomationTestFlags::ProductFilter | EAutomationTestFlags_ApplicationContextMask)
+	FMassAPITestWorld TestWorld;
+	TArray<FMassEntityHandle> Moving;
+	TArray<FMassEntityHandle> Sized;
+
+	int32 Count(const FEntityQuery& Query) const
+	{
+		TArray<FMassEntityHandle> Result;
+		TestWorld.MassAPI->GetMatchingEntities(Query, Result);
+		return Result.Num();
+	}
+
+	static FEntityQuery RadiusQuery(const double AtLeast)
+	{
+		FEntityQuery Query;
+		Query.Where<FAgentRadiusFragment>(TEXT("Radius"), EEntityPredicateOp::GreaterEqual, AtLeast);
+		return Query;
+	}
+END_DEFINE_SPEC(FMassAPIQueryCacheSpec)
+
+void FMassAPIQueryCacheSpec::Define()
+{
+	BeforeEach([this]()
+		{
+			TestTrue(TEXT("Test world has an entity manager"), TestWorld.Create());
+
+			Moving = TestWorld.BuildRaw(20, FMassAPITestWorld::FlagBit(EEntityFlags::Flag1));
+			Sized = TestWorld.BuildRaw(10, 0, { FEntityFlagFragment::StaticStruct(), FTransformFragment::StaticStruct(), FAgentRadiusFragment::StaticStruct() });
+			for (int32 Index = 0; Index < Sized.Num(); ++Index)
+			{
+				TestWorld.Manager->GetFragmentDataChecked<FAgentRadiusFragment>(Sized[Index]).Radius = Index;
+			}
+		});
+
+	AfterEach([this]()
+		{
+			Moving.Reset();
+			Sized.Reset();
+			TestWorld.Destroy();
+		});
+
+	It("shares one native query between queries listing the same fragments in any order", [this]()
+		{
+			FEntityQuery First;
+			First.All<FTransformFragment>().All<FAgentRadiusFragment>();
+			FEntityQuery Second;
+			Second.All<FAgentRadiusFragment>().All<FTransformFragment>();
+
+			TestEqual(TEXT("Same key"), First.GetNativeQueryKey(), Second.GetNativeQueryKey());
+			TestTrue(TEXT("Same native query"), &TestWorld.MassAPI->GetCachedNativeQuery(First) == &TestWorld.MassAPI->GetCachedNativeQuery(Second));
+			TestEqual(TEXT("Results"), Count(Second), Sized.Num());
+		});
+
+	It("keeps separate native queries for different requirements", [this]()
+		{
+			FEntityQuery Transforms;
+			Transforms.All<FTransformFragment>();
+			FEntityQuery Radii;
+			Radii.All<FAgentRadiusFragment>();
+			const FEntityQuery Flagged = FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag1 });
+
+			TestTrue(TEXT("Other fragment"), &TestWorld.MassAPI->GetCachedNativeQuery(Transforms) != &TestWorld.MassAPI->GetCachedNativeQuery(Radii));
+			TestTrue(TEXT("Flag column requirement"), &TestWorld.MassAPI->GetCachedNativeQuery(Transforms) != &TestWorld.MassAPI->GetCachedNativeQuery(Flagged));
+			TestEqual(TEXT("Transforms"), Count(Transforms), Moving.Num() + Sized.Num());
+			TestEqual(TEXT("Radii"), Count(Radii), Sized.Num());
+			TestEqual(TEXT("Flagged"), Count(Flagged), Moving.Num());
+		});
+
+	It("picks up archetypes created after the query was cached", [this]()
+		{
+			FEntityQuery Query;
+			Query.All<FTransformFragment>();
+			TestEqual(TEXT("Before"), Count(Query), Moving.Num() + Sized.Num());
+
+			const TArray<FMassEntityHandle> Later = TestWorld.BuildRaw(7, 0, { FTransformFragment::StaticStruct(), FAgentRadiusFragment::StaticStruct() });
+			TestEqual(TEXT("New archetype seen"), Count(Query), Moving.Num() + Sized.Num() + Later.Num());
+		});
+
+	It("compiles queries sharing a native query separately", [this]()
+		{
+			const FEntityQuery Large = RadiusQuery(7.0);
+			const FEntityQuery Small = RadiusQuery(2.0);
+			TestEqual(TEXT("Same key, values differ"), Large.GetNativeQueryKey(), Small.GetNativeQueryKey());
+
+			const TSharedRef<const FCompiledEntityQuery> LargeCompiled = TestWorld.MassAPI->GetCachedCompiledQuery(Large);
+			TestTrue(TEXT("Reused for the same query"), LargeCompiled == TestWorld.MassAPI->GetCachedCompiledQuery(RadiusQuery(7.0)));
+			TestTrue(TEXT("Not reused for other values"), LargeCompiled != TestWorld.MassAPI->GetCachedCompiledQuery(Small));
+			TestEqual(TEXT("Large"), Count(Large), 3);
+			TestEqual(TEXT("Small"), Count(Small), 8);
+		});
+
+	It("recompiles flag queries after the registry changes", [this]()
+		{
+			const FEntityQuery Query = FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag1 });
+			const TSharedRef<const FCompiledEntityQuery> Before = TestWorld.MassAPI->GetCachedCompiledQuery(Query);
+			TestEqual(TEXT("Flag1 entities"), Count(Query), Moving.Num());
+
+			UMassAPIFlagSettings* Settings = GetMutableDefault<UMassAPIFlagSettings>();
+			Settings->FlagRegistry.Add(FMassAPITestWorld::FlagName(EEntityFlags::Flag1), EEntityFlags::Flag5);
+			Settings->RebuildFlagTable();
+
+			TestTrue(TEXT("Compiled anew"), Before != TestWorld.MassAPI->GetCachedCompiledQuery(Query));
+			TestEqual(TEXT("Name now means bit 5"), Count(Query), 0);
+		});
+
+	It("rebuilds dropped entries on the next use", [this]()
+		{
+			const FEntityQuery Query = FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag1 });
+			TestEqual(TEXT("Before reset"), Count(Query), Moving.Num());
+			TestWorld.MassAPI->ResetQueryCache();
+			TestWorld.MassAPI->SetEntityFlag(Sized[0], EEntityFlags::Flag1);
+			TestEqual(TEXT("After reset"), Count(Query), Moving.Num() + 1);
+			TestEqual(TEXT("Count path"), TestWorld.MassAPI->CountMatchingEntities(Query), Moving.Num() + 1);
+		});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,123 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "MassAPIVersion.h"
+#include "MassAPITestWorld.h"
+
+BEGIN_DEFINE_SPEC(FMassAPITagBackedFlagSpec, "MassAPI.TagBackedFlag", EAutomationTestFlags::ProductFilter | EAutomationTestFlags_ApplicationContextMask)
+	FMassAPITestWorld TestWorld;
+	TArray<FMassEntityHandle> Raw;
+
+	bool HasMirrorTag(const FMassEntityHandle Entity) const
+	{
+		return TestWorld.Manager->GetArchetypeComposition(TestWorld.Manager->GetArchetypeForEntity(Entity)).GET_TAGS.Contains<FEntityFlagMirrorTag0>();
+	}
+
+	TArray<FMassEntityHandle> MatchFlag4() const
+	{
+		TArray<FMassEntityHandle> Result;
+		TestWorld.MassAPI->GetMatchingEntities(FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag4 }), Result);
+		return Result;
+	}
+
+	// The mirror command is pushed by one tick and applied at the next flush | 镜像命令由一帧推入，在下一次刷新时执行
+	void SyncMirrors() const
+	{
+		TestWorld.Tick();
+		TestWorld.Manager->FlushCommands();
+	}
+END_DEFINE_SPEC(FMassAPITagBackedFlagSpec)
+
+void FMassAPITagBackedFlagSpec::Define()
+{
+	BeforeEach([this]()
+		{
+			TestTrue(TEXT("Test world has an entity manager"), TestWorld.Create([](UMassAPIFlagSettings& Settings) { Settings.TagBackedFlags = { EEntityFlags::Flag4 }; }));
+			Raw = TestWorld.BuildRaw(100, 0);
+		});
+
+	AfterEach([this]()
+		{
+			Raw.Reset();
+			TestWorld.Destroy();
+		});
+
+	It("moves entities to the mirror tag in one batch", [this]()
+		{
+			TestWorld.MassAPI->SetEntityFlag(Raw[1], EEntityFlags::Flag4);
+			TestWorld.MassAPI->SetFlagsBatch(TArray<FMassEntityHandle>{ Raw[2], Raw[3] }, FMassAPITestWorld::FlagBit(EEntityFlags::Flag4), 0);
+			TestEqual(TEXT("Queued"), TestWorld.MassAPI->GetNumPendingFlagMirrors(), 3);
+			TestFalse(TEXT("Mirror lags until the flush"), HasMirrorTag(Raw[1]));
+
+			SyncMirrors();
+			TestEqual(TEXT("Nothing queued"), TestWorld.MassAPI->GetNumPendingFlagMirrors(), 0);
+			TestTrue(TEXT("Tagged"), HasMirrorTag(Raw[1]) && HasMirrorTag(Raw[2]) && HasMirrorTag(Raw[3]));
+			TestFalse(TEXT("Untouched entity"), HasMirrorTag(Raw[4]));
+			TestTrue(TEXT("Matched"), FMassAPITestWorld::SameEntities(MatchFlag4(), { Raw[1], Raw[2], Raw[3] }));
+
+			const FEntityFlagMigrationStats Stats = TestWorld.MassAPI->GetFlagMigrationStats(EEntityFlags::Flag4);
+			TestEqual(TEXT("Transitions"), Stats.Transitions, static_cast<int64>(3));
+			TestEqual(TEXT("Migrations"), Stats.Migrations, static_cast<int64>(3));
+			TestEqual(TEXT("One batch from one source archetype"), Stats.Batches, static_cast<int64>(1));
+		});
+
+	It("answers from the flag bits whatever the mirror tags say", [this]()
+		{
+			TestWorld.MassAPI->SetFlagsBatch(TArray<FMassEntityHandle>{ Raw[5], Raw[6] }, FMassAPITestWorld::FlagBit(EEntityFlags::Flag4), 0);
+			TestTrue(TEXT("Matched before the mirror catches up"), FMassAPITestWorld::SameEntities(MatchFlag4(), { Raw[5], Raw[6] }));
+			SyncMirrors();
+
+			// Direct writes never move the tag | 直接写入不会迁移标签
+			TestWorld.WriteFlagsDirect(Raw[5], 0, 0);
+			TestWorld.WriteFlagsDirect(Raw[9], FMassAPITestWorld::FlagBit(EEntityFlags::Flag4), 0);
+			TestTrue(TEXT("Tag is stale"), HasMirrorTag(Raw[5]));
+			TestFalse(TEXT("Tag is missing"), HasMirrorTag(Raw[9]));
+
+			const FEntityQuery AllFlag4 = FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag4 });
+			const FEntityQuery NoneFlag4 = FMassAPITestWorld::FlagQuery({}, {}, { EEntityFlags::Flag4 });
+			TArray<FMassEntityHandle> All, AllCompiled, None, NoneCompiled;
+			TestWorld.MassAPI->GetMatchingEntities(AllFlag4, All);
+			TestWorld.MassAPI->GetMatchingEntities(AllFlag4.Compile(), AllCompiled);
+			TestWorld.MassAPI->GetMatchingEntities(NoneFlag4, None);
+			TestWorld.MassAPI->GetMatchingEntities(NoneFlag4.Compile(), NoneCompiled);
+
+			TestTrue(TEXT("All: set bits only"), FMassAPITestWorld::SameEntities(All, { Raw[6], Raw[9] }));
+			TestTrue(TEXT("All: compiled path agrees"), FMassAPITestWorld::SameEntities(AllCompiled, All));
+			TestEqual(TEXT("None: every other entity"), None.Num(), Raw.Num() - 2);
+			TestTrue(TEXT("None: directly cleared entity with a stale tag"), None.Contains(Raw[5]));
+			TestFalse(TEXT("None: set bit"), None.Contains(Raw[6]));
+			TestTrue(TEXT("None: compiled path agrees"), FMassAPITestWorld::SameEntities(NoneCompiled, None));
+		});
+
+	It("removes the tag when the flag is cleared and keeps other bits", [this]()
+		{
+			TestWorld.WriteFlagsDirect(Raw[7], FMassAPITestWorld::FlagBit(EEntityFlags::Flag1), 0);
+			TestWorld.MassAPI->SetEntityFlag(Raw[7], EEntityFlags::Flag4);
+			SyncMirrors();
+			TestTrue(TEXT("Tagged"), HasMirrorTag(Raw[7]));
+
+			TestWorld.MassAPI->ClearEntityFlag(Raw[7], EEntityFlags::Flag4);
+			SyncMirrors();
+			TestFalse(TEXT("Untagged"), HasMirrorTag(Raw[7]));
+			TestTrue(TEXT("Directly written Flag1 survives both moves"), TestWorld.MassAPI->HasEntityFlag(Raw[7], EEntityFlags::Flag1));
+			TestEqual(TEXT("No match"), MatchFlag4().Num(), 0);
+		});
+
+	It("skips entities whose flag flipped back before the flush", [this]()
+		{
+			TestWorld.MassAPI->SetEntityFlag(Raw[8], EEntityFlags::Flag4);
+			TestWorld.MassAPI->ClearEntityFlag(Raw[8], EEntityFlags::Flag4);
+			SyncMirrors();
+
+			TestFalse(TEXT("Never tagged"), HasMirrorTag(Raw[8]));
+			TestEqual(TEXT("No migration"), TestWorld.MassAPI->GetFlagMigrationStats(EEntityFlags::Flag4).Migrations, static_cast<int64>(0));
+		});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,106 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "MassAPIFuncLib.h"
+#include "MassAPITestWorld.h"
+
+BEGIN_DEFINE_SPEC(FMassAPITemplateArchetypeSpec, "MassAPI.TemplateArchetype", EAutomationTestFlags::ProductFilter | EAutomationTestFlags_ApplicationContextMask)
+	FMassAPITestWorld TestWorld;
+	FEntityTemplateData Template;
+
+	static FAgentRadiusFragment Radius(const float Value)
+	{
+		FAgentRadiusFragment Fragment;
+		Fragment.Radius = Value;
+		return Fragment;
+	}
+
+	bool AllIn(TConstArrayView<FMassEntityHandle> Entities, const FMassArchetypeHandle& Archetype) const
+	{
+		for (const FMassEntityHandle& Entity : Entities)
+		{
+			if (TestWorld.Manager->GetArchetypeForEntity(Entity) != Archetype) return false;
+		}
+		return Entities.Num() > 0;
+	}
+END_DEFINE_SPEC(FMassAPITemplateArchetypeSpec)
+
+void FMassAPITemplateArchetypeSpec::Define()
+{
+	BeforeEach([this]()
+		{
+			TestTrue(TEXT("Test world has an entity manager"), TestWorld.Create());
+
+			Template = FEntityTemplateData(MakeShared<FMassEntityTemplateData>());
+			Template.Get()->AddFragment(FConstStructView::Make(FTransformFragment()));
+		});
+
+	AfterEach([this]()
+		{
+			Template = FEntityTemplateData();
+			TestWorld.Destroy();
+		});
+
+	It("resolves the archetype once and builds into it", [this]()
+		{
+			const FMassArchetypeHandle Archetype = Template.GetArchetype(*TestWorld.Manager);
+			TestTrue(TEXT("Valid"), Archetype.IsValid());
+			TestTrue(TEXT("Cached"), Template.GetArchetype(*TestWorld.Manager) == Archetype);
+			TestTrue(TEXT("The manager's archetype for the composition"), TestWorld.Manager->CreateArchetype(Template.Get()->GetCompositionDescriptor()) == Archetype);
+
+			TestTrue(TEXT("Batch build"), AllIn(TestWorld.MassAPI->BuildEntities(5, Template), Archetype));
+			TestTrue(TEXT("Single build"), AllIn({ TestWorld.MassAPI->BuildEntity(Template) }, Archetype));
+		});
+
+	It("keeps the archetype when only fragment values change", [this]()
+		{
+			UMassAPIFuncLib::SetFragments_Template(TestWorld.World, Template, { FInstancedStruct::Make(Radius(1.f)) });
+			const FMassArchetypeHandle Archetype = Template.GetArchetype(*TestWorld.Manager);
+
+			UMassAPIFuncLib::SetFragments_Template(TestWorld.World, Template, { FInstancedStruct::Make(Radius(4.f)) });
+			TestTrue(TEXT("Same archetype"), Template.GetArchetype(*TestWorld.Manager) == Archetype);
+
+			const TArray<FMassEntityHandle> Built = TestWorld.MassAPI->BuildEntities(3, Template);
+			TestEqual(TEXT("New value built"), TestWorld.Manager->GetFragmentDataChecked<FAgentRadiusFragment>(Built[2]).Radius, 4.f);
+		});
+
+	It("resolves again after the composition changes", [this]()
+		{
+			const FMassArchetypeHandle Before = Template.GetArchetype(*TestWorld.Manager);
+
+			UMassAPIFuncLib::SetFragments_Template(TestWorld.World, Template, { FInstancedStruct::Make(Radius(2.f)) });
+			const FMassArchetypeHandle WithRadius = Template.GetArchetype(*TestWorld.Manager);
+			TestTrue(TEXT("Fragment added"), WithRadius != Before);
+			const TArray<FMassEntityHandle> Built = TestWorld.MassAPI->BuildEntities(2, Template);
+			TestTrue(TEXT("Built into the new archetype"), AllIn(Built, WithRadius));
+			TestTrue(TEXT("With the fragment"), TestWorld.Manager->GetFragmentDataPtr<FAgentRadiusFragment>(Built[0]) != nullptr);
+
+			UMassAPIFuncLib::AddTag_Template(Template, FEntityFlagMirrorTag3::StaticStruct());
+			TestTrue(TEXT("Tag added"), Template.GetArchetype(*TestWorld.Manager) != WithRadius);
+
+			UMassAPIFuncLib::RemoveTag_Template(Template, FEntityFlagMirrorTag3::StaticStruct());
+			TestTrue(TEXT("Tag removed, back to the earlier archetype"), Template.GetArchetype(*TestWorld.Manager) == WithRadius);
+		});
+
+	It("resolves again for another entity manager", [this]()
+		{
+			const FMassArchetypeHandle First = Template.GetArchetype(*TestWorld.Manager);
+
+			FMassAPITestWorld OtherWorld;
+			TestTrue(TEXT("Second world"), OtherWorld.Create());
+			const FMassArchetypeHandle Other = Template.GetArchetype(*OtherWorld.Manager);
+			TestTrue(TEXT("Another manager's archetype"), Other.IsValid() && Other != First);
+			TestEqual(TEXT("Builds in the other world"), OtherWorld.MassAPI->BuildEntities(4, Template).Num(), 4);
+			OtherWorld.Destroy();
+
+			TestTrue(TEXT("Back to the first manager"), Template.GetArchetype(*TestWorld.Manager) == First);
+		});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,114 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "MassEntityView.h"
+#include "MassAPITestWorld.h"
+#include "MassAPITestTypes.h"
+
+BEGIN_DEFINE_SPEC(FMassAPITemplateBatchSpec, "MassAPI.TemplateBatch", EAutomationTestFlags::ProductFilter | EAutomationTestFlags_ApplicationContextMask)
+	FMassAPITestWorld TestWorld;
+
+	// Shared values are separate FSharedStruct instances on purpose, so equal values must batch by value | 刻意使用不同实例的共享值
+	static FEntityTemplateData MakeTemplate(const float Radius, const int32 SharedValue)
+	{
+		FAgentRadiusFragment RadiusFragment;
+		RadiusFragment.Radius = Radius;
+
+		FEntityTemplateData Template(MakeShared<FMassEntityTemplateData>());
+		Template.Get()->AddFragment(FConstStructView::Make(FTransformFragment()));
+		Template.Get()->AddFragment(FConstStructView::Make(RadiusFragment));
+		Template.Get()->AddSharedFragment(FSharedStruct::Make(FMassAPITestSharedFragment(SharedValue)));
+		return Template;
+	}
+
+	float RadiusOf(const FMassEntityHandle Entity) const
+	{
+		return TestWorld.Manager->GetFragmentDataChecked<FAgentRadiusFragment>(Entity).Radius;
+	}
+
+	int32 SharedOf(const FMassEntityHandle Entity) const
+	{
+		return FMassEntityView(*TestWorld.Manager, Entity).GetSharedFragmentData<FMassAPITestSharedFragment>().Value;
+	}
+END_DEFINE_SPEC(FMassAPITemplateBatchSpec)
+
+void FMassAPITemplateBatchSpec::Define()
+{
+	BeforeEach([this]()
+		{
+			TestTrue(TEXT("Test world has an entity manager"), TestWorld.Create());
+		});
+
+	AfterEach([this]()
+		{
+			TestWorld.Destroy();
+		});
+
+	It("batches templates with equal shared values held in different instances", [this]()
+		{
+			const FEntityTemplateData A = MakeTemplate(1.f, 7);
+			const FEntityTemplateData B = MakeTemplate(2.f, 7);
+			const FEntityTemplateData C = MakeTemplate(3.f, 8);
+			const TArray<FEntityTemplateData> Templates = { A, C, B, A };
+
+			TArray<FEntityTemplateBatch> Batches;
+			TestWorld.MassAPI->GroupTemplatesForBuild(Templates, Batches);
+			TestEqual(TEXT("One batch per shared value"), Batches.Num(), 2);
+
+			const FEntityTemplateBatch* Sevens = Batches.FindByPredicate([](const FEntityTemplateBatch& Batch) { return Batch.Indices.Contains(0); });
+			if (TestNotNull(TEXT("Batch of the first template"), Sevens))
+			{
+				TestTrue(TEXT("Equal values together, in input order"), Sevens->Indices == TArray<int32>({ 0, 2, 3 }));
+				TestEqual(TEXT("Copies of one template write once"), Sevens->ValueGroups.Num(), 2);
+			}
+		});
+
+	It("returns entities in input order with their own values", [this]()
+		{
+			const TArray<FEntityTemplateData> Templates = { MakeTemplate(1.f, 7), MakeTemplate(3.f, 8), FEntityTemplateData(), MakeTemplate(2.f, 7) };
+			const TArray<FMassEntityHandle> Built = TestWorld.MassAPI->BuildEntitiesFromTemplates(Templates);
+
+			TestEqual(TEXT("One handle per template"), Built.Num(), 4);
+			TestFalse(TEXT("Empty template yields an invalid handle"), Built[2].IsSet());
+			TestEqual(TEXT("First"), RadiusOf(Built[0]), 1.f);
+			TestEqual(TEXT("Second"), RadiusOf(Built[1]), 3.f);
+			TestEqual(TEXT("Fourth"), RadiusOf(Built[3]), 2.f);
+			TestEqual(TEXT("First shared value"), SharedOf(Built[0]), 7);
+			TestEqual(TEXT("Second shared value"), SharedOf(Built[1]), 8);
+			TestEqual(TEXT("Fourth shared value"), SharedOf(Built[3]), 7);
+			TestTrue(TEXT("Shared values do not split the archetype"), TestWorld.Manager->GetArchetypeForEntity(Built[0]) == TestWorld.Manager->GetArchetypeForEntity(Built[1]));
+		});
+
+	It("keeps input order across large mixed batches", [this]()
+		{
+			TArray<FEntityTemplateData> Distinct;
+			for (int32 Index = 0; Index < 6; ++Index)
+			{
+				Distinct.Add(MakeTemplate(Index, Index % 3));
+			}
+
+			TArray<FEntityTemplateData> Templates;
+			for (int32 Index = 0; Index < 2000; ++Index)
+			{
+				Templates.Add(Distinct[(Index * 5) % Distinct.Num()]);
+			}
+
+			const TArray<FMassEntityHandle> Built = TestWorld.MassAPI->BuildEntitiesFromTemplates(Templates);
+			bool bInOrder = Built.Num() == Templates.Num();
+			for (int32 Index = 0; bInOrder && Index < Built.Num(); ++Index)
+			{
+				const int32 Source = (Index * 5) % Distinct.Num();
+				bInOrder = RadiusOf(Built[Index]) == static_cast<float>(Source) && SharedOf(Built[Index]) == Source % 3;
+			}
+			TestTrue(TEXT("Entity i built from template i"), bInOrder);
+			TestEqual(TEXT("No duplicates"), TSet<FMassEntityHandle>(Built).Num(), Built.Num());
+		});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
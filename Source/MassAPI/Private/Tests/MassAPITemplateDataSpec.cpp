@@ -0,0 +1,90 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "MassAPIFuncLib.h"
+#include "MassAPITestWorld.h"
+
+BEGIN_DEFINE_SPEC(FMassAPITemplateDataSpec, "MassAPI.TemplateData", EAutomationTestFlags::ProductFilter | EAutomationTestFlags_ApplicationContextMask)
+	FMassAPITestWorld TestWorld;
+	FEntityTemplateData Original;
+
+	// Any tag type will do; the mirror tags are plain FMassTag structs | 任意标签类型均可
+	static UScriptStruct* TestTag() { return FEntityFlagMirrorTag15::StaticStruct(); }
+END_DEFINE_SPEC(FMassAPITemplateDataSpec)
+
+void FMassAPITemplateDataSpec::Define()
+{
+	BeforeEach([this]()
+		{
+			TestTrue(TEXT("Test world has an entity manager"), TestWorld.Create([](UMassAPIFlagSettings& Settings) { Settings.TagBackedFlags = { EEntityFlags::Flag4 }; }));
+
+			Original = FEntityTemplateData(MakeShared<FMassEntityTemplateData>());
+			Original.Get()->AddFragment(FConstStructView::Make(FTransformFragment()));
+		});
+
+	AfterEach([this]()
+		{
+			Original = FEntityTemplateData();
+			TestWorld.Destroy();
+		});
+
+	It("copies shared data before adding a tag", [this]()
+		{
+			const FMassArchetypeHandle OriginalArchetype = Original.GetArchetype(*TestWorld.Manager);
+			FEntityTemplateData Copy = Original;
+			TestFalse(TEXT("Handles share the data"), Copy.IsUnique());
+
+			UMassAPIFuncLib::AddTag_Template(Copy, TestTag());
+			TestTrue(TEXT("Copy has the tag"), UMassAPIFuncLib::HasTag_Template(Copy, TestTag()));
+			TestFalse(TEXT("Original does not"), UMassAPIFuncLib::HasTag_Template(Original, TestTag()));
+			TestTrue(TEXT("Both own their data now"), Original.IsUnique() && Copy.IsUnique());
+			TestTrue(TEXT("Original keeps its archetype"), Original.GetArchetype(*TestWorld.Manager) == OriginalArchetype);
+			TestTrue(TEXT("Copy resolves its own archetype"), Copy.GetArchetype(*TestWorld.Manager) != OriginalArchetype);
+		});
+
+	It("copies shared data before removing a tag", [this]()
+		{
+			UMassAPIFuncLib::AddTag_Template(Original, TestTag());
+			const FMassArchetypeHandle TaggedArchetype = Original.GetArchetype(*TestWorld.Manager);
+			FEntityTemplateData Copy = Original;
+
+			UMassAPIFuncLib::RemoveTag_Template(Copy, TestTag());
+			TestFalse(TEXT("Copy lost the tag"), UMassAPIFuncLib::HasTag_Template(Copy, TestTag()));
+			TestTrue(TEXT("Original keeps it"), UMassAPIFuncLib::HasTag_Template(Original, TestTag()));
+			TestTrue(TEXT("Original archetype still tagged"), Original.GetArchetype(*TestWorld.Manager) == TaggedArchetype);
+		});
+
+	It("leaves shared data alone when the tag is already in that state", [this]()
+		{
+			FEntityTemplateData Copy = Original;
+			UMassAPIFuncLib::RemoveTag_Template(Copy, TestTag());
+			TestFalse(TEXT("No copy for a no-op"), Copy.IsUnique());
+		});
+
+	It("keeps flags and mirror tags of a tag-backed flag on the edited handle only", [this]()
+		{
+			const FMassArchetypeHandle OriginalArchetype = Original.GetArchetype(*TestWorld.Manager);
+			FEntityTemplateData Copy = Original;
+
+			UMassAPIFuncLib::SetFlag_Template(nullptr, Copy, EEntityFlags::Flag4);
+			TestTrue(TEXT("Copy has the flag"), UMassAPIFuncLib::HasFlag_Template(Copy, EEntityFlags::Flag4));
+			TestTrue(TEXT("Copy has the mirror tag"), UMassAPIFuncLib::HasTag_Template(Copy, FEntityFlagMirrorTag0::StaticStruct()));
+			TestEqual(TEXT("Original flags untouched"), UMassAPIFuncLib::GetFlag_Template(Original), static_cast<int64>(0));
+			TestFalse(TEXT("Original has no mirror tag"), UMassAPIFuncLib::HasTag_Template(Original, FEntityFlagMirrorTag0::StaticStruct()));
+			TestTrue(TEXT("Original keeps its archetype"), Original.GetArchetype(*TestWorld.Manager) == OriginalArchetype);
+
+			FEntityTemplateData Second = Copy;
+			UMassAPIFuncLib::ClearFlag_Template(nullptr, Second, EEntityFlags::Flag4);
+			TestFalse(TEXT("Second cleared the flag"), UMassAPIFuncLib::HasFlag_Template(Second, EEntityFlags::Flag4));
+			TestFalse(TEXT("Second dropped the mirror tag"), UMassAPIFuncLib::HasTag_Template(Second, FEntityFlagMirrorTag0::StaticStruct()));
+			TestTrue(TEXT("Copy still flagged and tagged"), UMassAPIFuncLib::HasFlag_Template(Copy, EEntityFlags::Flag4) && UMassAPIFuncLib::HasTag_Template(Copy, FEntityFlagMirrorTag0::StaticStruct()));
+		});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
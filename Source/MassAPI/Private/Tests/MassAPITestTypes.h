@@ -0,0 +1,44 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTypes.h"
+#include "MassAPITestTypes.generated.h"
+
+// Reflected types used by the MassAPI specs. UHT ignores WITH_DEV_AUTOMATION_TESTS, so they are always compiled, but
+// nothing outside Private/Tests refers to them. | 规格测试用的反射类型；UHT 不识别测试宏，因此始终编译，但仅测试引用
+
+USTRUCT()
+struct FMassAPITestTag : public FMassTag
+{
+	GENERATED_BODY()
+};
+
+USTRUCT()
+struct FMassAPITestSharedFragment : public FMassSharedFragment
+{
+	GENERATED_BODY()
+
+	FMassAPITestSharedFragment() = default;
+	explicit FMassAPITestSharedFragment(const int32 InValue) : Value(InValue) {}
+
+	UPROPERTY()
+	int32 Value = 0;
+};
+
+USTRUCT()
+struct FMassAPITestConstSharedFragment : public FMassConstSharedFragment
+{
+	GENERATED_BODY()
+
+	FMassAPITestConstSharedFragment() = default;
+	explicit FMassAPITestConstSharedFragment(const int32 InValue) : Value(InValue) {}
+
+	UPROPERTY()
+	int32 Value = 0;
+};
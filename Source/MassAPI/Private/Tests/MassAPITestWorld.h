@@ -0,0 +1,180 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#pragma once
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "CoreMinimal.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "UObject/StrongObjectPtr.h"
+#include "UObject/Package.h"
+#include "MassEntityManager.h"
+#include "MassCommonFragments.h"
+#include "MassAPISubsystem.h"
+#include "MassAPIFlagSettings.h"
+#include "MassAPIStructs.h"
+
+/**
+ * Throwaway game world with its own entity manager and UMassAPISubsystem, shared by the MassAPI specs.
+ * Create snapshots every UMassAPIFlagSettings property, lets the spec configure the settings it needs, registers
+ * the test flags and reloads the settings before the subsystems initialize; Destroy restores the snapshot.
+ * | 规格测试共用的临时世界；Create 保存全部旗标设置并由规格自行配置，子系统初始化前生效，Destroy 时还原
+ */
+class FMassAPITestWorld
+{
+public:
+	/** Registry name of a test flag, usable in FEntityQuery flag lists | 测试旗标的注册名 */
+	static FName FlagName(const EEntityFlags Flag)
+	{
+		return FName(*FString::Printf(TEXT("MassAPITest.Flag%d"), static_cast<int32>(Flag)));
+	}
+
+	static int64 FlagBit(const EEntityFlags Flag)
+	{
+		return 1LL << FEntityFlagFragment::GetLocalBitIndex(Flag);
+	}
+
+	bool Create()
+	{
+		return Create([](UMassAPIFlagSettings&) {});
+	}
+
+	/** Configure edits the settings object after the snapshot, before the world exists | 在快照之后、世界创建之前修改设置 */
+	bool Create(TFunctionRef<void(UMassAPIFlagSettings&)> Configure)
+	{
+		UMassAPIFlagSettings* FlagSettings = GetMutableDefault<UMassAPIFlagSettings>();
+		SavedSettings.Reset(NewObject<UMassAPIFlagSettings>(GetTransientPackage()));
+		CopySettings(*FlagSettings, *SavedSettings);
+
+		Configure(*FlagSettings);
+		for (int32 Bit = 0; Bit < 8; ++Bit)
+		{
+			FlagSettings->FlagRegistry.Add(FlagName(static_cast<EEntityFlags>(Bit)), static_cast<EEntityFlags>(Bit));
+		}
+		FlagSettings->PostReloadConfig(nullptr);
+
+		World = UWorld::CreateWorld(EWorldType::Game, /*bInformEngineOfWorld*/false, TEXT("MassAPITestWorld"));
+		FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(World);
+
+		MassAPI = World ? World->GetSubsystem<UMassAPISubsystem>() : nullptr;
+		Manager = MassAPI ? MassAPI->GetEntityManager() : nullptr;
+		return Manager != nullptr;
+	}
+
+	void Destroy()
+	{
+		if (World)
+		{
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(/*bInformEngineOfWorld*/false);
+		}
+		World = nullptr;
+		MassAPI = nullptr;
+		Manager = nullptr;
+
+		if (SavedSettings.IsValid())
+		{
+			UMassAPIFlagSettings* FlagSettings = GetMutableDefault<UMassAPIFlagSettings>();
+			CopySettings(*SavedSettings, *FlagSettings);
+			FlagSettings->PostReloadConfig(nullptr);
+			SavedSettings.Reset();
+		}
+	}
+
+	/** One subsystem tick: command flush, timers, mirrors, observers, live queries, epoch | 推进一帧 */
+	void Tick(const float DeltaTime = 1.f / 60.f) const
+	{
+		MassAPI->Tick(DeltaTime);
+	}
+
+	/** Entities built through MassAPI from an FEntityTemplate carrying Flags and a transform | 经 MassAPI 模板创建的实体 */
+	TArray<FMassEntityHandle> BuildWithFlags(const int32 Quantity, const TArray<EEntityFlags>& Flags) const
+	{
+		FEntityTemplate Template;
+		Template.Fragments.Add(FInstancedStruct::Make(FTransformFragment()));
+		Template.Flags = Flags;
+
+		FMassEntityTemplateData TemplateData;
+		Template.GetTemplateData(TemplateData, *Manager);
+		return MassAPI->BuildEntities(Quantity, TemplateData);
+	}
+
+	/**
+	 * Entities created straight through FMassEntityManager, bypassing MassAPI, with FlagsLow written into their
+	 * flag fragment. Fragments lists the archetype; FEntityFlagFragment is only written when present.
+	 * | 绕过 MassAPI 直接由实体管理器创建的实体
+	 */
+	TArray<FMassEntityHandle> BuildRaw(const int32 Quantity, const int64 FlagsLow, TArray<const UScriptStruct*> Fragments = { FEntityFlagFragment::StaticStruct(), FTransformFragment::StaticStruct() }) const
+	{
+		const FMassArchetypeHandle Archetype = Manager->CreateArchetype(Fragments);
+		TArray<FMassEntityHandle> Entities;
+		{
+			TSharedRef<FMassEntityManager::FEntityCreationContext> CreationContext = Manager->BatchCreateEntities(Archetype, Quantity, Entities);
+		}
+		if (Fragments.Contains(FEntityFlagFragment::StaticStruct()))
+		{
+			for (const FMassEntityHandle& Entity : Entities)
+			{
+				WriteFlagsDirect(Entity, FlagsLow, 0);
+			}
+		}
+		return Entities;
+	}
+
+	/** Overwrites the entity's flags through a fragment pointer, as a processor would | 像处理器一样直接改写旗标片段 */
+	void WriteFlagsDirect(const FMassEntityHandle Entity, const int64 FlagsLow, const int64 FlagsHigh) const
+	{
+		FEntityFlagFragment& FlagFragment = Manager->GetFragmentDataChecked<FEntityFlagFragment>(Entity);
+		FlagFragment.Flags = FlagsLow;
+		FlagFragment.FlagsHigh = FlagsHigh;
+	}
+
+	/** Query over transform entities with the given test flags | 带测试旗标条件的查询 */
+	static FEntityQuery FlagQuery(const TArray<EEntityFlags>& AllFlags, const TArray<EEntityFlags>& AnyFlags = {}, const TArray<EEntityFlags>& NoneFlags = {})
+	{
+		FEntityQuery Query;
+		Query.All<FTransformFragment>();
+		for (const EEntityFlags Flag : AllFlags) { Query.AllFlagsList.Add(FlagName(Flag)); }
+		for (const EEntityFlags Flag : AnyFlags) { Query.AnyFlagsList.Add(FlagName(Flag)); }
+		for (const EEntityFlags Flag : NoneFlags) { Query.NoneFlagsList.Add(FlagName(Flag)); }
+		Query.MarkCacheDirty();
+		return Query;
+	}
+
+	/** Same entities regardless of order, no duplicates | 忽略顺序比较实体集合 */
+	static bool SameEntities(TConstArrayView<FMassEntityHandle> A, TConstArrayView<FMassEntityHandle> B)
+	{
+		if (A.Num() != B.Num()) return false;
+		const TSet<FMassEntityHandle> SetA(A);
+		if (SetA.Num() != A.Num()) return false;
+		for (const FMassEntityHandle& Entity : B)
+		{
+			if (!SetA.Contains(Entity)) return false;
+		}
+		return true;
+	}
+
+	UWorld* World = nullptr;
+	UMassAPISubsystem* MassAPI = nullptr;
+	FMassEntityManager* Manager = nullptr;
+
+private:
+	static void CopySettings(const UMassAPIFlagSettings& From, UMassAPIFlagSettings& To)
+	{
+		for (TFieldIterator<FProperty> It(UMassAPIFlagSettings::StaticClass(), EFieldIteratorFlags::ExcludeSuper); It; ++It)
+		{
+			It->CopyCompleteValue_InContainer(&To, &From);
+		}
+	}
+
+	// Settings as they were before Create, kept alive across garbage collection | Create 之前的设置
+	TStrongObjectPtr<UMassAPIFlagSettings> SavedSettings;
+};
+
+#endif // WITH_DEV_AUTOMATION_TESTS
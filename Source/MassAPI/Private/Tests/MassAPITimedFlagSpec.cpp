@@ -0,0 +1,105 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "MassAPITestWorld.h"
+
+BEGIN_DEFINE_SPEC(FMassAPITimedFlagSpec, "MassAPI.TimedFlag", EAutomationTestFlags::ProductFilter | EAutomationTestFlags_ApplicationContextMask)
+	FMassAPITestWorld TestWorld;
+	TArray<FMassEntityHandle> Raw;
+
+	bool HasFlag(const FMassEntityHandle Entity, const EEntityFlags Flag) const
+	{
+		return TestWorld.Manager->GetFragmentDataChecked<FEntityFlagFragment>(Entity).HasFlag(Flag);
+	}
+END_DEFINE_SPEC(FMassAPITimedFlagSpec)
+
+void FMassAPITimedFlagSpec::Define()
+{
+	BeforeEach([this]()
+		{
+			TestTrue(TEXT("Test world has an entity manager"), TestWorld.Create());
+			Raw = TestWorld.BuildRaw(20, FMassAPITestWorld::FlagBit(EEntityFlags::Flag5));
+		});
+
+	AfterEach([this]()
+		{
+			Raw.Reset();
+			TestWorld.Destroy();
+		});
+
+	It("applies a scheduled change once its delay has passed", [this]()
+		{
+			TestWorld.MassAPI->ScheduleFlagChange(Raw[0], EEntityFlags::Flag1, true, 0.1f);
+			TestWorld.MassAPI->ScheduleFlagChange(Raw[1], EEntityFlags::Flag5, false, 0.1f);
+			TestEqual(TEXT("Pending"), TestWorld.MassAPI->GetNumScheduledFlagChanges(), 2);
+
+			TestWorld.Tick(0.05f);
+			TestFalse(TEXT("Not due yet"), HasFlag(Raw[0], EEntityFlags::Flag1));
+			TestTrue(TEXT("Not cleared yet"), HasFlag(Raw[1], EEntityFlags::Flag5));
+
+			TestWorld.Tick(0.1f);
+			TestTrue(TEXT("Set"), HasFlag(Raw[0], EEntityFlags::Flag1));
+			TestTrue(TEXT("Directly written Flag5 kept"), HasFlag(Raw[0], EEntityFlags::Flag5));
+			TestFalse(TEXT("Cleared"), HasFlag(Raw[1], EEntityFlags::Flag5));
+			TestEqual(TEXT("Nothing pending"), TestWorld.MassAPI->GetNumScheduledFlagChanges(), 0);
+		});
+
+	It("sets a flag for a duration and restarts the window when called again", [this]()
+		{
+			TestTrue(TEXT("Set now"), TestWorld.MassAPI->SetFlagForDuration(Raw[2], EEntityFlags::Flag2, 0.2f));
+			TestTrue(TEXT("Flag set"), HasFlag(Raw[2], EEntityFlags::Flag2));
+
+			TestWorld.Tick(0.15f);
+			TestTrue(TEXT("Restarted"), TestWorld.MassAPI->SetFlagForDuration(Raw[2], EEntityFlags::Flag2, 0.2f));
+			TestEqual(TEXT("One pending change per entity and flag"), TestWorld.MassAPI->GetNumScheduledFlagChanges(), 1);
+
+			TestWorld.Tick(0.1f);
+			TestTrue(TEXT("First window superseded"), HasFlag(Raw[2], EEntityFlags::Flag2));
+			TestWorld.Tick(0.15f);
+			TestFalse(TEXT("Second window ended"), HasFlag(Raw[2], EEntityFlags::Flag2));
+		});
+
+	It("drops cancelled changes", [this]()
+		{
+			TestWorld.MassAPI->ScheduleFlagChange(Raw[3], EEntityFlags::Flag1, true, 0.05f);
+			TestWorld.MassAPI->CancelScheduledFlagChange(Raw[3], EEntityFlags::Flag1);
+			TestEqual(TEXT("Nothing pending"), TestWorld.MassAPI->GetNumScheduledFlagChanges(), 0);
+
+			TestWorld.Tick(0.2f);
+			TestFalse(TEXT("Never applied"), HasFlag(Raw[3], EEntityFlags::Flag1));
+		});
+
+	It("skips entities destroyed before their change is due", [this]()
+		{
+			TestWorld.MassAPI->ScheduleFlagChange(Raw[4], EEntityFlags::Flag1, true, 0.05f);
+			TestWorld.MassAPI->ScheduleFlagChange(Raw[5], EEntityFlags::Flag1, true, 0.05f);
+			TestWorld.Manager->DestroyEntity(Raw[4]);
+
+			// The freed index may be handed to a new entity, which must not inherit the change | 复用索引的新实体不应继承该变更
+			const FMassEntityHandle Reused = TestWorld.BuildRaw(1, 0)[0];
+
+			TestWorld.Tick(0.1f);
+			TestTrue(TEXT("Live entity"), HasFlag(Raw[5], EEntityFlags::Flag1));
+			TestFalse(TEXT("New entity"), HasFlag(Reused, EEntityFlags::Flag1));
+			TestEqual(TEXT("Nothing pending"), TestWorld.MassAPI->GetNumScheduledFlagChanges(), 0);
+		});
+
+	It("leaves directly written flags consistent when the timer fires", [this]()
+		{
+			TestWorld.MassAPI->SetFlagForDuration(Raw[6], EEntityFlags::Flag2, 0.05f);
+
+			// A processor clears the flag early and sets another one | 处理器提前清除该旗标并写入另一个
+			TestWorld.WriteFlagsDirect(Raw[6], FMassAPITestWorld::FlagBit(EEntityFlags::Flag3), 0);
+			TestWorld.Tick(0.1f);
+			TestFalse(TEXT("Still cleared"), HasFlag(Raw[6], EEntityFlags::Flag2));
+			TestTrue(TEXT("Direct write kept"), HasFlag(Raw[6], EEntityFlags::Flag3));
+		});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,122 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "MassAPITestWorld.h"
+
+BEGIN_DEFINE_SPEC(FMassAPITopKSpec, "MassAPI.TopK", EAutomationTestFlags::ProductFilter | EAutomationTestFlags_ApplicationContextMask)
+	FMassAPITestWorld TestWorld;
+	TArray<FMassEntityHandle> Entities;
+	TArray<FMassEntityHandle> Result;
+	TArray<double> Values;
+
+	static FStructRecursiveMemberReference RadiusMember()
+	{
+		return FStructRecursiveMemberReference(FAgentRadiusFragment::StaticStruct(), { TEXT("Radius") });
+	}
+
+	static FEntityQuery RadiusQuery()
+	{
+		FEntityQuery Query;
+		Query.All<FAgentRadiusFragment>();
+		return Query;
+	}
+
+	// Entities ordered by ascending index | 按实体索引升序
+	static bool IndexOrdered(TConstArrayView<FMassEntityHandle> Handles)
+	{
+		for (int32 Index = 1; Index < Handles.Num(); ++Index)
+		{
+			if (Handles[Index - 1].Index >= Handles[Index].Index) return false;
+		}
+		return true;
+	}
+END_DEFINE_SPEC(FMassAPITopKSpec)
+
+void FMassAPITopKSpec::Define()
+{
+	BeforeEach([this]()
+		{
+			TestTrue(TEXT("Test world has an entity manager"), TestWorld.Create());
+
+			// Radii 0,1,2,3,4,0,1,2,3,4,... so every value appears several times | 每个值出现多次
+			Entities = TestWorld.BuildRaw(500, 0, { FEntityFlagFragment::StaticStruct(), FAgentRadiusFragment::StaticStruct() });
+			for (int32 Index = 0; Index < Entities.Num(); ++Index)
+			{
+				TestWorld.Manager->GetFragmentDataChecked<FAgentRadiusFragment>(Entities[Index]).Radius = Index % 5;
+			}
+		});
+
+	AfterEach([this]()
+		{
+			Entities.Reset();
+			Result.Reset();
+			Values.Reset();
+			TestWorld.Destroy();
+		});
+
+	It("returns the K smallest values in order", [this]()
+		{
+			TestWorld.MassAPI->GetTopKMatchingEntities(RadiusQuery(), RadiusMember(), 150, false, Result, &Values);
+			TestEqual(TEXT("K results"), Result.Num(), 150);
+			TestEqual(TEXT("Values alongside"), Values.Num(), 150);
+			TestEqual(TEXT("First"), Values[0], 0.0);
+			TestEqual(TEXT("Last of the zeros"), Values[99], 0.0);
+			TestEqual(TEXT("Then the ones"), Values[100], 1.0);
+			TestEqual(TEXT("Last"), Values.Last(), 1.0);
+		});
+
+	It("breaks ties by entity index on both sides of the cut", [this]()
+		{
+			TestWorld.MassAPI->GetTopKMatchingEntities(RadiusQuery(), RadiusMember(), 30, true, Result, &Values);
+			TestEqual(TEXT("All ties"), Values.Last(), 4.0);
+			TestTrue(TEXT("Lowest indices win within the tie"), IndexOrdered(Result));
+
+			TArray<FMassEntityHandle> Sorted;
+			TestWorld.MassAPI->GetMatchingEntitiesSorted(RadiusQuery(), RadiusMember(), true, Sorted);
+			TestTrue(TEXT("Same as the head of the full sort"), FMassAPITestWorld::SameEntities(Result, MakeArrayView(Sorted.GetData(), 30)));
+			TestTrue(TEXT("Same order too"), Result[29] == Sorted[29]);
+		});
+
+	It("returns every match in order when K exceeds the match count", [this]()
+		{
+			TestWorld.MassAPI->GetTopKMatchingEntities(RadiusQuery(), RadiusMember(), 10000, false, Result, &Values);
+			TestEqual(TEXT("All entities"), Result.Num(), Entities.Num());
+			bool bOrdered = true;
+			for (int32 Index = 1; Index < Values.Num(); ++Index)
+			{
+				bOrdered &= Values[Index - 1] <= Values[Index];
+			}
+			TestTrue(TEXT("Ascending"), bOrdered);
+		});
+
+	It("returns nothing for K of zero or less", [this]()
+		{
+			Result.Add(Entities[0]);
+			TestWorld.MassAPI->GetTopKMatchingEntities(RadiusQuery(), RadiusMember(), 0, false, Result, &Values);
+			TestEqual(TEXT("K = 0 clears the output"), Result.Num(), 0);
+			TestWorld.MassAPI->GetTopKMatchingEntities(RadiusQuery(), RadiusMember(), -3, false, Result);
+			TestEqual(TEXT("Negative K"), Result.Num(), 0);
+		});
+
+	It("applies the query's flag conditions before ranking", [this]()
+		{
+			TestWorld.MassAPI->SetEntityFlag(Entities[7], EEntityFlags::Flag1);
+			TestWorld.MassAPI->SetEntityFlag(Entities[9], EEntityFlags::Flag1);
+			FEntityQuery Query = RadiusQuery();
+			Query.AllFlagsList.Add(FMassAPITestWorld::FlagName(EEntityFlags::Flag1));
+			Query.MarkCacheDirty();
+
+			TestWorld.MassAPI->GetTopKMatchingEntities(Query, RadiusMember(), 1, true, Result, &Values);
+			TestEqual(TEXT("Only flagged entities rank"), Result.Num(), 1);
+			TestTrue(TEXT("Largest flagged radius"), Result[0] == Entities[9]);
+			TestEqual(TEXT("Its value"), Values[0], 4.0);
+		});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
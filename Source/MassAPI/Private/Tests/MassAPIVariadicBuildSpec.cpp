@@ -0,0 +1,116 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "MassEntityView.h"
+#include "MassAPITestWorld.h"
+#include "MassAPITestTypes.h"
+
+BEGIN_DEFINE_SPEC(FMassAPIVariadicBuildSpec, "MassAPI.VariadicBuild", EAutomationTestFlags::ProductFilter | EAutomationTestFlags_ApplicationContextMask)
+	FMassAPITestWorld TestWorld;
+
+	static FAgentRadiusFragment Radius(const float Value)
+	{
+		FAgentRadiusFragment Fragment;
+		Fragment.Radius = Value;
+		return Fragment;
+	}
+
+	FMassArchetypeHandle ArchetypeOf(const FMassEntityHandle Entity) const
+	{
+		return TestWorld.Manager->GetArchetypeForEntity(Entity);
+	}
+END_DEFINE_SPEC(FMassAPIVariadicBuildSpec)
+
+void FMassAPIVariadicBuildSpec::Define()
+{
+	BeforeEach([this]()
+		{
+			TestTrue(TEXT("Test world has an entity manager"), TestWorld.Create());
+		});
+
+	AfterEach([this]()
+		{
+			TestWorld.Destroy();
+		});
+
+	It("writes every fragment value and tag into each entity", [this]()
+		{
+			const TArray<FMassEntityHandle> Built = TestWorld.MassAPI->BuildEntities(300,
+				FTransformFragment(FTransform(FVector(5.0, 0.0, 0.0))), Radius(3.f), FMassAPITestTag());
+			TestEqual(TEXT("Built"), Built.Num(), 300);
+
+			bool bAllWritten = true;
+			for (const FMassEntityHandle& Entity : Built)
+			{
+				const FMassEntityView View(*TestWorld.Manager, Entity);
+				bAllWritten &= View.GetFragmentData<FAgentRadiusFragment>().Radius == 3.f;
+				bAllWritten &= View.GetFragmentData<FTransformFragment>().GetTransform().GetLocation().X == 5.0;
+				bAllWritten &= View.HasTag<FMassAPITestTag>();
+			}
+			TestTrue(TEXT("Values in every chunk"), bAllWritten);
+		});
+
+	It("resolves one archetype per composition whatever the argument order or value category", [this]()
+		{
+			const FMassEntityHandle First = TestWorld.MassAPI->BuildEntity(FTransformFragment(), Radius(1.f));
+			const FMassArchetypeHandle Archetype = ArchetypeOf(First);
+			TestTrue(TEXT("The manager's archetype"), TestWorld.Manager->CreateArchetype({ FTransformFragment::StaticStruct(), FAgentRadiusFragment::StaticStruct() }) == Archetype);
+
+			TestTrue(TEXT("Same pack again"), ArchetypeOf(TestWorld.MassAPI->BuildEntity(FTransformFragment(), Radius(2.f))) == Archetype);
+			TestTrue(TEXT("Reversed order"), ArchetypeOf(TestWorld.MassAPI->BuildEntity(Radius(2.f), FTransformFragment())) == Archetype);
+
+			const FAgentRadiusFragment Lvalue = Radius(7.f);
+			const FMassEntityHandle FromLvalue = TestWorld.MassAPI->BuildEntity(FTransformFragment(), Lvalue);
+			TestTrue(TEXT("Const lvalue argument"), ArchetypeOf(FromLvalue) == Archetype);
+			TestEqual(TEXT("Its value"), TestWorld.Manager->GetFragmentDataChecked<FAgentRadiusFragment>(FromLvalue).Radius, 7.f);
+
+			TestTrue(TEXT("Other pack, other archetype"), ArchetypeOf(TestWorld.MassAPI->BuildEntity(FTransformFragment(), FMassAPITestTag())) != Archetype);
+		});
+
+	It("takes shared fragment values from every call", [this]()
+		{
+			const FMassEntityHandle A = TestWorld.MassAPI->BuildEntity(FTransformFragment(), FMassAPITestSharedFragment(1), FMassAPITestConstSharedFragment(10));
+			const FMassEntityHandle B = TestWorld.MassAPI->BuildEntity(FTransformFragment(), FMassAPITestSharedFragment(2), FMassAPITestConstSharedFragment(10));
+			const FMassEntityHandle C = TestWorld.MassAPI->BuildEntity(FTransformFragment(), FMassAPITestSharedFragment(1), FMassAPITestConstSharedFragment(20));
+
+			const FMassEntityView ViewA(*TestWorld.Manager, A);
+			const FMassEntityView ViewB(*TestWorld.Manager, B);
+			const FMassEntityView ViewC(*TestWorld.Manager, C);
+			TestEqual(TEXT("A shared"), ViewA.GetSharedFragmentData<FMassAPITestSharedFragment>().Value, 1);
+			TestEqual(TEXT("B shared"), ViewB.GetSharedFragmentData<FMassAPITestSharedFragment>().Value, 2);
+			TestEqual(TEXT("C const shared"), ViewC.GetConstSharedFragmentData<FMassAPITestConstSharedFragment>().Value, 20);
+			TestTrue(TEXT("One archetype"), ArchetypeOf(A) == ArchetypeOf(B) && ArchetypeOf(B) == ArchetypeOf(C));
+		});
+
+	It("builds nothing for a quantity of zero or less", [this]()
+		{
+			TestEqual(TEXT("Zero"), TestWorld.MassAPI->BuildEntities(0, FTransformFragment()).Num(), 0);
+			TestEqual(TEXT("Negative"), TestWorld.MassAPI->BuildEntities(-4, FTransformFragment()).Num(), 0);
+
+			FEntityQuery Query;
+			Query.All<FTransformFragment>();
+			TestEqual(TEXT("No entity created"), TestWorld.MassAPI->CountMatchingEntities(Query), 0);
+		});
+
+	It("resolves the same pack again in another world", [this]()
+		{
+			const FMassEntityHandle Here = TestWorld.MassAPI->BuildEntity(FTransformFragment(), Radius(1.f));
+
+			FMassAPITestWorld OtherWorld;
+			TestTrue(TEXT("Second world"), OtherWorld.Create());
+			const FMassEntityHandle There = OtherWorld.MassAPI->BuildEntity(FTransformFragment(), Radius(1.f));
+			TestTrue(TEXT("Built in the other manager"), OtherWorld.Manager->IsEntityValid(There));
+			TestTrue(TEXT("Into that manager's archetype"), OtherWorld.Manager->GetArchetypeForEntity(There) != ArchetypeOf(Here));
+			OtherWorld.Destroy();
+
+			TestTrue(TEXT("First world unaffected"), ArchetypeOf(TestWorld.MassAPI->BuildEntity(FTransformFragment(), Radius(1.f))) == ArchetypeOf(Here));
+		});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,195 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "MassAPITestWorld.h"
+
+BEGIN_DEFINE_SPEC(FMassAPIWideFlagSpec, "MassAPI.WideFlag", EAutomationTestFlags::ProductFilter | EAutomationTestFlags_ApplicationContextMask)
+	FMassAPITestWorld TestWorld;
+
+	template<int32 NumBits>
+	static TEntityFlagBlock<NumBits> MakeBits(std::initializer_list<int32> Bits)
+	{
+		TEntityFlagBlock<NumBits> Block;
+		for (const int32 Bit : Bits) { Block.SetBit(Bit); }
+		return Block;
+	}
+
+	// All/Any/None on the top bit of every register, so no register is skipped | 覆盖每个寄存器的最高位
+	template<int32 NumBits>
+	void TestEveryRegister()
+	{
+		for (int32 Bit = 127; Bit < NumBits; Bit += 128)
+		{
+			TEntityFlagQueryMask<NumBits> Mask;
+			Mask.AddAll(Bit).AddAny(Bit - 64).AddNone(Bit - 1);
+
+			const FString Width = FString::Printf(TEXT("[%d] bit %d "), NumBits, Bit);
+			TestTrue(Width + TEXT("all, any present"), Mask.Matches(MakeBits<NumBits>({ Bit, Bit - 64 })));
+			TestFalse(Width + TEXT("all missing"), Mask.Matches(MakeBits<NumBits>({ Bit - 64 })));
+			TestFalse(Width + TEXT("any missing"), Mask.Matches(MakeBits<NumBits>({ Bit })));
+			TestFalse(Width + TEXT("none present"), Mask.Matches(MakeBits<NumBits>({ Bit, Bit - 64, Bit - 1 })));
+		}
+	}
+
+	// The chunk bounds agree with testing every entity | 摘要边界与逐实体测试一致
+	template<int32 NumBits>
+	void TestSummaryBounds()
+	{
+		const TEntityFlagBlock<NumBits> A = MakeBits<NumBits>({ 3, NumBits - 1 });
+		const TEntityFlagBlock<NumBits> B = MakeBits<NumBits>({ 3, NumBits - 2 });
+		const TEntityFlagBlock<NumBits> Or = A | B;
+		const TEntityFlagBlock<NumBits> And = A & B;
+
+		TEntityFlagQueryMask<NumBits> Shared;
+		Shared.AddAll(3);
+		TEntityFlagQueryMask<NumBits> OnlyA;
+		OnlyA.AddAll(NumBits - 1);
+		TEntityFlagQueryMask<NumBits> Neither;
+		Neither.AddAll(NumBits - 3);
+
+		const FString Width = FString::Printf(TEXT("[%d] "), NumBits);
+		TestTrue(Width + TEXT("shared bit passes whole chunk"), Shared.MustAllPass(Or, And));
+		TestTrue(Width + TEXT("one entity can pass"), OnlyA.CanAnyPass(Or, And) && !OnlyA.MustAllPass(Or, And));
+		TestFalse(Width + TEXT("no entity can pass"), Neither.CanAnyPass(Or, And));
+		TestTrue(Width + TEXT("and-not"), Or.AndNot(And) == MakeBits<NumBits>({ NumBits - 1, NumBits - 2 }));
+	}
+END_DEFINE_SPEC(FMassAPIWideFlagSpec)
+
+void FMassAPIWideFlagSpec::Define()
+{
+	Describe("Flag blocks", [this]()
+		{
+			It("tests bits in every register at 128, 256 and 512 bits", [this]()
+				{
+					TestEveryRegister<128>();
+					TestEveryRegister<256>();
+					TestEveryRegister<512>();
+				});
+
+			It("bounds chunks consistently at every width", [this]()
+				{
+					TestSummaryBounds<128>();
+					TestSummaryBounds<256>();
+					TestSummaryBounds<512>();
+				});
+
+			It("treats an empty Any set as passing", [this]()
+				{
+					TEntityFlagQueryMask<512> Mask;
+					TestTrue(TEXT("Empty mask"), Mask.IsEmpty() && Mask.Matches(TEntityFlagBlock<512>()));
+					Mask.AddNone(400);
+					TestFalse(TEXT("None alone needs no flags"), Mask.RequiresFlags());
+					TestTrue(TEXT("Zero block passes"), Mask.Matches(TEntityFlagBlock<512>()));
+				});
+
+			It("ignores bits outside the width", [this]()
+				{
+					TEntityFlagBlock<256> Block;
+					Block.SetBit(256);
+					Block.SetBit(-1);
+					TestTrue(TEXT("Nothing set"), Block.IsZero());
+					TestFalse(TEXT("Atomic set refused"), Block.SetBitAtomic(300));
+					TestFalse(TEXT("Nothing read"), Block.HasBit(256));
+				});
+
+			It("keeps the 128-bit query mask equivalent to its block form", [this]()
+				{
+					FEntityFlagQueryMask Mask;
+					Mask.AllLow = 1LL << 2;
+					Mask.AnyHigh = (1LL << 5) | (1LL << 63);
+					Mask.NoneLow = 1LL << 9;
+					const TEntityFlagQueryMask<512> Wide = Mask.ToBlockMask<512>();
+
+					FRandomStream Random(1234);
+					bool bAgree = true;
+					for (int32 Sample = 0; Sample < 4096; ++Sample)
+					{
+						const int64 Low = (static_cast<int64>(Random.GetUnsignedInt()) << 32) | Random.GetUnsignedInt();
+						const int64 High = (static_cast<int64>(Random.GetUnsignedInt()) << 32) | Random.GetUnsignedInt();
+						TEntityFlagBlock<512> Block = TEntityFlagBlock<512>::FromLowHigh(Low, High);
+						Block.SetBit(128 + (Sample & 255));
+						bAgree &= Mask.Matches(Low, High) == Wide.Matches(Block);
+					}
+					TestTrue(TEXT("Same result on random words, bits 128+ unconstrained"), bAgree);
+				});
+		});
+
+	Describe("Queries", [this]()
+		{
+			BeforeEach([this]()
+				{
+					TestTrue(TEXT("Test world has an entity manager"), TestWorld.Create());
+				});
+
+			AfterEach([this]()
+				{
+					TestWorld.Destroy();
+				});
+
+			It("filters by bits held in the extension fragment", [this]()
+				{
+					const TArray<FMassEntityHandle> Wide = TestWorld.BuildRaw(200, 0,
+						{ FEntityFlagFragment::StaticStruct(), FEntityFlagExt512Fragment::StaticStruct(), FTransformFragment::StaticStruct() });
+					const TArray<FMassEntityHandle> Narrow = TestWorld.BuildRaw(50, 0);
+					for (int32 Index = 0; Index < Wide.Num(); Index += 3)
+					{
+						FEntityFlagExt512Fragment& Ext = TestWorld.Manager->GetFragmentDataChecked<FEntityFlagExt512Fragment>(Wide[Index]);
+						Ext.Words[(500 - 128) >> 6] |= 1LL << (500 & 63);
+					}
+
+					FEntityQuery Query;
+					Query.All<FTransformFragment>();
+					TArray<FMassEntityHandle> Result;
+					TestWorld.MassAPI->GetMatchingEntities(Query, TEntityFlagQueryMask<512>().AddAll(500), Result);
+					TestEqual(TEXT("Every third wide entity"), Result.Num(), 67);
+					TestTrue(TEXT("Top bit read back"), TestWorld.MassAPI->GetEntityFlagBlock<512>(Wide[0]).HasBit(500));
+
+					Result.Reset();
+					TestWorld.MassAPI->GetMatchingEntities(Query, TEntityFlagQueryMask<512>().AddNone(500), Result);
+					TestEqual(TEXT("Entities without the extension read as zero"), Result.Num(), 133 + Narrow.Num());
+				});
+
+			It("combines wide bits with the query's 128-bit flags", [this]()
+				{
+					const TArray<FMassEntityHandle> Wide = TestWorld.BuildRaw(10, FMassAPITestWorld::FlagBit(EEntityFlags::Flag1),
+						{ FEntityFlagFragment::StaticStruct(), FEntityFlagExt256Fragment::StaticStruct(), FTransformFragment::StaticStruct() });
+					TestWorld.WriteFlagsDirect(Wide[0], 0, 0);
+					TestWorld.Manager->GetFragmentDataChecked<FEntityFlagExt256Fragment>(Wide[0]).Words[0] = 1;
+					TestWorld.Manager->GetFragmentDataChecked<FEntityFlagExt256Fragment>(Wide[1]).Words[0] = 1;
+
+					TArray<FMassEntityHandle> Result;
+					TestWorld.MassAPI->GetMatchingEntities(FMassAPITestWorld::FlagQuery({ EEntityFlags::Flag1 }), TEntityFlagQueryMask<256>().AddAll(128), Result);
+					TestTrue(TEXT("Both conditions"), FMassAPITestWorld::SameEntities(Result, { Wide[1] }));
+				});
+
+#if MASSAPI_FLAG_BITS == 128
+			It("refuses bit writes past the configured width", [this]()
+				{
+					AddExpectedMessage(TEXT("outside the flag width"), ELogVerbosity::Warning, EAutomationExpectedMessageFlags::Contains, 0);
+					const TArray<FMassEntityHandle> Wide = TestWorld.BuildRaw(1, 0,
+						{ FEntityFlagFragment::StaticStruct(), FEntityFlagExt256Fragment::StaticStruct() });
+					TestFalse(TEXT("Bit 200 is out of a 128-bit project"), TestWorld.MassAPI->SetEntityFlagBit(Wide[0], 200));
+					TestEqual(TEXT("Extension untouched"), TestWorld.Manager->GetFragmentDataChecked<FEntityFlagExt256Fragment>(Wide[0]).Words[1], static_cast<int64>(0));
+				});
+#else
+			It("round-trips bit writes past 128", [this]()
+				{
+					using FExtFragment = TEntityFlagExtFragment<MASSAPI_FLAG_BITS>::Type;
+					const TArray<FMassEntityHandle> Wide = TestWorld.BuildRaw(1, 0, { FEntityFlagFragment::StaticStruct(), FExtFragment::StaticStruct() });
+					const int32 TopBit = MASSAPI_FLAG_BITS - 1;
+					TestTrue(TEXT("Set"), TestWorld.MassAPI->SetEntityFlagBit(Wide[0], TopBit));
+					TestTrue(TEXT("Read"), TestWorld.MassAPI->HasEntityFlagBit(Wide[0], TopBit));
+					TestTrue(TEXT("Clear"), TestWorld.MassAPI->ClearEntityFlagBit(Wide[0], TopBit));
+					TestTrue(TEXT("Block empty again"), TestWorld.MassAPI->GetEntityFlagBlock(Wide[0]).IsZero());
+				});
+#endif
+		});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
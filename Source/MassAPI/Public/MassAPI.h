@@ -9,6 +9,9 @@
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
 
+// Shared by every MassAPI source and the header-inlined templates | 所有 MassAPI 源文件与头文件模板共用的日志类别
+MASSAPI_API DECLARE_LOG_CATEGORY_EXTERN(LogMassAPI, Log, All);
+
 class FMassAPIModule : public IModuleInterface
 {
 public:
@@ -166,3 +166,49 @@ enum class EEntityFlags : uint8
 };
 
 //——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
+
+/**
+ * 片段成员谓词的比较运算符 (WHERE 子句)。
+ * Comparison operator of a fragment member predicate.
+ */
+UENUM(BlueprintType)
+enum class EEntityPredicateOp : uint8
+{
+	Equal			UMETA(DisplayName = "=="),
+	NotEqual		UMETA(DisplayName = "!="),
+	Less			UMETA(DisplayName = "<"),
+	LessEqual		UMETA(DisplayName = "<="),
+	Greater			UMETA(DisplayName = ">"),
+	GreaterEqual	UMETA(DisplayName = ">=")
+};
+
+// 编译后谓词读取的成员存储类型
+enum class EEntityPredicateValueType : uint8
+{
+	Invalid,
+	Bool,
+	Int8,
+	UInt8,
+	Int16,
+	UInt16,
+	Int32,
+	UInt32,
+	Int64,
+	UInt64,
+	Float,
+	Double
+};
+
+/**
+ * 项目使用的旗标总宽度；超过 128 位的部分存放在扩展片段中。
+ * Project-wide flag width; bits above 127 live in an extension fragment next to FEntityFlagFragment.
+ */
+UENUM(BlueprintType)
+enum class EEntityFlagWidth : uint8
+{
+	Bits128		UMETA(DisplayName = "128 Flags"),
+	Bits256		UMETA(DisplayName = "256 Flags"),
+	Bits512		UMETA(DisplayName = "512 Flags")
+};
+
+//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
@@ -0,0 +1,262 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/VectorRegister.h"
+
+//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
+
+/**
+ * Default flag block width of the project (128, 256 or 512). Override with a PublicDefinitions entry in a target's Build.cs.
+ * | 项目默认旗标宽度，可在 Build.cs 中通过 PublicDefinitions 覆盖
+ */
+#ifndef MASSAPI_FLAG_BITS
+	#define MASSAPI_FLAG_BITS 128
+#endif
+
+static_assert(MASSAPI_FLAG_BITS == 128 || MASSAPI_FLAG_BITS == 256 || MASSAPI_FLAG_BITS == 512, "MASSAPI_FLAG_BITS must be 128, 256 or 512.");
+
+/**
+ * Fixed-width flag bit set evaluated 128 bits per SIMD register.
+ * Word 0 holds bits 0-63, word 1 bits 64-127, and so on, so a 128-bit block has the same layout as FEntityFlagFragment.
+ * | 定宽旗标位集，按 128 位 SIMD 寄存器求值；布局与 FEntityFlagFragment 一致
+ */
+template<int32 NumBits>
+struct TEntityFlagBlock
+{
+	static_assert(NumBits == 128 || NumBits == 256 || NumBits == 512, "Flag blocks are 128, 256 or 512 bits wide.");
+
+	static constexpr int32 NumWords = NumBits / 64;
+	static constexpr int32 NumRegisters = NumBits / 128;
+
+	uint64 Words[NumWords] = {};
+
+	// ----------- Single bits -----------
+
+	FORCEINLINE bool HasBit(const int32 Bit) const
+	{
+		return (Bit >= 0 && Bit < NumBits) && (Words[Bit >> 6] & (1ULL << (Bit & 63))) != 0;
+	}
+
+	FORCEINLINE void SetBit(const int32 Bit)
+	{
+		if (Bit >= 0 && Bit < NumBits) Words[Bit >> 6] |= (1ULL << (Bit & 63));
+	}
+
+	FORCEINLINE void ClearBit(const int32 Bit)
+	{
+		if (Bit >= 0 && Bit < NumBits) Words[Bit >> 6] &= ~(1ULL << (Bit & 63));
+	}
+
+	FORCEINLINE void SetBitValue(const int32 Bit, const bool bValue)
+	{
+		if (bValue) SetBit(Bit); else ClearBit(Bit);
+	}
+
+	/** Atomic fetch-or on the word holding Bit; returns the previous bit value | 原子设置单个位，返回旧值 */
+	FORCEINLINE bool SetBitAtomic(const int32 Bit)
+	{
+		if (Bit < 0 || Bit >= NumBits) return false;
+		const int64 Mask = static_cast<int64>(1ULL << (Bit & 63));
+		return (FPlatformAtomics::InterlockedOr(reinterpret_cast<volatile int64*>(&Words[Bit >> 6]), Mask) & Mask) != 0;
+	}
+
+	/** Atomic fetch-and on the word holding Bit; returns the previous bit value | 原子清除单个位，返回旧值 */
+	FORCEINLINE bool ClearBitAtomic(const int32 Bit)
+	{
+		if (Bit < 0 || Bit >= NumBits) return false;
+		const int64 Mask = static_cast<int64>(1ULL << (Bit & 63));
+		return (FPlatformAtomics::InterlockedAnd(reinterpret_cast<volatile int64*>(&Words[Bit >> 6]), ~Mask) & Mask) != 0;
+	}
+
+	// ----------- Whole-block SIMD ops -----------
+
+	FORCEINLINE bool IsZero() const
+	{
+		VectorRegister4Int Acc = LoadRegister(0);
+		for (int32 RegIt = 1; RegIt < NumRegisters; ++RegIt)
+		{
+			Acc = VectorIntOr(Acc, LoadRegister(RegIt));
+		}
+		return IsRegisterZero(Acc);
+	}
+
+	/** True if every bit of Required is set here | 包含 Required 的全部位 */
+	FORCEINLINE bool ContainsAll(const TEntityFlagBlock& Required) const
+	{
+		// (Required & ~This) == 0 | VectorIntAndNot(A, B) = ~A & B
+		VectorRegister4Int Acc = VectorIntAndNot(LoadRegister(0), Required.LoadRegister(0));
+		for (int32 RegIt = 1; RegIt < NumRegisters; ++RegIt)
+		{
+			Acc = VectorIntOr(Acc, VectorIntAndNot(LoadRegister(RegIt), Required.LoadRegister(RegIt)));
+		}
+		return IsRegisterZero(Acc);
+	}
+
+	/** True if at least one bit is shared with Other | 与 Other 有任一公共位 */
+	FORCEINLINE bool Intersects(const TEntityFlagBlock& Other) const
+	{
+		VectorRegister4Int Acc = VectorIntAnd(LoadRegister(0), Other.LoadRegister(0));
+		for (int32 RegIt = 1; RegIt < NumRegisters; ++RegIt)
+		{
+			Acc = VectorIntOr(Acc, VectorIntAnd(LoadRegister(RegIt), Other.LoadRegister(RegIt)));
+		}
+		return !IsRegisterZero(Acc);
+	}
+
+	FORCEINLINE TEntityFlagBlock operator|(const TEntityFlagBlock& Other) const
+	{
+		TEntityFlagBlock Result;
+		for (int32 RegIt = 0; RegIt < NumRegisters; ++RegIt)
+		{
+			Result.StoreRegister(RegIt, VectorIntOr(LoadRegister(RegIt), Other.LoadRegister(RegIt)));
+		}
+		return Result;
+	}
+
+	FORCEINLINE TEntityFlagBlock operator&(const TEntityFlagBlock& Other) const
+	{
+		TEntityFlagBlock Result;
+		for (int32 RegIt = 0; RegIt < NumRegisters; ++RegIt)
+		{
+			Result.StoreRegister(RegIt, VectorIntAnd(LoadRegister(RegIt), Other.LoadRegister(RegIt)));
+		}
+		return Result;
+	}
+
+	/** This & ~Other | 去除 Other 中的位 */
+	FORCEINLINE TEntityFlagBlock AndNot(const TEntityFlagBlock& Other) const
+	{
+		TEntityFlagBlock Result;
+		for (int32 RegIt = 0; RegIt < NumRegisters; ++RegIt)
+		{
+			Result.StoreRegister(RegIt, VectorIntAndNot(Other.LoadRegister(RegIt), LoadRegister(RegIt)));
+		}
+		return Result;
+	}
+
+	FORCEINLINE TEntityFlagBlock& operator|=(const TEntityFlagBlock& Other) { return *this = *this | Other; }
+	FORCEINLINE TEntityFlagBlock& operator&=(const TEntityFlagBlock& Other) { return *this = *this & Other; }
+
+	FORCEINLINE bool operator==(const TEntityFlagBlock& Other) const
+	{
+		VectorRegister4Int Acc = VectorIntXor(LoadRegister(0), Other.LoadRegister(0));
+		for (int32 RegIt = 1; RegIt < NumRegisters; ++RegIt)
+		{
+			Acc = VectorIntOr(Acc, VectorIntXor(LoadRegister(RegIt), Other.LoadRegister(RegIt)));
+		}
+		return IsRegisterZero(Acc);
+	}
+	FORCEINLINE bool operator!=(const TEntityFlagBlock& Other) const { return !(*this == Other); }
+
+	/** Number of set bits | 置位数量 */
+	FORCEINLINE int32 CountBits() const
+	{
+		int32 Count = 0;
+		for (int32 WordIt = 0; WordIt < NumWords; ++WordIt)
+		{
+			Count += static_cast<int32>(FMath::CountBits(Words[WordIt]));
+		}
+		return Count;
+	}
+
+	/** Builds a block from the two words of the 128-bit layout; higher words are zero | 由 128 位两字构造 */
+	FORCEINLINE static TEntityFlagBlock FromLowHigh(const int64 Low, const int64 High)
+	{
+		TEntityFlagBlock Block;
+		Block.Words[0] = static_cast<uint64>(Low);
+		Block.Words[1] = static_cast<uint64>(High);
+		return Block;
+	}
+
+private:
+	FORCEINLINE VectorRegister4Int LoadRegister(const int32 RegIndex) const
+	{
+		return VectorIntLoad(&Words[RegIndex * 2]);
+	}
+
+	FORCEINLINE void StoreRegister(const int32 RegIndex, const VectorRegister4Int& Value)
+	{
+		VectorIntStore(Value, &Words[RegIndex * 2]);
+	}
+
+	FORCEINLINE static bool IsRegisterZero(const VectorRegister4Int& Value)
+	{
+		uint64 Lanes[2];
+		VectorIntStore(Value, Lanes);
+		return (Lanes[0] | Lanes[1]) == 0;
+	}
+};
+
+using FEntityFlagBlock128 = TEntityFlagBlock<128>;
+using FEntityFlagBlock256 = TEntityFlagBlock<256>;
+using FEntityFlagBlock512 = TEntityFlagBlock<512>;
+
+/** Block of the project-wide default width | 项目默认宽度的旗标块 */
+using FEntityFlagBlock = TEntityFlagBlock<MASSAPI_FLAG_BITS>;
+
+/**
+ * All / Any / None flag constraint of any width, the wide counterpart of FEntityFlagQueryMask.
+ * Same semantics: an empty Any set always passes. | 任意宽度的 All/Any/None 旗标约束，语义与 FEntityFlagQueryMask 一致
+ */
+template<int32 NumBits>
+struct TEntityFlagQueryMask
+{
+	using FBlock = TEntityFlagBlock<NumBits>;
+
+	FBlock All;
+	FBlock Any;
+	FBlock None;
+
+	TEntityFlagQueryMask& AddAll(const int32 Bit) { All.SetBit(Bit); return *this; }
+	TEntityFlagQueryMask& AddAny(const int32 Bit) { Any.SetBit(Bit); return *this; }
+	TEntityFlagQueryMask& AddNone(const int32 Bit) { None.SetBit(Bit); return *this; }
+
+	/** True if the mask has no flag constraint at all | 没有任何旗标约束 */
+	FORCEINLINE bool IsEmpty() const
+	{
+		return (All | Any | None).IsZero();
+	}
+
+	/** True if an entity with all-zero flags can never pass | 旗标全 0 的实体必然不通过 */
+	FORCEINLINE bool RequiresFlags() const
+	{
+		return !(All | Any).IsZero();
+	}
+
+	/** All/Any/None test of one entity's flag block | 对单个实体旗标块的测试 */
+	FORCEINLINE bool Matches(const FBlock& Flags) const
+	{
+		const bool bAll = Flags.ContainsAll(All);
+		const bool bAny = Any.IsZero() | Flags.Intersects(Any);
+		const bool bNone = !Flags.Intersects(None);
+		return bAll & bAny & bNone;
+	}
+
+	/** False if no entity bounded by the OR / AND summary can pass | 摘要范围内不可能有实体通过 */
+	FORCEINLINE bool CanAnyPass(const FBlock& OrBlock, const FBlock& AndBlock) const
+	{
+		const bool bAll = OrBlock.ContainsAll(All);
+		const bool bAny = Any.IsZero() | OrBlock.Intersects(Any);
+		const bool bNone = !AndBlock.Intersects(None);
+		return bAll & bAny & bNone;
+	}
+
+	/** True if every entity bounded by the OR / AND summary passes | 摘要范围内所有实体必然通过 */
+	FORCEINLINE bool MustAllPass(const FBlock& OrBlock, const FBlock& AndBlock) const
+	{
+		const bool bAll = AndBlock.ContainsAll(All);
+		const bool bAny = Any.IsZero() | AndBlock.Intersects(Any);
+		const bool bNone = !OrBlock.Intersects(None);
+		return bAll & bAny & bNone;
+	}
+};
+
+using FEntityFlagBlockQueryMask = TEntityFlagQueryMask<MASSAPI_FLAG_BITS>;
+
+//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
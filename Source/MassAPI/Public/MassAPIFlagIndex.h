@@ -0,0 +1,121 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FEntityFlagQueryMask;
+
+//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
+
+/**
+ * Compressed set of entity indices (roaring-style).
+ * Indices are split into 65536-wide buckets by their high 16 bits. A bucket stores a sorted uint16 array
+ * while sparse and switches to a 65536-bit bitmap once it holds more than ArrayMaxCardinality entries,
+ * so rare flags cost a few bytes per entity and common flags at most one bit per entity.
+ * | 压缩的实体索引集合（Roaring 风格）：按高 16 位分桶，稀疏时为有序数组，稠密时为位图
+ */
+class MASSAPI_API FEntityIndexBitmap
+{
+public:
+
+	/** Adds Index, returns false if it was already present | 添加索引，已存在时返回 false */
+	bool Add(uint32 Index);
+
+	/** Removes Index, returns false if it was not present | 移除索引，不存在时返回 false */
+	bool Remove(uint32 Index);
+
+	bool Contains(uint32 Index) const;
+
+	FORCEINLINE int32 Num() const { return Cardinality; }
+	FORCEINLINE bool IsEmpty() const { return Cardinality == 0; }
+
+	void Reset();
+
+	/** Heap memory used by the containers | 容器占用的堆内存 */
+	SIZE_T GetAllocatedSize() const;
+
+	/** Appends every index in ascending order | 按升序追加全部索引 */
+	void AppendTo(TArray<uint32>& OutIndices) const;
+
+	/**
+	 * Indices present in every bitmap, in ascending order. Walks the smallest bitmap and probes the others
+	 * bucket by bucket, so the cost follows the rarest flag. | 求交集：遍历最小的位图并按桶探测其余位图
+	 */
+	static void Intersect(TConstArrayView<const FEntityIndexBitmap*> Bitmaps, TArray<uint32>& OutIndices);
+
+	/** Indices present in any bitmap, in ascending order | 求并集，升序输出 */
+	static void Union(TConstArrayView<const FEntityIndexBitmap*> Bitmaps, TArray<uint32>& OutIndices);
+
+	/** Bucket switches to a bitmap above this many entries, and back below half of it | 超过该数量转为位图，低于一半转回数组 */
+	static constexpr int32 ArrayMaxCardinality = 4096;
+
+private:
+	static constexpr int32 BitmapNumWords = 65536 / 64;
+
+	/** One 65536-wide bucket | 一个 65536 宽的桶 */
+	struct FContainer
+	{
+		uint16 Key = 0;
+		int32 Cardinality = 0;
+
+		// Sorted low 16 bits while sparse | 稀疏时的有序低 16 位
+		TArray<uint16> Values;
+
+		// BitmapNumWords words once dense, empty otherwise | 稠密时的位图
+		TArray<uint64> Bits;
+
+		FORCEINLINE bool IsBitmap() const { return Bits.Num() > 0; }
+		bool Contains(uint16 Low) const;
+		void AppendTo(TArray<uint32>& OutIndices) const;
+	};
+
+	// Buckets sorted by Key | 按 Key 排序的桶
+	TArray<FContainer> Containers;
+	int32 Cardinality = 0;
+
+	int32 FindContainer(uint16 Key) const;
+	const FContainer* FindContainerPtr(uint16 Key) const;
+};
+
+/**
+ * One FEntityIndexBitmap per flag bit (0-127), keyed by FMassEntityHandle::Index.
+ * Maintained by UMassAPISubsystem from every MassAPI flag write when the flag index is enabled.
+ * | 每个旗标位一个实体索引位图（0-127），由 UMassAPISubsystem 在所有旗标写入时维护
+ */
+struct MASSAPI_API FEntityFlagIndex
+{
+	static constexpr int32 NumFlags = 128;
+
+	/** Clears then sets the given bits of one entity | 对单个实体先清除后设置旗标位 */
+	void Apply(uint32 EntityIndex, int64 SetLow, int64 SetHigh, int64 ClearLow, int64 ClearHigh);
+
+	void Reset();
+
+	FORCEINLINE const FEntityIndexBitmap& GetBitmap(const int32 Bit) const { check(Bit >= 0 && Bit < NumFlags); return Bitmaps[Bit]; }
+
+	/**
+	 * Upper bound of the entities able to pass the mask, read from bitmap sizes:
+	 * the smallest All bitmap, else the summed Any bitmaps. INDEX_NONE if the mask has neither.
+	 * | 根据位图大小估算可能通过的实体数；无 All/Any 约束时返回 INDEX_NONE
+	 */
+	int32 EstimateCandidates(const FEntityFlagQueryMask& Mask) const;
+
+	/**
+	 * Entity indices that may pass the mask: the intersection of the All bitmaps, or the union of the Any bitmaps.
+	 * None terms are not applied here, callers confirm each candidate. Returns false if the mask has no All/Any term.
+	 * | 可能通过的实体索引（All 求交或 Any 求并）；None 不在此处理，调用者需逐个确认
+	 */
+	bool CollectCandidates(const FEntityFlagQueryMask& Mask, TArray<uint32>& OutIndices) const;
+
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	FEntityIndexBitmap Bitmaps[NumFlags];
+};
+
+//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
@@ -8,6 +8,7 @@
 #include "CoreMinimal.h"
 #include "Engine/DeveloperSettings.h"
 #include "MassAPIEnums.h"
+#include "MassAPIFlagBlock.h"
 #include "MassAPIFlagSettings.generated.h"
 
 //——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
@@ -29,6 +30,74 @@ public:
 	UPROPERTY(Config, EditAnywhere, Category="Flag Registry", meta=(DisplayName="Flag Registry"))
 	TMap<FName, EEntityFlags> FlagRegistry;
 
+	/**
+	 * Templates built from FEntityTemplate also get an FEntityFlagChunkFragment when they carry flags,
+	 * so flag queries can accept or reject whole chunks from its OR/AND summary.
+	 * A summary is rebuilt from the flag column whenever its chunk's serial changes (entities added, removed or
+	 * moved) and after every frame with MassAPI flag writes to its archetype. Writes that bypass MassAPI (fragment
+	 * views, FMassEntityManager) are not seen: call UMassAPISubsystem::InvalidateFlagChunkSummaries after them,
+	 * or leave this off.
+	 * | 带旗标的模板自动附加 FEntityFlagChunkFragment，旗标查询可按 Chunk 摘要整块接受或跳过。Chunk 序列号变化或
+	 * 本原型有 MassAPI 旗标写入时从旗标列重建；绕过 MassAPI 的写入不可见，之后需调用 InvalidateFlagChunkSummaries，否则请保持关闭
+	 */
+	UPROPERTY(Config, EditAnywhere, Category="Flag Query", meta=(DisplayName="Enable Flag Chunk Summary"))
+	bool bEnableFlagChunkSummary = false;
+
+	/**
+	 * Keeps one compressed bitmap of entity indices per flag (0-127) in UMassAPISubsystem, updated by every MassAPI
+	 * flag write. Queries requiring rare flags then visit only the flagged entities instead of scanning.
+	 * Chunks changed structurally since the index last read them are read again before use; writes that bypass
+	 * MassAPI on indexed entities are not seen until UMassAPISubsystem::RebuildFlagIndex.
+	 * | 为每个旗标维护实体索引位图，要求稀有旗标的查询只访问带旗标的实体而非全量扫描。结构变化的 Chunk 使用前重新读取；
+	 * 绕过 MassAPI 改写已索引实体的旗标需调用 RebuildFlagIndex
+	 */
+	UPROPERTY(Config, EditAnywhere, Category="Flag Query", meta=(DisplayName="Enable Flag Index"))
+	bool bEnableFlagIndex = false;
+
+	/**
+	 * Templates that carry flags also get an FEntityFlagChangeFragment recording the epoch and bits of their last
+	 * flag change, so queries can ask for entities whose flags changed since a given epoch (FEntityQuery::FlagsChangedSince).
+	 * | 带旗标的模板附加 FEntityFlagChangeFragment，记录最近一次旗标变化，供"自某纪元起变化"查询
+	 */
+	UPROPERTY(Config, EditAnywhere, Category="Flag Query", meta=(DisplayName="Enable Flag Change Tracking"))
+	bool bEnableFlagChangeTracking = false;
+
+	/**
+	 * Flags mirrored into a tag (FEntityFlagMirrorTag0-15, assigned in list order, at most 16).
+	 * Changes made through MassAPI queue a tag migration, applied in one batch per tick through the command buffer,
+	 * and UMassAPISubsystem::GetFlagMigrationStats reports what that costs per flag. Queries keep testing the flag bits:
+	 * mirrors catch up only at the next command flush and direct fragment writes never move them, so they are not
+	 * used as archetype requirements.
+	 * | 镜像为标签的旗标（最多 16 个）：经 MassAPI 的变化排队迁移，每帧经命令缓冲批量执行，迁移开销见 GetFlagMigrationStats；
+	 * 镜像滞后且不跟随直接片段写入，查询仍检测旗标位而不以标签作为原型需求
+	 */
+	UPROPERTY(Config, EditAnywhere, Category="Flag Query", meta=(DisplayName="Tag-Backed Flags"))
+	TArray<EEntityFlags> TagBackedFlags;
+
+	/**
+	 * Counts MassAPI flag transitions per flag (0-127) in UMassAPISubsystem::GetFlagMigrationStats, i.e. the
+	 * migrations each flag would cost if it were tag-backed. Tag-backed flags are always counted.
+	 * | 统计每个旗标的翻转次数（即改为标签后的迁移次数）；标签镜像旗标始终统计
+	 */
+	UPROPERTY(Config, EditAnywhere, Category="Flag Query", meta=(DisplayName="Collect Flag Migration Stats"))
+	bool bCollectFlagMigrationStats = false;
+
+	/**
+	 * Total number of flags per entity, fixed at compile time by MASSAPI_FLAG_BITS (set it through PublicDefinitions in
+	 * a target's Build.cs) so that runtime templates and FEntityFlagBlock agree. Bits 0-127 stay in FEntityFlagFragment;
+	 * wider builds add an extension fragment (FEntityFlagExt256Fragment / FEntityFlagExt512Fragment) to flagged templates.
+	 * | 每个实体的旗标总数，由编译期的 MASSAPI_FLAG_BITS 决定，运行时模板与 FEntityFlagBlock 保持一致；更宽时附加扩展片段
+	 */
+	UPROPERTY(VisibleAnywhere, Category="Flag Registry", meta=(DisplayName="Flag Width"))
+	EEntityFlagWidth FlagWidth = MASSAPI_FLAG_BITS == 512 ? EEntityFlagWidth::Bits512 : (MASSAPI_FLAG_BITS == 256 ? EEntityFlagWidth::Bits256 : EEntityFlagWidth::Bits128);
+
+	/**
+	 * FName → bit index mapping for any bit below the flag width (including 128+).
+	 * Names in FlagRegistry take precedence. | FName → 任意位索引（含 128 以上），FlagRegistry 优先
+	 */
+	UPROPERTY(Config, EditAnywhere, Category="Flag Registry", meta=(DisplayName="Extended Flag Registry", ClampMin="0", ClampMax="511"))
+	TMap<FName, int32> ExtendedFlagRegistry;
+
 	//———————— UDeveloperSettings overrides | 设置分类名
 
 	virtual FName GetCategoryName() const override { return FName(TEXT("Plugins")); }
@@ -48,6 +117,43 @@ public:
 
 	/** Resolve a flag FName to its EEntityFlags bit position. Returns EEntityFlags_MAX if not found. | 将旗标 FName 解析为位位置 */
 	static EEntityFlags ResolveFlag(FName FlagName);
+
+	/**
+	 * Hash of the resolved registry contents (names and bits). Stable across sessions, so a flag id baked at
+	 * Blueprint compile time stays valid until the registry actually changes. | 注册表内容哈希，跨会话稳定，用于检测过期的旗标 ID
+	 */
+	static int32 GetRegistryVersion();
+
+	/** Resolve a flag FName to any bit index below the flag width. Returns INDEX_NONE if not found. | 将旗标 FName 解析为任意位索引 */
+	static int32 ResolveFlagBit(FName FlagName);
+
+	/** Number of flag bits, MASSAPI_FLAG_BITS (128, 256 or 512) | 旗标位数，即 MASSAPI_FLAG_BITS */
+	static int32 GetFlagBitCount();
+
+	/** Extension fragment holding bits 128+ for the configured width, or nullptr at 128 | 当前宽度对应的扩展片段类型 */
+	static const UScriptStruct* GetFlagExtFragmentType();
+
+	/** Mirror tag of a tag-backed flag bit (0-127), nullptr otherwise | 标签镜像旗标对应的镜像标签 */
+	static const UScriptStruct* GetFlagMirrorTag(int32 Bit);
+
+	/** Bits of every tag-backed flag | 所有标签镜像旗标的位掩码 */
+	static void GetTagBackedMask(int64& OutLow, int64& OutHigh);
+
+	//———————— UObject overrides | 注册表变化时重建查找表
+
+	virtual void PostInitProperties() override;
+	virtual void PostReloadConfig(FProperty* PropertyThatWasLoaded) override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	/**
+	 * Rebuilds the flat FName → bit lookup table from both registries and recomputes the registry version.
+	 * Runs on the game thread when the settings load or change. The new table is immutable and replaces the old one
+	 * in a single atomic swap, so lookups on worker threads see either table whole.
+	 * | 由两个注册表重建扁平查找表并重新计算版本；新表不可变并以一次原子交换发布，工作线程的查找只会看到完整的新表或旧表
+	 */
+	void RebuildFlagTable() const;
 };
 
 //——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
@@ -0,0 +1,73 @@
+/*
+* MassAPI
+* Created: 2025
+* Author: Leroy Works, Ember, All Rights Reserved.
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTypes.h"
+
+//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
+
+/**
+ * One scheduled flag change: set or clear Bit on Entity once the wheel reaches DueTick.
+ * Generation lets a later schedule of the same entity/flag supersede this one. | 一次计划中的旗标变更
+ */
+struct FEntityFlagTimer
+{
+	FMassEntityHandle Entity;
+	uint64 DueTick = 0;
+	uint32 Generation = 0;
+	uint8 Bit = 0;
+	bool bValue = false;
+};
+
+/**
+ * Hierarchical timing wheel for flag timers: NumLevels levels of 64 slots, level L holding timers due within
+ * 64^(L+1) ticks. Scheduling is O(1); each advanced tick drains one level-0 slot and, every 64^L ticks,
+ * redistributes one level-L slot into the levels below. Timers beyond the top span park in the top level
+ * and are re-placed each time their slot comes round.
+ * | 分层时间轮：每层 64 槽，调度 O(1)，每前进一刻清空一个 0 层槽，并按周期把高层槽下放
+ */
+class MASSAPI_API FEntityFlagTimingWheel
+{
+public:
+	static constexpr int32 NumLevels = 4;
+	static constexpr int32 SlotBits = 6;
+	static constexpr int32 NumSlots = 1 << SlotBits;
+
+	/** Seconds per wheel tick | 每刻对应的秒数 */
+	static constexpr double TickSeconds = 1.0 / 100.0;
+
+	/** Adds a timer; one due at or before the current tick fires on the next Advance | 添加计时器，已到期的在下次推进时触发 */
+	void Schedule(const FEntityFlagTimer& Timer);
+
+	/** Advances the wheel to TargetTick and appends every timer that came due, in due order | 推进到 TargetTick 并输出到期计时器 */
+	void Advance(uint64 TargetTick, TArray<FEntityFlagTimer>& OutDue);
+
+	/** Advances by DeltaSeconds of accumulated time | 按累计时间推进 */
+	void AdvanceSeconds(double DeltaSeconds, TArray<FEntityFlagTimer>& OutDue);
+
+	/** Wheel tick a delay of DelaySeconds from now lands on (at least the next tick) | 延迟对应的到期刻 */
+	FORCEINLINE uint64 GetDueTick(const double DelaySeconds) const
+	{
+		return CurrentTick + static_cast<uint64>(FMath::Max<int64>(1, FMath::CeilToInt64(DelaySeconds / TickSeconds)));
+	}
+
+	FORCEINLINE uint64 GetCurrentTick() const { return CurrentTick; }
+	FORCEINLINE int32 Num() const { return NumTimers; }
+
+	void Reset();
+
+private:
+	TArray<FEntityFlagTimer> Slots[NumLevels][NumSlots];
+	uint64 CurrentTick = 0;
+	double PendingSeconds = 0.0;
+	int32 NumTimers = 0;
+
+	void Place(const FEntityFlagTimer& Timer);
+};
+
+//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
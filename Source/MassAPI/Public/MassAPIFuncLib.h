@@ -21,6 +21,9 @@ struct FGenericStruct;
 // Delegate to fire when a deferred command finishes
 DECLARE_DYNAMIC_DELEGATE_OneParam(FOnMassDeferredFinished, FEntityHandle, EntityHandle);
 
+// Delegate fired once per tick by a flag observer with the entities whose observed flags were set / cleared
+DECLARE_DYNAMIC_DELEGATE_TwoParams(FOnMassFlagsChanged, const TArray<FEntityHandle>&, SetEntities, const TArray<FEntityHandle>&, ClearedEntities);
+
 //——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
 
 /**
@@ -111,6 +114,23 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "MassAPI|Entity", meta = (WorldContext = "WorldContextObject", DisplayName = "Build Entities From Template Data Array", Tooltip = "Builds one entity per template data entry in the array.", Keywords = "spawn create make construct build batch mass entity template array multiple", AutoCreateRefTerm = "OnFinished"))
 	static TArray<FEntityHandle> BuildEntitiesFromTemplateDataArray(const UObject* WorldContextObject, UPARAM(ref) const TArray<FEntityTemplateData>& TemplateDatas, const bool bDeferred, const FOnMassDeferredFinished OnFinished);
 
+	/**
+	 * Builds one entity per element of Values from the template, each taking its element as the initial value of that
+	 * fragment instead of the template's. Values must be an array of a fragment struct the template contains; the
+	 * values are written into chunk memory during creation, so no per-entity SetFragment is needed afterwards.
+	 * Blueprint wildcards give one value array per node, so this fills a single fragment type and builds immediately;
+	 * C++ callers needing several columns use UMassAPISubsystem::BuildEntitiesWithColumns.
+	 * @param WorldContextObject The context object to retrieve the world.
+	 * @param TemplateData The template data defining the entities' composition and remaining initial values.
+	 * @param Values Array of fragment structs, one per entity to build.
+	 * @return An array of handles to the newly created entities, in the order of Values.
+	 */
+	UFUNCTION(BlueprintCallable, CustomThunk, Category = "MassAPI|Entity", meta = (WorldContext = "WorldContextObject", ArrayParm = "Values", DisplayName = "Build Entities From Template Data With Values", Tooltip = "Builds one entity per element of Values, each taking its element as its initial fragment value.", Keywords = "spawn create make construct build batch mass entity template array column values per entity"))
+	static TArray<FEntityHandle> BuildEntitiesFromTemplateDataWithValues(const UObject* WorldContextObject, UPARAM(ref) const FEntityTemplateData& TemplateData, const TArray<int32>& Values);
+
+	static TArray<FEntityHandle> Generic_BuildEntitiesFromTemplateDataWithValues(const UObject* WorldContextObject, const FEntityTemplateData& TemplateData, const FEntityBuildColumn& Column);
+	DECLARE_FUNCTION(execBuildEntitiesFromTemplateDataWithValues);
+
 	//================ Entity Querying & BP Processors															========
 
 	/**
@@ -144,6 +164,26 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "MassAPI|Query", meta = (WorldContext = "WorldContextObject", DisplayName = "Get Num Matching Entities", Tooltip = "Counts how many entities in the world match the provided query.", Keywords = "get count num number query filter mass entity entities"))
 	static int32 GetNumMatchingEntities(const UObject* WorldContextObject, UPARAM(ref) const FEntityQuery& Query);
 
+	/**
+	 * Checks whether at least one entity in the world matches the provided query.
+	 * Stops at the first matching chunk and never builds a handle array.
+	 * @param WorldContextObject The context object to retrieve the world.
+	 * @param Query The query rules.
+	 * @return True if any entity matches.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Query", BlueprintPure, meta = (WorldContext = "WorldContextObject", DisplayName = "Any Matching Entities", Tooltip = "Checks whether at least one entity matches the provided query. Stops at the first match.", Keywords = "any exist has some query filter mass entity entities"))
+	static bool AnyMatchingEntities(const UObject* WorldContextObject, UPARAM(ref) const FEntityQuery& Query);
+
+	/**
+	 * Counts, for each of the 128 flags, how many entities matching the query have it set.
+	 * Reads every matching chunk's flag column once instead of running one query per flag.
+	 * @param WorldContextObject The context object to retrieve the world.
+	 * @param Query The query rules.
+	 * @return 128 counts, indexed by flag.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Query", meta = (WorldContext = "WorldContextObject", DisplayName = "Get Flag Histogram", Tooltip = "Counts, for each of the 128 flags, how many entities matching the query have it set.", Keywords = "flag histogram count population statistics telemetry query mass entity entities"))
+	static TArray<int32> GetFlagHistogram(const UObject* WorldContextObject, UPARAM(ref) const FEntityQuery& Query);
+
 	/**
 	 * Retrieves all entities that match the provided query.
 	 * Warning: This can return a large array and impact performance if the result set is huge.
@@ -154,6 +194,140 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "MassAPI|Query", meta = (WorldContext = "WorldContextObject", DisplayName = "Get Matching Entities", Tooltip = "Retrieves all entities that match the provided query. Use it for prototyping only, because for each loop in BP is slow.", Keywords = "get find query filter mass entity entities array list"))
 	static TArray<FEntityHandle> GetMatchingEntities(const UObject* WorldContextObject, UPARAM(ref) const FEntityQuery& Query);
 
+	/**
+	 * Retrieves all entities that match the provided query, splitting the flag evaluation across worker threads.
+	 * The result order is deterministic (archetype order, then chunk order) and identical to Get Matching Entities.
+	 * @param WorldContextObject The context object to retrieve the world.
+	 * @param Query The query rules.
+	 * @param SerialThreshold Below this many candidate entities the query runs on the calling thread only.
+	 *        Negative uses UMassAPISubsystem::ParallelQuerySerialThreshold.
+	 * @return An array of handles for all matching entities.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Query", meta = (WorldContext = "WorldContextObject", DisplayName = "Get Matching Entities (Parallel)", Tooltip = "Retrieves all entities that match the provided query, evaluating flags on worker threads. Result order is deterministic.", Keywords = "get find query filter parallel multithread mass entity entities array list"))
+	static TArray<FEntityHandle> GetMatchingEntitiesParallel(const UObject* WorldContextObject, UPARAM(ref) const FEntityQuery& Query, int32 SerialThreshold = -1);
+
+	/**
+	 * Retrieves the K matching entities with the smallest (or largest) value of a numeric fragment member.
+	 * Uses a bounded heap over the fragment columns, so the cost is O(N log K). Entities without the fragment are skipped.
+	 * @param WorldContextObject The context object to retrieve the world.
+	 * @param Query The query rules.
+	 * @param SortMember The fragment member to sort by (bool, integer, float, double or enum).
+	 * @param K The maximum number of entities to return.
+	 * @param bDescending If true, the largest values come first.
+	 * @param OutValues The sort value of each returned entity.
+	 * @return Up to K entity handles, ordered by the member value.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Query", meta = (WorldContext = "WorldContextObject", DisplayName = "Get Top K Matching Entities", Tooltip = "Returns the K matching entities with the smallest (or largest) value of a fragment member, in order.", Keywords = "get find query top k limit order sort rank nearest min max mass entity entities"))
+	static TArray<FEntityHandle> GetTopKMatchingEntities(const UObject* WorldContextObject, UPARAM(ref) const FEntityQuery& Query, const FStructRecursiveMemberReference& SortMember, int32 K, bool bDescending, TArray<double>& OutValues);
+
+	/**
+	 * Retrieves all matching entities ordered by the value of a numeric fragment member.
+	 * @param WorldContextObject The context object to retrieve the world.
+	 * @param Query The query rules.
+	 * @param SortMember The fragment member to sort by (bool, integer, float, double or enum).
+	 * @param bDescending If true, the largest values come first.
+	 * @param OutValues The sort value of each returned entity.
+	 * @return The matching entity handles, ordered by the member value.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Query", meta = (WorldContext = "WorldContextObject", DisplayName = "Get Matching Entities (Sorted)", Tooltip = "Returns all matching entities ordered by the value of a fragment member.", Keywords = "get find query order sort by mass entity entities array list"))
+	static TArray<FEntityHandle> GetMatchingEntitiesSorted(const UObject* WorldContextObject, UPARAM(ref) const FEntityQuery& Query, const FStructRecursiveMemberReference& SortMember, bool bDescending, TArray<double>& OutValues);
+
+	/**
+	 * Compiles a query into its immutable form (prebuilt bitsets and flag masks).
+	 * Compile once and reuse the result every frame; recompile after editing the query.
+	 * @param Query The query rules to compile.
+	 * @return The compiled query.
+	 */
+	UFUNCTION(BlueprintPure, Category = "MassAPI|Query", meta = (DisplayName = "Compile Entity Query", Tooltip = "Compiles a query into an immutable, thread-safe form. Compile once, reuse every frame.", Keywords = "compile bake prepare cache query filter mass entity"))
+	static FCompiledEntityQuery CompileEntityQuery(UPARAM(ref) const FEntityQuery& Query);
+
+	/**
+	 * Checks if a specific entity matches the provided compiled query.
+	 * @param WorldContextObject The context object to retrieve the world.
+	 * @param EntityHandle The entity to check.
+	 * @param Query The compiled query.
+	 * @return True if the entity matches the query, false otherwise.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Query", BlueprintPure, meta = (WorldContext = "WorldContextObject", DisplayName = "Match Entity Query (Compiled)", Tooltip = "Checks if a specific entity matches the provided compiled query.", Keywords = "match query filter check mass entity compiled"))
+	static bool MatchEntityCompiledQuery(const UObject* WorldContextObject, const FEntityHandle& EntityHandle, UPARAM(ref) const FCompiledEntityQuery& Query);
+
+	/**
+	 * Splits an array of entity handles into matching and unmatching arrays based on the provided compiled query.
+	 * Invalid entities are placed into the unmatching array.
+	 * @param WorldContextObject The context object to retrieve the world.
+	 * @param EntityHandles The entities to test against the query.
+	 * @param Query The compiled query.
+	 * @param MatchingHandles Output array of entities that match the query.
+	 * @param UnmatchingHandles Output array of entities that do NOT match the query (or are invalid).
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Query", meta = (WorldContext = "WorldContextObject", DisplayName = "Match Entities Query (Compiled)", Tooltip = "Splits an array of entity handles into matching and unmatching arrays based on the provided compiled query.", Keywords = "match query filter check split partition mass entity entities array compiled"))
+	static void MatchEntitiesCompiledQuery(const UObject* WorldContextObject, const TArray<FEntityHandle>& EntityHandles, UPARAM(ref) const FCompiledEntityQuery& Query, TArray<FEntityHandle>& MatchingHandles, TArray<FEntityHandle>& UnmatchingHandles);
+
+	/**
+	 * Counts how many entities in the world match the provided compiled query.
+	 * @param WorldContextObject The context object to retrieve the world.
+	 * @param Query The compiled query.
+	 * @return The number of matching entities.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Query", meta = (WorldContext = "WorldContextObject", DisplayName = "Get Num Matching Entities (Compiled)", Tooltip = "Counts how many entities in the world match the provided compiled query.", Keywords = "get count num number query filter mass entity entities compiled"))
+	static int32 GetNumMatchingEntitiesCompiled(const UObject* WorldContextObject, UPARAM(ref) const FCompiledEntityQuery& Query);
+
+	/**
+	 * Checks whether at least one entity in the world matches the provided compiled query.
+	 * @param WorldContextObject The context object to retrieve the world.
+	 * @param Query The compiled query.
+	 * @return True if any entity matches.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Query", BlueprintPure, meta = (WorldContext = "WorldContextObject", DisplayName = "Any Matching Entities (Compiled)", Tooltip = "Checks whether at least one entity matches the provided compiled query. Stops at the first match.", Keywords = "any exist has some query filter mass entity entities compiled"))
+	static bool AnyMatchingEntitiesCompiled(const UObject* WorldContextObject, UPARAM(ref) const FCompiledEntityQuery& Query);
+
+	/**
+	 * Retrieves all entities that match the provided compiled query.
+	 * @param WorldContextObject The context object to retrieve the world.
+	 * @param Query The compiled query.
+	 * @return An array of handles for all matching entities.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Query", meta = (WorldContext = "WorldContextObject", DisplayName = "Get Matching Entities (Compiled)", Tooltip = "Retrieves all entities that match the provided compiled query.", Keywords = "get find query filter mass entity entities array list compiled"))
+	static TArray<FEntityHandle> GetMatchingEntitiesCompiled(const UObject* WorldContextObject, UPARAM(ref) const FCompiledEntityQuery& Query);
+
+	/**
+	 * Registers a live query whose result set is kept up to date every tick.
+	 * Only chunks that changed since the last tick are rescanned.
+	 * @param WorldContextObject The context object to retrieve the world.
+	 * @param Query The query rules.
+	 * @return The live query id, or -1 if Mass is not available.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Query", meta = (WorldContext = "WorldContextObject", DisplayName = "Register Live Query", Tooltip = "Registers a query whose matching set and added/removed deltas are updated every tick.", Keywords = "live query register watch track delta added removed mass entity"))
+	static int32 RegisterLiveQuery(const UObject* WorldContextObject, UPARAM(ref) const FEntityQuery& Query);
+
+	/**
+	 * Stops updating a live query and releases its result set.
+	 * @param WorldContextObject The context object to retrieve the world.
+	 * @param LiveQueryId The id returned by Register Live Query.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Query", meta = (WorldContext = "WorldContextObject", DisplayName = "Unregister Live Query", Tooltip = "Stops updating a live query and releases its result set.", Keywords = "live query unregister remove stop mass entity"))
+	static void UnregisterLiveQuery(const UObject* WorldContextObject, int32 LiveQueryId);
+
+	/**
+	 * Gets the entities that started and stopped matching a live query during the last tick.
+	 * @param WorldContextObject The context object to retrieve the world.
+	 * @param LiveQueryId The id returned by Register Live Query.
+	 * @param Added Entities that started matching.
+	 * @param Removed Entities that stopped matching (or were destroyed).
+	 * @return False if the live query id is unknown.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Query", meta = (WorldContext = "WorldContextObject", DisplayName = "Get Live Query Deltas", Tooltip = "Gets the entities that started and stopped matching the live query during the last tick.", Keywords = "live query delta added removed changed mass entity"))
+	static bool GetLiveQueryDeltas(const UObject* WorldContextObject, int32 LiveQueryId, TArray<FEntityHandle>& Added, TArray<FEntityHandle>& Removed);
+
+	/**
+	 * Gets every entity currently matching a live query.
+	 * @param WorldContextObject The context object to retrieve the world.
+	 * @param LiveQueryId The id returned by Register Live Query.
+	 * @return The current matching set (unordered).
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Query", meta = (WorldContext = "WorldContextObject", DisplayName = "Get Live Query Entities", Tooltip = "Gets every entity currently matching the live query.", Keywords = "live query current matching set mass entity entities"))
+	static TArray<FEntityHandle> GetLiveQueryEntities(const UObject* WorldContextObject, int32 LiveQueryId);
+
 	/**
 	 * Begins a ForEach iteration over entities matching the Query.
 	 * Stores the entity list on the subsystem and returns a cursor ID.
@@ -329,6 +503,19 @@ public:
 	static void Generic_SetFragment_Template_Unified(const UObject* WorldContextObject, UPARAM(ref) FEntityTemplateData& TemplateData, UScriptStruct* FragmentType, const void* InFragmentPtr);
 	DECLARE_FUNCTION(execSetFragment_Template_Unified);
 
+	//———————— Set.Fragments.Template																					————
+
+	/**
+	 * Sets several Fragment, SharedFragment or ConstSharedFragment values on Template Data in one edit.
+	 * Values are written in place (the data is copied once if another handle shares it); replacing shared values
+	 * the template already has costs a single rebuild for the whole array. A later value of a type wins.
+	 * @param WorldContextObject The context object.
+	 * @param TemplateData The template data to modify.
+	 * @param Fragments The values to set, each an instanced fragment struct.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Composition", meta = (WorldContext = "WorldContextObject", DisplayName = "SetFragments (Template)", Tooltip = "Sets several Fragment, SharedFragment or ConstSharedFragment values on Template Data in one edit, without rebuilding the template per value.", Keywords = "set add update fragments shared const batch multiple template mass value"))
+	static void SetFragments_Template(const UObject* WorldContextObject, UPARAM(ref) FEntityTemplateData& TemplateData, const TArray<FInstancedStruct>& Fragments);
+
 	//———————— Get.Fragment.Entity (Unified for Fragment/SharedFragment/ConstSharedFragment)								————
 
 	/**
@@ -601,6 +788,206 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "MassAPI|Flag", BlueprintInternalUseOnly, meta = (WorldContext = "WorldContextObject", Keywords = "clear remove delete flag fname template mass"))
 	static void ClearFlag_TemplateByName(const UObject* WorldContextObject, UPARAM(ref) FEntityTemplateData& TemplateData, FName FlagName);
 
+	//================ Flag Operations (Pre-resolved Id)                                                        ========
+
+	//———————— Make.FlagId                                                                                      ————
+
+	/**
+	 * Resolves a flag name once into an FEntityFlagId. Store the id and reuse it to skip the name lookup on every call.
+	 * @param FlagName A name from the flag registry.
+	 * @return The resolved id; its Bit is INDEX_NONE if the name is not registered.
+	 */
+	UFUNCTION(BlueprintPure, Category = "MassAPI|Flag", meta = (DisplayName = "Make Flag Id", Keywords = "make resolve flag id fname mass"))
+	static FEntityFlagId MakeFlagId(FName FlagName);
+
+	//———————— Is.FlagId.Valid                                                                                  ————
+
+	UFUNCTION(BlueprintPure, Category = "MassAPI|Flag", meta = (DisplayName = "Is Flag Id Valid", Keywords = "valid check flag id mass"))
+	static bool IsFlagIdValid(const FEntityFlagId& FlagId);
+
+	//———————— Has.Flag.ById.Entity                                                                             ————
+
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Flag", BlueprintInternalUseOnly, BlueprintPure, meta = (WorldContext = "WorldContextObject", Keywords = "has check exist flag id mass entity"))
+	static bool HasFlag_EntityById(const UObject* WorldContextObject, const FEntityHandle& EntityHandle, const FEntityFlagId& FlagId);
+
+	//———————— Has.Flag.ById.Template                                                                           ————
+
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Flag", BlueprintInternalUseOnly, BlueprintPure, meta = (Keywords = "has check exist flag id template mass"))
+	static bool HasFlag_TemplateById(UPARAM(ref) const FEntityTemplateData& TemplateData, const FEntityFlagId& FlagId);
+
+	//———————— Set.Flag.ById.Entity                                                                             ————
+
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Flag", BlueprintInternalUseOnly, meta = (WorldContext = "WorldContextObject", AutoCreateRefTerm = "OnFinished", Keywords = "set add update flag id mass entity"))
+	static bool SetFlag_EntityById(const UObject* WorldContextObject, const FEntityHandle& EntityHandle, const FEntityFlagId& FlagId, bool bDeferred, FOnMassDeferredFinished OnFinished);
+
+	//———————— Set.Flag.ById.Template                                                                           ————
+
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Flag", BlueprintInternalUseOnly, meta = (WorldContext = "WorldContextObject", Keywords = "set add update flag id template mass"))
+	static void SetFlag_TemplateById(const UObject* WorldContextObject, UPARAM(ref) FEntityTemplateData& TemplateData, const FEntityFlagId& FlagId);
+
+	//———————— Clear.Flag.ById.Entity                                                                           ————
+
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Flag", BlueprintInternalUseOnly, meta = (WorldContext = "WorldContextObject", AutoCreateRefTerm = "OnFinished", Keywords = "clear remove delete flag id mass entity"))
+	static bool ClearFlag_EntityById(const UObject* WorldContextObject, const FEntityHandle& EntityHandle, const FEntityFlagId& FlagId, bool bDeferred, FOnMassDeferredFinished OnFinished);
+
+	//———————— Clear.Flag.ById.Template                                                                         ————
+
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Flag", BlueprintInternalUseOnly, meta = (WorldContext = "WorldContextObject", Keywords = "clear remove delete flag id template mass"))
+	static void ClearFlag_TemplateById(const UObject* WorldContextObject, UPARAM(ref) FEntityTemplateData& TemplateData, const FEntityFlagId& FlagId);
+
+
+	//================ Flag Operations (Batch)                                                                  ========
+
+	//———————— Apply.FlagMask.Entities                                                                          ————
+
+	/**
+	 * Clears then sets flags on many entities in one pass per archetype chunk.
+	 * In deferred mode the whole batch is pushed as a single command.
+	 * @param WorldContextObject The context object.
+	 * @param EntityHandles The entities to modify. Entities without FEntityFlagFragment are skipped.
+	 * @param FlagsToSet Flags to set.
+	 * @param FlagsToClear Flags to clear (applied before FlagsToSet).
+	 * @param bDeferred If true, the write happens when the command buffer flushes.
+	 * @return The number of entities written (0 in deferred mode).
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Flag", meta = (WorldContext = "WorldContextObject", DisplayName = "Apply Flag Mask (Batch)", AutoCreateRefTerm = "FlagsToSet,FlagsToClear", Tooltip = "Clears then sets flags on many entities, one pass per chunk. Deferred mode pushes one command for the whole batch.", Keywords = "apply set clear flag mask batch bulk array mass entity entities"))
+	static int32 ApplyFlagMask(const UObject* WorldContextObject, const TArray<FEntityHandle>& EntityHandles, const TArray<EEntityFlags>& FlagsToSet, const TArray<EEntityFlags>& FlagsToClear, bool bDeferred = false);
+
+	//———————— Set.Flags.Batch                                                                                  ————
+
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Flag", meta = (WorldContext = "WorldContextObject", DisplayName = "Set Flags (Batch)", Tooltip = "Sets flags on many entities, one pass per chunk. Deferred mode pushes one command for the whole batch.", Keywords = "set add flag batch bulk array mass entity entities"))
+	static int32 SetFlagsBatch(const UObject* WorldContextObject, const TArray<FEntityHandle>& EntityHandles, const TArray<EEntityFlags>& Flags, bool bDeferred = false);
+
+	//———————— Clear.Flags.Batch                                                                                ————
+
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Flag", meta = (WorldContext = "WorldContextObject", DisplayName = "Clear Flags (Batch)", Tooltip = "Clears flags on many entities, one pass per chunk. Deferred mode pushes one command for the whole batch.", Keywords = "clear remove flag batch bulk array mass entity entities"))
+	static int32 ClearFlagsBatch(const UObject* WorldContextObject, const TArray<FEntityHandle>& EntityHandles, const TArray<EEntityFlags>& Flags, bool bDeferred = false);
+
+	//———————— Apply.FlagMask.Query                                                                             ————
+
+	/**
+	 * Clears then sets flags on every entity matching a query, without building a handle array in Blueprint.
+	 * @param WorldContextObject The context object.
+	 * @param Query The query rules.
+	 * @param FlagsToSet Flags to set.
+	 * @param FlagsToClear Flags to clear (applied before FlagsToSet).
+	 * @param bDeferred If true, the query is matched and written when the command buffer flushes.
+	 * @return The number of entities written (0 in deferred mode).
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Flag", meta = (WorldContext = "WorldContextObject", DisplayName = "Apply Flag Mask (Query)", AutoCreateRefTerm = "FlagsToSet,FlagsToClear", Tooltip = "Clears then sets flags on every entity matching the query, one pass per chunk.", Keywords = "apply set clear flag mask batch bulk query filter mass entity entities"))
+	static int32 ApplyFlagMaskToQuery(const UObject* WorldContextObject, UPARAM(ref) const FEntityQuery& Query, const TArray<EEntityFlags>& FlagsToSet, const TArray<EEntityFlags>& FlagsToClear, bool bDeferred = false);
+
+	//================ Flag Index                                                                               ========
+
+	//———————— Get.Entities.WithFlag                                                                            ————
+
+	/**
+	 * Returns every entity that has a flag set. With the flag index enabled this only visits the flagged entities.
+	 * @param WorldContextObject The context object.
+	 * @param Flag The flag to look up.
+	 * @return The flagged entities, in entity index order when the index is used.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Flag", meta = (WorldContext = "WorldContextObject", DisplayName = "Get Entities With Flag", Tooltip = "Returns every entity that has the flag set. Uses the flag index when it is enabled.", Keywords = "get find entities flag index lookup mass entity"))
+	static TArray<FEntityHandle> GetEntitiesWithFlag(const UObject* WorldContextObject, EEntityFlags Flag);
+
+	//———————— Set.FlagIndex.Enabled                                                                            ————
+
+	/**
+	 * Enables or disables the per-flag entity index. Enabling rebuilds it from every entity's flags.
+	 * @param WorldContextObject The context object.
+	 * @param bEnabled Whether the index should be maintained.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Flag", meta = (WorldContext = "WorldContextObject", DisplayName = "Set Flag Index Enabled", Tooltip = "Enables or disables the per-flag entity index used to answer flag queries without scanning.", Keywords = "set enable disable flag index bitmap mass"))
+	static void SetFlagIndexEnabled(const UObject* WorldContextObject, bool bEnabled);
+
+	//================ Flag Change Tracking                                                                     ========
+
+	//———————— Get.FlagChangeEpoch                                                                              ————
+
+	/**
+	 * Returns the current flag change epoch. Store it, then set it as a query's FlagsChangedSince later to match
+	 * only entities whose flags changed from that point on (requires flag change tracking in the project settings).
+	 * @param WorldContextObject The context object.
+	 * @return The current epoch, advanced once per frame.
+	 */
+	UFUNCTION(BlueprintPure, Category = "MassAPI|Flag", meta = (WorldContext = "WorldContextObject", DisplayName = "Get Flag Change Epoch", Tooltip = "Current flag change epoch. Use it as a query's FlagsChangedSince to find entities whose flags changed since then.", Keywords = "get flag change epoch frame changed since dirty mass"))
+	static int64 GetFlagChangeEpoch(const UObject* WorldContextObject);
+
+	//================ Timed Flags                                                                              ========
+
+	//———————— Set.Flag.ForDuration                                                                             ————
+
+	/**
+	 * Sets a flag on an entity now and clears it after a number of seconds, without a Delay node or Tick logic.
+	 * Calling it again before the flag expires restarts the window.
+	 * @param WorldContextObject The context object.
+	 * @param EntityHandle The entity to flag.
+	 * @param Flag The flag to set.
+	 * @param Duration Seconds until the flag is cleared.
+	 * @return True if the flag was set, false if the entity is invalid or lacks the flag fragment.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Flag", meta = (WorldContext = "WorldContextObject", DisplayName = "Set Flag For Duration", Tooltip = "Sets the flag now and clears it after Duration seconds. Calling again restarts the window.", Keywords = "set flag duration timer timed expire stun window mass entity"))
+	static bool SetFlagForDuration(const UObject* WorldContextObject, const FEntityHandle& EntityHandle, EEntityFlags Flag, float Duration);
+
+	//———————— Schedule.Flag.Change                                                                             ————
+
+	/**
+	 * Sets or clears a flag on an entity after a delay. A newer schedule for the same entity and flag replaces this one.
+	 * @param WorldContextObject The context object.
+	 * @param EntityHandle The entity to change.
+	 * @param Flag The flag to change.
+	 * @param bValue True to set the flag, false to clear it.
+	 * @param Delay Seconds until the change is applied.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Flag", meta = (WorldContext = "WorldContextObject", DisplayName = "Schedule Flag Change", Tooltip = "Sets or clears the flag after Delay seconds. Changes due in the same frame are applied in one batch.", Keywords = "schedule delay flag set clear timer timed mass entity"))
+	static void ScheduleFlagChange(const UObject* WorldContextObject, const FEntityHandle& EntityHandle, EEntityFlags Flag, bool bValue, float Delay);
+
+	//================ Flag Observers                                                                           ========
+
+	//———————— Register.FlagObserver                                                                            ————
+
+	/**
+	 * Calls OnChanged once per tick with every entity whose watched flags were set or cleared since the last tick,
+	 * replacing GetMatchingEntities polls used to detect transitions.
+	 * @param WorldContextObject The context object.
+	 * @param Flags The flags to watch.
+	 * @param OnChanged Receives the entities whose watched flags went on (SetEntities) or off (ClearedEntities).
+	 * @return The observer id, or -1 if Flags is empty or Mass is not available.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Flag", meta = (WorldContext = "WorldContextObject", DisplayName = "Register Flag Observer", Tooltip = "Calls OnChanged once per tick with the entities whose watched flags were set or cleared.", Keywords = "register flag observer watch event changed set cleared callback mass entity"))
+	static int32 RegisterFlagObserver(const UObject* WorldContextObject, const TArray<EEntityFlags>& Flags, FOnMassFlagsChanged OnChanged);
+
+	//———————— Unregister.FlagObserver                                                                          ————
+
+	/**
+	 * Stops a flag observer.
+	 * @param WorldContextObject The context object.
+	 * @param ObserverId The id returned by Register Flag Observer.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Flag", meta = (WorldContext = "WorldContextObject", DisplayName = "Unregister Flag Observer", Tooltip = "Stops a flag observer.", Keywords = "unregister remove stop flag observer mass"))
+	static void UnregisterFlagObserver(const UObject* WorldContextObject, int32 ObserverId);
+
+	//———————— Get.FlagMigrationStats                                                                           ————
+
+	/**
+	 * Gets the migration cost counters of a flag: transitions, and for tag-backed flags the entities moved and batches used.
+	 * Non tag-backed flags are only counted when Collect Flag Migration Stats is enabled in the project settings.
+	 * @param WorldContextObject The context object.
+	 * @param Flag The flag to inspect.
+	 * @return The counters accumulated since start or the last reset.
+	 */
+	UFUNCTION(BlueprintPure, Category = "MassAPI|Flag", meta = (WorldContext = "WorldContextObject", DisplayName = "Get Flag Migration Stats", Tooltip = "Gets how often a flag flipped and, for tag-backed flags, how many entities were migrated.", Keywords = "get flag migration stats cost tag backed mirror archetype mass"))
+	static FEntityFlagMigrationStats GetFlagMigrationStats(const UObject* WorldContextObject, EEntityFlags Flag);
+
+	//———————— Reset.FlagMigrationStats                                                                         ————
+
+	/**
+	 * Zeroes the migration counters of every flag.
+	 * @param WorldContextObject The context object.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MassAPI|Flag", meta = (WorldContext = "WorldContextObject", DisplayName = "Reset Flag Migration Stats", Tooltip = "Zeroes the migration counters of every flag.", Keywords = "reset clear flag migration stats mass"))
+	static void ResetFlagMigrationStats(const UObject* WorldContextObject);
+
 
 	//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
 	// Deprecated Functions
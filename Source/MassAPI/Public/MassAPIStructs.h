@@ -13,8 +13,9 @@
 #include "MassEntityTemplate.h"
 #include "MassAPIEnums.h"
 #include "MassEntityQuery.h"
-#include <atomic>
 #include "MassAPIFlagSettings.h"
+#include "MassAPIFlagBlock.h"
+#include "Property/MagnusNodesStruct.h"
 #include "MassAPIStructs.generated.h"
 
 
@@ -47,59 +48,77 @@ public:
 };
 
 /**
- * (New) Stores dynamic flags without causing Archetype migration.
- * Uses two int64 bitmasks for 128 flags total (Flags for 0-63, FlagsHigh for 64-127).
- * Thread-safe implementation using atomic spinlock.
+ * A flag name resolved once to its bit index, so name-based flag access costs the same as an enum.
+ * RegistryVersion records the flag registry the bit was resolved against; if the registry has changed since,
+ * the id is stale and re-resolves from Name. | 预解析的旗标 ID：名称只解析一次；注册表版本不符时按名称重新解析
  */
 USTRUCT(BlueprintType)
-struct MASSAPI_API FEntityFlagFragment : public FMassFragment
+struct MASSAPI_API FEntityFlagId
 {
 	GENERATED_BODY()
 
-private:
-	// The spinlock flag, copied from FStatistics implementation
-	mutable std::atomic<bool> LockFlag{ false };
-
 public:
-	/** Low flags (0-63) */
-	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "MassAPI|Flags")
-	int64 Flags = 0;
+	FEntityFlagId() = default;
+	FORCEINLINE explicit FEntityFlagId(const FName InName)
+		: Name(InName)
+		, Bit(UMassAPIFlagSettings::ResolveFlagBit(InName))
+		, RegistryVersion(UMassAPIFlagSettings::GetRegistryVersion())
+	{}
 
-	/** High flags (64-127) */
-	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "MassAPI|Flags")
-	int64 FlagsHigh = 0;
+	/** Registered flag name | 注册的旗标名 */
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category = "MassAPI|Flags")
+	FName Name;
 
-	// --- Constructors & Operators (Required for std::atomic) ---
+	/** Resolved bit index, INDEX_NONE if the name is not registered | 解析得到的位索引 */
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category = "MassAPI|Flags")
+	int32 Bit = INDEX_NONE;
 
-	FEntityFlagFragment() {};
+	/** Registry version at resolve time, 0 if never resolved | 解析时的注册表版本 */
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category = "MassAPI|Flags")
+	int32 RegistryVersion = 0;
 
-	FEntityFlagFragment(const FEntityFlagFragment& Other)
-	{
-		Flags = Other.Flags;
-		FlagsHigh = Other.FlagsHigh;
-	}
+	/** True if the registry changed since this id was resolved | 注册表在解析后已变化 */
+	FORCEINLINE bool IsStale() const { return RegistryVersion != UMassAPIFlagSettings::GetRegistryVersion(); }
+
+	/** Current bit index; re-resolves from Name only when stale | 当前位索引，仅在过期时重新解析 */
+	FORCEINLINE int32 GetBit() const { return IsStale() ? UMassAPIFlagSettings::ResolveFlagBit(Name) : Bit; }
 
-	FEntityFlagFragment& operator=(const FEntityFlagFragment& Other)
+	/** Bit as EEntityFlags, or EEntityFlags_MAX for unregistered or 128+ bits | 以 EEntityFlags 表示的位 */
+	FORCEINLINE EEntityFlags GetFlag() const
 	{
-		if (this != &Other)
-		{
-			Flags = Other.Flags;
-			FlagsHigh = Other.FlagsHigh;
-		}
-		return *this;
+		const int32 CurrentBit = GetBit();
+		return (CurrentBit >= 0 && CurrentBit < 128) ? static_cast<EEntityFlags>(CurrentBit) : EEntityFlags::EEntityFlags_MAX;
 	}
 
-	// --- Locking Mechanics ---
+	FORCEINLINE bool IsValid() const { return GetBit() != INDEX_NONE; }
 
-	void Lock() const
-	{
-		while (LockFlag.exchange(true, std::memory_order_acquire));
-	}
+	/** Re-resolves in place if stale, so later reads skip the lookup | 过期时原地刷新 */
+	FORCEINLINE void Refresh() { if (IsStale()) *this = FEntityFlagId(Name); }
 
-	void Unlock() const
-	{
-		LockFlag.store(false, std::memory_order_release);
-	}
+	FORCEINLINE bool operator==(const FEntityFlagId& Other) const { return Name == Other.Name; }
+	FORCEINLINE bool operator!=(const FEntityFlagId& Other) const { return !(*this == Other); }
+	FORCEINLINE friend uint32 GetTypeHash(const FEntityFlagId& FlagId) { return GetTypeHash(FlagId.Name); }
+};
+
+/**
+ * (New) Stores dynamic flags without causing Archetype migration.
+ * Uses two int64 bitmasks for 128 flags total (Flags for 0-63, FlagsHigh for 64-127).
+ * Thread-safe without a lock: every write is a single atomic read-modify-write on one 64-bit word,
+ * so the fragment stays a plain 16-byte trivially copyable POD (chunk moves and batch sets are memcpy).
+ * | 无锁实现：每次写入为单个 64 位字的原子读改写，片段保持 16 字节可平凡复制
+ */
+USTRUCT(BlueprintType)
+struct MASSAPI_API FEntityFlagFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	/** Low flags (0-63) */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "MassAPI|Flags")
+	int64 Flags = 0;
+
+	/** High flags (64-127) */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "MassAPI|Flags")
+	int64 FlagsHigh = 0;
 
 	// --- Helper Methods for 128-bit Flag Support ---
 
@@ -119,163 +138,932 @@ public:
 
 	/**
 	 * (New) Checks if this Fragment has a specific flag set.
-	 * Note: This is a read operation and currently technically lock-free.
+	 * Lock-free: relaxed atomic read of one word.
 	 */
 	FORCEINLINE bool HasFlag(const EEntityFlags Flag) const
 	{
 		if (Flag >= EEntityFlags::EEntityFlags_MAX) return false;
-		const uint8 LocalIndex = GetLocalBitIndex(Flag);
-		const int64 Mask = (1LL << LocalIndex);
-		return IsHighFlag(Flag) ? (FlagsHigh & Mask) != 0 : (Flags & Mask) != 0;
+		const int64 Mask = (1LL << GetLocalBitIndex(Flag));
+		return (LoadWord(IsHighFlag(Flag) ? FlagsHigh : Flags) & Mask) != 0;
 	}
 
 	/**
 	 * (New) Sets a specific flag on this Fragment.
-	 * Thread-safe: Uses Lock/Unlock, but checks first to avoid unnecessary locking.
+	 * Lock-free: atomic fetch-or, skipped when the flag is already set to avoid dirtying the cache line.
 	 */
 	FORCEINLINE void SetFlag(const EEntityFlags Flag)
 	{
 		if (Flag >= EEntityFlags::EEntityFlags_MAX) return;
 
-		// OPTIMIZATION: If the flag is already set, do not wait for a lock.
+		// OPTIMIZATION: If the flag is already set, do not write.
 		if (HasFlag(Flag))
 		{
 			return;
 		}
 
-		Lock(); // Enter Critical Section
+		const int64 Mask = (1LL << GetLocalBitIndex(Flag));
+		FPlatformAtomics::InterlockedOr(&GetWord(Flag), Mask);
+	}
+
+	/**
+	 * (New) Clears a specific flag on this Fragment.
+	 * Lock-free: atomic fetch-and, skipped when the flag is already clear.
+	 */
+	FORCEINLINE void ClearFlag(const EEntityFlags Flag)
+	{
+		if (Flag >= EEntityFlags::EEntityFlags_MAX) return;
+
+		// OPTIMIZATION: If the flag is already clear, do not write.
+		if (!HasFlag(Flag))
+		{
+			return;
+		}
+
+		const int64 Mask = (1LL << GetLocalBitIndex(Flag));
+		FPlatformAtomics::InterlockedAnd(&GetWord(Flag), ~Mask);
+	}
+
+	/**
+	 * (New) Sets or Clears a specific flag based on a boolean value.
+	 * Lock-free: see SetFlag / ClearFlag.
+	 */
+	FORCEINLINE void SetFlagValue(const EEntityFlags Flag, const bool bValue)
+	{
+		if (bValue)
+		{
+			SetFlag(Flag);
+		}
+		else
+		{
+			ClearFlag(Flag);
+		}
+	}
+
+	/** The 128 flags as a flag block (for wide masks and SIMD ops) | 以旗标块形式返回 128 个旗标 */
+	FORCEINLINE FEntityFlagBlock128 GetBlock() const
+	{
+		return FEntityFlagBlock128::FromLowHigh(LoadWord(Flags), LoadWord(FlagsHigh));
+	}
+
+	// --- Multi-flag atomic operations | 多旗标原子操作 ---
+
+	/**
+	 * Sets every bit of SetLow / SetHigh and returns the masks as they were before the write.
+	 * Each word is updated atomically on its own; a write touching both words is not one atomic step.
+	 * | 一次设置多个旗标并返回写入前的掩码；两个字各自原子
+	 */
+	FORCEINLINE FEntityFlagFragment FetchSetFlags(const int64 SetLow, const int64 SetHigh)
+	{
+		FEntityFlagFragment Previous;
+		Previous.Flags = SetLow ? FPlatformAtomics::InterlockedOr(&Flags, SetLow) : LoadWord(Flags);
+		Previous.FlagsHigh = SetHigh ? FPlatformAtomics::InterlockedOr(&FlagsHigh, SetHigh) : LoadWord(FlagsHigh);
+		return Previous;
+	}
+
+	/** Clears every bit of ClearLow / ClearHigh and returns the previous masks | 一次清除多个旗标并返回写入前的掩码 */
+	FORCEINLINE FEntityFlagFragment FetchClearFlags(const int64 ClearLow, const int64 ClearHigh)
+	{
+		FEntityFlagFragment Previous;
+		Previous.Flags = ClearLow ? FPlatformAtomics::InterlockedAnd(&Flags, ~ClearLow) : LoadWord(Flags);
+		Previous.FlagsHigh = ClearHigh ? FPlatformAtomics::InterlockedAnd(&FlagsHigh, ~ClearHigh) : LoadWord(FlagsHigh);
+		return Previous;
+	}
+
+	/**
+	 * Sets Flag and returns true only if this call turned it on, judged from the word the atomic replaced,
+	 * so two racing writers never both report the change. | 设置旗标；仅当本次原子写入使其从无到有时返回 true
+	 */
+	FORCEINLINE bool SetFlagIfClear(const EEntityFlags Flag)
+	{
+		if (Flag >= EEntityFlags::EEntityFlags_MAX || HasFlag(Flag)) return false;
+
+		const int64 Mask = (1LL << GetLocalBitIndex(Flag));
+		return (FPlatformAtomics::InterlockedOr(&GetWord(Flag), Mask) & Mask) == 0;
+	}
+
+	/** Clears Flag and returns true only if this call turned it off (see SetFlagIfClear) | 清除旗标；仅当本次写入使其消失时返回 true */
+	FORCEINLINE bool ClearFlagIfSet(const EEntityFlags Flag)
+	{
+		if (Flag >= EEntityFlags::EEntityFlags_MAX || !HasFlag(Flag)) return false;
+
+		const int64 Mask = (1LL << GetLocalBitIndex(Flag));
+		return (FPlatformAtomics::InterlockedAnd(&GetWord(Flag), ~Mask) & Mask) != 0;
+	}
+
+	/**
+	 * Compare-and-swap of one word: writes Desired only if the word still equals Expected.
+	 * On failure Expected receives the current value so the caller can retry.
+	 * | 单字 CAS：仅当值等于 Expected 时写入 Desired；失败时 Expected 更新为当前值
+	 */
+	FORCEINLINE bool CompareExchangeFlags(const bool bHigh, int64& Expected, const int64 Desired)
+	{
+		const int64 Observed = FPlatformAtomics::InterlockedCompareExchange(bHigh ? &FlagsHigh : &Flags, Desired, Expected);
+		const bool bSwapped = Observed == Expected;
+		Expected = Observed;
+		return bSwapped;
+	}
+
+	/**
+	 * Sets all bits of Mask in one word only if none of them is set yet (claim several flags at once).
+	 * Returns false, leaving the word untouched, if any bit was already set. OutPrevious receives the word before the attempt.
+	 * | 仅当 Mask 中所有位均未设置时一次性设置（批量占用），否则不写入并返回 false
+	 */
+	FORCEINLINE bool TrySetFlagsIfClear(const bool bHigh, const int64 Mask, int64& OutPrevious)
+	{
+		int64 Expected = LoadWord(bHigh ? FlagsHigh : Flags);
+		while ((Expected & Mask) == 0)
+		{
+			if (CompareExchangeFlags(bHigh, Expected, Expected | Mask))
+			{
+				OutPrevious = Expected;
+				return true;
+			}
+		}
+		OutPrevious = Expected;
+		return false;
+	}
+
+	// --- FName-based flag operations | 基于FName的旗标操作 ---
+
+	FORCEINLINE bool HasFlagByName(const FName FlagName) const
+	{
+		const EEntityFlags Resolved = UMassAPIFlagSettings::ResolveFlag(FlagName);
+		return (Resolved != EEntityFlags::EEntityFlags_MAX) && HasFlag(Resolved);
+	}
+
+	FORCEINLINE void SetFlagByName(const FName FlagName)
+	{
+		const EEntityFlags Resolved = UMassAPIFlagSettings::ResolveFlag(FlagName);
+		if (Resolved != EEntityFlags::EEntityFlags_MAX)
+		{
+			SetFlag(Resolved);
+		}
+	}
+
+	FORCEINLINE void ClearFlagByName(const FName FlagName)
+	{
+		const EEntityFlags Resolved = UMassAPIFlagSettings::ResolveFlag(FlagName);
+		if (Resolved != EEntityFlags::EEntityFlags_MAX)
+		{
+			ClearFlag(Resolved);
+		}
+	}
+
+	FORCEINLINE void SetFlagValueByName(const FName FlagName, const bool bValue)
+	{
+		const EEntityFlags Resolved = UMassAPIFlagSettings::ResolveFlag(FlagName);
+		if (Resolved != EEntityFlags::EEntityFlags_MAX)
+		{
+			SetFlagValue(Resolved, bValue);
+		}
+	}
+
+	// --- Pre-resolved flag id operations | 预解析旗标 ID 操作 ---
+
+	FORCEINLINE bool HasFlagById(const FEntityFlagId& FlagId) const
+	{
+		const EEntityFlags Flag = FlagId.GetFlag();
+		return (Flag != EEntityFlags::EEntityFlags_MAX) && HasFlag(Flag);
+	}
+
+	FORCEINLINE void SetFlagById(const FEntityFlagId& FlagId)
+	{
+		SetFlag(FlagId.GetFlag());
+	}
+
+	FORCEINLINE void ClearFlagById(const FEntityFlagId& FlagId)
+	{
+		ClearFlag(FlagId.GetFlag());
+	}
+
+private:
+	FORCEINLINE static int64 LoadWord(const int64& Word)
+	{
+		return FPlatformAtomics::AtomicRead_Relaxed(&Word);
+	}
+
+	FORCEINLINE int64& GetWord(const EEntityFlags Flag)
+	{
+		return IsHighFlag(Flag) ? FlagsHigh : Flags;
+	}
+};
+
+static_assert(sizeof(FEntityFlagFragment) == 16, "FEntityFlagFragment must stay two int64 words.");
+static_assert(std::is_trivially_copyable_v<FEntityFlagFragment>, "FEntityFlagFragment must stay trivially copyable.");
+
+/**
+ * Flags 128-255, used when MASSAPI_FLAG_BITS is 256. Bits 0-127 stay in FEntityFlagFragment.
+ * | 旗标 128-255 的扩展片段（宽度 256 时使用）
+ */
+USTRUCT()
+struct MASSAPI_API FEntityFlagExt256Fragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	static constexpr int32 NumBits = 256;
+	static constexpr int32 NumWords = (NumBits - 128) / 64;
+
+	UPROPERTY(EditAnywhere, Category = "MassAPI|Flags")
+	int64 Words[NumWords] = {};
+};
+
+/**
+ * Flags 128-511, used when MASSAPI_FLAG_BITS is 512. Bits 0-127 stay in FEntityFlagFragment.
+ * | 旗标 128-511 的扩展片段（宽度 512 时使用）
+ */
+USTRUCT()
+struct MASSAPI_API FEntityFlagExt512Fragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	static constexpr int32 NumBits = 512;
+	static constexpr int32 NumWords = (NumBits - 128) / 64;
+
+	UPROPERTY(EditAnywhere, Category = "MassAPI|Flags")
+	int64 Words[NumWords] = {};
+};
+
+/** Extension fragment type per flag width | 各宽度对应的扩展片段 */
+template<int32 NumBits> struct TEntityFlagExtFragment;
+template<> struct TEntityFlagExtFragment<128> { using Type = void; };
+template<> struct TEntityFlagExtFragment<256> { using Type = FEntityFlagExt256Fragment; };
+template<> struct TEntityFlagExtFragment<512> { using Type = FEntityFlagExt512Fragment; };
+
+namespace MassAPIFlags
+{
+	/** Word holding Bit (>= 128) inside an extension fragment's Words | 扩展片段中存放 Bit 的字 */
+	template<typename TExtFragment>
+	FORCEINLINE int64* FindExtWord(TExtFragment& Ext, const int32 Bit)
+	{
+		const int32 WordIndex = (Bit - 128) >> 6;
+		return (Bit >= 128 && WordIndex < TExtFragment::NumWords) ? &Ext.Words[WordIndex] : nullptr;
+	}
+
+	/** Assembles the full-width block from the 128-bit fragment and its extension (either may be null) | 由基础片段与扩展片段组装完整旗标块 */
+	template<int32 NumBits>
+	FORCEINLINE TEntityFlagBlock<NumBits> MakeBlock(const FEntityFlagFragment* Base, const typename TEntityFlagExtFragment<NumBits>::Type* Ext)
+	{
+		TEntityFlagBlock<NumBits> Block;
+		if (Base)
+		{
+			Block.Words[0] = static_cast<uint64>(Base->Flags);
+			Block.Words[1] = static_cast<uint64>(Base->FlagsHigh);
+		}
+		if constexpr (NumBits > 128)
+		{
+			if (Ext)
+			{
+				FMemory::Memcpy(&Block.Words[2], Ext->Words, sizeof(Ext->Words));
+			}
+		}
+		return Block;
+	}
+
+	/** MakeBlock for the Index-th entity of a chunk's flag columns | 按 Chunk 列中第 Index 个实体组装旗标块 */
+	template<int32 NumBits>
+	FORCEINLINE TEntityFlagBlock<NumBits> MakeBlockAt(const FEntityFlagFragment* BaseColumn, const typename TEntityFlagExtFragment<NumBits>::Type* ExtColumn, const int32 Index)
+	{
+		if constexpr (NumBits > 128)
+		{
+			return MakeBlock<NumBits>(BaseColumn + Index, ExtColumn ? ExtColumn + Index : nullptr);
+		}
+		else
+		{
+			return MakeBlock<NumBits>(BaseColumn + Index, nullptr);
+		}
+	}
+}
+
+/**
+ * Optional per-chunk summary of every FEntityFlagFragment in the chunk.
+ * OrMask is an upper bound (a bit set on any entity), AndMask a lower bound (a bit set on all entities).
+ * Rebuilt lazily by the query engine whenever the chunk's serial or its archetype's write epoch changes;
+ * between rebuilds the subsystem widens the bounds with the bits written through MassAPI setters.
+ * | 可选的 Chunk 级旗标摘要：OR 为上界，AND 为下界；Chunk 序列号或写入纪元变化时由查询惰性重建
+ */
+USTRUCT()
+struct MASSAPI_API FEntityFlagChunkFragment : public FMassChunkFragment
+{
+	GENERATED_BODY()
+
+	int64 OrLow = 0;
+	int64 OrHigh = 0;
+	int64 AndLow = 0;
+	int64 AndHigh = 0;
+
+	/** Chunk serial modification number the summary was built for | 构建摘要时的 Chunk 序列号 */
+	int32 ChunkSerial = INDEX_NONE;
+
+	/** Archetype write epoch the summary was built in | 构建摘要时的原型写入纪元 */
+	uint32 WriteEpoch = 0;
+
+	/** UMassAPISubsystem summary generation, advanced by InvalidateFlagChunkSummaries | 摘要代数，失效时递增 */
+	uint32 Generation = 0;
+
+	FORCEINLINE bool IsBuiltFor(const int32 InChunkSerial, const uint32 InWriteEpoch, const uint32 InGeneration) const
+	{
+		return ChunkSerial == InChunkSerial && WriteEpoch == InWriteEpoch && Generation == InGeneration;
+	}
+};
+
+/**
+ * Bits written through MassAPI setters on one archetype during the current write epoch.
+ * Widens the chunk summaries of that archetype until the epoch is advanced in Tick, and tells live queries
+ * which archetypes to rescan. | 当前纪元内通过 MassAPI 写入某原型的旗标位，用于放宽 Chunk 摘要并决定实时查询重扫的原型
+ */
+struct FEntityFlagArchetypeWrites
+{
+	int64 SetLow = 0;
+	int64 SetHigh = 0;
+	int64 ClearLow = 0;
+	int64 ClearHigh = 0;
+	uint32 Epoch = 1;
+
+	// Extended bits (128+) written while change tracking is on; only live change filters read this | 扩展位写入，仅实时变更过滤器使用
+	bool bExtWrites = false;
+
+	FORCEINLINE bool HasWrites() const { return ((SetLow | SetHigh | ClearLow | ClearHigh) != 0); }
+};
+
+/**
+ * Optional per-entity record of flag changes made through MassAPI (setters, batch masks, deferred commands).
+ * ChangeEpoch is the newest UMassAPISubsystem::GetFlagChangeEpoch() that changed a flag; ChangedLow / ChangedHigh
+ * accumulate every bit that ever changed and are never reset, so a filter on one flag cannot miss it because another
+ * flag changed later. The price is that such a filter may also report an entity whose flag changed before the
+ * requested epoch while another flag changed since. Read by FEntityQuery::FlagsChangedSince.
+ * | 可选的逐实体旗标变更记录：ChangeEpoch 为最近一次变更的纪元，ChangedLow / ChangedHigh 累积所有变化过的位且不重置，
+ * 按旗标过滤不会因其他旗标之后变化而漏报，但可能多报；供 FlagsChangedSince 查询
+ */
+USTRUCT()
+struct MASSAPI_API FEntityFlagChangeFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	int64 ChangedLow = 0;
+	int64 ChangedHigh = 0;
+
+	/** 0 = never changed, epochs start at 1 | 0 表示从未变更 */
+	uint32 ChangeEpoch = 0;
+
+	/**
+	 * Raises ChangeEpoch to Epoch. Also stamps changes of extended flags (bits 128+), which have no bit in the record
+	 * and therefore match "any flag" change filters only. Only ever moves forward, so concurrent writers of different
+	 * epochs settle on the newest. | 将纪元提升到 Epoch（只增不减，并发写入取最新）；扩展旗标仅以此记录，只匹配"任意旗标"过滤
+	 */
+	FORCEINLINE void RecordEpoch(const uint32 Epoch)
+	{
+		volatile int32* EpochWord = reinterpret_cast<volatile int32*>(&ChangeEpoch);
+		int32 Seen = FPlatformAtomics::AtomicRead(EpochWord);
+		while (static_cast<uint32>(Seen) < Epoch)
+		{
+			const int32 Previous = FPlatformAtomics::InterlockedCompareExchange(EpochWord, static_cast<int32>(Epoch), Seen);
+			if (Previous == Seen) break;
+			Seen = Previous;
+		}
+	}
+
+	/** Folds changed bits into the record, then raises the epoch; safe against concurrent writers | 原子累积变化位后提升纪元，可并发调用 */
+	FORCEINLINE void Record(const uint32 Epoch, const int64 Low, const int64 High)
+	{
+		if ((Low | High) == 0) return;
+		FPlatformAtomics::InterlockedOr(&ChangedLow, Low);
+		FPlatformAtomics::InterlockedOr(&ChangedHigh, High);
+		RecordEpoch(Epoch);
+	}
+
+	/** Changed in SinceEpoch or later, touching MaskLow / MaskHigh (both zero = any flag) | 自 SinceEpoch 起变更且涉及掩码 */
+	FORCEINLINE bool ChangedSince(const uint32 SinceEpoch, const int64 MaskLow, const int64 MaskHigh) const
+	{
+		const bool bAnyMask = (MaskLow | MaskHigh) == 0;
+		return ChangeEpoch != 0 && ChangeEpoch >= SinceEpoch && (bAnyMask || ((ChangedLow & MaskLow) | (ChangedHigh & MaskHigh)) != 0);
+	}
+};
+
+/**
+ * Mirror tags for tag-backed flags (UMassAPIFlagSettings::TagBackedFlags, assigned in list order).
+ * A tag follows its flag at the next command flush after a MassAPI write; direct fragment writes do not move it.
+ * FEntityQuery always tests the flag bits themselves and never requires these tags.
+ * | 标签镜像旗标使用的镜像标签（按设置列表顺序分配）；经 MassAPI 写入后在下一次命令刷新时同步，直接片段写入不会迁移标签；FEntityQuery 始终检测旗标位，不依赖这些标签
+ */
+static constexpr int32 NumFlagMirrorTags = 16;
+
+USTRUCT()
+struct MASSAPI_API FEntityFlagMirrorTag0 : public FMassTag
+{
+	GENERATED_BODY()
+};
+
+USTRUCT()
+struct MASSAPI_API FEntityFlagMirrorTag1 : public FMassTag
+{
+	GENERATED_BODY()
+};
+
+USTRUCT()
+struct MASSAPI_API FEntityFlagMirrorTag2 : public FMassTag
+{
+	GENERATED_BODY()
+};
+
+USTRUCT()
+struct MASSAPI_API FEntityFlagMirrorTag3 : public FMassTag
+{
+	GENERATED_BODY()
+};
+
+USTRUCT()
+struct MASSAPI_API FEntityFlagMirrorTag4 : public FMassTag
+{
+	GENERATED_BODY()
+};
+
+USTRUCT()
+struct MASSAPI_API FEntityFlagMirrorTag5 : public FMassTag
+{
+	GENERATED_BODY()
+};
+
+USTRUCT()
+struct MASSAPI_API FEntityFlagMirrorTag6 : public FMassTag
+{
+	GENERATED_BODY()
+};
+
+USTRUCT()
+struct MASSAPI_API FEntityFlagMirrorTag7 : public FMassTag
+{
+	GENERATED_BODY()
+};
+
+USTRUCT()
+struct MASSAPI_API FEntityFlagMirrorTag8 : public FMassTag
+{
+	GENERATED_BODY()
+};
+
+USTRUCT()
+struct MASSAPI_API FEntityFlagMirrorTag9 : public FMassTag
+{
+	GENERATED_BODY()
+};
+
+USTRUCT()
+struct MASSAPI_API FEntityFlagMirrorTag10 : public FMassTag
+{
+	GENERATED_BODY()
+};
+
+USTRUCT()
+struct MASSAPI_API FEntityFlagMirrorTag11 : public FMassTag
+{
+	GENERATED_BODY()
+};
+
+USTRUCT()
+struct MASSAPI_API FEntityFlagMirrorTag12 : public FMassTag
+{
+	GENERATED_BODY()
+};
+
+USTRUCT()
+struct MASSAPI_API FEntityFlagMirrorTag13 : public FMassTag
+{
+	GENERATED_BODY()
+};
+
+USTRUCT()
+struct MASSAPI_API FEntityFlagMirrorTag14 : public FMassTag
+{
+	GENERATED_BODY()
+};
+
+USTRUCT()
+struct MASSAPI_API FEntityFlagMirrorTag15 : public FMassTag
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Migration cost counters of one flag, see UMassAPISubsystem::GetFlagMigrationStats.
+ * | 单个旗标的迁移开销统计
+ */
+USTRUCT(BlueprintType)
+struct MASSAPI_API FEntityFlagMigrationStats
+{
+	GENERATED_BODY()
+
+	/** Times the flag flipped on an entity through MassAPI | 通过 MassAPI 翻转的次数 */
+	UPROPERTY(BlueprintReadOnly, Category = "MassAPI|Flags")
+	int64 Transitions = 0;
+
+	/** Entities moved to another archetype to update the flag's mirror tag | 为同步镜像标签而迁移的实体数 */
+	UPROPERTY(BlueprintReadOnly, Category = "MassAPI|Flags")
+	int64 Migrations = 0;
+
+	/** Batched tag changes (one per target archetype) that carried the flag | 含该旗标的批量标签变更次数 */
+	UPROPERTY(BlueprintReadOnly, Category = "MassAPI|Flags")
+	int64 Batches = 0;
+};
+
+/**
+ * All/Any/None flag masks of a query, split into low (0-63) and high (64-127) words.
+ * Evaluation is branch-free so it can be streamed over a chunk's FEntityFlagFragment column.
+ * | 查询的 All/Any/None 旗标掩码（低位/高位），无分支求值，可按 Chunk 列流式处理
+ */
+struct FEntityFlagQueryMask
+{
+	int64 AllLow = 0;
+	int64 AllHigh = 0;
+	int64 AnyLow = 0;
+	int64 AnyHigh = 0;
+	int64 NoneLow = 0;
+	int64 NoneHigh = 0;
+
+	/** True if the query has no flag constraint at all | 没有任何旗标约束 */
+	FORCEINLINE bool IsEmpty() const
+	{
+		return ((AllLow | AllHigh | AnyLow | AnyHigh | NoneLow | NoneHigh) == 0);
+	}
+
+	/** True if an entity without FEntityFlagFragment (flags == 0) can never pass | 没有旗标片段的实体必然不通过 */
+	FORCEINLINE bool RequiresFlagFragment() const
+	{
+		return ((AllLow | AllHigh | AnyLow | AnyHigh) != 0);
+	}
+
+	/** Branch-free All/Any/None test of one entity's flag words | 对单个实体旗标的无分支测试 */
+	FORCEINLINE bool Matches(const int64 FlagsLow, const int64 FlagsHigh) const
+	{
+		const bool bAll = (((FlagsLow & AllLow) ^ AllLow) | ((FlagsHigh & AllHigh) ^ AllHigh)) == 0;
+		const bool bAny = ((AnyLow | AnyHigh) == 0) | (((FlagsLow & AnyLow) | (FlagsHigh & AnyHigh)) != 0);
+		const bool bNone = ((FlagsLow & NoneLow) | (FlagsHigh & NoneHigh)) == 0;
+		return bAll & bAny & bNone;
+	}
+
+	FORCEINLINE bool Matches(const FEntityFlagFragment& Fragment) const
+	{
+		return Matches(Fragment.Flags, Fragment.FlagsHigh);
+	}
+
+	/** False if no entity bounded by the summary can pass (chunk can be skipped) | 摘要范围内不可能有实体通过 */
+	FORCEINLINE bool CanAnyPass(const int64 OrLow, const int64 OrHigh, const int64 AndLow, const int64 AndHigh) const
+	{
+		const bool bAll = (((OrLow & AllLow) ^ AllLow) | ((OrHigh & AllHigh) ^ AllHigh)) == 0;
+		const bool bAny = ((AnyLow | AnyHigh) == 0) | (((OrLow & AnyLow) | (OrHigh & AnyHigh)) != 0);
+		const bool bNone = ((AndLow & NoneLow) | (AndHigh & NoneHigh)) == 0;
+		return bAll & bAny & bNone;
+	}
+
+	/** True if every entity bounded by the summary passes (chunk accepted whole) | 摘要范围内所有实体必然通过 */
+	FORCEINLINE bool MustAllPass(const int64 OrLow, const int64 OrHigh, const int64 AndLow, const int64 AndHigh) const
+	{
+		const bool bAll = (((AndLow & AllLow) ^ AllLow) | ((AndHigh & AllHigh) ^ AllHigh)) == 0;
+		const bool bAny = ((AnyLow | AnyHigh) == 0) | (((AndLow & AnyLow) | (AndHigh & AnyHigh)) != 0);
+		const bool bNone = ((OrLow & NoneLow) | (OrHigh & NoneHigh)) == 0;
+		return bAll & bAny & bNone;
+	}
+
+	/** The same constraint as a mask of any width (bits 128+ unconstrained) | 转换为任意宽度的掩码 */
+	template<int32 NumBits = 128>
+	TEntityFlagQueryMask<NumBits> ToBlockMask() const
+	{
+		TEntityFlagQueryMask<NumBits> Mask;
+		Mask.All = TEntityFlagBlock<NumBits>::FromLowHigh(AllLow, AllHigh);
+		Mask.Any = TEntityFlagBlock<NumBits>::FromLowHigh(AnyLow, AnyHigh);
+		Mask.None = TEntityFlagBlock<NumBits>::FromLowHigh(NoneLow, NoneHigh);
+		return Mask;
+	}
+};
+
+/**
+ * A numeric fragment member resolved to a byte offset and stored type, read straight from chunk memory.
+ * Shared by WHERE clauses and ORDER BY / Top-K. | 解析为偏移与存储类型的片段数值成员，供谓词与排序共用
+ */
+struct MASSAPI_API FCompiledFragmentMember
+{
+	const UScriptStruct* FragmentType = nullptr;
+	int32 Offset = 0;
+	int32 Stride = 0;
+	EEntityPredicateValueType ValueType = EEntityPredicateValueType::Invalid;
+
+	FORCEINLINE bool IsValid() const { return FragmentType != nullptr && ValueType != EEntityPredicateValueType::Invalid; }
+
+	/** Reads the member of one fragment instance as double | 以 double 读取单个片段的成员 */
+	FORCEINLINE double Read(const uint8* FragmentMemory) const
+	{
+		return ReadStored(FragmentMemory + Offset);
+	}
+
+	/** Reads the member of the Index-th fragment of a chunk column | 读取列中第 Index 个片段的成员 */
+	FORCEINLINE double ReadAt(const uint8* Column, const int32 Index) const
+	{
+		return ReadStored(Column + static_cast<SIZE_T>(Index) * Stride + Offset);
+	}
+
+	FORCEINLINE double ReadStored(const uint8* Member) const
+	{
+		switch (ValueType)
+		{
+		case EEntityPredicateValueType::Bool:	return *reinterpret_cast<const bool*>(Member) ? 1.0 : 0.0;
+		case EEntityPredicateValueType::Int8:	return static_cast<double>(*reinterpret_cast<const int8*>(Member));
+		case EEntityPredicateValueType::UInt8:	return static_cast<double>(*reinterpret_cast<const uint8*>(Member));
+		case EEntityPredicateValueType::Int16:	return static_cast<double>(*reinterpret_cast<const int16*>(Member));
+		case EEntityPredicateValueType::UInt16:	return static_cast<double>(*reinterpret_cast<const uint16*>(Member));
+		case EEntityPredicateValueType::Int32:	return static_cast<double>(*reinterpret_cast<const int32*>(Member));
+		case EEntityPredicateValueType::UInt32:	return static_cast<double>(*reinterpret_cast<const uint32*>(Member));
+		case EEntityPredicateValueType::Int64:	return static_cast<double>(*reinterpret_cast<const int64*>(Member));
+		case EEntityPredicateValueType::UInt64:	return static_cast<double>(*reinterpret_cast<const uint64*>(Member));
+		case EEntityPredicateValueType::Float:	return static_cast<double>(*reinterpret_cast<const float*>(Member));
+		case EEntityPredicateValueType::Double:	return *reinterpret_cast<const double*>(Member);
+		default:								return 0.0;
+		}
+	}
+
+	/**
+	 * Resolves the first member path of Reference (e.g. "Transform.Location.Z") on an FMassFragment type.
+	 * Supports bool, integers, float, double and enums; logs and returns false otherwise.
+	 * | 解析成员路径，支持 bool / 整数 / 浮点 / 枚举，失败时输出警告
+	 */
+	static bool Resolve(const FStructRecursiveMemberReference& Reference, FCompiledFragmentMember& OutMember);
+};
+
+/**
+ * Fragment member predicate resolved by FEntityQuery::Compile(): the member to read, the operator and the constant.
+ * Evaluated column-wise over chunk memory by the query engine. | 编译后的成员谓词，按列求值
+ */
+struct FCompiledFragmentPredicate
+{
+	FCompiledFragmentMember Member;
+	EEntityPredicateOp Op = EEntityPredicateOp::Equal;
+	double Value = 0.0;
+
+	// Flag change filter (FEntityQuery::FlagsChangedSince), reads FEntityFlagChangeFragment instead of Member/Op/Value
+	// | 旗标变更过滤器，读取 FEntityFlagChangeFragment 而非 Member/Op/Value
+	bool bFlagChangeFilter = false;
+	uint32 ChangedSinceEpoch = 0;
+	int64 ChangedMaskLow = 0;
+	int64 ChangedMaskHigh = 0;
+
+	/** Predicate matching entities whose flags changed in SinceEpoch or later, optionally only the masked bits | 旗标变更谓词 */
+	static FCompiledFragmentPredicate MakeFlagChangeFilter(const uint32 SinceEpoch, const int64 MaskLow, const int64 MaskHigh)
+	{
+		FCompiledFragmentPredicate Predicate;
+		Predicate.Member.FragmentType = FEntityFlagChangeFragment::StaticStruct();
+		Predicate.Member.Offset = STRUCT_OFFSET(FEntityFlagChangeFragment, ChangeEpoch);
+		Predicate.Member.Stride = sizeof(FEntityFlagChangeFragment);
+		Predicate.Member.ValueType = EEntityPredicateValueType::UInt32;
+		Predicate.bFlagChangeFilter = true;
+		Predicate.ChangedSinceEpoch = SinceEpoch;
+		Predicate.ChangedMaskLow = MaskLow;
+		Predicate.ChangedMaskHigh = MaskHigh;
+		return Predicate;
+	}
 
-		const uint8 LocalIndex = GetLocalBitIndex(Flag);
-		const int64 Mask = (1LL << LocalIndex);
-		if (IsHighFlag(Flag))
-		{
-			FlagsHigh |= Mask;
-		}
-		else
+	/** Tests one fragment instance | 测试单个片段 */
+	FORCEINLINE bool Matches(const uint8* FragmentMemory) const
+	{
+		if (bFlagChangeFilter)
 		{
-			Flags |= Mask;
+			return reinterpret_cast<const FEntityFlagChangeFragment*>(FragmentMemory)->ChangedSince(ChangedSinceEpoch, ChangedMaskLow, ChangedMaskHigh);
 		}
-
-		Unlock(); // Exit Critical Section
+		return Compare(Member.Read(FragmentMemory));
 	}
 
 	/**
-	 * (New) Clears a specific flag on this Fragment.
-	 * Thread-safe: Uses Lock/Unlock, but checks first to avoid unnecessary locking.
+	 * ANDs the predicate into PassWords (one bit per entity) for a column of NumEntities fragments.
+	 * Words already zero are skipped. | 将谓词结果按位与进通过位字，已为 0 的字跳过
 	 */
-	FORCEINLINE void ClearFlag(const EEntityFlags Flag)
+	void EvaluateColumn(const uint8* Column, const int32 NumEntities, TArrayView<uint64> PassWords) const
 	{
-		if (Flag >= EEntityFlags::EEntityFlags_MAX) return;
-
-		// OPTIMIZATION: If the flag is already clear, do not wait for a lock.
-		if (!HasFlag(Flag))
+		if (bFlagChangeFilter)
 		{
+			EvaluateFlagChangeColumn(reinterpret_cast<const FEntityFlagChangeFragment*>(Column), NumEntities, PassWords);
 			return;
 		}
 
-		Lock(); // Enter Critical Section
-
-		const uint8 LocalIndex = GetLocalBitIndex(Flag);
-		const int64 Mask = (1LL << LocalIndex);
-		if (IsHighFlag(Flag))
+		switch (Member.ValueType)
 		{
-			FlagsHigh &= ~Mask;
+		case EEntityPredicateValueType::Bool:	EvaluateColumnAs<bool>(Column, NumEntities, PassWords); break;
+		case EEntityPredicateValueType::Int8:	EvaluateColumnAs<int8>(Column, NumEntities, PassWords); break;
+		case EEntityPredicateValueType::UInt8:	EvaluateColumnAs<uint8>(Column, NumEntities, PassWords); break;
+		case EEntityPredicateValueType::Int16:	EvaluateColumnAs<int16>(Column, NumEntities, PassWords); break;
+		case EEntityPredicateValueType::UInt16:	EvaluateColumnAs<uint16>(Column, NumEntities, PassWords); break;
+		case EEntityPredicateValueType::Int32:	EvaluateColumnAs<int32>(Column, NumEntities, PassWords); break;
+		case EEntityPredicateValueType::UInt32:	EvaluateColumnAs<uint32>(Column, NumEntities, PassWords); break;
+		case EEntityPredicateValueType::Int64:	EvaluateColumnAs<int64>(Column, NumEntities, PassWords); break;
+		case EEntityPredicateValueType::UInt64:	EvaluateColumnAs<uint64>(Column, NumEntities, PassWords); break;
+		case EEntityPredicateValueType::Float:	EvaluateColumnAs<float>(Column, NumEntities, PassWords); break;
+		case EEntityPredicateValueType::Double:	EvaluateColumnAs<double>(Column, NumEntities, PassWords); break;
+		default:
+			for (uint64& Word : PassWords) { Word = 0; }
+			break;
 		}
-		else
+	}
+
+private:
+	void EvaluateFlagChangeColumn(const FEntityFlagChangeFragment* Changes, const int32 NumEntities, TArrayView<uint64> PassWords) const
+	{
+		for (int32 WordIt = 0; WordIt < PassWords.Num(); ++WordIt)
 		{
-			Flags &= ~Mask;
-		}
+			if (PassWords[WordIt] == 0) continue;
 
-		Unlock(); // Exit Critical Section
+			const int32 Base = WordIt * 64;
+			const int32 NumLanes = FMath::Min(64, NumEntities - Base);
+			uint64 Keep = 0;
+			for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+			{
+				Keep |= static_cast<uint64>(Changes[Base + Lane].ChangedSince(ChangedSinceEpoch, ChangedMaskLow, ChangedMaskHigh)) << Lane;
+			}
+			PassWords[WordIt] &= Keep;
+		}
 	}
 
-	/**
-	 * (New) Sets or Clears a specific flag based on a boolean value.
-	 * Thread-safe: Uses Lock/Unlock, but checks first to avoid unnecessary locking.
-	 */
-	FORCEINLINE void SetFlagValue(const EEntityFlags Flag, const bool bValue)
+	FORCEINLINE bool Compare(const double MemberValue) const
 	{
-		if (Flag >= EEntityFlags::EEntityFlags_MAX) return;
-
-		// OPTIMIZATION: If the current state already matches bValue, do nothing.
-		if (HasFlag(Flag) == bValue)
+		switch (Op)
 		{
-			return;
+		case EEntityPredicateOp::Equal:			return MemberValue == Value;
+		case EEntityPredicateOp::NotEqual:		return MemberValue != Value;
+		case EEntityPredicateOp::Less:			return MemberValue < Value;
+		case EEntityPredicateOp::LessEqual:		return MemberValue <= Value;
+		case EEntityPredicateOp::Greater:		return MemberValue > Value;
+		case EEntityPredicateOp::GreaterEqual:	return MemberValue >= Value;
+		default:								return false;
 		}
+	}
 
-		Lock(); // Enter Critical Section
-
-		const uint8 LocalIndex = GetLocalBitIndex(Flag);
-		const int64 Mask = (1LL << LocalIndex);
-		if (bValue)
+	// Operator hoisted out of the lane loop | 运算符提到循环外
+	template<typename TStored>
+	void EvaluateColumnAs(const uint8* Column, const int32 NumEntities, TArrayView<uint64> PassWords) const
+	{
+		switch (Op)
 		{
-			if (IsHighFlag(Flag))
-			{
-				FlagsHigh |= Mask;
-			}
-			else
-			{
-				Flags |= Mask;
-			}
+		case EEntityPredicateOp::Equal:			EvaluateLanes<TStored>(Column, NumEntities, PassWords, [C = Value](const double V) { return V == C; }); break;
+		case EEntityPredicateOp::NotEqual:		EvaluateLanes<TStored>(Column, NumEntities, PassWords, [C = Value](const double V) { return V != C; }); break;
+		case EEntityPredicateOp::Less:			EvaluateLanes<TStored>(Column, NumEntities, PassWords, [C = Value](const double V) { return V < C; }); break;
+		case EEntityPredicateOp::LessEqual:		EvaluateLanes<TStored>(Column, NumEntities, PassWords, [C = Value](const double V) { return V <= C; }); break;
+		case EEntityPredicateOp::Greater:		EvaluateLanes<TStored>(Column, NumEntities, PassWords, [C = Value](const double V) { return V > C; }); break;
+		case EEntityPredicateOp::GreaterEqual:	EvaluateLanes<TStored>(Column, NumEntities, PassWords, [C = Value](const double V) { return V >= C; }); break;
 		}
-		else
+	}
+
+	template<typename TStored, typename TCompare>
+	FORCEINLINE void EvaluateLanes(const uint8* Column, const int32 NumEntities, TArrayView<uint64> PassWords, TCompare&& CompareFunc) const
+	{
+		const uint8* MemberBase = Column + Member.Offset;
+		const SIZE_T Stride = Member.Stride;
+		for (int32 WordIt = 0; WordIt < PassWords.Num(); ++WordIt)
 		{
-			if (IsHighFlag(Flag))
-			{
-				FlagsHigh &= ~Mask;
-			}
-			else
+			if (PassWords[WordIt] == 0) continue;
+
+			const int32 Base = WordIt * 64;
+			const int32 NumLanes = FMath::Min(64, NumEntities - Base);
+			uint64 Keep = 0;
+			for (int32 Lane = 0; Lane < NumLanes; ++Lane)
 			{
-				Flags &= ~Mask;
+				const TStored Stored = *reinterpret_cast<const TStored*>(MemberBase + static_cast<SIZE_T>(Base + Lane) * Stride);
+				Keep |= static_cast<uint64>(CompareFunc(static_cast<double>(Stored))) << Lane;
 			}
+			PassWords[WordIt] &= Keep;
 		}
+	}
+};
+
+/**
+ * WHERE clause of FEntityQuery: compares one member of a fragment against a constant.
+ * The member path (e.g. "Health" or "Transform.Location.Z") is resolved to a byte offset once, when the query compiles.
+ * Supported members: bool, integers, float, double and enums. Entities without the fragment never match.
+ * | 片段成员谓词：成员路径在编译时解析为偏移，支持 bool / 整数 / 浮点 / 枚举
+ */
+USTRUCT(BlueprintType)
+struct MASSAPI_API FEntityFragmentPredicate
+{
+	GENERATED_BODY()
 
-		Unlock(); // Exit Critical Section
+public:
+	FEntityFragmentPredicate() = default;
+
+	FEntityFragmentPredicate(UScriptStruct* InFragmentType, const FString& InMemberPath, const EEntityPredicateOp InOp, const double InValue)
+		: Member(InFragmentType, { InMemberPath })
+		, Op(InOp)
+		, Value(InValue)
+	{
 	}
 
-	// --- FName-based flag operations | 基于FName的旗标操作 ---
+	/** Fragment type and member path (the first path is used) | 片段类型与成员路径（使用第一条路径） */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "MassAPI|Query")
+	FStructRecursiveMemberReference Member;
 
-	FORCEINLINE bool HasFlagByName(const FName FlagName) const
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "MassAPI|Query")
+	EEntityPredicateOp Op = EEntityPredicateOp::Equal;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "MassAPI|Query")
+	double Value = 0.0;
+
+	/** Fragment the predicate reads, nullptr if unset or not an FMassFragment | 谓词读取的片段类型 */
+	const UScriptStruct* GetFragmentType() const
 	{
-		const EEntityFlags Resolved = UMassAPIFlagSettings::ResolveFlag(FlagName);
-		return (Resolved != EEntityFlags::EEntityFlags_MAX) && HasFlag(Resolved);
+		const UScriptStruct* FragmentType = Member.StructType.Get();
+		return (FragmentType && FragmentType->IsChildOf(FMassFragment::StaticStruct())) ? FragmentType : nullptr;
 	}
 
-	FORCEINLINE void SetFlagByName(const FName FlagName)
+	/** Resolves the member path to an offset and stored type; logs and returns false if unsupported | 解析成员路径 */
+	bool Compile(FCompiledFragmentPredicate& OutPredicate) const;
+};
+
+/**
+ * Immutable, prebuilt form of FEntityQuery produced by FEntityQuery::Compile().
+ * Holds the All/Any/None composition bitsets, the 128-bit flag masks and the native query key, with no lazy
+ * state, so one instance can be read concurrently from any thread (e.g. shared by ParallelForEachEntityChunk workers).
+ * Recompile after editing the source query or the flag registry.
+ * | FEntityQuery 的不可变编译形式：预建位集与旗标掩码，无延迟缓存，可被任意线程并发读取
+ */
+USTRUCT(BlueprintType)
+struct MASSAPI_API FCompiledEntityQuery
+{
+	GENERATED_BODY()
+
+	friend struct FEntityQuery;
+
+public:
+	FCompiledEntityQuery() = default;
+
+	/** False for a default-constructed instance | 默认构造时为 false */
+	FORCEINLINE bool IsCompiled() const { return bIsCompiled; }
+
+	FORCEINLINE const FMassArchetypeCompositionDescriptor& GetAllComposition() const { return AllComposition; }
+	FORCEINLINE const FMassArchetypeCompositionDescriptor& GetAnyComposition() const { return AnyComposition; }
+	FORCEINLINE const FMassArchetypeCompositionDescriptor& GetNoneComposition() const { return NoneComposition; }
+
+	FORCEINLINE bool HasAllTerms() const { return bHasAll; }
+	FORCEINLINE bool HasAnyTerms() const { return bHasAny; }
+	FORCEINLINE bool HasNoneTerms() const { return bHasNone; }
+
+	FORCEINLINE const FEntityFlagQueryMask& GetFlagQueryMask() const { return FlagMask; }
+
+	/** Same contract as FEntityQuery::GetFlagFragmentPresence | 与 FEntityQuery 版本一致 */
+	FORCEINLINE bool GetFlagFragmentPresence(EMassFragmentPresence& OutPresence) const
 	{
-		const EEntityFlags Resolved = UMassAPIFlagSettings::ResolveFlag(FlagName);
-		if (Resolved != EEntityFlags::EEntityFlags_MAX)
-		{
-			SetFlag(Resolved);
-		}
+		OutPresence = FlagPresence;
+		return bReadsFlags;
 	}
 
-	FORCEINLINE void ClearFlagByName(const FName FlagName)
+	FORCEINLINE uint32 GetNativeQueryKey() const { return NativeQueryKey; }
+
+	/** Resolved WHERE clauses; their fragments are part of the All requirements | 已解析的成员谓词 */
+	FORCEINLINE TConstArrayView<FCompiledFragmentPredicate> GetPredicates() const { return Predicates; }
+
+	// Sorted unique requirement structs | 排序去重后的需求结构
+	FORCEINLINE TConstArrayView<const UScriptStruct*> GetAllStructs() const { return AllStructs; }
+	FORCEINLINE TConstArrayView<const UScriptStruct*> GetAnyStructs() const { return AnyStructs; }
+	FORCEINLINE TConstArrayView<const UScriptStruct*> GetNoneStructs() const { return NoneStructs; }
+
+	/** Populates a native query, identical to FEntityQuery::ConfigureQuery | 填充原生查询的需求 */
+	void ConfigureQuery(FMassEntityQuery& OutQuery) const
 	{
-		const EEntityFlags Resolved = UMassAPIFlagSettings::ResolveFlag(FlagName);
-		if (Resolved != EEntityFlags::EEntityFlags_MAX)
-		{
-			ClearFlag(Resolved);
-		}
+		ConfigureRequirements(OutQuery, AllStructs, AnyStructs, NoneStructs);
 	}
 
-	FORCEINLINE void SetFlagValueByName(const FName FlagName, const bool bValue)
+	/** Adds All (read-only) / Any (read-only) / None requirements for sorted unique struct lists | 按列表添加需求 */
+	static void ConfigureRequirements(FMassEntityQuery& OutQuery, const TConstArrayView<const UScriptStruct*> InAll, const TConstArrayView<const UScriptStruct*> InAny, const TConstArrayView<const UScriptStruct*> InNone)
 	{
-		const EEntityFlags Resolved = UMassAPIFlagSettings::ResolveFlag(FlagName);
-		if (Resolved != EEntityFlags::EEntityFlags_MAX)
-		{
-			SetFlagValue(Resolved, bValue);
-		}
+		for (const UScriptStruct* Struct : InAll) { AddStructRequirement(OutQuery, Struct, EMassFragmentPresence::All, EMassFragmentAccess::ReadOnly); }
+		for (const UScriptStruct* Struct : InAny) { AddStructRequirement(OutQuery, Struct, EMassFragmentPresence::Any, EMassFragmentAccess::ReadOnly); }
+		for (const UScriptStruct* Struct : InNone) { AddStructRequirement(OutQuery, Struct, EMassFragmentPresence::None, EMassFragmentAccess::None); }
 	}
-};
 
-#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 7
-template<>
-struct TMassFragmentTraits<FEntityFlagFragment>
-{
-	static constexpr bool AuthorAcceptsItsNotTriviallyCopyable = true;
+	/** Routes one struct to the matching requirement kind (tag, shared, chunk, fragment) | 按结构类型添加对应需求 */
+	static void AddStructRequirement(FMassEntityQuery& OutQuery, const UScriptStruct* Struct, const EMassFragmentPresence Presence, const EMassFragmentAccess Access)
+	{
+		if (!Struct) return;
+		if (Struct->IsChildOf(FMassTag::StaticStruct())) { OutQuery.AddTagRequirement(*Struct, Presence); }
+		else if (Struct->IsChildOf(FMassSharedFragment::StaticStruct())) { OutQuery.AddSharedRequirement(Struct, Access, Presence); }
+		else if (Struct->IsChildOf(FMassConstSharedFragment::StaticStruct())) { OutQuery.AddConstSharedRequirement(Struct, Presence); }
+		else if (Struct->IsChildOf(FMassChunkFragment::StaticStruct())) { OutQuery.AddChunkRequirement(Struct, Access, Presence); }
+		else if (Struct->IsChildOf(FMassFragment::StaticStruct())) { OutQuery.AddRequirement(Struct, Access, Presence); }
+	}
+
+private:
+	FMassArchetypeCompositionDescriptor AllComposition;
+	FMassArchetypeCompositionDescriptor AnyComposition;
+	FMassArchetypeCompositionDescriptor NoneComposition;
+
+	TArray<const UScriptStruct*> AllStructs;
+	TArray<const UScriptStruct*> AnyStructs;
+	TArray<const UScriptStruct*> NoneStructs;
+
+	TArray<FCompiledFragmentPredicate> Predicates;
+
+	FEntityFlagQueryMask FlagMask;
+	EMassFragmentPresence FlagPresence = EMassFragmentPresence::None;
+	uint32 NativeQueryKey = 0;
+
+	bool bHasAll = false;
+	bool bHasAny = false;
+	bool bHasNone = false;
+	bool bReadsFlags = false;
+	bool bIsCompiled = false;
 };
-#endif
 
 /**
  * FEntityQuery allows for individual entity fragment and tag composition matching
@@ -360,6 +1148,32 @@ public:
 		return MoveTemp(this->None<TArgs...>());
 	}
 
+	// WHERE clause on a fragment member, e.g. Where<FHealthFragment>(TEXT("Value"), EEntityPredicateOp::Less, 20.0)
+	template<typename T>
+	FORCEINLINE FEntityQuery& Where(const FString& MemberPath, const EEntityPredicateOp Op, const double Value)&
+	{
+		static_assert(TIsDerivedFrom<T, FMassFragment>::IsDerived, "Predicates can only read FMassFragment types.");
+		Predicates.Emplace(T::StaticStruct(), MemberPath, Op, Value);
+		return *this;
+	}
+	template<typename T>
+	FORCEINLINE FEntityQuery&& Where(const FString& MemberPath, const EEntityPredicateOp Op, const double Value)&&
+	{
+		return MoveTemp(this->Where<T>(MemberPath, Op, Value));
+	}
+
+	// Only entities whose flags changed in Epoch or later, optionally only the named flags, e.g. ChangedSince(LastSeenEpoch, { "Stunned" })
+	FORCEINLINE FEntityQuery& ChangedSince(const int64 Epoch, TArray<FName> Flags = {})&
+	{
+		FlagsChangedSince = Epoch;
+		ChangedFlagsList = MoveTemp(Flags);
+		return *this;
+	}
+	FORCEINLINE FEntityQuery&& ChangedSince(const int64 Epoch, TArray<FName> Flags = {})&&
+	{
+		return MoveTemp(this->ChangedSince(Epoch, MoveTemp(Flags)));
+	}
+
 	// ----------- UPROPERTIES -----------
 
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "MassAPI|Query")
@@ -380,6 +1194,26 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "MassAPI|Flags")
 	TArray<FName> NoneFlagsList;
 
+	/** WHERE clauses on fragment members, all must pass; each fragment is implicitly required | 成员谓词，全部需通过 */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "MassAPI|Query")
+	TArray<FEntityFragmentPredicate> Predicates;
+
+	/**
+	 * Only match entities whose flags changed in this flag change epoch or later (see UMassAPISubsystem::GetFlagChangeEpoch).
+	 * Requires FEntityFlagChangeFragment (UMassAPIFlagSettings::bEnableFlagChangeTracking). Negative disables the filter.
+	 * | 仅匹配在该变更纪元及之后旗标发生变化的实体；需要 FEntityFlagChangeFragment，负数表示关闭
+	 */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "MassAPI|Flags")
+	int64 FlagsChangedSince = -1;
+
+	/**
+	 * Restricts FlagsChangedSince to changes of these flags; empty = any flag. Never misses a listed flag that changed
+	 * since the epoch, but may include entities whose listed flag changed earlier (see FEntityFlagChangeFragment).
+	 * | 仅统计这些旗标的变化，空表示任意旗标；不会漏报，但可能多报
+	 */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "MassAPI|Flags")
+	TArray<FName> ChangedFlagsList;
+
 private:
 	// Composition Descriptors (RESTORED)
 	mutable FMassArchetypeCompositionDescriptor AllComposition;
@@ -402,6 +1236,9 @@ private:
 	mutable bool bIsNoneCompDirty = false;
 	mutable bool bIsFlagsCacheDirty = false;
 
+	// Registry version the flag bitmasks were resolved against | 旗标掩码解析时的注册表版本
+	mutable int32 FlagsCacheRegistryVersion = 0;
+
 public:
 	// ----------- Public Interface -----------
 
@@ -423,18 +1260,53 @@ public:
 	}
 
 	// Flag Accessors (Low flags 0-63)
-	int64 GetAllFlagsBitmask() const { if (bIsFlagsCacheDirty) BuildFlagsCache(); return AllFlagsBitmask_Cache; }
-	int64 GetAnyFlagsBitmask() const { if (bIsFlagsCacheDirty) BuildFlagsCache(); return AnyFlagsBitmask_Cache; }
-	int64 GetNoneFlagsBitmask() const { if (bIsFlagsCacheDirty) BuildFlagsCache(); return NoneFlagsBitmask_Cache; }
+	int64 GetAllFlagsBitmask() const { if (IsFlagsCacheStale()) BuildFlagsCache(); return AllFlagsBitmask_Cache; }
+	int64 GetAnyFlagsBitmask() const { if (IsFlagsCacheStale()) BuildFlagsCache(); return AnyFlagsBitmask_Cache; }
+	int64 GetNoneFlagsBitmask() const { if (IsFlagsCacheStale()) BuildFlagsCache(); return NoneFlagsBitmask_Cache; }
 
 	// Flag Accessors (High flags 64-127)
-	int64 GetAllFlagsBitmaskHigh() const { if (bIsFlagsCacheDirty) BuildFlagsCache(); return AllFlagsBitmaskHigh_Cache; }
-	int64 GetAnyFlagsBitmaskHigh() const { if (bIsFlagsCacheDirty) BuildFlagsCache(); return AnyFlagsBitmaskHigh_Cache; }
-	int64 GetNoneFlagsBitmaskHigh() const { if (bIsFlagsCacheDirty) BuildFlagsCache(); return NoneFlagsBitmaskHigh_Cache; }
+	int64 GetAllFlagsBitmaskHigh() const { if (IsFlagsCacheStale()) BuildFlagsCache(); return AllFlagsBitmaskHigh_Cache; }
+	int64 GetAnyFlagsBitmaskHigh() const { if (IsFlagsCacheStale()) BuildFlagsCache(); return AnyFlagsBitmaskHigh_Cache; }
+	int64 GetNoneFlagsBitmaskHigh() const { if (IsFlagsCacheStale()) BuildFlagsCache(); return NoneFlagsBitmaskHigh_Cache; }
+
+	// All six flag words bundled for chunk-wise evaluation | 打包全部旗标掩码，用于按 Chunk 求值
+	FEntityFlagQueryMask GetFlagQueryMask() const
+	{
+		if (IsFlagsCacheStale()) BuildFlagsCache();
+		FEntityFlagQueryMask Mask;
+		Mask.AllLow = AllFlagsBitmask_Cache;
+		Mask.AllHigh = AllFlagsBitmaskHigh_Cache;
+		Mask.AnyLow = AnyFlagsBitmask_Cache;
+		Mask.AnyHigh = AnyFlagsBitmaskHigh_Cache;
+		Mask.NoneLow = NoneFlagsBitmask_Cache;
+		Mask.NoneHigh = NoneFlagsBitmaskHigh_Cache;
+		return Mask;
+	}
+
+	/**
+	 * How the FEntityFlagFragment column is requested when this query is executed chunk-wise.
+	 * All/Any flags need the fragment (archetypes without it are skipped), None-only flags read it optionally.
+	 * Returns false if the query has no flag constraint or already lists the fragment itself. A query that lists it as
+	 * None only sees entities whose flags are all zero: chunk scans then test the flag mask against zero instead of
+	 * reading the column, so All/Any flags match nothing and None flags match everything.
+	 * | 按 Chunk 执行时旗标片段的需求方式；All/Any 需要片段，仅 None 时为可选
+	 */
+	bool GetFlagFragmentPresence(EMassFragmentPresence& OutPresence) const
+	{
+		const FEntityFlagQueryMask Mask = GetFlagQueryMask();
+		if (Mask.IsEmpty()) return false;
+
+		UScriptStruct* FlagStruct = FEntityFlagFragment::StaticStruct();
+		if (AllList.Contains(FlagStruct) || AnyList.Contains(FlagStruct) || NoneList.Contains(FlagStruct)) return false;
+
+		OutPresence = Mask.RequiresFlagFragment() ? EMassFragmentPresence::All : EMassFragmentPresence::Optional;
+		return true;
+	}
 
 	/** * Returns a native FMassEntityQuery bound to the provided EntityManager.
 	 * Note: We cannot cache the bound query itself because the Manager can change,
 	 * but we reuse the struct lists to populate it efficiently.
+	 * For repeated use prefer UMassAPISubsystem::GetCachedNativeQuery, which keeps the query alive.
 	 */
 	FMassEntityQuery GetNativeQuery(const TSharedPtr<FMassEntityManager>& EntityManager) const
 	{
@@ -455,6 +1327,151 @@ public:
 		bIsFlagsCacheDirty = true;
 	}
 
+	/**
+	 * Stable, order-independent hash of the All/Any/None struct lists and their access modes.
+	 * Two queries with the same key configure identical native queries, so the subsystem can share one.
+	 * | All/Any/None 结构列表及访问模式的稳定哈希（与顺序无关），相同键的查询可共享同一原生查询
+	 */
+	uint32 GetNativeQueryKey() const
+	{
+		TArray<const UScriptStruct*> SortedAll, SortedAny, SortedNone;
+		GatherRequirementStructs(SortedAll, SortedAny, SortedNone);
+
+		// Flag column requirement is part of the native query too | 旗标列需求也属于原生查询配置
+		EMassFragmentPresence FlagPresence = EMassFragmentPresence::None;
+		const bool bReadsFlags = GetFlagFragmentPresence(FlagPresence);
+		return HashRequirementStructs(SortedAll, SortedAny, SortedNone, bReadsFlags, FlagPresence);
+	}
+
+	/** Sorted unique requirement structs; predicate fragments join the All list | 排序去重的需求结构，谓词片段并入 All */
+	void GatherRequirementStructs(TArray<const UScriptStruct*>& OutAll, TArray<const UScriptStruct*>& OutAny, TArray<const UScriptStruct*>& OutNone) const
+	{
+		auto Gather = [](const TArray<TObjectPtr<UScriptStruct>>& List, TArray<const UScriptStruct*>& OutStructs)
+			{
+				OutStructs.Reset(List.Num());
+				for (const TObjectPtr<UScriptStruct>& Struct : List)
+				{
+					if (Struct) OutStructs.AddUnique(Struct.Get());
+				}
+			};
+		Gather(AllList, OutAll);
+		Gather(AnyList, OutAny);
+		Gather(NoneList, OutNone);
+
+		for (const FEntityFragmentPredicate& Predicate : Predicates)
+		{
+			if (const UScriptStruct* FragmentType = Predicate.GetFragmentType()) OutAll.AddUnique(FragmentType);
+		}
+		if (HasFlagChangeFilter())
+		{
+			OutAll.AddUnique(FEntityFlagChangeFragment::StaticStruct());
+		}
+
+		OutAll.Sort();
+		OutAny.Sort();
+		OutNone.Sort();
+	}
+
+	static uint32 HashRequirementStructs(const TConstArrayView<const UScriptStruct*> SortedAll, const TConstArrayView<const UScriptStruct*> SortedAny,
+		const TConstArrayView<const UScriptStruct*> SortedNone, const bool bReadsFlags, const EMassFragmentPresence FlagPresence)
+	{
+		auto HashList = [](const TConstArrayView<const UScriptStruct*> Sorted, const EMassFragmentAccess Access)
+			{
+				uint32 Hash = GetTypeHash(static_cast<uint8>(Access));
+				for (const UScriptStruct* Struct : Sorted)
+				{
+					Hash = HashCombine(Hash, GetTypeHash(Struct));
+				}
+				return Hash;
+			};
+
+		uint32 Key = HashList(SortedAll, EMassFragmentAccess::ReadOnly);
+		Key = HashCombine(Key, HashList(SortedAny, EMassFragmentAccess::ReadOnly));
+		Key = HashCombine(Key, HashList(SortedNone, EMassFragmentAccess::None));
+		Key = HashCombine(Key, GetTypeHash(bReadsFlags ? static_cast<uint8>(FlagPresence) + 1 : 0));
+		return Key;
+	}
+
+	/** Helper to populate a native query from our lists | 用结构列表填充原生查询的需求 */
+	void ConfigureQuery(FMassEntityQuery& OutQuery) const
+	{
+		TArray<const UScriptStruct*> SortedAll, SortedAny, SortedNone;
+		GatherRequirementStructs(SortedAll, SortedAny, SortedNone);
+		FCompiledEntityQuery::ConfigureRequirements(OutQuery, SortedAll, SortedAny, SortedNone);
+	}
+
+	/** True if the query has WHERE clauses or a flag change filter; such queries run through their compiled form | 是否含成员谓词或变更过滤 */
+	FORCEINLINE bool HasPredicates() const { return Predicates.Num() > 0 || HasFlagChangeFilter(); }
+
+	FORCEINLINE bool HasFlagChangeFilter() const { return FlagsChangedSince >= 0; }
+
+	/**
+	 * Builds the immutable compiled form of this query (compositions, flag masks, native query key).
+	 * Call on the owning thread; the result can then be shared across threads freely.
+	 * ReadFragments join the native requirements so their columns can be read per chunk (e.g. ORDER BY, wide flags).
+	 * | 生成不可变的编译查询；在所属线程调用，结果可跨线程共享；ReadFragments 会加入原生需求以便按 Chunk 读取
+	 */
+	FCompiledEntityQuery Compile(const TConstArrayView<const UScriptStruct*> ReadFragments = {}) const
+	{
+		FCompiledEntityQuery Compiled;
+
+		// Flag bits, tag-backed or not, are always tested per entity: mirror tags lag their flags until the next
+		// command flush and never follow direct fragment writes, so they cannot stand in for the bits
+		// | 旗标位（含标签镜像旗标）始终逐实体检测：镜像标签滞后于旗标且不跟随直接片段写入，不能代替位检测
+		Compiled.FlagMask = GetFlagQueryMask();
+		BuildCompositionFromStructs(Compiled.AllComposition, AllList);
+		BuildCompositionFromStructs(Compiled.AnyComposition, AnyList);
+		BuildCompositionFromStructs(Compiled.NoneComposition, NoneList);
+
+		GatherRequirementStructs(Compiled.AllStructs, Compiled.AnyStructs, Compiled.NoneStructs);
+		if (ReadFragments.Num() > 0)
+		{
+			for (const UScriptStruct* ReadFragment : ReadFragments)
+			{
+				// A fragment the query excludes cannot be required as well; chunks simply lack that column | 已被 None 排除的片段不再加入需求
+				if (ReadFragment && !NoneList.Contains(ReadFragment)) Compiled.AllStructs.AddUnique(ReadFragment);
+			}
+			Compiled.AllStructs.Sort();
+		}
+
+		Compiled.bHasAll = !AllList.IsEmpty();
+		Compiled.bHasAny = !AnyList.IsEmpty();
+		Compiled.bHasNone = !NoneList.IsEmpty();
+
+		// Member offsets are resolved here, once | 成员偏移只在此解析一次
+		for (const FEntityFragmentPredicate& Predicate : Predicates)
+		{
+			FCompiledFragmentPredicate& CompiledPredicate = Compiled.Predicates.AddDefaulted_GetRef();
+			Predicate.Compile(CompiledPredicate);
+		}
+		if (HasFlagChangeFilter())
+		{
+			int64 ChangedLow = 0, ChangedHigh = 0;
+			for (const FName& FlagName : ChangedFlagsList)
+			{
+				const EEntityFlags Flag = UMassAPIFlagSettings::ResolveFlag(FlagName);
+				if (Flag >= EEntityFlags::EEntityFlags_MAX) continue;
+				const uint8 Index = static_cast<uint8>(Flag);
+				if (Index >= 64) { ChangedHigh |= (1LL << (Index - 64)); }
+				else { ChangedLow |= (1LL << Index); }
+			}
+			// Named flags that all failed to resolve match nothing rather than everything | 指定旗标均无法解析时不匹配任何实体
+			const bool bUnresolved = ChangedFlagsList.Num() > 0 && (ChangedLow | ChangedHigh) == 0;
+			const uint32 SinceEpoch = bUnresolved ? MAX_uint32 : static_cast<uint32>(FMath::Clamp<int64>(FlagsChangedSince, 0, MAX_uint32));
+			Compiled.Predicates.Add(FCompiledFragmentPredicate::MakeFlagChangeFilter(SinceEpoch, ChangedLow, ChangedHigh));
+		}
+
+		// The remaining per-entity flag terms decide how the flag column is read; a column already required through
+		// ReadFragments must not be added twice | 剩余的逐实体旗标条件决定旗标列的读取方式，已在需求中时不重复添加
+		UScriptStruct* FlagStruct = FEntityFlagFragment::StaticStruct();
+		const bool bFlagColumnListed = AllList.Contains(FlagStruct) || AnyList.Contains(FlagStruct) || NoneList.Contains(FlagStruct);
+		Compiled.FlagPresence = Compiled.FlagMask.RequiresFlagFragment() ? EMassFragmentPresence::All : EMassFragmentPresence::Optional;
+		Compiled.bReadsFlags = !Compiled.FlagMask.IsEmpty() && !bFlagColumnListed && !Compiled.AllStructs.Contains(FlagStruct);
+		Compiled.NativeQueryKey = HashRequirementStructs(Compiled.AllStructs, Compiled.AnyStructs, Compiled.NoneStructs, Compiled.bReadsFlags, Compiled.FlagPresence);
+		Compiled.bIsCompiled = true;
+		return Compiled;
+	}
+
 private:
 	// ----------- Private Helpers -----------
 
@@ -471,28 +1488,13 @@ private:
 		if (bIsAllCompDirty) { BuildCompositionFromStructs(AllComposition, AllList); bIsAllCompDirty = false; }
 		if (bIsAnyCompDirty) { BuildCompositionFromStructs(AnyComposition, AnyList); bIsAnyCompDirty = false; }
 		if (bIsNoneCompDirty) { BuildCompositionFromStructs(NoneComposition, NoneList); bIsNoneCompDirty = false; }
-		if (bIsFlagsCacheDirty) { BuildFlagsCache(); }
+		if (IsFlagsCacheStale()) { BuildFlagsCache(); }
 	}
 
-	/** Helper to populate a native query from our lists */
-	void ConfigureQuery(FMassEntityQuery& OutQuery) const
+	// Dirty after a flag list edit, stale after a registry rebuild moved names to other bits | 旗标列表修改或注册表重建后需要重新解析
+	FORCEINLINE bool IsFlagsCacheStale() const
 	{
-		auto AddReqs = [&](const TArray<TObjectPtr<UScriptStruct>>& List, EMassFragmentPresence TagP, EMassFragmentPresence FragP, EMassFragmentAccess Access)
-			{
-				for (const TObjectPtr<UScriptStruct>& Struct : List)
-				{
-					if (!Struct) continue;
-					if (Struct->IsChildOf(FMassTag::StaticStruct())) { OutQuery.AddTagRequirement(*Struct, TagP); }
-					else if (Struct->IsChildOf(FMassSharedFragment::StaticStruct())) { OutQuery.AddSharedRequirement(Struct, Access, FragP); }
-					else if (Struct->IsChildOf(FMassConstSharedFragment::StaticStruct())) { OutQuery.AddConstSharedRequirement(Struct, FragP); }
-					else if (Struct->IsChildOf(FMassChunkFragment::StaticStruct())) { OutQuery.AddChunkRequirement(Struct, Access, FragP); }
-					else if (Struct->IsChildOf(FMassFragment::StaticStruct())) { OutQuery.AddRequirement(Struct, Access, FragP); }
-				}
-			};
-
-		AddReqs(AllList, EMassFragmentPresence::All, EMassFragmentPresence::All, EMassFragmentAccess::ReadOnly);
-		AddReqs(AnyList, EMassFragmentPresence::Any, EMassFragmentPresence::Any, EMassFragmentAccess::ReadOnly);
-		AddReqs(NoneList, EMassFragmentPresence::None, EMassFragmentPresence::None, EMassFragmentAccess::None);
+		return bIsFlagsCacheDirty || FlagsCacheRegistryVersion != UMassAPIFlagSettings::GetRegistryVersion();
 	}
 
 	void BuildFlagsCache() const
@@ -501,23 +1503,22 @@ private:
 		AllFlagsBitmask_Cache = 0; AnyFlagsBitmask_Cache = 0; NoneFlagsBitmask_Cache = 0;
 		AllFlagsBitmaskHigh_Cache = 0; AnyFlagsBitmaskHigh_Cache = 0; NoneFlagsBitmaskHigh_Cache = 0;
 
-		// Resolve FName flags via settings registry | 通过设置注册表解析 FName 旗标
-		if (const UMassAPIFlagSettings* Settings = GetDefault<UMassAPIFlagSettings>())
+		// Resolve FName flags via the settings lookup table | 通过设置查找表解析 FName 旗标
+		auto SetFlagBit = [&](int64& LowMask, int64& HighMask, const FName& FlagName)
 		{
-			auto SetFlagBit = [&](int64& LowMask, int64& HighMask, const FName& FlagName)
+			const EEntityFlags Flag = UMassAPIFlagSettings::ResolveFlag(FlagName);
+			if (Flag < EEntityFlags::EEntityFlags_MAX)
 			{
-				if (const EEntityFlags* Flag = Settings->FlagRegistry.Find(FlagName))
-				{
-					const uint8 Index = static_cast<uint8>(*Flag);
-					if (Index >= 64) { HighMask |= (1LL << (Index - 64)); }
-					else { LowMask |= (1LL << Index); }
-				}
-			};
-			for (const FName& FlagName : AllFlagsList) { SetFlagBit(AllFlagsBitmask_Cache, AllFlagsBitmaskHigh_Cache, FlagName); }
-			for (const FName& FlagName : AnyFlagsList) { SetFlagBit(AnyFlagsBitmask_Cache, AnyFlagsBitmaskHigh_Cache, FlagName); }
-			for (const FName& FlagName : NoneFlagsList) { SetFlagBit(NoneFlagsBitmask_Cache, NoneFlagsBitmaskHigh_Cache, FlagName); }
-		}
+				const uint8 Index = static_cast<uint8>(Flag);
+				if (Index >= 64) { HighMask |= (1LL << (Index - 64)); }
+				else { LowMask |= (1LL << Index); }
+			}
+		};
+		for (const FName& FlagName : AllFlagsList) { SetFlagBit(AllFlagsBitmask_Cache, AllFlagsBitmaskHigh_Cache, FlagName); }
+		for (const FName& FlagName : AnyFlagsList) { SetFlagBit(AnyFlagsBitmask_Cache, AnyFlagsBitmaskHigh_Cache, FlagName); }
+		for (const FName& FlagName : NoneFlagsList) { SetFlagBit(NoneFlagsBitmask_Cache, NoneFlagsBitmaskHigh_Cache, FlagName); }
 
+		FlagsCacheRegistryVersion = UMassAPIFlagSettings::GetRegistryVersion();
 		bIsFlagsCacheDirty = false;
 	}
 
@@ -681,6 +1682,18 @@ public:
 	void GetTemplateData(FMassEntityTemplateData& OutTemplateData, FMassEntityManager& EntityManager) const;
 };
 
+/**
+ * Archetype resolved for a template's composition, with the manager it belongs to.
+ * Shared by every copy of an FEntityTemplateData handle, like the template data itself.
+ * | 模板组合解析出的原型及其所属管理器，与模板数据一样在句柄副本间共享
+ */
+struct FEntityTemplateArchetypeCache
+{
+	FMassArchetypeHandle Archetype;
+	TWeakPtr<FMassEntityManager> Manager;
+	bool bSorted = false;
+};
+
 /**
  * A Blueprint-accessible wrapper for FMassEntityTemplateData.
  * This struct acts as a handle to the underlying template data, allowing it
@@ -699,6 +1712,7 @@ public:
 
 	FEntityTemplateData(TSharedPtr<FMassEntityTemplateData> InData)
 		: DataPtr(InData)
+		, ArchetypeCache(InData.IsValid() ? MakeShared<FEntityTemplateArchetypeCache>() : nullptr)
 	{
 	}
 
@@ -708,7 +1722,95 @@ public:
 	/** Provides direct access to the underlying FMassEntityTemplateData */
 	FMassEntityTemplateData* Get() const { return DataPtr.Get(); }
 
+	/** True when no other handle shares the underlying data, so it can be edited in place | 没有其它句柄共享数据时为真，可原地修改 */
+	bool IsUnique() const { return DataPtr.IsValid() && DataPtr.IsUnique(); }
+
+	/**
+	 * Data that only this handle owns: returned as is when unique, otherwise copied once (copy-on-write) so other
+	 * handles keep their values. Null for an empty handle. | 仅本句柄拥有的数据：唯一时直接返回，否则复制一次（写时复制）
+	 */
+	FMassEntityTemplateData* GetMutable();
+
+	/**
+	 * Archetype of the template's composition in Manager. The template is sorted and the archetype looked up on
+	 * first use; later calls return the cached handle until the template is mutated in place or another manager
+	 * asks. Call from the game thread. | 模板对应的原型：首次排序并查找后缓存，直到模板被修改或换了管理器；在游戏线程调用
+	 */
+	FMassArchetypeHandle GetArchetype(FMassEntityManager& Manager) const;
+
+	/** Drops the cached archetype; every in-place template mutation must call it | 清除原型缓存，原地修改模板后必须调用 */
+	void InvalidateArchetype() const
+	{
+		if (ArchetypeCache.IsValid()) { *ArchetypeCache = FEntityTemplateArchetypeCache(); }
+	}
+
 private:
 	// Use a shared pointer to manage the lifetime of the native FMassEntityTemplateData object.
 	TSharedPtr<FMassEntityTemplateData> DataPtr;
+
+	// Resolved archetype, created with DataPtr so every copy of the handle sees the same cache | 与 DataPtr 一同创建的原型缓存
+	TSharedPtr<FEntityTemplateArchetypeCache> ArchetypeCache;
+};
+
+/**
+ * Per-entity initial values of one fragment type for a column build: element i goes to the i-th built entity.
+ * A strided view over caller memory, so it can read a TArray of the fragment itself or one member of an array of
+ * larger structs; the memory only needs to outlive the build call. | 列式构建中某片段类型的逐实体初始值（带步长的视图）
+ */
+struct FEntityBuildColumn
+{
+	const UScriptStruct* FragmentType = nullptr;
+	const uint8* Data = nullptr;
+	int32 Stride = 0;
+	int32 Num = 0;
+
+	FEntityBuildColumn() = default;
+
+	FEntityBuildColumn(const UScriptStruct* InFragmentType, const void* InData, const int32 InStride, const int32 InNum)
+		: FragmentType(InFragmentType)
+		, Data(static_cast<const uint8*>(InData))
+		, Stride(InStride)
+		, Num(InNum)
+	{
+	}
+
+	template<typename T>
+	static FEntityBuildColumn Make(TConstArrayView<T> Values)
+	{
+		return FEntityBuildColumn(T::StaticStruct(), Values.GetData(), sizeof(T), Values.Num());
+	}
+
+	template<typename T, typename AllocatorType>
+	static FEntityBuildColumn Make(const TArray<T, AllocatorType>& Values)
+	{
+		return Make(TConstArrayView<T>(Values));
+	}
+
+	FORCEINLINE const uint8* GetElement(const int32 Index) const { return Data + static_cast<int64>(Index) * Stride; }
+};
+
+/**
+ * Templates of a mixed build that share an archetype and shared fragment values, so one batch call creates them all.
+ * Value groups split the batch by template data, each written with one batch set of its initial values.
+ * | 混合构建中原型与共享值相同的一批模板，一次批量创建；按模板数据分组批量写入初始值
+ */
+struct FEntityTemplateBatch
+{
+	struct FValueGroup
+	{
+		const FMassEntityTemplateData* Source = nullptr;
+
+		// Positions within the batch, ascending | 批内位置，升序
+		TArray<int32> Positions;
+	};
+
+	FMassArchetypeHandle ArchetypeHandle;
+
+	// Any template of the batch; all of them carry these shared values | 批内任一模板，共享值均相同
+	const FMassEntityTemplateData* SharedSource = nullptr;
+
+	// Input indices in input order; position k of the batch builds input Indices[k] | 输入下标，按输入顺序
+	TArray<int32> Indices;
+
+	TArray<FValueGroup> ValueGroups;
 };
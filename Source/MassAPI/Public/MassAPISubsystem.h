@@ -7,9 +7,12 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "MassAPI.h"
 #include "Runtime/Launch/Resources/Version.h"
 #include "MassSubsystemBase.h"
 #include "MassAPIStructs.h"
+#include "MassAPIFlagIndex.h"
+#include "MassAPIFlagTimer.h"
 #include "MassAPIEnums.h"
 #include "MassEntitySubsystem.h"
 #include "MassEntityManager.h"
@@ -33,6 +36,156 @@ struct FEntityForEachState
 	int32 CurrentIndex = 0;
 };
 
+// Compiled form of one FEntityQuery (plus the fragments it reads), kept under the query's native key | 同一原生键下缓存的编译查询
+struct FEntityCompiledQuerySlot
+{
+	// The exact query and read fragments it was compiled from, compared on lookup | 编译来源，查找时逐项比较
+	FEntityQuery Source;
+	TArray<const UScriptStruct*> ReadFragments;
+
+	// Flag names and tag-backed flags resolve through the registry | 旗标名与镜像旗标依赖注册表版本
+	int32 RegistryVersion = 0;
+
+	TSharedPtr<const FCompiledEntityQuery> Compiled;
+};
+
+// Persistent native query shared by every FEntityQuery with the same key | 相同键的 FEntityQuery 共享的持久原生查询
+struct FEntityQueryCacheEntry
+{
+	// Bound to the manager once; archetype list is updated incrementally by Mass on each use | 只绑定一次，原型列表由 Mass 增量更新
+	TSharedPtr<FMassEntityQuery> NativeQuery;
+
+	// Sorted requirement structs; entries sharing a key are told apart by these | 排序后的需求结构，同键条目据此区分
+	TArray<const UScriptStruct*> AllStructs;
+	TArray<const UScriptStruct*> AnyStructs;
+	TArray<const UScriptStruct*> NoneStructs;
+
+	// FEntityFlagFragment column requirement added for flag queries | 旗标查询附加的旗标列需求
+	bool bReadsFlags = false;
+	EMassFragmentPresence FlagPresence = EMassFragmentPresence::None;
+
+	// Compiled forms of the queries sharing this key, most recent last | 共享此键的查询的编译形式，最近使用的在末尾
+	TArray<FEntityCompiledQuerySlot> CompiledQueries;
+
+	uint64 LastUsedFrame = 0;
+};
+
+// Matching entities of one chunk as of the last refresh, keyed by the chunk's entity array | 单个 Chunk 上次刷新时的匹配结果
+struct FEntityLiveQueryChunk
+{
+	FMassArchetypeHandle Archetype;
+	int32 ChunkSerial = INDEX_NONE;
+	uint64 LastSeenRefresh = 0;
+	TArray<FMassEntityHandle> Matching;
+};
+
+/** A chunk whose entities the flag index has read from the flag column, as of ChunkSerial | 旗标索引已读取过旗标列的 Chunk */
+struct FEntityFlagIndexChunk
+{
+	FMassArchetypeHandle Archetype;
+	int32 ChunkSerial = INDEX_NONE;
+};
+
+/**
+ * Persistent query result set, refreshed by UMassAPISubsystem every tick.
+ * A chunk is rescanned only when its serial changed (entities added, removed or moved) or when MassAPI recorded
+ * a write of a watched flag bit to its archetype since the last refresh; untouched chunks cost a map lookup.
+ * Writes MassAPI does not see (flags or predicate members written through fragment views) need
+ * UMassAPISubsystem::InvalidateLiveQueries before the next tick.
+ * Added / Removed hold the delta of the last refresh; Matching is the full current set.
+ * | 持久化的查询结果集，只重扫序号变化或被 MassAPI 写入过相关旗标位的原型的 Chunk；绕过 MassAPI 的写入需调用 InvalidateLiveQueries
+ */
+struct FEntityLiveQuery
+{
+	FCompiledEntityQuery Query;
+
+	TSet<FMassEntityHandle> Matching;
+	TArray<FMassEntityHandle> Added;
+	TArray<FMassEntityHandle> Removed;
+
+	TMap<const void*, FEntityLiveQueryChunk> Chunks;
+	uint64 RefreshCount = 0;
+
+	// UMassAPISubsystem live query generation seen by the last refresh | 上次刷新时的失效代数
+	uint32 Generation = 0;
+};
+
+/**
+ * Flag observer callback, fired once per tick with the entities whose observed bits went 0→1 (SetEntities)
+ * or 1→0 (ClearedEntities) since the previous dispatch. An entity that flipped several times may appear in both.
+ * Transitions come from the values the atomic writes replaced, so concurrent writers never report the same one twice.
+ * | 旗标观察者回调：每帧一次，携带被观察位由 0→1 与 1→0 的实体
+ */
+DECLARE_DELEGATE_TwoParams(FOnEntityFlagsChanged, TConstArrayView<FMassEntityHandle> /*SetEntities*/, TConstArrayView<FMassEntityHandle> /*ClearedEntities*/);
+
+// Bits of one entity that actually flipped in a flag write | 一次旗标写入中实际翻转的位
+struct FEntityFlagTransition
+{
+	FMassEntityHandle Entity;
+	int64 RoseLow = 0;
+	int64 RoseHigh = 0;
+	int64 FellLow = 0;
+	int64 FellHigh = 0;
+};
+
+// Registered flag mask and the transitions collected for it since the last dispatch | 观察的旗标掩码及累积的变化
+struct FEntityFlagObserver
+{
+	int64 MaskLow = 0;
+	int64 MaskHigh = 0;
+	FOnEntityFlagsChanged Callback;
+
+	TArray<FMassEntityHandle> PendingSet;
+	TArray<FMassEntityHandle> PendingCleared;
+};
+
+namespace MassAPIBuild
+{
+	/**
+	 * Composition of a fixed BuildEntities argument pack (decayed types), built once per pack.
+	 * Its address identifies the pack in UMassAPISubsystem's archetype cache. | 固定参数包的组合，每个参数包只构建一次，其地址作为原型缓存的键
+	 */
+	template<typename... TArgs>
+	struct TEntityBuildSignature
+	{
+		static const FMassArchetypeCompositionDescriptor& GetComposition()
+		{
+			static const FMassArchetypeCompositionDescriptor Composition = MakeComposition();
+			return Composition;
+		}
+
+		static constexpr bool bHasFragments = (UE::Mass::CFragment<TArgs> || ...);
+		static constexpr bool bHasSharedFragments = ((UE::Mass::CSharedFragment<TArgs> || UE::Mass::CConstSharedFragment<TArgs>) || ...);
+
+	private:
+		static FMassArchetypeCompositionDescriptor MakeComposition()
+		{
+			FMassFragmentBitSet Fragments;
+			FMassTagBitSet Tags;
+			FMassSharedFragmentBitSet SharedFragments;
+			FMassConstSharedFragmentBitSet ConstSharedFragments;
+
+			(AddType<TArgs>(Fragments, Tags, SharedFragments, ConstSharedFragments), ...);
+
+			return FMassArchetypeCompositionDescriptor(MoveTemp(Fragments), MoveTemp(Tags), FMassChunkFragmentBitSet(), MoveTemp(SharedFragments), MoveTemp(ConstSharedFragments));
+		}
+
+		template<typename ArgType>
+		static void AddType(FMassFragmentBitSet& Fragments, FMassTagBitSet& Tags, FMassSharedFragmentBitSet& SharedFragments, FMassConstSharedFragmentBitSet& ConstSharedFragments)
+		{
+			if constexpr (UE::Mass::CTag<ArgType>) { BIT_SET_ADD(Tags, ArgType::StaticStruct()); }
+			else if constexpr (UE::Mass::CFragment<ArgType>) { BIT_SET_ADD(Fragments, ArgType::StaticStruct()); }
+			else if constexpr (UE::Mass::CSharedFragment<ArgType>) { BIT_SET_ADD(SharedFragments, ArgType::StaticStruct()); }
+			else if constexpr (UE::Mass::CConstSharedFragment<ArgType>) { BIT_SET_ADD(ConstSharedFragments, ArgType::StaticStruct()); }
+			else
+			{
+				static_assert(UE::Mass::TAlwaysFalse<ArgType>,
+					"Arguments must be MassTags, MassFragments, MassSharedFragments, or MassConstSharedFragments");
+			}
+		}
+	};
+}
+
 
 //——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
 //——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
@@ -139,6 +292,27 @@ public:
 		return AllResult && AnyResult && NoneResult;
 	}
 
+	// Compiled query: prebuilt bitsets, no dirty-flag branches | 编译查询：预建位集，无脏标记分支
+	FORCEINLINE static bool MatchQueryAll(const FMassArchetypeCompositionDescriptor& Composition, const FCompiledEntityQuery& Query)
+	{
+		return !Query.HasAllTerms() || HasAll(Composition, Query.GetAllComposition());
+	}
+
+	FORCEINLINE static bool MatchQueryAny(const FMassArchetypeCompositionDescriptor& Composition, const FCompiledEntityQuery& Query)
+	{
+		return !Query.HasAnyTerms() || HasAny(Composition, Query.GetAnyComposition());
+	}
+
+	FORCEINLINE static bool MatchQueryNone(const FMassArchetypeCompositionDescriptor& Composition, const FCompiledEntityQuery& Query)
+	{
+		return !Query.HasNoneTerms() || !HasAny(Composition, Query.GetNoneComposition());
+	}
+
+	FORCEINLINE static bool MatchQuery(const FMassArchetypeCompositionDescriptor& Composition, const FCompiledEntityQuery& Query)
+	{
+		return MatchQueryAll(Composition, Query) && MatchQueryAny(Composition, Query) && MatchQueryNone(Composition, Query);
+	}
+
 	/** * 检查实体的 Composition (Tags / Fragments) 是否匹配查询
 	 * @param Manager 实体管理器实例
 	 * @param ArchetypeHandle 要检查的实体的原型句柄
@@ -170,47 +344,38 @@ public:
 		FMassEntityManager* Manager = GetEntityManager();
 		checkf(Manager, TEXT("EntityManager is not available"));
 
-		// 从查询中获取缓存的位掩码 (低位 0-63)
-		const int64 AllFlagsQueryLow = Query.GetAllFlagsBitmask();
-		const int64 AnyFlagsQueryLow = Query.GetAnyFlagsBitmask();
-		const int64 NoneFlagsQueryLow = Query.GetNoneFlagsBitmask();
-
-		// 从查询中获取缓存的位掩码 (高位 64-127)
-		const int64 AllFlagsQueryHigh = Query.GetAllFlagsBitmaskHigh();
-		const int64 AnyFlagsQueryHigh = Query.GetAnyFlagsBitmaskHigh();
-		const int64 NoneFlagsQueryHigh = Query.GetNoneFlagsBitmaskHigh();
+		const FEntityFlagQueryMask Mask = Query.GetFlagQueryMask();
 
 		// 只有在有标志位查询时才执行检查
-		if (AllFlagsQueryLow == 0 && AnyFlagsQueryLow == 0 && NoneFlagsQueryLow == 0 &&
-		    AllFlagsQueryHigh == 0 && AnyFlagsQueryHigh == 0 && NoneFlagsQueryHigh == 0)
+		if (Mask.IsEmpty())
 		{
 			return true; // 没有标志位查询，总是通过
 		}
 
-		// 尝试获取实体的 Flag Fragment
+		// 如果实体没有 Flag Fragment，则认为它的标志位为 0
 		const FEntityFlagFragment* FlagFragment = Manager->GetFragmentDataPtr<FEntityFlagFragment>(EntityHandle);
+		return FlagFragment ? Mask.Matches(*FlagFragment) : Mask.Matches(0, 0);
+	}
 
-		// 如果实体没有 Flag Fragment，则认为它的标志位为 0
-		const int64 EntityFlagsLow = FlagFragment ? FlagFragment->Flags : 0;
-		const int64 EntityFlagsHigh = FlagFragment ? FlagFragment->FlagsHigh : 0;
+	FORCEINLINE bool MatchQueryComposition(const FMassArchetypeHandle ArchetypeHandle, const FCompiledEntityQuery& Query) const
+	{
+		FMassEntityManager* Manager = GetEntityManager();
+		checkf(Manager, TEXT("EntityManager is not available"));
 
-		// 执行标志位检查 (低位 + 高位)
-		// All flags: must have ALL in both low and high
-		const bool bAllLow = (AllFlagsQueryLow == 0) || ((EntityFlagsLow & AllFlagsQueryLow) == AllFlagsQueryLow);
-		const bool bAllHigh = (AllFlagsQueryHigh == 0) || ((EntityFlagsHigh & AllFlagsQueryHigh) == AllFlagsQueryHigh);
-		const bool bAllFlags = bAllLow && bAllHigh;
+		return MatchQuery(Manager->GetArchetypeComposition(ArchetypeHandle), Query);
+	}
 
-		// Any flags: need at least one match across both
-		const bool bAnyPass = (AnyFlagsQueryLow == 0 && AnyFlagsQueryHigh == 0)
-		                    || ((EntityFlagsLow & AnyFlagsQueryLow) != 0)
-		                    || ((EntityFlagsHigh & AnyFlagsQueryHigh) != 0);
+	FORCEINLINE bool MatchQueryFlag(const FEntityHandle EntityHandle, const FCompiledEntityQuery& Query) const
+	{
+		FMassEntityManager* Manager = GetEntityManager();
+		checkf(Manager, TEXT("EntityManager is not available"));
 
-		// None flags: must NOT have any in either
-		const bool bNoneLow = (NoneFlagsQueryLow == 0) || ((EntityFlagsLow & NoneFlagsQueryLow) == 0);
-		const bool bNoneHigh = (NoneFlagsQueryHigh == 0) || ((EntityFlagsHigh & NoneFlagsQueryHigh) == 0);
-		const bool bNoneFlags = bNoneLow && bNoneHigh;
+		const FEntityFlagQueryMask& Mask = Query.GetFlagQueryMask();
+		if (Mask.IsEmpty()) return true;
 
-		return (bAllFlags && bAnyPass && bNoneFlags);
+		// 没有 Flag Fragment 的实体按标志位为 0 处理
+		const FEntityFlagFragment* FlagFragment = Manager->GetFragmentDataPtr<FEntityFlagFragment>(EntityHandle);
+		return FlagFragment ? Mask.Matches(*FlagFragment) : Mask.Matches(0, 0);
 	}
 
 	/**
@@ -221,6 +386,12 @@ public:
 	 */
 	FORCEINLINE bool MatchQuery(const FEntityHandle EntityHandle, const FEntityQuery& Query) const
 	{
+		// WHERE clauses need resolved member offsets; compile the query once for repeated use
+		if (Query.HasPredicates())
+		{
+			return MatchQuery(EntityHandle, *GetCachedCompiledQuery(Query));
+		}
+
 		FMassEntityManager* Manager = GetEntityManager();
 		checkf(Manager, TEXT("EntityManager is not available"));
 
@@ -245,6 +416,32 @@ public:
 		return true;
 	}
 
+	FORCEINLINE bool MatchQuery(const FEntityHandle EntityHandle, const FCompiledEntityQuery& Query) const
+	{
+		FMassEntityManager* Manager = GetEntityManager();
+		checkf(Manager, TEXT("EntityManager is not available"));
+
+		if (UNLIKELY(!Manager->IsEntityActive(EntityHandle))) return false;
+
+		const FMassArchetypeHandle ArchetypeHandle = Manager->GetArchetypeForEntity(EntityHandle);
+		if (UNLIKELY(!ArchetypeHandle.IsValid())) return false;
+
+		return MatchQueryComposition(ArchetypeHandle, Query) && MatchQueryFlag(EntityHandle, Query)
+			&& (Query.GetPredicates().Num() == 0 || MatchQueryPredicates(EntityHandle, Query));
+	}
+
+	/** Tests the compiled WHERE clauses of the query against one entity's fragments | 测试单个实体的成员谓词 */
+	bool MatchQueryPredicates(const FEntityHandle EntityHandle, const FCompiledEntityQuery& Query) const;
+
+	/**
+	 * Batched MatchQuery: the composition is evaluated once per archetype seen in the input, and per-entity
+	 * flag reads only happen for archetypes that carry FEntityFlagFragment when the query has flag terms.
+	 * OutMatches[i] is the verdict for EntityHandles[i], so the input order is preserved.
+	 * | 批量匹配：每个原型只比较一次 Composition，仅在需要时逐实体读取旗标；结果与输入一一对应、保持顺序
+	 */
+	void MatchQueryBatch(TConstArrayView<FEntityHandle> EntityHandles, const FEntityQuery& Query, TBitArray<>& OutMatches) const;
+	void MatchQueryBatch(TConstArrayView<FEntityHandle> EntityHandles, const FCompiledEntityQuery& Query, TBitArray<>& OutMatches) const;
+
 
 	//--------------- Entity Operations ---------------
 
@@ -272,6 +469,43 @@ public:
 	// Build entities using a template
 	TArray<FMassEntityHandle> BuildEntities(int32 Quantity, FMassEntityTemplateData& TemplateData) const;
 
+	/**
+	 * Builds entities from a template handle, reusing the archetype it cached on an earlier build instead of
+	 * sorting and hashing the composition again. Taken by value (two shared pointers) so it is chosen over the
+	 * variadic overload. | 使用模板句柄缓存的原型批量创建实体，免去重复排序与哈希查找
+	 */
+	TArray<FMassEntityHandle> BuildEntities(int32 Quantity, FEntityTemplateData TemplateData) const;
+
+	/** Builds entities of a known archetype with the template's shared and initial fragment values | 在已知原型中按模板的共享与初始值创建实体 */
+	TArray<FMassEntityHandle> BuildEntities(int32 Quantity, const FMassArchetypeHandle& ArchetypeHandle, const FMassEntityTemplateData& TemplateData) const;
+
+	/**
+	 * Builds Quantity entities from a template, entity i taking element i of each column in place of the template's
+	 * value for that fragment. Every column type must be a fragment of the template, appear in one column only and hold
+	 * at least Quantity values; otherwise nothing is built.
+	 * All entities land in the template's cached archetype and the columns are copied chunk by chunk (one copy per
+	 * chunk for packed columns) while the creation context is still open, so observers see the final values.
+	 * | 列式批量构建：第 i 个实体取各列第 i 个值，创建期间一次性写入 Chunk
+	 *
+	 * Usage:
+	 * BuildEntitiesWithColumns(Transforms.Num(), ProjectileTemplate, { FEntityBuildColumn::Make(Transforms) })
+	 */
+	TArray<FMassEntityHandle> BuildEntitiesWithColumns(int32 Quantity, FEntityTemplateData TemplateData, TConstArrayView<FEntityBuildColumn> Columns) const;
+
+	/**
+	 * Builds one entity per template, batching templates with the same archetype and shared fragment values into a
+	 * single create and templates with the same data into a single value write. The result follows the input order;
+	 * an empty template yields an invalid handle at its index. | 每个模板创建一个实体，按原型与共享值分批，结果保持输入顺序
+	 */
+	TArray<FMassEntityHandle> BuildEntitiesFromTemplates(TConstArrayView<FEntityTemplateData> Templates) const;
+
+	/**
+	 * Buckets templates for a mixed build; empty templates and ones without an archetype are left out.
+	 * Shared fragment values match by struct type and value, so equal values held in different instances still batch.
+	 * | 为混合构建分批模板；共享片段按类型与值匹配，不同实例的相同值也可合批
+	 */
+	void GroupTemplatesForBuild(TConstArrayView<FEntityTemplateData> Templates, TArray<FEntityTemplateBatch>& OutBatches) const;
+
 	/**
 	 * Pull a const-shared fragment value back out of a FMassEntityTemplateData.
 	 * Useful when caching values from a template at spawn-time without going through
@@ -387,6 +621,8 @@ public:
 	template<typename... TArgs>
 	TArray<FMassEntityHandle> BuildEntities(int32 Quantity, TArgs&&... Args) const
 	{
+		using FSignature = MassAPIBuild::TEntityBuildSignature<std::decay_t<TArgs>...>;
+
 		TArray<FMassEntityHandle> SpawnedEntities;
 		FMassEntityManager* Manager = GetEntityManager();
 		checkf(Manager, TEXT("EntityManager is not available"));
@@ -397,79 +633,31 @@ public:
 			return SpawnedEntities;
 		}
 
-		// Build the composition descriptor
-		FMassFragmentBitSet Fragments;
-		FMassTagBitSet Tags;
-		FMassSharedFragmentBitSet SharedFragments;
-		FMassConstSharedFragmentBitSet ConstSharedFragments;
+		// The composition is built once per argument pack and its archetype resolved once per world | 组合每个参数包构建一次，原型每个世界解析一次
+		const FMassArchetypeHandle ArchetypeHandle = GetBuildSignatureArchetype(FSignature::GetComposition());
+		if (!ArchetypeHandle.IsValid())
+		{
+			UE_LOG(LogMassAPI, Warning, TEXT("Failed to create archetype for entity spawning"));
+			return SpawnedEntities;
+		}
 
-		TArray<FInstancedStruct> FragmentInstances;
+		// Shared fragment values still depend on the arguments
 		FMassArchetypeSharedFragmentValues SharedFragmentValues;
-
-		// Reserve space for fragment instances
-		if constexpr (sizeof...(Args) > 0)
+		if constexpr (FSignature::bHasSharedFragments)
 		{
-			FragmentInstances.Reserve(sizeof...(Args));
-
-			// Helper lambda to process each argument
-			auto ProcessArg = [&](auto&& Arg)
+			auto AddShared = [&](auto&& Arg)
 				{
 					using ArgType = std::decay_t<decltype(Arg)>;
-
-					// Check if it's a Tag
-					if constexpr (UE::Mass::CTag<ArgType>)
+					if constexpr (UE::Mass::CSharedFragment<ArgType>)
 					{
-						BIT_SET_ADD(Tags, ArgType::StaticStruct());
-					}
-					// Check if it's a regular Fragment
-					else if constexpr (UE::Mass::CFragment<ArgType>)
-					{
-						BIT_SET_ADD(Fragments, ArgType::StaticStruct());
-						FragmentInstances.Add(FInstancedStruct::Make(Forward<decltype(Arg)>(Arg)));
-					}
-					// Check if it's specifically a SharedFragment or ConstSharedFragment
-					else if constexpr (UE::Mass::CSharedFragment<ArgType>)
-					{
-						BIT_SET_ADD(SharedFragments, ArgType::StaticStruct());
-						// Create or get the shared fragment instance
-						const FSharedStruct& SharedStruct = Manager->GetOrCreateSharedFragment(Forward<decltype(Arg)>(Arg));
-						SharedFragmentValues.Add(SharedStruct);
+						SharedFragmentValues.Add(Manager->GetOrCreateSharedFragment(Arg));
 					}
 					else if constexpr (UE::Mass::CConstSharedFragment<ArgType>)
 					{
-						BIT_SET_ADD(ConstSharedFragments, ArgType::StaticStruct());
-						// Create or get the const shared fragment instance
-						const FConstSharedStruct& ConstSharedStruct = Manager->GetOrCreateConstSharedFragment(Forward<decltype(Arg)>(Arg));
-						SharedFragmentValues.Add(ConstSharedStruct);
-					}
-					else
-					{
-						static_assert(UE::Mass::TAlwaysFalse<ArgType>,
-							"Arguments must be MassTags, MassFragments, MassSharedFragments, or MassConstSharedFragments");
+						SharedFragmentValues.Add(Manager->GetOrCreateConstSharedFragment(Arg));
 					}
 				};
-
-			// Process all arguments
-			(ProcessArg(Forward<TArgs>(Args)), ...);
-		}
-
-		// Create the composition descriptor
-		FMassArchetypeCompositionDescriptor Composition
-		(
-			MoveTemp(Fragments),
-			MoveTemp(Tags),
-			FMassChunkFragmentBitSet(),
-			MoveTemp(SharedFragments),
-			MoveTemp(ConstSharedFragments)
-		);
-
-		// Create the archetype
-		FMassArchetypeHandle ArchetypeHandle = Manager->CreateArchetype(Composition);
-
-		if (!ArchetypeHandle.IsValid())
-		{
-			UE_LOG(LogTemp, Warning, TEXT("Failed to create archetype for entity spawning"));
-			return SpawnedEntities;
+			(AddShared(Args), ...);
 		}
 
 		// Reserve space for entities
@@ -479,27 +667,31 @@ public:
 		TSharedRef<FMassEntityManager::FEntityCreationContext> CreationContext =
 			Manager->BatchCreateEntities(ArchetypeHandle, SharedFragmentValues, Quantity, SpawnedEntities);
 
-		// Set initial fragment values if any were provided
-		if (FragmentInstances.Num() > 0)
+		// Initial values are copied straight into each entity's chunk slot, no FInstancedStruct boxing | 初始值直接写入各实体的 Chunk 槽位
+		if constexpr (FSignature::bHasFragments)
 		{
-			// Create entity collection for the spawned entities
-			TArray<FMassArchetypeEntityCollection> EntityCollections;
-			UE::Mass::Utils::CreateEntityCollections(
-				*Manager,
-				SpawnedEntities,
-				FMassArchetypeEntityCollection::NoDuplicates,
-				EntityCollections
-			);
-
-			// Apply initial fragment values to all spawned entities
-			Manager->BatchSetEntityFragmentValues(EntityCollections, FragmentInstances);
+			for (const FMassEntityHandle& Entity : SpawnedEntities)
+			{
+				const FMassEntityView EntityView(*Manager, Entity);
+				auto WriteFragment = [&EntityView](const auto& Arg)
+					{
+						using ArgType = std::decay_t<decltype(Arg)>;
+						if constexpr (UE::Mass::CFragment<ArgType>)
+						{
+							EntityView.GetFragmentData<ArgType>() = Arg;
+						}
+					};
+				(WriteFragment(Args), ...);
+			}
 		}
 
+		IndexBuiltEntities(*Manager, SpawnedEntities);
 		return SpawnedEntities;
 	}
 
 	// Build an entity using a template
 	FMassEntityHandle BuildEntity(FMassEntityTemplateData& TemplateData) const;
+	FMassEntityHandle BuildEntity(FEntityTemplateData TemplateData) const;
 
 	// Overload for spawning a single entity
 	template<typename... TArgs>
@@ -521,6 +713,13 @@ public:
 
 	void BuildEntitiesDefer(FMassCommandBuffer& CommandBuffer, int32 Quantity, FMassEntityTemplateData& TemplateData, TArray<FMassEntityHandle>& OutEntities) const;
 
+	/**
+	 * Template handle variant: the archetype is resolved (or taken from the handle's cache) now and captured by the
+	 * command, so call it from the game thread; processors should use the FMassEntityTemplateData overloads.
+	 * | 模板句柄版本：立即解析或取用缓存的原型并由命令捕获，需在游戏线程调用
+	 */
+	void BuildEntitiesDefer(FMassCommandBuffer& CommandBuffer, int32 Quantity, FEntityTemplateData TemplateData, TArray<FMassEntityHandle>& OutEntities) const;
+
 	/**
 	 * Spawns an entity deferentially using a raw command buffer.
 	 * This is the base implementation that other overloads call.
@@ -569,6 +768,7 @@ public:
 	FMassEntityHandle BuildEntityDefer(FMassExecutionContext& Context, FMassEntityTemplateData& TemplateData) const;
 
 	FMassEntityHandle BuildEntityDefer(FMassCommandBuffer& CommandBuffer, FMassEntityTemplateData& TemplateData) const;
+	FMassEntityHandle BuildEntityDefer(FMassCommandBuffer& CommandBuffer, FEntityTemplateData TemplateData) const;
 
 	/**
 	 * Destroys an entity immediately.
@@ -1743,13 +1943,14 @@ public:
 	FORCEINLINE void SetEntityFlagDefer(FMassCommandBuffer& CommandBuffer, FMassEntityHandle EntityHandle, EEntityFlags FlagToSet) const
 	{
 		if (FlagToSet >= EEntityFlags::EEntityFlags_MAX) return;
-			CommandBuffer.PushCommand<FMassDeferredSetCommand>([EntityHandle, FlagToSet](FMassEntityManager& Manager)
+			CommandBuffer.PushCommand<FMassDeferredSetCommand>([WeakThis = TWeakObjectPtr<const UMassAPISubsystem>(this), EntityHandle, FlagToSet](FMassEntityManager& Manager)
 			{
 				if (Manager.IsEntityValid(EntityHandle))
 				{
 					if (FEntityFlagFragment* Frag = Manager.GetFragmentDataPtr<FEntityFlagFragment>(EntityHandle))
 					{
-						Frag->SetFlag(FlagToSet);
+						const bool bChanged = Frag->SetFlagIfClear(FlagToSet);
+						if (const UMassAPISubsystem* This = WeakThis.Get(); This && bChanged) This->NotifyFlagWrite(Manager, EntityHandle, FlagToSet, true);
 					}
 				}
 			});
@@ -1765,13 +1966,14 @@ public:
 	FORCEINLINE void ClearEntityFlagDefer(FMassCommandBuffer& CommandBuffer, FMassEntityHandle EntityHandle, EEntityFlags FlagToClear) const
 	{
 		if (FlagToClear >= EEntityFlags::EEntityFlags_MAX) return;
-			CommandBuffer.PushCommand<FMassDeferredSetCommand>([EntityHandle, FlagToClear](FMassEntityManager& Manager)
+			CommandBuffer.PushCommand<FMassDeferredSetCommand>([WeakThis = TWeakObjectPtr<const UMassAPISubsystem>(this), EntityHandle, FlagToClear](FMassEntityManager& Manager)
 			{
 				if (Manager.IsEntityValid(EntityHandle))
 				{
 					if (FEntityFlagFragment* Frag = Manager.GetFragmentDataPtr<FEntityFlagFragment>(EntityHandle))
 					{
-						Frag->ClearFlag(FlagToClear);
+						const bool bChanged = Frag->ClearFlagIfSet(FlagToClear);
+						if (const UMassAPISubsystem* This = WeakThis.Get(); This && bChanged) This->NotifyFlagWrite(Manager, EntityHandle, FlagToClear, false);
 					}
 				}
 			});
@@ -1783,6 +1985,66 @@ public:
 		ClearEntityFlagDefer(Context.Defer(), EntityHandle, FlagToClear);
 	}
 
+	//--------------- Flag Operations (Batch) | 批量旗标操作 ---------------
+
+	/**
+	 * Applies one flag mask to many entities: bits in Clear* are cleared, then bits in Set* are set.
+	 * Entities are grouped into archetype chunks and each chunk's FEntityFlagFragment column is written in one pass
+	 * (per-word atomic fetch-and / fetch-or); chunk summaries are widened once per archetype.
+	 * Invalid entities and entities without FEntityFlagFragment are skipped.
+	 * @return The number of entities written.
+	 * | 批量应用旗标掩码：先清除后设置；按原型 Chunk 分组，对旗标列单遍写入
+	 */
+	int32 ApplyFlagMask(TConstArrayView<FMassEntityHandle> Entities, int64 SetLow, int64 SetHigh, int64 ClearLow, int64 ClearHigh) const;
+
+	/** Same as above for every entity matching Query (composition, flags and WHERE clauses) | 对匹配查询的全部实体应用掩码 */
+	int32 ApplyFlagMask(const FEntityQuery& Query, int64 SetLow, int64 SetHigh, int64 ClearLow, int64 ClearHigh) const;
+
+	FORCEINLINE int32 SetFlagsBatch(TConstArrayView<FMassEntityHandle> Entities, int64 FlagsLow, int64 FlagsHigh) const { return ApplyFlagMask(Entities, FlagsLow, FlagsHigh, 0, 0); }
+	FORCEINLINE int32 SetFlagsBatch(const FEntityQuery& Query, int64 FlagsLow, int64 FlagsHigh) const { return ApplyFlagMask(Query, FlagsLow, FlagsHigh, 0, 0); }
+	FORCEINLINE int32 ClearFlagsBatch(TConstArrayView<FMassEntityHandle> Entities, int64 FlagsLow, int64 FlagsHigh) const { return ApplyFlagMask(Entities, 0, 0, FlagsLow, FlagsHigh); }
+	FORCEINLINE int32 ClearFlagsBatch(const FEntityQuery& Query, int64 FlagsLow, int64 FlagsHigh) const { return ApplyFlagMask(Query, 0, 0, FlagsLow, FlagsHigh); }
+
+	// Deferred batch — one coalesced command for the whole array | 延迟批量写入 — 整个数组只推送一条命令
+	FORCEINLINE void ApplyFlagMaskDefer(FMassCommandBuffer& CommandBuffer, TArray<FMassEntityHandle> Entities, int64 SetLow, int64 SetHigh, int64 ClearLow, int64 ClearHigh) const
+	{
+		if (Entities.Num() == 0 || (SetLow | SetHigh | ClearLow | ClearHigh) == 0) return;
+		CommandBuffer.PushCommand<FMassDeferredSetCommand>([WeakThis = TWeakObjectPtr<const UMassAPISubsystem>(this), Entities = MoveTemp(Entities), SetLow, SetHigh, ClearLow, ClearHigh](FMassEntityManager& Manager)
+			{
+				if (const UMassAPISubsystem* This = WeakThis.Get())
+				{
+					This->ApplyFlagMask(Entities, SetLow, SetHigh, ClearLow, ClearHigh);
+				}
+			});
+	}
+
+	// Deferred batch — Query overload, matched when the command buffer flushes | 查询重载，在命令缓冲刷新时匹配
+	FORCEINLINE void ApplyFlagMaskDefer(FMassCommandBuffer& CommandBuffer, const FEntityQuery& Query, int64 SetLow, int64 SetHigh, int64 ClearLow, int64 ClearHigh) const
+	{
+		if ((SetLow | SetHigh | ClearLow | ClearHigh) == 0) return;
+		CommandBuffer.PushCommand<FMassDeferredSetCommand>([WeakThis = TWeakObjectPtr<const UMassAPISubsystem>(this), Query, SetLow, SetHigh, ClearLow, ClearHigh](FMassEntityManager&)
+			{
+				if (const UMassAPISubsystem* This = WeakThis.Get())
+				{
+					This->ApplyFlagMask(Query, SetLow, SetHigh, ClearLow, ClearHigh);
+				}
+			});
+	}
+
+	// Deferred batch — Context overloads | 延迟批量写入 — Context 重载
+	FORCEINLINE void ApplyFlagMaskDefer(FMassExecutionContext& Context, TArray<FMassEntityHandle> Entities, int64 SetLow, int64 SetHigh, int64 ClearLow, int64 ClearHigh) const
+	{
+		ApplyFlagMaskDefer(Context.Defer(), MoveTemp(Entities), SetLow, SetHigh, ClearLow, ClearHigh);
+	}
+
+	FORCEINLINE void ApplyFlagMaskDefer(FMassExecutionContext& Context, const FEntityQuery& Query, int64 SetLow, int64 SetHigh, int64 ClearLow, int64 ClearHigh) const
+	{
+		ApplyFlagMaskDefer(Context.Defer(), Query, SetLow, SetHigh, ClearLow, ClearHigh);
+	}
+
+	FORCEINLINE void SetFlagsBatchDefer(FMassCommandBuffer& CommandBuffer, TArray<FMassEntityHandle> Entities, int64 FlagsLow, int64 FlagsHigh) const { ApplyFlagMaskDefer(CommandBuffer, MoveTemp(Entities), FlagsLow, FlagsHigh, 0, 0); }
+	FORCEINLINE void ClearFlagsBatchDefer(FMassCommandBuffer& CommandBuffer, TArray<FMassEntityHandle> Entities, int64 FlagsLow, int64 FlagsHigh) const { ApplyFlagMaskDefer(CommandBuffer, MoveTemp(Entities), 0, 0, FlagsLow, FlagsHigh); }
+
 	//--------------- Flag Operations (FName) | 旗标操作（基于FName）---------------
 
 	// EEntityFlags shorthand — delegate to internal impl | EEntityFlags简写
@@ -1794,30 +2056,31 @@ public:
 	FORCEINLINE void ClearFlagDefer(FMassCommandBuffer& B, FMassEntityHandle H, EEntityFlags F) const { ClearEntityFlagDefer(B, H, F); }
 	FORCEINLINE void ClearFlagDefer(FMassExecutionContext& C, FMassEntityHandle H, EEntityFlags F) const { ClearEntityFlagDefer(C, H, F); }
 
+	// FName resolves to any bit below the configured flag width | FName 可解析到配置宽度内的任意位
 	FORCEINLINE bool HasFlag(FMassEntityHandle EntityHandle, FName FlagName) const
 	{
-		const EEntityFlags Resolved = UMassAPIFlagSettings::ResolveFlag(FlagName);
-		return (Resolved != EEntityFlags::EEntityFlags_MAX) && HasFlag(EntityHandle, Resolved);
+		const int32 Bit = UMassAPIFlagSettings::ResolveFlagBit(FlagName);
+		return (Bit != INDEX_NONE) && HasEntityFlagBit(EntityHandle, Bit);
 	}
 
 	FORCEINLINE bool SetFlag(FMassEntityHandle EntityHandle, FName FlagName) const
 	{
-		const EEntityFlags Resolved = UMassAPIFlagSettings::ResolveFlag(FlagName);
-		return (Resolved != EEntityFlags::EEntityFlags_MAX) && SetFlag(EntityHandle, Resolved);
+		const int32 Bit = UMassAPIFlagSettings::ResolveFlagBit(FlagName);
+		return (Bit != INDEX_NONE) && SetEntityFlagBit(EntityHandle, Bit);
 	}
 
 	FORCEINLINE bool ClearFlag(FMassEntityHandle EntityHandle, FName FlagName) const
 	{
-		const EEntityFlags Resolved = UMassAPIFlagSettings::ResolveFlag(FlagName);
-		return (Resolved != EEntityFlags::EEntityFlags_MAX) && ClearFlag(EntityHandle, Resolved);
+		const int32 Bit = UMassAPIFlagSettings::ResolveFlagBit(FlagName);
+		return (Bit != INDEX_NONE) && ClearEntityFlagBit(EntityHandle, Bit);
 	}
 
 	FORCEINLINE void SetFlagDefer(FMassCommandBuffer& CommandBuffer, FMassEntityHandle EntityHandle, FName FlagName) const
 	{
-		const EEntityFlags Resolved = UMassAPIFlagSettings::ResolveFlag(FlagName);
-		if (Resolved != EEntityFlags::EEntityFlags_MAX)
+		const int32 Bit = UMassAPIFlagSettings::ResolveFlagBit(FlagName);
+		if (Bit != INDEX_NONE)
 		{
-			SetFlagDefer(CommandBuffer, EntityHandle, Resolved);
+			SetEntityFlagBitDefer(CommandBuffer, EntityHandle, Bit, true);
 		}
 	}
 
@@ -1828,10 +2091,10 @@ public:
 
 	FORCEINLINE void ClearFlagDefer(FMassCommandBuffer& CommandBuffer, FMassEntityHandle EntityHandle, FName FlagName) const
 	{
-		const EEntityFlags Resolved = UMassAPIFlagSettings::ResolveFlag(FlagName);
-		if (Resolved != EEntityFlags::EEntityFlags_MAX)
+		const int32 Bit = UMassAPIFlagSettings::ResolveFlagBit(FlagName);
+		if (Bit != INDEX_NONE)
 		{
-			ClearFlagDefer(CommandBuffer, EntityHandle, Resolved);
+			SetEntityFlagBitDefer(CommandBuffer, EntityHandle, Bit, false);
 		}
 	}
 
@@ -1840,6 +2103,434 @@ public:
 		ClearFlagDefer(Context.Defer(), EntityHandle, FlagName);
 	}
 
+	// Pre-resolved flag id: no name lookup unless the registry changed | 预解析旗标 ID：注册表未变化时无名称查找
+	FORCEINLINE bool HasFlag(FMassEntityHandle EntityHandle, const FEntityFlagId& FlagId) const
+	{
+		const int32 Bit = FlagId.GetBit();
+		return (Bit != INDEX_NONE) && HasEntityFlagBit(EntityHandle, Bit);
+	}
+
+	FORCEINLINE bool SetFlag(FMassEntityHandle EntityHandle, const FEntityFlagId& FlagId) const
+	{
+		const int32 Bit = FlagId.GetBit();
+		return (Bit != INDEX_NONE) && SetEntityFlagBit(EntityHandle, Bit);
+	}
+
+	FORCEINLINE bool ClearFlag(FMassEntityHandle EntityHandle, const FEntityFlagId& FlagId) const
+	{
+		const int32 Bit = FlagId.GetBit();
+		return (Bit != INDEX_NONE) && ClearEntityFlagBit(EntityHandle, Bit);
+	}
+
+	FORCEINLINE void SetFlagDefer(FMassCommandBuffer& CommandBuffer, FMassEntityHandle EntityHandle, const FEntityFlagId& FlagId) const
+	{
+		const int32 Bit = FlagId.GetBit();
+		if (Bit != INDEX_NONE)
+		{
+			SetEntityFlagBitDefer(CommandBuffer, EntityHandle, Bit, true);
+		}
+	}
+
+	FORCEINLINE void ClearFlagDefer(FMassCommandBuffer& CommandBuffer, FMassEntityHandle EntityHandle, const FEntityFlagId& FlagId) const
+	{
+		const int32 Bit = FlagId.GetBit();
+		if (Bit != INDEX_NONE)
+		{
+			SetEntityFlagBitDefer(CommandBuffer, EntityHandle, Bit, false);
+		}
+	}
+
+	//--------------- Flag Operations (bit index, any width) | 旗标操作（位索引，任意宽度）---------------
+
+	/**
+	 * Bit-index flag access covering the configured flag width (UMassAPIFlagSettings::FlagWidth).
+	 * Bits 0-127 go through the EEntityFlags path (FEntityFlagFragment), bits 128+ through the extension fragment.
+	 * | 按位索引访问旗标；0-127 走 FEntityFlagFragment，128 以上走扩展片段
+	 */
+	bool HasEntityFlagBit(FMassEntityHandle EntityHandle, int32 Bit) const;
+	bool SetEntityFlagBit(FMassEntityHandle EntityHandle, int32 Bit) const;
+	bool ClearEntityFlagBit(FMassEntityHandle EntityHandle, int32 Bit) const;
+
+	/**
+	 * Atomic write of a bit >= 128 into the entity's extension fragment; false if absent or out of width.
+	 * bOutChanged tells whether the bit actually flipped; pass it on to NotifyExtFlagWrite.
+	 * | 原子写入扩展片段中的位；bOutChanged 表示是否真正翻转，应转交 NotifyExtFlagWrite
+	 */
+	static bool WriteExtFlagBit(FMassEntityManager& Manager, FMassEntityHandle EntityHandle, int32 Bit, bool bValue, bool& bOutChanged);
+
+	// Deferred bit write | 延迟写入位
+	FORCEINLINE void SetEntityFlagBitDefer(FMassCommandBuffer& CommandBuffer, FMassEntityHandle EntityHandle, int32 Bit, bool bValue) const
+	{
+		if (Bit < 0 || Bit >= UMassAPIFlagSettings::GetFlagBitCount()) return;
+		if (Bit < 128)
+		{
+			bValue ? SetEntityFlagDefer(CommandBuffer, EntityHandle, static_cast<EEntityFlags>(Bit)) : ClearEntityFlagDefer(CommandBuffer, EntityHandle, static_cast<EEntityFlags>(Bit));
+			return;
+		}
+		CommandBuffer.PushCommand<FMassDeferredSetCommand>([WeakThis = TWeakObjectPtr<const UMassAPISubsystem>(this), EntityHandle, Bit, bValue](FMassEntityManager& Manager)
+			{
+				bool bChanged = false;
+				if (Manager.IsEntityValid(EntityHandle) && WriteExtFlagBit(Manager, EntityHandle, Bit, bValue, bChanged) && bChanged)
+				{
+					if (const UMassAPISubsystem* This = WeakThis.Get()) This->NotifyExtFlagWrite(Manager, EntityHandle);
+				}
+			});
+	}
+
+	/**
+	 * The entity's flags as one block of NumBits (128, 256 or 512); missing fragments read as zero.
+	 * | 以 NumBits 宽的旗标块返回实体旗标；缺失片段按 0 处理
+	 */
+	template<int32 NumBits = MASSAPI_FLAG_BITS>
+	TEntityFlagBlock<NumBits> GetEntityFlagBlock(FMassEntityHandle EntityHandle) const
+	{
+		FMassEntityManager* Manager = GetEntityManager();
+		if (!Manager || !Manager->IsEntityValid(EntityHandle)) return TEntityFlagBlock<NumBits>();
+
+		const FEntityFlagFragment* Base = Manager->GetFragmentDataPtr<FEntityFlagFragment>(EntityHandle);
+		if constexpr (NumBits > 128)
+		{
+			using FExtFragment = typename TEntityFlagExtFragment<NumBits>::Type;
+			return MassAPIFlags::MakeBlock<NumBits>(Base, Manager->GetFragmentDataPtr<FExtFragment>(EntityHandle));
+		}
+		else
+		{
+			return MassAPIFlags::MakeBlock<NumBits>(Base, nullptr);
+		}
+	}
+
+	/**
+	 * Collects entities matching Query whose full-width flags also satisfy FlagMask.
+	 * Reads FEntityFlagFragment (and the NumBits extension fragment) column-wise per chunk and tests each lane
+	 * with SIMD block ops; entities missing those fragments are not visited. The query's own 128-bit flag
+	 * constraint still prunes chunks through their summaries first. Appends to OutEntities like the other overloads.
+	 * | 收集同时满足宽旗标掩码的实体（追加到 OutEntities）；逐 Chunk 读列并用 SIMD 测试，缺少旗标片段的实体不参与
+	 */
+	template<int32 NumBits>
+	void GetMatchingEntities(const FEntityQuery& Query, const TEntityFlagQueryMask<NumBits>& FlagMask, TArray<FMassEntityHandle>& OutEntities) const
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE_STR("MassAPI_GetMatchingEntitiesWideFlags");
+
+		const UScriptStruct* ExtFragmentType = nullptr;
+		if constexpr (NumBits > 128)
+		{
+			ExtFragmentType = TEntityFlagExtFragment<NumBits>::Type::StaticStruct();
+		}
+
+		const UScriptStruct* ReadFragments[] = { FEntityFlagFragment::StaticStruct(), ExtFragmentType };
+		VisitFlagFilteredChunks(*GetCachedCompiledQuery(Query, ReadFragments),
+			[&FlagMask, &OutEntities](FMassExecutionContext& Context, TConstArrayView<uint64> PassWords, int32 NumPassed)
+			{
+				const TConstArrayView<FMassEntityHandle> Entities = Context.GetEntities();
+				// Chunks without the flag column (the query excludes it) have nothing to test | 无旗标列的 Chunk 无需测试
+				if (!Context.DoesArchetypeHaveFragment<FEntityFlagFragment>()) return true;
+
+				const FEntityFlagFragment* BaseColumn = Context.GetFragmentView<FEntityFlagFragment>().GetData();
+				const typename TEntityFlagExtFragment<NumBits>::Type* ExtColumn = nullptr;
+				if constexpr (NumBits > 128)
+				{
+					if (Context.DoesArchetypeHaveFragment<typename TEntityFlagExtFragment<NumBits>::Type>())
+					{
+						ExtColumn = Context.GetFragmentView<typename TEntityFlagExtFragment<NumBits>::Type>().GetData();
+					}
+				}
+
+				auto TestLane = [&](const int32 EntityIt)
+					{
+						if (FlagMask.Matches(MassAPIFlags::MakeBlockAt<NumBits>(BaseColumn, ExtColumn, EntityIt)))
+						{
+							OutEntities.Add(Entities[EntityIt]);
+						}
+					};
+
+				OutEntities.Reserve(OutEntities.Num() + NumPassed);
+				if (PassWords.Num() == 0)
+				{
+					for (int32 EntityIt = 0; EntityIt < Entities.Num(); ++EntityIt) { TestLane(EntityIt); }
+					return true;
+				}
+				for (int32 WordIt = 0; WordIt < PassWords.Num(); ++WordIt)
+				{
+					uint64 Word = PassWords[WordIt];
+					while (Word)
+					{
+						TestLane(WordIt * 64 + static_cast<int32>(FMath::CountTrailingZeros64(Word)));
+						Word &= Word - 1;
+					}
+				}
+				return true;
+			});
+	}
+
+
+	//--------------- Query Cache | 查询缓存 ---------------
+
+	/**
+	 * Returns a persistent native query for the given FEntityQuery, creating it on first use.
+	 * Entries are keyed by FEntityQuery::GetNativeQueryKey(), so identical queries coming from different
+	 * Blueprint nodes share one FMassEntityQuery whose archetype cache survives between calls. Queries whose keys
+	 * collide are told apart by their full requirement lists and keep an entry each.
+	 * Entries not used for QueryCacheEvictionFrames frames are evicted in Tick.
+	 * | 返回持久化的原生查询，首次使用时创建；长时间未使用的条目在 Tick 中被清除
+	 */
+	FMassEntityQuery& GetCachedNativeQuery(const FEntityQuery& Query) const;
+	FMassEntityQuery& GetCachedNativeQuery(const FCompiledEntityQuery& Query) const;
+
+	/**
+	 * Returns the compiled form of Query, compiling it only the first time. Kept in the native query cache entry
+	 * under the same key and evicted with it; a query that differs in any field, or a registry change, compiles anew.
+	 * ReadFragments are forwarded to FEntityQuery::Compile.
+	 * | 返回查询的编译形式，只在首次编译；与原生查询同键缓存、同时清除；任何字段或注册表变化都会重新编译
+	 */
+	TSharedRef<const FCompiledEntityQuery> GetCachedCompiledQuery(const FEntityQuery& Query, TConstArrayView<const UScriptStruct*> ReadFragments = {}) const;
+
+	/**
+	 * Collects every entity matching the query (composition and flags).
+	 * Flags are tested chunk by chunk over the contiguous FEntityFlagFragment column instead of
+	 * looking up each entity's fragment, and only passing lanes are written out.
+	 * | 收集匹配查询的全部实体；旗标按 Chunk 连续列测试，仅输出通过的实体
+	 */
+	void GetMatchingEntities(const FEntityQuery& Query, TArray<FMassEntityHandle>& OutEntities) const;
+	void GetMatchingEntities(const FCompiledEntityQuery& Query, TArray<FMassEntityHandle>& OutEntities) const;
+
+	/**
+	 * Parallel variant of GetMatchingEntities for large flag queries.
+	 * Matching chunks are recorded serially, evaluated in contiguous ranges on task-graph workers with one
+	 * output buffer per range, then concatenated, so the order is always archetype order then chunk order.
+	 * Stays serial when fewer than SerialThreshold candidate entities are found.
+	 * | 并行版本：Chunk 按连续区间分给工作线程，各自缓冲后按顺序拼接，结果顺序确定；候选数低于阈值时保持串行
+	 */
+	void GetMatchingEntitiesParallel(const FEntityQuery& Query, TArray<FMassEntityHandle>& OutEntities, int32 SerialThreshold = ParallelQuerySerialThreshold) const;
+	void GetMatchingEntitiesParallel(const FCompiledEntityQuery& Query, TArray<FMassEntityHandle>& OutEntities, int32 SerialThreshold = ParallelQuerySerialThreshold) const;
+
+	/** Default candidate count below which GetMatchingEntitiesParallel stays serial | 并行查询默认串行阈值 */
+	static constexpr int32 ParallelQuerySerialThreshold = 16384;
+
+	/**
+	 * Counts entities matching the query without materializing any handle.
+	 * Flag queries popcount the passing lanes of each chunk's FEntityFlagFragment column.
+	 * | 只计数不生成句柄；旗标查询对每个 Chunk 的通过位做 popcount
+	 */
+	int32 CountMatchingEntities(const FEntityQuery& Query) const;
+	int32 CountMatchingEntities(const FCompiledEntityQuery& Query) const;
+
+	/** Early-exit variant of CountMatchingEntities: stops at the first passing chunk | 找到第一个匹配即停止 */
+	bool AnyMatchingEntities(const FEntityQuery& Query) const;
+	bool AnyMatchingEntities(const FCompiledEntityQuery& Query) const;
+
+	/**
+	 * Per-flag population of the query: OutCounts[Flag] is the number of matching entities with that flag set (128 entries).
+	 * One pass over each chunk's FEntityFlagFragment column, folding lanes into bit-sliced counters instead of
+	 * testing 128 flags per entity. | 查询结果中每个旗标的置位数量（128 项）；逐 Chunk 读旗标列，位切片累加
+	 */
+	void GetFlagHistogram(const FEntityQuery& Query, TArray<int32>& OutCounts) const;
+
+	/**
+	 * Chunk visitor used by the query engine. PassWords holds one bit per entity (64 per word) of the chunk,
+	 * or is empty when every entity of the chunk passes. Return false to stop the iteration.
+	 * | 查询引擎的 Chunk 访问器；PassWords 为每实体一位，为空表示整块通过；返回 false 停止遍历
+	 */
+	using FFlagChunkVisitor = TFunctionRef<bool(FMassExecutionContext& Context, TConstArrayView<uint64> PassWords, int32 NumPassed)>;
+
+	/**
+	 * Walks every chunk matching the query's composition, evaluates its flag constraint chunk-wise
+	 * (summary first, then the flag column) and hands chunks with at least one passing entity to Visitor.
+	 * | 遍历匹配 Composition 的 Chunk，按 Chunk 求值旗标后把有通过实体的 Chunk 交给访问器
+	 */
+	void VisitFlagFilteredChunks(const FEntityQuery& Query, FFlagChunkVisitor Visitor) const;
+	void VisitFlagFilteredChunks(const FCompiledEntityQuery& Query, FFlagChunkVisitor Visitor) const;
+
+	/**
+	 * ORDER BY ... LIMIT K: the K matching entities with the smallest (or largest) value of SortMember, in order.
+	 * The member is read straight from each chunk's fragment column and kept in a bounded heap of size K,
+	 * so cost is O(N log K) and no per-entity fragment lookup happens. Entities without the fragment never match.
+	 * Ties are broken by entity index so the result is deterministic. OutValues, if given, receives the sort keys.
+	 * | 按成员取前 K 个实体：直接读 Chunk 列并维护大小为 K 的堆，O(N log K)；同值按实体索引排序
+	 */
+	void GetTopKMatchingEntities(const FEntityQuery& Query, const FStructRecursiveMemberReference& SortMember, int32 K, bool bDescending,
+		TArray<FMassEntityHandle>& OutEntities, TArray<double>* OutValues = nullptr) const;
+
+	/** Every matching entity ordered by SortMember (full ORDER BY, O(N log N)) | 按成员排序返回全部匹配实体 */
+	void GetMatchingEntitiesSorted(const FEntityQuery& Query, const FStructRecursiveMemberReference& SortMember, bool bDescending,
+		TArray<FMassEntityHandle>& OutEntities, TArray<double>* OutValues = nullptr) const;
+
+	/**
+	 * Records bits written to an entity's FEntityFlagFragment so the chunk summaries of its archetype stay conservative.
+	 * Every MassAPI flag setter (immediate, deferred, FName) calls this; code writing the fragment directly should too.
+	 * Set/Clear bits are recorded as changed in the entity's FEntityFlagChangeFragment, so report real transitions only.
+	 * | 记录写入的旗标位，保证该原型的 Chunk 摘要保持保守正确；直接写片段的代码也应调用；写入位会记为变更，只应报告真实变化
+	 */
+	void NotifyFlagWrite(const FMassEntityManager& Manager, FMassEntityHandle EntityHandle, int64 SetLow, int64 SetHigh, int64 ClearLow, int64 ClearHigh) const;
+
+	/** Archetype-level variant of NotifyFlagWrite for batch writers | 批量写入使用的原型级版本 */
+	void NotifyFlagArchetypeWrite(FMassArchetypeHandle ArchetypeHandle, int64 SetLow, int64 SetHigh, int64 ClearLow, int64 ClearHigh) const;
+
+	/**
+	 * Marks every chunk flag summary stale, so the next query rebuilds it from the flag column.
+	 * Call after writing FEntityFlagFragment outside MassAPI (fragment views, FMassEntityManager) while
+	 * UMassAPIFlagSettings::bEnableFlagChunkSummary is on. | 使所有 Chunk 旗标摘要失效；绕过 MassAPI 写旗标后调用
+	 */
+	void InvalidateFlagChunkSummaries() const;
+
+	/**
+	 * NotifyFlagWrite for extended bits (128+). Only change tracking sees them: it stamps the entity's
+	 * FEntityFlagChangeFragment so "any flag" FlagsChangedSince filters match. Chunk summaries, the flag index,
+	 * observers and tag mirrors cover bits 0-127 only. | 扩展位的写入通知：仅记录变更纪元；摘要、索引、观察者与镜像只覆盖 0-127 位
+	 */
+	void NotifyExtFlagWrite(const FMassEntityManager& Manager, FMassEntityHandle EntityHandle) const;
+
+	/** Adds the flags of freshly built entities to the flag index (no-op while it is disabled) | 将新建实体的旗标加入索引 */
+	void IndexBuiltEntities(const FMassEntityManager& Manager, TConstArrayView<FMassEntityHandle> Entities) const;
+
+	FORCEINLINE void NotifyFlagWrite(const FMassEntityManager& Manager, FMassEntityHandle EntityHandle, EEntityFlags Flag, bool bValue) const
+	{
+		const int64 Bit = (1LL << FEntityFlagFragment::GetLocalBitIndex(Flag));
+		const int64 Low = FEntityFlagFragment::IsHighFlag(Flag) ? 0 : Bit;
+		const int64 High = FEntityFlagFragment::IsHighFlag(Flag) ? Bit : 0;
+		NotifyFlagWrite(Manager, EntityHandle, bValue ? Low : 0, bValue ? High : 0, bValue ? 0 : Low, bValue ? 0 : High);
+	}
+
+	//--------------- Flag Index | 旗标索引 ---------------
+
+	/**
+	 * Turns the per-flag entity index on or off (default from UMassAPIFlagSettings::bEnableFlagIndex).
+	 * Enabling rebuilds it from a scan of every FEntityFlagFragment. While enabled, GetMatchingEntities on queries
+	 * requiring rare flags intersects the flag bitmaps first and confirms composition only on the survivors.
+	 * The index is a hint: chunks it has not read since their last structural change (entities created or moved
+	 * outside MassAPI) are read from their flag column before it is used, and every candidate is confirmed
+	 * against its fragment. Flag writes that bypass MassAPI on already indexed entities still need RebuildFlagIndex.
+	 * | 开启或关闭旗标索引；开启时全量重建。开启后要求稀有旗标的查询先求位图交集，再只确认幸存实体的 Composition。
+	 * 索引仅作提示：结构变化后未读取过的 Chunk 先读取旗标列，候选逐个按片段确认；绕过 MassAPI 改写已索引实体的旗标仍需 RebuildFlagIndex
+	 */
+	void SetFlagIndexEnabled(bool bEnabled);
+
+	FORCEINLINE bool IsFlagIndexEnabled() const { return bFlagIndexEnabled; }
+
+	/**
+	 * Rebuilds the flag index from the current FEntityFlagFragment values.
+	 * Call after writing flag fragments directly (bypassing MassAPI setters). | 按当前旗标片段重建索引；直接写片段后调用
+	 */
+	void RebuildFlagIndex() const;
+
+	/**
+	 * Every live entity that has Flag set, in entity index order, in O(entities with the flag).
+	 * Falls back to a query scan when the flag index is disabled. | 返回设置了该旗标的实体；未开启索引时退回查询扫描
+	 */
+	void GetEntitiesWithFlag(EEntityFlags Flag, TArray<FMassEntityHandle>& OutEntities) const;
+
+	/** Number of entities the index holds for Flag (may include stale entries not yet confirmed) | 索引中该旗标的实体数 */
+	int32 GetFlagIndexCount(EEntityFlags Flag) const;
+
+	/**
+	 * The index is used when its candidate estimate times this ratio stays below the query's entity count,
+	 * since a confirmed candidate costs a random fragment lookup and a scanned entity a streamed column read.
+	 * | 候选数乘以该比例仍小于查询实体数时才使用索引
+	 */
+	static constexpr int32 FlagIndexScanRatio = 16;
+
+	//--------------- Flag Change Tracking | 旗标变更追踪 ---------------
+
+	/**
+	 * Current flag change epoch, advanced once per tick. Flag changes made now are stamped with this value in
+	 * FEntityFlagChangeFragment; keep it and pass it as FEntityQuery::FlagsChangedSince later to get every entity
+	 * whose flags changed from then on. | 当前旗标变更纪元，每帧递增；保存后作为 FlagsChangedSince 传入即可查询此后变化的实体
+	 */
+	FORCEINLINE uint32 GetFlagChangeEpoch() const { return FlagChangeEpoch; }
+
+	/** Whether MassAPI flag writes stamp FEntityFlagChangeFragment (UMassAPIFlagSettings::bEnableFlagChangeTracking) | 是否记录旗标变更 */
+	FORCEINLINE bool IsFlagChangeTrackingEnabled() const { return bFlagChangeTrackingEnabled; }
+
+	//--------------- Timed Flags | 定时旗标 ---------------
+
+	/**
+	 * Sets (bValue = true) or clears Flag on the entity once Delay seconds have passed.
+	 * Timers live in a hierarchical timing wheel advanced in Tick; every change due in the same tick is applied in one
+	 * batched flag pass. A newer schedule for the same entity and flag replaces the pending one, and entities destroyed
+	 * in the meantime are skipped. | 在 Delay 秒后设置或清除旗标；同一实体同一旗标的新计划覆盖旧计划，已销毁的实体被跳过
+	 */
+	void ScheduleFlagChange(FMassEntityHandle EntityHandle, EEntityFlags Flag, bool bValue, float Delay) const;
+
+	/**
+	 * Sets Flag now and clears it after Duration seconds (e.g. a stun or invulnerability window).
+	 * Calling it again while the flag is pending restarts the window. | 立即设置旗标并在 Duration 秒后清除，重复调用会重新计时
+	 */
+	bool SetFlagForDuration(FMassEntityHandle EntityHandle, EEntityFlags Flag, float Duration) const;
+
+	/** Drops the pending timed change of Flag on the entity, if any | 取消实体该旗标的计划变更 */
+	void CancelScheduledFlagChange(FMassEntityHandle EntityHandle, EEntityFlags Flag) const;
+
+	/** Number of timed flag changes still pending | 尚未执行的计划变更数量 */
+	int32 GetNumScheduledFlagChanges() const;
+
+	//--------------- Flag Observers | 旗标观察者 ---------------
+
+	/**
+	 * Registers interest in the flags of MaskLow / MaskHigh. Transitions made through any MassAPI flag path
+	 * (setters, deferred commands, batch masks, timed flags) are collected and delivered in one Callback per tick,
+	 * after the command flush. Callbacks may write flags; those changes arrive on the next tick.
+	 * Only writes made through UMassAPISubsystem or UMassAPIFuncLib are observed; flags written through fragment
+	 * views or FMassEntityManager, and extended bits (128+), are not reported.
+	 * @return Id used by UnregisterFlagObserver | 注册旗标观察者，每帧在命令刷新后批量回调一次；仅观察经 MassAPI 的写入，不含直接片段写入与扩展位
+	 */
+	int32 RegisterFlagObserver(int64 MaskLow, int64 MaskHigh, FOnEntityFlagsChanged Callback);
+	int32 RegisterFlagObserver(TConstArrayView<EEntityFlags> Flags, FOnEntityFlagsChanged Callback);
+
+	/** Stops notifying the observer; pending transitions are discarded | 注销观察者，丢弃未派发的变化 */
+	void UnregisterFlagObserver(int32 ObserverId);
+
+	/**
+	 * Feeds real 0→1 / 1→0 transitions to the observers whose mask they touch.
+	 * Called by every MassAPI flag write path; code writing FEntityFlagFragment directly can call it too.
+	 * | 将实际翻转的旗标位交给相关观察者；直接写片段的代码也可调用
+	 */
+	void RecordFlagTransitions(TConstArrayView<FEntityFlagTransition> Transitions) const;
+
+	//--------------- Tag-Backed Flags | 标签镜像旗标 ---------------
+
+	/**
+	 * Migration cost of Flag: how often it flipped, and for tag-backed flags how many entities were moved and in
+	 * how many batches. Non tag-backed flags are counted only with UMassAPIFlagSettings::bCollectFlagMigrationStats,
+	 * which tells what promoting them would cost. | 旗标的迁移开销统计，非镜像旗标需开启 bCollectFlagMigrationStats
+	 */
+	FEntityFlagMigrationStats GetFlagMigrationStats(EEntityFlags Flag) const;
+
+	/** Zeroes every flag's migration counters | 清零所有旗标的迁移统计 */
+	void ResetFlagMigrationStats() const;
+
+	/** Number of entities whose mirror tags wait for the next batched migration | 等待下一次批量迁移的实体数 */
+	int32 GetNumPendingFlagMirrors() const;
+
+	//--------------- Live Query | 实时查询 ---------------
+
+	/**
+	 * Registers a live query; its result set is refreshed every tick after the command flush.
+	 * The first refresh runs immediately, so every current match is reported as Added.
+	 * @return Id used by GetLiveQuery / UnregisterLiveQuery | 返回实时查询 ID
+	 */
+	int32 RegisterLiveQuery(const FEntityQuery& Query);
+	int32 RegisterLiveQuery(const FCompiledEntityQuery& Query);
+
+	/** Stops refreshing and drops the result set | 注销实时查询 */
+	void UnregisterLiveQuery(int32 LiveQueryId);
+
+	/** Current set and last deltas, nullptr for an unknown id | 当前结果与增量，ID 无效时返回 nullptr */
+	const FEntityLiveQuery* GetLiveQuery(int32 LiveQueryId) const { return LiveQueries.Find(LiveQueryId); }
+
+	/**
+	 * Makes the next refresh rescan every chunk of every live query.
+	 * Call after writing FEntityFlagFragment or a member read by a live query's WHERE predicates outside MassAPI
+	 * (fragment views, FMassEntityManager). | 使所有实时查询下次全部重扫；绕过 MassAPI 写旗标或谓词成员后调用
+	 */
+	void InvalidateLiveQueries() const;
+
+	/** Drops every cached native query | 清空查询缓存 */
+	void ResetQueryCache() const { QueryCache.Reset(); }
+
+	/** Frames an unused cached query survives before eviction | 未使用的缓存查询保留帧数 */
+	static constexpr uint64 QueryCacheEvictionFrames = 600;
+
+	/** Compiled variants kept per native key (e.g. one per FlagsChangedSince epoch), oldest dropped first | 每个原生键保留的编译查询数 */
+	static constexpr int32 MaxCompiledQueriesPerKey = 8;
 
 	//--------------- Entity ForEach Iteration (cursor-based, Apparatus-style) | 实体遍历迭代（游标模式）---------------
 
@@ -1861,6 +2552,113 @@ private:
 
 	mutable FMassEntityManager* EntityManager = nullptr;
 
+	// Native query cache keyed by FEntityQuery::GetNativeQueryKey(); queries whose keys collide get one entry each | 原生查询缓存，哈希冲突的查询各占一个条目
+	mutable TMap<uint32, TArray<FEntityQueryCacheEntry, TInlineAllocator<1>>> QueryCache;
+
+	// Per-archetype bits written in the current epoch, widens chunk flag summaries | 当前纪元内各原型的旗标写入
+	mutable TMap<FMassArchetypeHandle, FEntityFlagArchetypeWrites> FlagArchetypeWrites;
+
+	// Flag setters may run from parallel processors | 旗标写入可能来自并行处理器
+	mutable FRWLock FlagArchetypeWritesLock;
+
+	// Stamped into rebuilt chunk summaries, advanced by InvalidateFlagChunkSummaries; guarded by FlagArchetypeWritesLock | 摘要代数
+	mutable uint32 FlagSummaryGeneration = 0;
+
+	// Compared with FEntityLiveQuery::Generation, advanced by InvalidateLiveQueries; guarded by FlagArchetypeWritesLock | 实时查询失效代数
+	mutable uint32 LiveQueryGeneration = 0;
+
+	// Per-flag entity index bitmaps, valid while bFlagIndexEnabled | 每个旗标的实体索引位图
+	mutable FEntityFlagIndex FlagIndex;
+
+	// Chunks the index has read, keyed by the chunk's entity array; guarded by FlagIndexLock | 索引已读取的 Chunk
+	mutable TMap<const FMassEntityHandle*, FEntityFlagIndexChunk> FlagIndexedChunks;
+	mutable FRWLock FlagIndexLock;
+	bool bFlagIndexEnabled = false;
+
+	// Stamped into FEntityFlagChangeFragment by flag writes, advanced in Tick; starts at 1 (0 = never changed) | 旗标变更纪元
+	uint32 FlagChangeEpoch = 1;
+	bool bFlagChangeTrackingEnabled = false;
+
+	// Timed flag changes, advanced in Tick | 定时旗标变更，在 Tick 中推进
+	mutable FEntityFlagTimingWheel FlagTimers;
+
+	// Live generation per (entity index, flag); older timers of the same key are ignored when due | 每个 (实体, 旗标) 的当前代数
+	mutable TMap<uint64, uint32> FlagTimerGenerations;
+	mutable uint32 NextFlagTimerGeneration = 1;
+	mutable FCriticalSection FlagTimersLock;
+
+	// Flag observers keyed by id, with the union of their masks for a cheap early out | 旗标观察者及其掩码并集
+	mutable TMap<int32, FEntityFlagObserver> FlagObservers;
+	mutable FCriticalSection FlagObserversLock;
+	int64 ObservedFlagsLow = 0;
+	int64 ObservedFlagsHigh = 0;
+	int32 NextFlagObserverId = 0;
+
+	// Entities whose tag-backed flags flipped since the last migration batch | 自上次批量迁移以来镜像旗标翻转的实体
+	mutable TSet<FMassEntityHandle> PendingFlagMirrors;
+	mutable FEntityFlagMigrationStats FlagMigrationStats[128];
+	mutable FCriticalSection FlagMirrorsLock;
+
+	// Tag-backed bits, and the bits whose transitions are counted (tag-backed, or all when collecting stats) | 镜像位与统计位
+	int64 TagBackedFlagsLow = 0;
+	int64 TagBackedFlagsHigh = 0;
+	int64 MigrationStatFlagsLow = 0;
+	int64 MigrationStatFlagsHigh = 0;
+
+	// Archetypes of variadic BuildEntities argument packs, keyed by their static composition | 可变参数 BuildEntities 参数包的原型缓存
+	mutable TMap<const FMassArchetypeCompositionDescriptor*, FMassArchetypeHandle> BuildSignatureArchetypes;
+
+	// Registered live queries keyed by id | 已注册的实时查询
+	TMap<int32, FEntityLiveQuery> LiveQueries;
+	int32 NextLiveQueryId = 0;
+
+	//------------------- Query Engine ---------------
+
+	// Rescans the changed chunks of one live query and rebuilds its deltas | 重扫变化的 Chunk 并生成增量
+	void RefreshLiveQuery(FEntityLiveQuery& LiveQuery) const;
+
+	// Archetype of a BuildEntities argument pack, created on first use in this world | 参数包对应的原型，首次使用时创建
+	FMassArchetypeHandle GetBuildSignatureArchetype(const FMassArchetypeCompositionDescriptor& Composition) const;
+
+	// Advances the flag timing wheel and applies the changes that came due, batched per flag | 推进时间轮并按旗标批量应用到期变更
+	void FlushFlagTimers(float DeltaTime);
+
+	// Delivers the transitions collected since the last tick, one callback per observer | 每个观察者派发一次累积的变化
+	void DispatchFlagObservers();
+
+	// Union of every observer mask | 重新计算观察掩码并集
+	void UpdateObservedFlags();
+
+	// Counts transitions and queues entities whose tag-backed flags flipped | 统计翻转并排队镜像需更新的实体
+	void RecordFlagMigrations(TConstArrayView<FEntityFlagTransition> Transitions) const;
+
+	// Pushes one deferred command moving every queued entity to the archetype matching its mirror tags | 推送一条批量迁移镜像标签的延迟命令
+	void FlushFlagMirrors();
+
+	// Runs in the command buffer: groups entities by mirror tag change and batch-changes each group | 命令缓冲中执行：按标签变化分组并批量变更
+	void ApplyFlagMirrors(FMassEntityManager& Manager, TConstArrayView<FMassEntityHandle> Entities) const;
+
+	// Index-driven GetMatchingEntities; false if the index cannot narrow this query | 索引驱动的查询；索引无法缩小范围时返回 false
+	bool GetMatchingEntitiesFromFlagIndex(const FCompiledEntityQuery& Query, TArray<FMassEntityHandle>& OutEntities) const;
+
+	// Reads into the index every chunk of NativeQuery whose serial moved since the index last read it | 将序号变化后未读取的 Chunk 读入索引
+	void SeedFlagIndexChunks(FMassEntityQuery& NativeQuery) const;
+
+	// Entry under Key with exactly these requirements, added (without a native query yet) when missing | 查找需求完全相同的条目，缺失时添加
+	FEntityQueryCacheEntry& FindOrAddCacheEntry(uint32 Key, TConstArrayView<const UScriptStruct*> AllStructs, TConstArrayView<const UScriptStruct*> AnyStructs,
+		TConstArrayView<const UScriptStruct*> NoneStructs, bool bReadsFlags, EMassFragmentPresence FlagPresence) const;
+
+	// Cache lookup shared by both query forms; Configure only runs when the entry is built | 两种查询共用的缓存查找
+	FMassEntityQuery& FindOrAddCachedQuery(uint32 Key, TConstArrayView<const UScriptStruct*> AllStructs, TConstArrayView<const UScriptStruct*> AnyStructs,
+		TConstArrayView<const UScriptStruct*> NoneStructs, bool bReadsFlags, EMassFragmentPresence FlagPresence, TFunctionRef<void(FMassEntityQuery&)> Configure) const;
+
+	// Engine bodies, run on a resolved native query, flag mask and WHERE clauses | 在已解析的原生查询、旗标掩码与成员谓词上执行
+	void VisitFlagFilteredChunks(FMassEntityQuery& NativeQuery, const FEntityFlagQueryMask& Mask, TConstArrayView<FCompiledFragmentPredicate> Predicates, FFlagChunkVisitor Visitor) const;
+	void GetMatchingEntities(FMassEntityQuery& NativeQuery, const FEntityFlagQueryMask& Mask, TConstArrayView<FCompiledFragmentPredicate> Predicates, TArray<FMassEntityHandle>& OutEntities) const;
+	void GetMatchingEntitiesParallel(FMassEntityQuery& NativeQuery, const FEntityFlagQueryMask& Mask, TConstArrayView<FCompiledFragmentPredicate> Predicates, TArray<FMassEntityHandle>& OutEntities, int32 SerialThreshold) const;
+	int32 CountMatchingEntities(FMassEntityQuery& NativeQuery, const FEntityFlagQueryMask& Mask, TConstArrayView<FCompiledFragmentPredicate> Predicates) const;
+	bool AnyMatchingEntities(FMassEntityQuery& NativeQuery, const FEntityFlagQueryMask& Mask, TConstArrayView<FCompiledFragmentPredicate> Predicates) const;
+
 protected:
 
 	// Check if EntityHandle is valid, will trigger an assertion
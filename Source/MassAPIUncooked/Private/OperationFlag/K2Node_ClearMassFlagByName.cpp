@@ -4,6 +4,7 @@
 */
 
 #include "OperationFlag/K2Node_ClearMassFlagByName.h"
+#include "OperationFlag/K2Node_MakeLiteralFlagName.h"
 #include "MassAPIFuncLib.h"
 #include "MassAPIStructs.h"
 #include "MassEntityTypes.h"
@@ -383,6 +384,10 @@ virtual void Compile() override
 {
 	OwnerNode->UpdateDataSourceType();
 
+	// A literal flag name is resolved now and passed as a pre-resolved id | 字面量旗标名在编译期解析为旗标 ID
+	FName LiteralFlagName;
+	const bool bBakeFlag = UK2Node_MakeLiteralFlagName::TryGetLiteralFlagName(OwnerNode->FindPin(UK2Node_ClearMassFlagByName::FlagPinName()), LiteralFlagName);
+
 	if (OwnerNode->CachedDataSourceType == EMassFragmentSourceDataType::None)
 	{
 		CompilerContext.MessageLog.Error(TEXT("DataSource must be connected to either FEntityHandle or FEntityTemplateData. @@"), OwnerNode);
@@ -395,11 +400,11 @@ virtual void Compile() override
 	switch (OwnerNode->CachedDataSourceType)
 	{
 		case EMassFragmentSourceDataType::EntityHandle:
-			ClearFunctionNode = HNCH_SpawnFunctionNode(UMassAPIFuncLib, ClearFlag_EntityByName);
+			ClearFunctionNode = (bBakeFlag ? HNCH_SpawnFunctionNode(UMassAPIFuncLib, ClearFlag_EntityById) : HNCH_SpawnFunctionNode(UMassAPIFuncLib, ClearFlag_EntityByName));
 			FunctionDataSourcePinName = TEXT("EntityHandle");
 			break;
 		case EMassFragmentSourceDataType::EntityTemplateData:
-			ClearFunctionNode = HNCH_SpawnFunctionNode(UMassAPIFuncLib, ClearFlag_TemplateByName);
+			ClearFunctionNode = (bBakeFlag ? HNCH_SpawnFunctionNode(UMassAPIFuncLib, ClearFlag_TemplateById) : HNCH_SpawnFunctionNode(UMassAPIFuncLib, ClearFlag_TemplateByName));
 			FunctionDataSourcePinName = TEXT("TemplateData");
 			break;
 		default:
@@ -410,7 +415,14 @@ virtual void Compile() override
 	Link(ThenPin(ClearFunctionNode), ProxyThenPin());
 
 	Link(ProxyPin(UK2Node_ClearMassFlagByName::DataSourcePinName()), FunctionInputPin(ClearFunctionNode, FunctionDataSourcePinName));
-	Link(ProxyPin(UK2Node_ClearMassFlagByName::FlagPinName()), FunctionInputPin(ClearFunctionNode, TEXT("FlagName")));
+	if (bBakeFlag)
+	{
+		PinDefaultValue(FunctionInputPin(ClearFunctionNode, TEXT("FlagId")), UK2Node_MakeLiteralFlagName::MakeBakedFlagIdDefault(LiteralFlagName));
+	}
+	else
+	{
+		Link(ProxyPin(UK2Node_ClearMassFlagByName::FlagPinName()), FunctionInputPin(ClearFunctionNode, TEXT("FlagName")));
+	}
 
 	if (OwnerNode->CachedDataSourceType == EMassFragmentSourceDataType::EntityHandle)
 	{
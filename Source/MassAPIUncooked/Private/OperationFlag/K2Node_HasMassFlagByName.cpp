@@ -4,6 +4,7 @@
 */
 
 #include "OperationFlag/K2Node_HasMassFlagByName.h"
+#include "OperationFlag/K2Node_MakeLiteralFlagName.h"
 #include "MassAPIFuncLib.h"
 #include "MassAPIStructs.h"
 #include "MassEntityTypes.h"
@@ -218,6 +219,10 @@ virtual void Compile() override
 {
 	OwnerNode->UpdateDataSourceType();
 
+	// A literal flag name is resolved now and passed as a pre-resolved id | 字面量旗标名在编译期解析为旗标 ID
+	FName LiteralFlagName;
+	const bool bBakeFlag = UK2Node_MakeLiteralFlagName::TryGetLiteralFlagName(OwnerNode->FindPin(UK2Node_HasMassFlagByName::FlagPinName()), LiteralFlagName);
+
 	if (OwnerNode->CachedDataSourceType == EMassFragmentSourceDataType::None)
 	{
 		CompilerContext.MessageLog.Error(TEXT("DataSource must be connected to either FEntityHandle or FEntityTemplateData. @@"), OwnerNode);
@@ -230,11 +235,11 @@ virtual void Compile() override
 	switch (OwnerNode->CachedDataSourceType)
 	{
 		case EMassFragmentSourceDataType::EntityHandle:
-			HasFunctionNode = HNCH_SpawnFunctionNode(UMassAPIFuncLib, HasFlag_EntityByName);
+			HasFunctionNode = (bBakeFlag ? HNCH_SpawnFunctionNode(UMassAPIFuncLib, HasFlag_EntityById) : HNCH_SpawnFunctionNode(UMassAPIFuncLib, HasFlag_EntityByName));
 			FunctionDataSourcePinName = TEXT("EntityHandle");
 			break;
 		case EMassFragmentSourceDataType::EntityTemplateData:
-			HasFunctionNode = HNCH_SpawnFunctionNode(UMassAPIFuncLib, HasFlag_TemplateByName);
+			HasFunctionNode = (bBakeFlag ? HNCH_SpawnFunctionNode(UMassAPIFuncLib, HasFlag_TemplateById) : HNCH_SpawnFunctionNode(UMassAPIFuncLib, HasFlag_TemplateByName));
 			FunctionDataSourcePinName = TEXT("TemplateData");
 			break;
 		default:
@@ -242,7 +247,14 @@ virtual void Compile() override
 	}
 
 	Link(ProxyPin(UK2Node_HasMassFlagByName::DataSourcePinName()), FunctionInputPin(HasFunctionNode, FunctionDataSourcePinName));
-	Link(ProxyPin(UK2Node_HasMassFlagByName::FlagPinName()), FunctionInputPin(HasFunctionNode, TEXT("FlagName")));
+	if (bBakeFlag)
+	{
+		PinDefaultValue(FunctionInputPin(HasFunctionNode, TEXT("FlagId")), UK2Node_MakeLiteralFlagName::MakeBakedFlagIdDefault(LiteralFlagName));
+	}
+	else
+	{
+		Link(ProxyPin(UK2Node_HasMassFlagByName::FlagPinName()), FunctionInputPin(HasFunctionNode, TEXT("FlagName")));
+	}
 
 	UEdGraphPin* FunctionReturnPin = NodePin(HasFunctionNode, UEdGraphSchema_K2::PN_ReturnValue.ToString());
 	if (FunctionReturnPin)
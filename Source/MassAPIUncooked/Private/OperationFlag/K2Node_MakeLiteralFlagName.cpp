@@ -8,6 +8,7 @@
 #include "BlueprintNodeSpawner.h"
 #include "BlueprintActionDatabaseRegistrar.h"
 #include "KismetCompiler.h"
+#include "MassAPIStructs.h"
 
 //——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
 
@@ -51,6 +52,9 @@ void UK2Node_MakeLiteralFlagName::AllocateDefaultPins()
 	// Output pin: FName, pass-through | 输出引脚：FName，透传
 	CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Name, NAME_None, UEdGraphSchema_K2::PN_ReturnValue);
 
+	// Output pin: the same flag pre-resolved at compile time | 输出引脚：编译期预解析的旗标 ID
+	CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Struct, FEntityFlagId::StaticStruct(), FlagIdPinName());
+
 	Super::AllocateDefaultPins();
 }
 
@@ -93,6 +97,28 @@ void UK2Node_MakeLiteralFlagName::ExpandNode(FKismetCompilerContext& CompilerCon
 	UEdGraphPin* InputPin = FindPinChecked(ValuePinName());
 	UEdGraphPin* OutputPin = FindPinChecked(UEdGraphSchema_K2::PN_ReturnValue);
 
+	// Literal values are written straight into the consumers before links are broken | 断开连接前将字面量直接写入下游引脚
+	if (!InputPin->LinkedTo.Num())
+	{
+		for (UEdGraphPin* ConsumerPin : OutputPin->LinkedTo)
+		{
+			ConsumerPin->DefaultValue = InputPin->DefaultValue;
+		}
+
+		if (UEdGraphPin* FlagIdPin = FindPin(FlagIdPinName()))
+		{
+			const FString BakedFlagId = MakeBakedFlagIdDefault(FName(*InputPin->DefaultValue));
+			for (UEdGraphPin* ConsumerPin : FlagIdPin->LinkedTo)
+			{
+				ConsumerPin->DefaultValue = BakedFlagId;
+			}
+		}
+	}
+	else if (UEdGraphPin* FlagIdPin = FindPin(FlagIdPinName()); FlagIdPin && FlagIdPin->LinkedTo.Num() > 0)
+	{
+		CompilerContext.MessageLog.Warning(TEXT("FlagId can only be baked from a literal Value; @@ outputs an unresolved id."), this);
+	}
+
 	if (InputPin && OutputPin && OutputPin->LinkedTo.Num() > 0)
 	{
 		// Move input connections to a literal FName → wire to output | 将输入端 DefaultValue 字面量连到输出
@@ -114,4 +140,49 @@ void UK2Node_MakeLiteralFlagName::ExpandNode(FKismetCompilerContext& CompilerCon
 	BreakAllNodeLinks();
 }
 
+//================ Flag.Baking																						========
+
+bool UK2Node_MakeLiteralFlagName::TryGetLiteralFlagName(const UEdGraphPin* FlagPin, FName& OutFlagName)
+{
+	if (!FlagPin)
+	{
+		return false;
+	}
+
+	const UEdGraphPin* SourcePin = FlagPin;
+	if (FlagPin->LinkedTo.Num() > 0)
+	{
+		// Only a Make Literal Flag with an unlinked Value is a compile-time constant | 仅未连接 Value 的字面量节点视为常量
+		const UEdGraphPin* LinkedPin = FlagPin->LinkedTo[0];
+		const UK2Node_MakeLiteralFlagName* LiteralNode = LinkedPin ? Cast<UK2Node_MakeLiteralFlagName>(LinkedPin->GetOwningNode()) : nullptr;
+		if (!LiteralNode || LinkedPin->PinName != UEdGraphSchema_K2::PN_ReturnValue)
+		{
+			return false;
+		}
+
+		SourcePin = LiteralNode->FindPin(ValuePinName());
+		if (!SourcePin || SourcePin->LinkedTo.Num() > 0)
+		{
+			return false;
+		}
+	}
+
+	if (SourcePin->DefaultValue.IsEmpty() || SourcePin->DefaultValue == TEXT("None"))
+	{
+		return false;
+	}
+
+	OutFlagName = FName(*SourcePin->DefaultValue);
+	return true;
+}
+
+FString UK2Node_MakeLiteralFlagName::MakeBakedFlagIdDefault(FName FlagName)
+{
+	const FEntityFlagId FlagId(FlagName);
+
+	FString DefaultValue;
+	FEntityFlagId::StaticStruct()->ExportText(DefaultValue, &FlagId, nullptr, nullptr, PPF_None, nullptr);
+	return DefaultValue;
+}
+
 //——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————//——————————————————————————————————————————————————————————————————————————————————————————————————————————————————————
@@ -4,6 +4,7 @@
 */
 
 #include "OperationFlag/K2Node_SetMassFlagByName.h"
+#include "OperationFlag/K2Node_MakeLiteralFlagName.h"
 #include "MassAPIFuncLib.h"
 #include "MassAPIStructs.h"
 #include "MassEntityTypes.h"
@@ -414,6 +415,10 @@ virtual void Compile() override
 {
 	OwnerNode->UpdateDataSourceType();
 
+	// A literal flag name is resolved now and passed as a pre-resolved id | 字面量旗标名在编译期解析为旗标 ID
+	FName LiteralFlagName;
+	const bool bBakeFlag = UK2Node_MakeLiteralFlagName::TryGetLiteralFlagName(OwnerNode->FindPin(UK2Node_SetMassFlagByName::FlagPinName()), LiteralFlagName);
+
 	if (OwnerNode->CachedDataSourceType == EMassFragmentSourceDataType::None)
 	{
 		CompilerContext.MessageLog.Error(TEXT("DataSource must be connected to either FEntityHandle or FEntityTemplateData. @@"), OwnerNode);
@@ -484,16 +489,23 @@ virtual void Compile() override
 
 		if (bIsEntityMode)
 		{
-			SetFunctionNode = HNCH_SpawnFunctionNode(UMassAPIFuncLib, SetFlag_EntityByName);
+			SetFunctionNode = (bBakeFlag ? HNCH_SpawnFunctionNode(UMassAPIFuncLib, SetFlag_EntityById) : HNCH_SpawnFunctionNode(UMassAPIFuncLib, SetFlag_EntityByName));
 			Link(ArrayItemPin, FunctionInputPin(SetFunctionNode, TEXT("EntityHandle")));
 		}
 		else
 		{
-			SetFunctionNode = HNCH_SpawnFunctionNode(UMassAPIFuncLib, SetFlag_TemplateByName);
+			SetFunctionNode = (bBakeFlag ? HNCH_SpawnFunctionNode(UMassAPIFuncLib, SetFlag_TemplateById) : HNCH_SpawnFunctionNode(UMassAPIFuncLib, SetFlag_TemplateByName));
 			Link(ArrayItemPin, FunctionInputPin(SetFunctionNode, TEXT("TemplateData")));
 		}
 
-		Link(ProxyPin(UK2Node_SetMassFlagByName::FlagPinName()), FunctionInputPin(SetFunctionNode, TEXT("FlagName")));
+		if (bBakeFlag)
+		{
+			PinDefaultValue(FunctionInputPin(SetFunctionNode, TEXT("FlagId")), UK2Node_MakeLiteralFlagName::MakeBakedFlagIdDefault(LiteralFlagName));
+		}
+		else
+		{
+			Link(ProxyPin(UK2Node_SetMassFlagByName::FlagPinName()), FunctionInputPin(SetFunctionNode, TEXT("FlagName")));
+		}
 			if (bIsEntityMode)
 			{
 				Link(ProxyPin(UK2Node_SetMassFlagByName::DeferredPinName()), FunctionInputPin(SetFunctionNode, TEXT("bDeferred")));
@@ -534,11 +546,11 @@ virtual void Compile() override
 		switch (OwnerNode->CachedDataSourceType)
 		{
 			case EMassFragmentSourceDataType::EntityHandle:
-				SetFunctionNode = HNCH_SpawnFunctionNode(UMassAPIFuncLib, SetFlag_EntityByName);
+				SetFunctionNode = (bBakeFlag ? HNCH_SpawnFunctionNode(UMassAPIFuncLib, SetFlag_EntityById) : HNCH_SpawnFunctionNode(UMassAPIFuncLib, SetFlag_EntityByName));
 				FunctionDataSourcePinName = TEXT("EntityHandle");
 				break;
 			case EMassFragmentSourceDataType::EntityTemplateData:
-				SetFunctionNode = HNCH_SpawnFunctionNode(UMassAPIFuncLib, SetFlag_TemplateByName);
+				SetFunctionNode = (bBakeFlag ? HNCH_SpawnFunctionNode(UMassAPIFuncLib, SetFlag_TemplateById) : HNCH_SpawnFunctionNode(UMassAPIFuncLib, SetFlag_TemplateByName));
 				FunctionDataSourcePinName = TEXT("TemplateData");
 				break;
 			default:
@@ -549,7 +561,14 @@ virtual void Compile() override
 		Link(ThenPin(SetFunctionNode), ProxyThenPin());
 
 		Link(ProxyPin(UK2Node_SetMassFlagByName::DataSourcePinName()), FunctionInputPin(SetFunctionNode, FunctionDataSourcePinName));
-		Link(ProxyPin(UK2Node_SetMassFlagByName::FlagPinName()), FunctionInputPin(SetFunctionNode, TEXT("FlagName")));
+		if (bBakeFlag)
+		{
+			PinDefaultValue(FunctionInputPin(SetFunctionNode, TEXT("FlagId")), UK2Node_MakeLiteralFlagName::MakeBakedFlagIdDefault(LiteralFlagName));
+		}
+		else
+		{
+			Link(ProxyPin(UK2Node_SetMassFlagByName::FlagPinName()), FunctionInputPin(SetFunctionNode, TEXT("FlagName")));
+		}
 
 
 			if (OwnerNode->CachedDataSourceType == EMassFragmentSourceDataType::EntityHandle)
@@ -16,6 +16,7 @@ class FBlueprintActionDatabaseRegistrar;
 /**
  * Pure node that outputs a single FName literal picked from the FlagRegistry dropdown.
  * Follows UK2Node_EnumLiteral pattern: input pin (with dropdown) → output pin.
+ * The FlagId output carries the same flag resolved to its bit index at Blueprint compile time.
  * | 纯节点，从下拉列表选择一个旗标名，输出 FName。仿 UK2Node_EnumLiteral 模式。
  */
 UCLASS()
@@ -54,6 +55,18 @@ public:
 	//================ Pin.Names																				========
 
 	static FName ValuePinName() { return TEXT("Value"); }
+	static FName FlagIdPinName() { return TEXT("FlagId"); }
+
+	//================ Flag.Baking																				========
+
+	/**
+	 * Reads a flag name that is fixed at compile time: the pin's own default when unlinked,
+	 * or the Value of a Make Literal Flag node it is linked to. | 读取编译期确定的旗标名
+	 */
+	static bool TryGetLiteralFlagName(const UEdGraphPin* FlagPin, FName& OutFlagName);
+
+	/** FEntityFlagId default-value text with the bit index and registry version resolved now | 以当前注册表解析的 FEntityFlagId 默认值文本 */
+	static FString MakeBakedFlagIdDefault(FName FlagName);
 
 };
 